@@ -28,9 +28,9 @@ CREDITS:
 #include <cstddef>
 
 #define NRD_VERSION_MAJOR 4
-#define NRD_VERSION_MINOR 14
+#define NRD_VERSION_MINOR 15
 #define NRD_VERSION_BUILD 0
-#define NRD_VERSION_DATE "19 February 2025"
+#define NRD_VERSION_DATE "18 October 2026"
 
 #if defined(_WIN32)
     #define NRD_CALL __stdcall
@@ -51,13 +51,26 @@ namespace nrd
     NRD_API Result NRD_CALL CreateInstance(const InstanceCreationDesc& instanceCreationDesc, Instance*& instance);
     NRD_API void NRD_CALL DestroyInstance(Instance& instance);
 
+    // Memory-mapped shader packs (optional, an alternative to embedding shaders into the library, see "NRD_SHADER_PACKS")
+    NRD_API Result NRD_CALL CreateShaderPack(const ShaderPackCreationDesc& shaderPackCreationDesc, ShaderPack*& shaderPack);
+    NRD_API void NRD_CALL DestroyShaderPack(ShaderPack& shaderPack);
+
     // Get
     NRD_API const LibraryDesc& NRD_CALL GetLibraryDesc();
     NRD_API const InstanceDesc& NRD_CALL GetInstanceDesc(const Instance& instance);
 
-    // Typically needs to be called once per frame
+    // Typically needs to be called once per frame (sets viewport 0)
     NRD_API Result NRD_CALL SetCommonSettings(Instance& instance, const CommonSettings& commonSettings);
 
+    // Multiple viewports (see "InstanceCreationDesc::viewportsNum"): needs to be called once per frame for each viewport (dispatches
+    // are not merged across viewports)
+    NRD_API Result NRD_CALL SetViewportSettings(Instance& instance, uint32_t viewportIndex, const CommonSettings& commonSettings);
+
+    // Stereo: eyes are viewports 0 and 1, settings are applied in pairs. Eyes must share "frameIndex", "resourceSize" and "rectSize",
+    // accumulation gets restarted for both eyes if requested for any of them (i.e. eye histories stay in sync). Eyes are denoised by separate
+    // dispatches (as two viewports), there is no layered "z = eye" dispatch
+    NRD_API Result NRD_CALL SetStereoSettings(Instance& instance, const CommonSettings& leftEye, const CommonSettings& rightEye);
+
     // Typically needs to be called at least once per denoiser (not necessarily on each frame)
     NRD_API Result NRD_CALL SetDenoiserSettings(Instance& instance, Identifier identifier, const void* denoiserSettings);
 
@@ -65,6 +78,56 @@ namespace nrd
     // IMPORTANT: returned memory is owned by the "instance" and will be overwritten by the next "GetComputeDispatches" call
     NRD_API Result NRD_CALL GetComputeDispatches(Instance& instance, const Identifier* identifiers, uint32_t identifiersNum, const DispatchDesc*& dispatchDescs, uint32_t& dispatchDescsNum);
 
+    // Same as above, but dispatches and constants are written directly into caller-owned memory (for example, a mapped upload buffer)
+    //  - "dispatchDescsNum" and "constantDataSize" are capacities on input and required sizes on output
+    //  - "dispatchDescs = NULL" is a size query
+    //  - INSUFFICIENT_MEMORY is returned if capacities are not enough ("constantBufferData = NULL" for dispatches, which constants don't fit)
+    //  - "constantData" is only written (never read), i.e. write-combined memory is fine
+    //  - each "constantBufferData" is aligned to "constantDataAlignment" (a power of 2, >= 16) relative to "constantData" (16 bytes aligned)
+    //  - "resources" and "name" point to immutable memory owned by the "instance"
+    //  - idempotent for a given "CommonSettings::frameIndex" (denoiser state is advanced only once per frame)
+    //  - thread safe for disjoint "identifiers" lists (no calls to "Set*Settings" in parallel), including denoisers of different viewports
+    NRD_API Result NRD_CALL GetComputeDispatchesToMemory(Instance& instance, const Identifier* identifiers, uint32_t identifiersNum,
+        DispatchDesc* dispatchDescs, uint32_t& dispatchDescsNum, uint8_t* constantData, uint32_t& constantDataSize, uint32_t constantDataAlignment);
+
+    // Resize without losing history: returns dispatches resampling the permanent pool into the new resource size. Inputs ("TEXTURE")
+    // refer to permanent pool textures of the old size, outputs ("STORAGE_TEXTURE") - to new textures. The next frame continues accumulation
+    // IMPORTANT: returned memory is owned by the "instance" and will be overwritten by the next "GetComputeDispatches" call
+    NRD_API Result NRD_CALL GetResizeDispatches(Instance& instance, uint16_t resourceWidth, uint16_t resourceHeight, const DispatchDesc*& dispatchDescs, uint32_t& dispatchDescsNum);
+
+    // Pre-creation planning: memory, bandwidth and grid estimates for a would-be instance with "resourceSize = rectSize = resourceWidth x resourceHeight"
+    // (no instance or device is needed, shaders are not touched). "passPlansNum" is capacity on input and required size on output,
+    // "passPlans = NULL" is a size query. INSUFFICIENT_MEMORY is returned if capacity is not enough ("instancePlan" is valid anyway).
+    // Texture sizes ignore alignment and padding of the graphics API, i.e. the real memory usage is slightly higher
+    NRD_API Result NRD_CALL PlanInstance(const InstanceCreationDesc& instanceCreationDesc, uint16_t resourceWidth, uint16_t resourceHeight,
+        InstancePlan& instancePlan, PassPlan* passPlans, uint32_t& passPlansNum);
+
+    // Per-frame budgeting: counts work generated by dispatches returned by "GetComputeDispatches*" or "GetResizeDispatches" (stateless,
+    // i.e. stats of several calls can be accumulated by the caller)
+    NRD_API Result NRD_CALL GetDispatchStats(const Instance& instance, const DispatchDesc* dispatchDescs, uint32_t dispatchDescsNum, DispatchStats& dispatchStats);
+
+    // Warm start: CPU-side history state (the GPU-side history is the permanent pool, i.e. its textures need to be copied by the application)
+    //  - "ExportHistory": "dataSize" is capacity on input and required size on output, "data = NULL" is a size query. FAILURE if there is no history yet
+    //  - "ImportHistory": must be called before "SetCommonSettings", it's valid for a new instance (including a different "resourceSize").
+    //    All denoisers of the instance must be in the history (matched by "identifier" and "denoiser"). The next frame continues accumulation,
+    //    "Prev" settings are taken from the history (the history is expected in the top-left corner of new textures, if "rectSize" of
+    //    the exported frame doesn't fit into the new "resourceSize" accumulation restarts)
+    //  - "permanentPoolRemap" (optional, "InstanceDesc::permanentPoolSize" entries) - receives indices of exported permanent pool textures,
+    //    which need to be copied into the corresponding textures of the instance
+    //  - both return UNSUPPORTED for instances with multiple viewports
+    NRD_API Result NRD_CALL ExportHistory(const Instance& instance, void* data, uint32_t& dataSize);
+    NRD_API Result NRD_CALL ImportHistory(Instance& instance, const void* data, uint32_t dataSize, uint16_t* permanentPoolRemap);
+
+    // Live reconfiguration (adding or removing denoisers without "DestroyInstance" + "CreateInstance" losing the history of all denoisers):
+    // "instance" is a new instance with the desired set of denoisers, "source" is the instance being replaced (can be destroyed right after)
+    //  - must be called before "SetCommonSettings". Viewport states are taken from "source"
+    //  - denoisers found in "source" (matched by "identifier", "denoiser" and "viewportIndex") keep settings and continue accumulation,
+    //    new denoisers restart alone (other denoisers of the same viewport are not affected)
+    //  - "permanentPoolRemap" (optional, "InstanceDesc::permanentPoolSize" entries) - receives indices of "source" permanent pool textures,
+    //    which must be used as is (no copy) in place of the corresponding textures of "instance", or "0xFFFF" for new textures.
+    //    "source" textures not referenced by the remap are not needed anymore. The transient pool is not preserved
+    NRD_API Result NRD_CALL InheritHistory(Instance& instance, const Instance& source, uint16_t* permanentPoolRemap);
+
     // Helpers
     NRD_API const char* GetResourceTypeString(ResourceType resourceType);
     NRD_API const char* GetDenoiserString(Denoiser denoiser);
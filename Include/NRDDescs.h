@@ -11,7 +11,7 @@ license agreement from NVIDIA CORPORATION is strictly prohibited.
 #pragma once
 
 #define NRD_DESCS_VERSION_MAJOR 4
-#define NRD_DESCS_VERSION_MINOR 14
+#define NRD_DESCS_VERSION_MINOR 15
 
 static_assert(NRD_VERSION_MAJOR == NRD_DESCS_VERSION_MAJOR && NRD_VERSION_MINOR == NRD_DESCS_VERSION_MINOR, "Please, update all NRD SDK files");
 
@@ -20,6 +20,7 @@ namespace nrd
     typedef uint32_t Identifier;
 
     struct Instance;
+    struct ShaderPack;
 
     enum class Result : uint32_t
     {
@@ -28,6 +29,7 @@ namespace nrd
         INVALID_ARGUMENT,
         UNSUPPORTED,
         NON_UNIQUE_IDENTIFIER,
+        INSUFFICIENT_MEMORY,
 
         MAX_NUM
     };
@@ -150,6 +152,19 @@ namespace nrd
         // Dedicated to NRD, can't be reused
         PERMANENT_POOL,
 
+        //=============================================================================================================================
+        // OUTPUTS (added after pools to keep values of the entries above intact)
+        //=============================================================================================================================
+
+        // (Optional) Upscaled "OUT_DIFF_RADIANCE_HITDIST" and "OUT_SPEC_RADIANCE_HITDIST" (RGBA16f+), same encoding
+        // Used if "CommonSettings::outputSize" is not 0, the size is "outputSize" (not "rectSize")
+        OUT_DIFF_RADIANCE_HITDIST_UPSCALED,
+        OUT_SPEC_RADIANCE_HITDIST_UPSCALED,
+
+        // (Optional) Ray budget per 16x16 tile in [0; 1] (R8+), the size is "rectSize / 16" (rounded up)
+        // Used if "CommonSettings::enableSamplingHint = true"
+        OUT_SAMPLING_HINT,
+
         MAX_NUM,
     };
 
@@ -337,6 +352,16 @@ namespace nrd
         MAX_NUM
     };
 
+    // Order matches "PipelineDesc::computeShader*"
+    enum class ShaderFormat : uint32_t
+    {
+        DXBC,
+        DXIL,
+        SPIRV,
+
+        MAX_NUM
+    };
+
     // NRD_NORMAL_ENCODING variants
     enum class NormalEncoding : uint8_t
     {
@@ -401,6 +426,7 @@ namespace nrd
     {
         Identifier identifier;
         Denoiser denoiser;
+        uint32_t viewportIndex; // "CommonSettings" to use (see "SetViewportSettings")
     };
 
     struct InstanceCreationDesc
@@ -408,12 +434,28 @@ namespace nrd
         AllocationCallbacks allocationCallbacks;
         const DenoiserDesc* denoisers;
         uint32_t denoisersNum;
+
+        // (Optional) number of viewports with individual "CommonSettings" (0 = 1). Split-screen, reflection or portal views can live in
+        // one instance sharing the transient pool, "resourceSize" must be the same for all viewports. It's per-viewport state only:
+        // each denoiser still gets its own dispatches, i.e. the dispatch count is the same as with separate instances
+        uint32_t viewportsNum;
+
+        // (Optional) shader packs providing bytecode for formats not embedded into the library (must outlive the instance)
+        const ShaderPack* const* shaderPacks;
+        uint32_t shaderPacksNum;
+    };
+
+    struct ShaderPackCreationDesc
+    {
+        AllocationCallbacks allocationCallbacks;
+        const char* path; // a file produced by "NRDShaderPacker"
     };
 
     struct TextureDesc
     {
         Format format;
         uint16_t downsampleFactor;
+        const char* name; // "DENOISER::SLOT" (a transient texture can be shared by several denoisers, it's named after the first one)
     };
 
     struct ResourceDesc
@@ -446,6 +488,9 @@ namespace nrd
         const ResourceRangeDesc* resourceRanges; // up to 2 ranges: "TEXTURE" inputs (optional) and "TEXTURE_STORAGE" outputs
         uint32_t resourceRangesNum;
 
+        // Size of per-dispatch root (push) constants, 0 if unused (see "InstanceDesc::rootConstantsRegisterIndex")
+        uint32_t rootConstantDataSize;
+
         // Hint that pipeline has a constant buffer with shared parameters from "InstanceDesc"
         bool hasConstantData;
     };
@@ -466,6 +511,9 @@ namespace nrd
         uint32_t constantBufferSpaceIndex; // = NRD_CONSTANT_BUFFER_SPACE_INDEX
         uint32_t constantBufferRegisterIndex; // = NRD_CONSTANT_BUFFER_REGISTER_INDEX
 
+        // Root (push) constants (in "constantBufferSpaceIndex" space)
+        uint32_t rootConstantsRegisterIndex; // = NRD_ROOT_CONSTANTS_REGISTER_INDEX
+
         // Samplers (shared)
         const Sampler* samplers;
         uint32_t samplersNum; // = Sampler::MAX_NUM
@@ -505,9 +553,46 @@ namespace nrd
         uint32_t constantBufferDataSize;
         bool constantBufferDataMatchesPreviousDispatch; // i.e. no update needed
 
+        // Root (push) constants, small per-pass values (only if "PipelineDesc::rootConstantDataSize != 0")
+        uint32_t rootConstantData[4];
+        uint32_t rootConstantDataSize;
+
         // Other
         uint16_t pipelineIndex;
         uint16_t gridWidth;
         uint16_t gridHeight;
     };
+
+    // Pre-creation planning (see "PlanInstance"). Bandwidth is a rough estimate: each bound texture is assumed to be read (or written)
+    // once per pixel, user resources are assumed to be full resolution (4 bytes per pixel for "IN_VIEWZ" and "IN_NORMAL_ROUGHNESS",
+    // 8 bytes per pixel for others)
+    struct PassPlan
+    {
+        const char* name;
+        Identifier identifier;
+        uint64_t bytesRead; // per dispatch
+        uint64_t bytesWritten; // per dispatch
+        uint16_t gridWidth;
+        uint16_t gridHeight;
+        uint16_t maxRepeatsNum; // the pass can be dispatched up to this number of times per frame
+    };
+
+    struct InstancePlan
+    {
+        uint64_t permanentPoolSize; // bytes
+        uint64_t transientPoolSize; // bytes
+        uint64_t bytesReadPerFrame; // all passes with all repeats (upper bound)
+        uint64_t bytesWrittenPerFrame;
+        uint32_t passesNum;
+    };
+
+    // Work generated by a list of dispatches (see "GetDispatchStats")
+    struct DispatchStats
+    {
+        uint32_t dispatchNum;
+        uint32_t clearDispatchNum; // injected if "AccumulationMode::CLEAR_AND_RESTART"
+        uint64_t threadGroupNum;
+        uint64_t constantBufferBytesWritten;
+        uint64_t constantBufferBytesSkipped; // "constantBufferDataMatchesPreviousDispatch = true"
+    };
 }
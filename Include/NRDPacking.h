@@ -0,0 +1,66 @@
+/*
+Copyright (c) 2022, NVIDIA CORPORATION. All rights reserved.
+
+NVIDIA CORPORATION and its licensors retain all intellectual property
+and proprietary rights in and to this software, related documentation
+and any modifications thereto. Any use, reproduction, disclosure or
+distribution of this software and related documentation without an express
+license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include "NRD.h"
+
+// Host-side versions of "NRD.hlsli" front-end (and back-end) functions, for CPU path tracers, bakes and tools:
+//  - batch processing of "num" elements, arrays are tightly packed ("float3" - 3 floats, "float4" - 4 floats per element)
+//  - encoding matches the library ("LibraryDesc::normalEncoding" and "LibraryDesc::roughnessEncoding")
+//  - results are bit-exact with a straightforward scalar port of "NRD.hlsli" (the same operation order, no FMA contraction),
+//    regardless of the SIMD path used (SSE4.1, AVX2 or scalar). NAN results stay NAN, but the payload is unspecified (like on GPU).
+//    GPU results can differ in the last bits (approximate "rsqrt", "exp2"...)
+//  - optional inputs can be NULL
+namespace nrd
+{
+    // X => IN_NORMAL_ROUGHNESS ("materialID" is optional)
+    NRD_API void NRD_CALL NRD_FrontEnd_PackNormalAndRoughness(const float* normal, const float* roughness, const float* materialID, uint32_t num, float* packed);
+
+    // IN_NORMAL_ROUGHNESS => X ("normalAndRoughness" - "float4", "materialID" is optional)
+    NRD_API void NRD_CALL NRD_FrontEnd_UnpackNormalAndRoughness(const float* packed, uint32_t num, float* normalAndRoughness, float* materialID);
+
+    // Hit distance => normalized hit distance
+    NRD_API void NRD_CALL REBLUR_FrontEnd_GetNormHitDist(const float* hitDist, const float* viewZ, const float* roughness, const HitDistanceParameters& hitDistanceParameters, uint32_t num, float* normHitDist);
+
+    // X => IN_DIFF_RADIANCE_HITDIST, IN_SPEC_RADIANCE_HITDIST
+    NRD_API void NRD_CALL REBLUR_FrontEnd_PackRadianceAndNormHitDist(const float* radiance, const float* normHitDist, uint32_t num, bool sanitize, float* packed);
+
+    // X => IN_DIFF_SH0 and IN_DIFF_SH1, IN_SPEC_SH0 and IN_SPEC_SH1
+    NRD_API void NRD_CALL REBLUR_FrontEnd_PackSh(const float* radiance, const float* normHitDist, const float* direction, uint32_t num, bool sanitize, float* packed0, float* packed1);
+
+    // X => IN_DIFF_DIRECTION_HITDIST
+    NRD_API void NRD_CALL REBLUR_FrontEnd_PackDirectionalOcclusion(const float* direction, const float* normHitDist, uint32_t num, bool sanitize, float* packed);
+
+    // X => IN_DIFF_RADIANCE_HITDIST, IN_SPEC_RADIANCE_HITDIST
+    NRD_API void NRD_CALL RELAX_FrontEnd_PackRadianceAndHitDist(const float* radiance, const float* hitDist, uint32_t num, bool sanitize, float* packed);
+
+    // X => IN_DIFF_SH0 and IN_DIFF_SH1, IN_SPEC_SH0 and IN_SPEC_SH1
+    NRD_API void NRD_CALL RELAX_FrontEnd_PackSh(const float* radiance, const float* hitDist, const float* direction, uint32_t num, bool sanitize, float* packed0, float* packed1);
+
+    // X => IN_PENUMBRA (infinite light source)
+    NRD_API void NRD_CALL SIGMA_FrontEnd_PackPenumbra(const float* distanceToOccluder, float tanOfLightAngularRadius, uint32_t num, float* penumbra);
+
+    // X => IN_PENUMBRA (local light source)
+    NRD_API void NRD_CALL SIGMA_FrontEnd_PackPenumbraLocal(const float* distanceToOccluder, const float* distanceToLight, float lightSize, uint32_t num, float* penumbra);
+
+    // X => IN_TRANSLUCENCY ("translucency" - "float3")
+    NRD_API void NRD_CALL SIGMA_FrontEnd_PackTranslucency(const float* distanceToOccluder, const float* translucency, uint32_t num, float* packed);
+
+    // OUT_DIFF_RADIANCE_HITDIST, OUT_SPEC_RADIANCE_HITDIST => X (other REBLUR and RELAX outputs are used "as is")
+    NRD_API void NRD_CALL REBLUR_BackEnd_UnpackRadianceAndNormHitDist(const float* packed, uint32_t num, float* radianceAndNormHitDist);
+
+    // OUT_SHADOW_TRANSLUCENCY => X (element-wise, "num" - number of floats)
+    NRD_API void NRD_CALL SIGMA_BackEnd_UnpackShadow(const float* packed, uint32_t num, float* shadow);
+
+    // FP32 <=> FP16 (round to nearest even, F16C if available), i.e. packed data can be uploaded into "*16_SFLOAT" textures
+    NRD_API void NRD_CALL ConvertFloatToHalf(const float* src, uint32_t num, uint16_t* dst);
+    NRD_API void NRD_CALL ConvertHalfToFloat(const uint16_t* src, uint32_t num, float* dst);
+}
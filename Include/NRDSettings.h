@@ -11,7 +11,7 @@ license agreement from NVIDIA CORPORATION is strictly prohibited.
 #pragma once
 
 #define NRD_SETTINGS_VERSION_MAJOR 4
-#define NRD_SETTINGS_VERSION_MINOR 14
+#define NRD_SETTINGS_VERSION_MINOR 15
 
 static_assert(NRD_VERSION_MAJOR == NRD_SETTINGS_VERSION_MAJOR && NRD_VERSION_MINOR == NRD_SETTINGS_VERSION_MINOR, "Please, update all NRD SDK files");
 
@@ -127,6 +127,10 @@ namespace nrd
         uint16_t rectSize[2] = {};
         uint16_t rectSizePrev[2] = {};
 
+        // (Optional) if non-zero, REBLUR/RELAX radiance denoisers additionally upscale the denoised signal to this size
+        // into "OUT_*_RADIANCE_HITDIST_UPSCALED" (jitter-aware, i.e. "cameraJitter" must match the jitter used for rendering)
+        uint16_t outputSize[2] = {};
+
         // (>0) - viewZ = IN_VIEWZ * viewZScale (mostly for FP16 viewZ)
         float viewZScale = 1.0f;
 
@@ -169,7 +173,8 @@ namespace nrd
         uint32_t rectOrigin[2] = {};
 
         // A consecutively growing number. Valid usage:
-        // - must be incremented by 1 on each frame (not by 1 on each "SetCommonSettings" call)
+        // - must be incremented by 1 on each frame (not by 1 on each "SetCommonSettings" call), denoisers advance only if it changes
+        //   (INVALID_ARGUMENT is returned for the same value, unless "AccumulationMode != CONTINUE")
         // - sequence can be restarted after passing "AccumulationMode != CONTINUE"
         // - must be in sync with "CheckerboardMode" (if not OFF)
         uint32_t frameIndex = 0;
@@ -192,6 +197,9 @@ namespace nrd
 
         // Enables debug overlay in OUT_VALIDATION
         bool enableValidation = false;
+
+        // Enables per-tile ray budget in OUT_SAMPLING_HINT (REBLUR/RELAX radiance denoisers), based on history length and noise
+        bool enableSamplingHint = false;
     };
 
     //====================================================================================================================================================
@@ -18,19 +18,27 @@ license agreement from NVIDIA CORPORATION is strictly prohibited.
 //    Extensions/NRIWrapperD3D12.h
 //    Extensions/NRIWrapperVK.h
 
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <vector>
+#include <string>
 #include <map>
+#include <list>
+#include <unordered_map>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 #include <stdio.h>
 
+#include "NRDIntegrationUtils.h"
+
 #define NRD_INTEGRATION_MAJOR 1
-#define NRD_INTEGRATION_MINOR 16
-#define NRD_INTEGRATION_DATE "20 December 2024"
+#define NRD_INTEGRATION_MINOR 17
+#define NRD_INTEGRATION_DATE "18 October 2026"
 #define NRD_INTEGRATION 1
 
-// Debugging
-#define NRD_INTEGRATION_DEBUG_LOGGING 0
-
 #ifndef NRD_INTEGRATION_ASSERT
     #include <assert.h>
     #define NRD_INTEGRATION_ASSERT(expr, msg) assert(msg && expr)
@@ -42,17 +50,53 @@ namespace nrd
 {
 
 // "TextureBarrierDesc::texture" represents the resource, the rest represents the state ("before" state is unused and can be zeroed)
-typedef std::array<nri::TextureBarrierDesc*, (size_t)ResourceType::MAX_NUM - 2> UserPool;
+typedef std::array<nri::TextureBarrierDesc*, (size_t)ResourceType::MAX_NUM> UserPool; // pool slots are unused
 
 // User pool must contain valid entries for resources, which are required for requested denoisers,
 // but the entire pool must be zero-ed during initialization
 inline void Integration_SetResource(UserPool& pool, ResourceType slot, nri::TextureBarrierDesc* texture)
 {
     NRD_INTEGRATION_ASSERT(texture != nullptr, "Invalid texture!");
+    NRD_INTEGRATION_ASSERT(slot != ResourceType::TRANSIENT_POOL && slot != ResourceType::PERMANENT_POOL, "Pools are managed by NRD integration!");
 
     pool[(size_t)slot] = texture;
 }
 
+// Sink for the runtime tracer, receives chunks of Chrome trace-event JSON (can be opened in "chrome://tracing" or Perfetto).
+// The first chunk opens the JSON array, which is never closed (allowed by the format), i.e. chunks can be simply appended to a file
+struct TraceCallbacks
+{
+    void (*Write)(void* userArg, const char* data, size_t size);
+    void* userArg;
+};
+
+// Warm start: a snapshot of the denoiser history, which can be imported into the same or another (for example, recreated) integration
+struct IntegrationHistory
+{
+    std::vector<uint8_t> state; // see "nrd::ExportHistory"
+    std::vector<nri::TextureBarrierDesc> textures; // copies of the permanent pool
+    std::vector<nri::Memory*> memoryAllocations;
+};
+
+// Work recorded by an integration since the last "NewFrame" (see "Integration::GetFrameStats")
+struct IntegrationFrameStats
+{
+    DispatchStats dispatchStats; // see "nrd::GetDispatchStats"
+    uint32_t descriptorWriteNum; // texture, sampler and constant buffer descriptors written into descriptor sets
+    uint32_t descriptorSetNum; // allocated
+    uint32_t descriptorSetReuseNum; // dispatches, which reused descriptor sets of an identical dispatch (no allocations and writes)
+    uint32_t barrierNum; // texture barriers
+};
+
+// Memory used by a pool texture (see "Integration::GetMemoryReport")
+struct IntegrationResourceMemory
+{
+    const char* name; // see "TextureDesc::name"
+    uint64_t size;
+    uint32_t indexInPool;
+    bool isPermanent;
+};
+
 struct IntegrationCreationDesc
 {
     // Not so long name
@@ -70,6 +114,33 @@ struct IntegrationCreationDesc
     // false - descriptors are cached only within a single "Denoise" call
     bool enableDescriptorCaching = false;
 
+    // (Optional) max number of cached descriptors (caching only), least recently used descriptors get evicted beyond this limit.
+    // Descriptors used in the current frame are never evicted, evicted descriptors are destroyed when not in use by the GPU anymore
+    // 0 - unbounded
+    uint32_t descriptorCacheCapacity = 0;
+
+    // true - pipelines are created on first use (or via "PrewarmPipelines"), it reduces load time and driver memory,
+    // because typically only a few permutations get used
+    // false - all pipelines are created in "Initialize"
+    bool enableLazyPipelineCreation = false;
+
+    // (Optional) number of background threads creating pipelines queued by "PrewarmPipelines" (lazy creation only)
+    // 0 - pipelines are created on the calling thread
+    uint8_t pipelineCompilationThreadsNum = 0;
+
+    // (Optional) persistent prewarm list, loaded in "Initialize" and stored in "Destroy" (callbacks have priority over the path).
+    // It remembers pipelines used in previous runs, which get prewarmed on the next launch (lazy creation only, otherwise ignored).
+    // It's NOT a driver pipeline cache: only shader names are stored, i.e. compilation time stays the same, but it moves out of the
+    // first frames using these pipelines. The blob is keyed by NRD version, encodings, graphics API and adapter, i.e. a stale list
+    // is silently ignored
+    const char* prewarmListPath = nullptr;
+    PrewarmListCallbacks prewarmListCallbacks = {};
+
+    // true - transient pool textures are not bound to memory by the integration. The application must place them into its own memory
+    // via "BindTransientPool" (after "Initialize" and after each "Resize"), it allows to alias the transient pool with other
+    // resources used outside of "Denoise" (for example, post-processing targets)
+    bool enableExternalTransientPool = false;
+
     // Demote FP32 to FP16 (slightly improves performance in exchange of precision loss)
     // (FP32 is used only for viewZ under the hood, all denoisers are FP16 compatible)
     bool demoteFloat32to16 = false;
@@ -78,6 +149,98 @@ struct IntegrationCreationDesc
     bool promoteFloat16to32 = false;
 };
 
+// Process-wide registry of pipelines (and their layouts), shared by all "Integration" instances created on the same device.
+// Entries are keyed by shader identity (device, shader file name, resource layout) and reference counted
+class PipelineRegistry
+{
+public:
+    struct Entry
+    {
+        nri::PipelineLayout* pipelineLayout;
+        nri::Pipeline* pipeline;
+        uint32_t refCount;
+    };
+
+    // Returns "true" and references the entry if found, otherwise the caller must create objects and "Register" them
+    static bool Acquire(uint64_t key, Entry& entry);
+    static void Register(uint64_t key, Entry& entry); // "entry" gets replaced if another thread has registered the key first
+    static void Release(uint64_t key, const nri::CoreInterface& nriCore);
+
+    static inline size_t GetEntriesNum()
+    {
+        std::lock_guard<std::mutex> lock(s_Lock);
+        return s_Entries.size();
+    }
+
+private:
+    static inline std::map<uint64_t, Entry> s_Entries;
+    static inline std::mutex s_Lock;
+};
+
+// CPU-side tracer producing Chrome trace-event JSON (doesn't depend on a device, i.e. can be used and tested standalone).
+// Events are accumulated in memory and passed to the sink in "Flush". "args" are members of a JSON object, like "\"num\":3"
+class Tracer
+{
+public:
+    inline bool IsEnabled() const
+    { return m_Callbacks.Write != nullptr; }
+
+    inline uint64_t GetTimestamp() const // microseconds
+    { return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_Origin).count(); }
+
+    void Enable(const TraceCallbacks& callbacks, const char* processName);
+    void Disable(); // flushes
+    void Flush();
+    void Span(const char* name, const char* category, uint64_t beginTimestamp, const char* args = nullptr);
+    void Instant(const char* name, const char* category, const char* args = nullptr);
+
+private:
+    void AppendEvent(const char* name, const char* category, char phase, uint64_t timestamp, uint64_t duration, const char* args);
+    void AppendString(const char* s);
+
+    std::string m_Buffer;
+    std::chrono::steady_clock::time_point m_Origin;
+    TraceCallbacks m_Callbacks = {};
+};
+
+// Records a span from construction to destruction, does nothing (except a branch) if tracing is disabled
+class TraceScope
+{
+public:
+    inline TraceScope(Tracer& tracer, const char* name, const char* category) :
+        m_Tracer(tracer.IsEnabled() ? &tracer : nullptr),
+        m_Name(name),
+        m_Category(category)
+    {
+        m_Args[0] = '\0'; // the rest is written only by "SetArgs"
+
+        if (m_Tracer)
+            m_BeginTimestamp = m_Tracer->GetTimestamp();
+    }
+
+    inline ~TraceScope()
+    {
+        if (m_Tracer)
+            m_Tracer->Span(m_Name, m_Category, m_BeginTimestamp, m_Args[0] ? m_Args : nullptr);
+    }
+
+    inline bool IsEnabled() const
+    { return m_Tracer != nullptr; }
+
+    // Call only if "IsEnabled"
+    template<typename... Args> inline void SetArgs(const char* format, Args... args)
+    { snprintf(m_Args, sizeof(m_Args), format, args...); }
+
+private:
+    TraceScope(const TraceScope&) = delete;
+
+    Tracer* m_Tracer;
+    const char* m_Name;
+    const char* m_Category;
+    uint64_t m_BeginTimestamp = 0;
+    char m_Args[512]; // not zero-filled, scopes are created per dispatch
+};
+
 class Integration
 {
 public:
@@ -87,16 +250,29 @@ public:
     inline ~Integration()
     { NRD_INTEGRATION_ASSERT(m_NRI == nullptr, "m_NRI must be NULL at this point!"); }
 
-    // There is no "Resize" functionality, because NRD full recreation costs nothing.
-    // The main cost comes from render targets resizing, which needs to be done in any case
-    // (call Destroy beforehand)
     bool Initialize(const IntegrationCreationDesc& nrdIntegrationDesc, const InstanceCreationDesc& instanceCreationDesc, nri::Device& nriDevice, const nri::CoreInterface& nriCore, const nri::HelperInterface& nriHelper);
 
     // Must be called once on a frame start
     void NewFrame();
 
+    // Changes the resource size keeping the instance, pipelines and other size independent objects. Only the texture pool gets
+    // reallocated, the history is resampled into new textures (recorded into "commandBuffer"), i.e. the next frame continues
+    // accumulation. Old textures are destroyed when they are not in use by the GPU anymore (see "bufferedFramesNum").
+    // Must be called after "NewFrame" and before "SetCommonSettings". DRS within the allocated size doesn't need "Resize":
+    // keep "resourceSize" and change "rectSize" instead
+    bool Resize(nri::CommandBuffer& commandBuffer, uint16_t resourceWidth, uint16_t resourceHeight);
+
+    // Adds or removes denoisers keeping the history of the others (see "nrd::InheritHistory"): the instance is replaced by a new one, created
+    // from "instanceCreationDesc". Permanent textures of kept denoisers are reused as is, transient textures are reused if descriptions
+    // match, i.e. only missing textures get created and memory of textures, which are not needed anymore, gets freed. Pipelines used by
+    // both instances are not recreated (unless "enableLazyPipelineCreation" is used). Must be called after "NewFrame" and before
+    // "SetCommonSettings", the device must be in the IDLE state. The external transient pool must be bound again (see "BindTransientPool")
+    bool Reconfigure(const InstanceCreationDesc& instanceCreationDesc);
+
     // Explicitly calls eponymous NRD API functions
     bool SetCommonSettings(const CommonSettings& commonSettings);
+    bool SetViewportSettings(uint32_t viewportIndex, const CommonSettings& commonSettings); // see "InstanceCreationDesc::viewportsNum"
+    bool SetStereoSettings(const CommonSettings& leftEye, const CommonSettings& rightEye);
     bool SetDenoiserSettings(Identifier denoiser, const void* denoiserSettings);
 
     // Invokes denoising for specified denoisers
@@ -112,6 +288,26 @@ public:
     // Should not be called explicitly, unless you want to reload pipelines
     void CreatePipelines();
 
+    // Lazy creation only: requests pipelines for the given shaders (see "PipelineDesc::shaderFileName", NULL - all pipelines).
+    // Pipelines are created on worker threads if "pipelineCompilationThreadsNum != 0", otherwise right now
+    void PrewarmPipelines(const char* const* shaderFileNames, uint32_t shaderFileNamesNum);
+
+    // Warm start (fast cuts to precomputed camera positions, recreation):
+    //  - "ExportHistory" records copies of the permanent pool into "history" (textures are created on first use and reused later)
+    //  - "ImportHistory" records copies from "history" into the permanent pool and restores the CPU state. Must be called before
+    //    "SetCommonSettings", the next frame continues accumulation from the exported frame ("Prev" settings are ignored).
+    //    The resource size can differ (see "nrd::ImportHistory")
+    //  - "DestroyHistory" destroys textures, the history must not be in use by the GPU
+    bool ExportHistory(nri::CommandBuffer& commandBuffer, IntegrationHistory& history);
+    bool ImportHistory(nri::CommandBuffer& commandBuffer, IntegrationHistory& history);
+    void DestroyHistory(IntegrationHistory& history);
+
+    // Runtime tracing (can be toggled at any time, including before "Initialize"): spans for "Denoise", dispatches, barrier
+    // batches, descriptor allocations and constant uploads in Chrome trace-event JSON. Events are passed to the sink in "NewFrame"
+    // and "DisableTracing". If disabled, the cost is a branch per potential event
+    void EnableTracing(const TraceCallbacks& traceCallbacks);
+    void DisableTracing();
+
     // Helpers
     inline double GetTotalMemoryUsageInMb() const
     { return double(m_PermanentPoolSize + m_TransientPoolSize) / (1024.0 * 1024.0); }
@@ -122,29 +318,105 @@ public:
     inline double GetAliasableMemoryUsageInMb() const
     { return double(m_TransientPoolSize) / (1024.0 * 1024.0); }
 
+    inline DescriptorCacheStats GetDescriptorCacheStats() const
+    { return m_DescriptorCache.GetStats(); }
+
+    inline const IntegrationFrameStats& GetFrameStats() const
+    { return m_FrameStats; }
+
+    // External transient pool: "memory" must be of "TransientPoolPlacement::memoryType", "offset" must be aligned to "alignment" and
+    // "offset + size" must fit into "memory". The memory must stay alive while in use by the GPU (including "bufferedFramesNum" frames
+    // after "Resize" or "Destroy")
+    inline const TransientPoolPlacement& GetTransientPoolPlacement() const
+    { return m_TransientPoolPlacement; }
+
+    bool BindTransientPool(nri::Memory& memory, uint64_t offset);
+
+    // Per-texture breakdown of "GetTotalMemoryUsageInMb"
+    void GetMemoryReport(std::vector<IntegrationResourceMemory>& report) const;
+
 private:
     Integration(const Integration&) = delete;
 
+    struct TextureMemory // textures created together share memory allocations
+    {
+        std::vector<nri::Memory*> allocations;
+        uint32_t textureNum; // alive textures, allocations are freed if 0
+    };
+
+    struct RetiredResources
+    {
+        std::vector<nri::Descriptor*> descriptors;
+        std::vector<nri::Texture*> textures;
+        std::vector<nri::Memory*> memoryAllocations;
+    };
+
+    struct DescriptorSetCacheEntry // descriptor sets of a dispatch, reusable by identical dispatches within a frame
+    {
+        nri::DescriptorSet* descriptorSets[3];
+        uint64_t key;
+        uint32_t descriptorsOffset; // in "m_DescriptorSetCacheDescriptors"
+        uint32_t pipelineIndex;
+    };
+
+    enum class PipelineState : uint8_t
+    {
+        NOT_CREATED,
+        QUEUED,
+        CREATING,
+        READY,
+    };
+
+    void CreatePipeline(uint32_t pipelineIndex);
+    void RequestPipeline(uint32_t pipelineIndex);
+    void PipelineWorker();
+    void StopPipelineWorkers();
+    void DestroyPipelines();
+    void LoadPrewarmList();
+    void StorePrewarmList();
     void CreateResources(uint16_t resourceWidth, uint16_t resourceHeight);
+    void CreateInstanceResources();
+    void DestroyInstanceResources();
+    void CreateTextures(uint16_t resourceWidth, uint16_t resourceHeight);
+    void DestroyTexture(nri::Texture& texture, uint32_t textureMemoryIndex);
+    void DestroyRetiredResources(RetiredResources& retiredResources);
     void AllocateAndBindMemory();
+    void CopyTexture(nri::CommandBuffer& commandBuffer, nri::TextureBarrierDesc& dst, nri::TextureBarrierDesc& src);
+    void AccumulateDispatchStats(const DispatchDesc* dispatchDescs, uint32_t dispatchDescsNum);
     void Dispatch(nri::CommandBuffer& commandBuffer, nri::DescriptorPool& descriptorPool, const DispatchDesc& dispatchDesc, UserPool& userPool);
 
 private:
     std::vector<nri::TextureBarrierDesc> m_TexturePool;
-    std::map<uint64_t, nri::Descriptor*> m_CachedDescriptors;
-    std::vector<std::vector<nri::Descriptor*>> m_DescriptorsInFlight;
+    std::vector<nri::TextureBarrierDesc>* m_ResampleTexturePool = nullptr; // the pool before "Resize" (only while resampling)
+    std::vector<RetiredResources> m_RetiredResources; // per "bufferedFramesNum"
+    DescriptorCache m_DescriptorCache;
+    Tracer m_Tracer;
+    IntegrationFrameStats m_FrameStats = {};
+    TransientPoolPlacement m_TransientPoolPlacement = {};
     std::vector<nri::PipelineLayout*> m_PipelineLayouts;
     std::vector<nri::Pipeline*> m_Pipelines;
+    std::vector<uint64_t> m_PipelineKeys; // 0 - not shared (reloaded shaders)
+    std::vector<PipelineState> m_PipelineStates; // guarded by "m_PipelineLock"
+    std::vector<std::thread> m_PipelineWorkers;
+    std::deque<uint32_t> m_PipelineQueue;
+    std::mutex m_PipelineLock;
+    std::condition_variable m_PipelineCondition;
     std::vector<nri::Memory*> m_MemoryAllocations;
+    std::vector<TextureMemory> m_TextureMemories;
+    std::vector<uint32_t> m_TextureMemoryIndices; // per "m_TexturePool" entry, "uint32_t(-1)" - the external transient pool
+    std::vector<uint64_t> m_TransientPoolOffsets; // external transient pool only
+    std::string m_PrewarmListPath;
+    PrewarmListCallbacks m_PrewarmListCallbacks = {};
     std::vector<nri::Descriptor*> m_Samplers;
     std::vector<nri::DescriptorPool*> m_DescriptorPools = {};
     std::vector<nri::DescriptorSet*> m_DescriptorSetSamplers = {};
+    std::vector<DescriptorSetCacheEntry> m_DescriptorSetCache; // current frame only
+    std::vector<nri::Descriptor*> m_DescriptorSetCacheDescriptors;
     const nri::CoreInterface* m_NRI = nullptr;
     const nri::HelperInterface* m_NRIHelper = nullptr;
     nri::Device* m_Device = nullptr;
     nri::Buffer* m_ConstantBuffer = nullptr;
     nri::Descriptor* m_ConstantBufferView = nullptr;
-    FILE* m_Log = nullptr;
     Instance* m_Instance = nullptr;
     uint64_t m_PermanentPoolSize = 0;
     uint64_t m_TransientPoolSize = 0;
@@ -152,14 +424,21 @@ private:
     uint32_t m_ConstantBufferViewSize = 0;
     uint32_t m_ConstantBufferOffset = 0;
     uint32_t m_ConstantBufferOffsetPrev = 0;
+    uint32_t m_DescriptorCacheCapacity = 0;
     uint32_t m_DescriptorPoolIndex = 0;
     uint32_t m_FrameIndex = uint32_t(-1); // 0 needed after 1st "NewFrame"
     uint32_t m_PrevFrameIndexFromSettings = 0;
     uint16_t m_Width = 0;
     uint16_t m_Height = 0;
     uint8_t m_BufferedFramesNum = 0;
+    uint8_t m_PipelineCompilationThreadsNum = 0;
     char m_Name[32] = {};
     bool m_ReloadShaders = false;
+    bool m_IsResized = false;
+    bool m_EnableExternalTransientPool = false;
+    bool m_IsTransientPoolBound = false;
+    bool m_EnableLazyPipelineCreation = false;
+    bool m_StopPipelineWorkers = false;
     bool m_EnableDescriptorCaching = false;
     bool m_DemoteFloat32to16 = false;
     bool m_PromoteFloat16to32 = false;
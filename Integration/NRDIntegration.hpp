@@ -17,7 +17,7 @@ license agreement from NVIDIA CORPORATION is strictly prohibited.
     #include <alloca.h>
 #endif
 
-static_assert(NRD_VERSION_MAJOR >= 4 && NRD_VERSION_MINOR >= 11, "Unsupported NRD version!");
+static_assert(NRD_VERSION_MAJOR >= 4 && NRD_VERSION_MINOR >= 15, "Unsupported NRD version!");
 static_assert(NRI_VERSION_MAJOR >= 1 && NRI_VERSION_MINOR >= 161, "Unsupported NRI version!");
 
 namespace nrd
@@ -77,10 +77,13 @@ static inline uint16_t DivideUp(uint32_t x, uint16_t y)
 static inline nri::Format GetNriFormat(Format format)
 { return g_NrdFormatToNri[(uint32_t)format]; }
 
-static inline uint64_t CreateDescriptorKey(uint64_t texture, bool isStorage)
+static inline uint64_t CreateDescriptorKey(uint64_t texture, bool isStorage, uint32_t layer)
 {
+    NRD_INTEGRATION_ASSERT(layer < 128, "Only 128 texture array layers are addressable by descriptor keys");
+
     uint64_t key = uint64_t(isStorage ? 1 : 0) << 63ull;
-    key |= texture & ((1ull << 63ull) - 1);
+    key |= uint64_t(layer) << 56ull;
+    key |= texture & ((1ull << 56ull) - 1);
 
     return key;
 }
@@ -90,6 +93,129 @@ template<typename T, typename A> constexpr T GetAlignedSize(const T& size, A ali
     return T(((size + alignment - 1) / alignment) * alignment);
 }
 
+bool PipelineRegistry::Acquire(uint64_t key, Entry& entry)
+{
+    std::lock_guard<std::mutex> lock(s_Lock);
+
+    auto it = s_Entries.find(key);
+    if (it == s_Entries.end())
+        return false;
+
+    it->second.refCount++;
+    entry = it->second;
+
+    return true;
+}
+
+void PipelineRegistry::Register(uint64_t key, Entry& entry)
+{
+    std::lock_guard<std::mutex> lock(s_Lock);
+
+    // Another thread can win the race, the caller must destroy own objects and use the returned ones
+    auto result = s_Entries.insert({key, entry});
+    if (!result.second)
+        result.first->second.refCount++;
+
+    entry = result.first->second;
+}
+
+void PipelineRegistry::Release(uint64_t key, const nri::CoreInterface& nriCore)
+{
+    std::lock_guard<std::mutex> lock(s_Lock);
+
+    auto it = s_Entries.find(key);
+    NRD_INTEGRATION_ASSERT(it != s_Entries.end(), "Unknown pipeline!");
+
+    if (--it->second.refCount == 0)
+    {
+        nriCore.DestroyPipeline(*it->second.pipeline);
+        nriCore.DestroyPipelineLayout(*it->second.pipelineLayout);
+
+        s_Entries.erase(it);
+    }
+}
+
+void Tracer::Enable(const TraceCallbacks& callbacks, const char* processName)
+{
+    if (IsEnabled())
+        Disable();
+
+    m_Callbacks = callbacks;
+    m_Origin = std::chrono::steady_clock::now();
+
+    m_Buffer = "[\n";
+    m_Buffer += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":";
+    AppendString(processName);
+    m_Buffer += "}},\n";
+}
+
+void Tracer::Disable()
+{
+    Flush();
+
+    m_Callbacks = {};
+    m_Buffer.clear();
+    m_Buffer.shrink_to_fit();
+}
+
+void Tracer::Flush()
+{
+    if (!IsEnabled() || m_Buffer.empty())
+        return;
+
+    m_Callbacks.Write(m_Callbacks.userArg, m_Buffer.data(), m_Buffer.size());
+    m_Buffer.clear(); // keeps capacity
+}
+
+void Tracer::Span(const char* name, const char* category, uint64_t beginTimestamp, const char* args)
+{ AppendEvent(name, category, 'X', beginTimestamp, GetTimestamp() - beginTimestamp, args); }
+
+void Tracer::Instant(const char* name, const char* category, const char* args)
+{ AppendEvent(name, category, 'i', GetTimestamp(), 0, args); }
+
+void Tracer::AppendEvent(const char* name, const char* category, char phase, uint64_t timestamp, uint64_t duration, const char* args)
+{
+    if (!IsEnabled())
+        return;
+
+    m_Buffer += "{\"name\":";
+    AppendString(name);
+    m_Buffer += ",\"cat\":";
+    AppendString(category);
+
+    char buf[128];
+    if (phase == 'X')
+        snprintf(buf, sizeof(buf), ",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,\"pid\":0,\"tid\":0", (unsigned long long)timestamp, (unsigned long long)duration);
+    else
+        snprintf(buf, sizeof(buf), ",\"ph\":\"%c\",\"s\":\"t\",\"ts\":%llu,\"pid\":0,\"tid\":0", phase, (unsigned long long)timestamp);
+    m_Buffer += buf;
+
+    if (args)
+    {
+        m_Buffer += ",\"args\":{";
+        m_Buffer += args;
+        m_Buffer += "}";
+    }
+
+    m_Buffer += "},\n";
+}
+
+void Tracer::AppendString(const char* s)
+{
+    m_Buffer += '"';
+    for (; *s; s++)
+    {
+        if (*s == '"' || *s == '\\')
+        {
+            m_Buffer += '\\';
+            m_Buffer += *s;
+        }
+        else if ((uint8_t)*s >= 0x20)
+            m_Buffer += *s;
+    }
+    m_Buffer += '"';
+}
+
 bool Integration::Initialize(const IntegrationCreationDesc& integrationDesc, const InstanceCreationDesc& instanceDesc, nri::Device& nriDevice, const nri::CoreInterface& nriCore, const nri::HelperInterface& nriHelper)
 {
     NRD_INTEGRATION_ASSERT(!m_Instance, "Already initialized! Did you forget to call 'Destroy'?");
@@ -116,41 +242,287 @@ bool Integration::Initialize(const IntegrationCreationDesc& integrationDesc, con
 
     m_BufferedFramesNum = integrationDesc.bufferedFramesNum;
     m_EnableDescriptorCaching = integrationDesc.enableDescriptorCaching;
+    m_DescriptorCacheCapacity = integrationDesc.descriptorCacheCapacity;
+    m_EnableExternalTransientPool = integrationDesc.enableExternalTransientPool;
+    m_EnableLazyPipelineCreation = integrationDesc.enableLazyPipelineCreation;
+    m_PipelineCompilationThreadsNum = integrationDesc.enableLazyPipelineCreation ? integrationDesc.pipelineCompilationThreadsNum : 0;
     m_PromoteFloat16to32 = integrationDesc.promoteFloat16to32;
     m_DemoteFloat32to16 = integrationDesc.demoteFloat32to16;
     m_Device = &nriDevice;
     m_NRI = &nriCore;
     m_NRIHelper = &nriHelper;
+    m_PrewarmListPath = integrationDesc.prewarmListPath ? integrationDesc.prewarmListPath : "";
+    m_PrewarmListCallbacks = integrationDesc.prewarmListCallbacks;
 
     strncpy(m_Name, integrationDesc.name, sizeof(m_Name));
 
-#if( NRD_INTEGRATION_DEBUG_LOGGING == 1 )
-    char filename[128];
-    snprintf(filename, sizeof(filename), "NRD-%s.log", m_Name);
-    m_Log = fopen(filename, "w");
-    if (m_Log)
-        fprintf(m_Log, "Resource size = %u x %u\n", integrationDesc.resourceWidth, integrationDesc.resourceHeight);
-#endif
+    TraceScope traceScope(m_Tracer, "Initialize", "nrd");
+    if (traceScope.IsEnabled())
+        traceScope.SetArgs("\"resourceWidth\":%u,\"resourceHeight\":%u", integrationDesc.resourceWidth, integrationDesc.resourceHeight);
 
     CreatePipelines();
+    LoadPrewarmList();
     CreateResources(integrationDesc.resourceWidth, integrationDesc.resourceHeight);
 
     return true;
 }
 
-void Integration::CreatePipelines()
+void Integration::LoadPrewarmList()
+{
+    if (!m_EnableLazyPipelineCreation) // all pipelines are already created
+        return;
+
+    std::vector<uint8_t> data;
+    if (!PrewarmList::Load(m_PrewarmListPath.c_str(), m_PrewarmListCallbacks, data))
+        return;
+
+    std::vector<uint64_t> shaderHashes;
+    uint64_t key = PrewarmList::GetKey(GetLibraryDesc(), m_NRI->GetDeviceDesc(*m_Device));
+    if (!PrewarmList::Deserialize(key, data.data(), data.size(), shaderHashes))
+        return;
+
+    // Prewarm pipelines used in previous runs
+    const InstanceDesc& instanceDesc = GetInstanceDesc(*m_Instance);
+
+    std::vector<const char*> shaderFileNames;
+    for (uint32_t i = 0; i < instanceDesc.pipelinesNum; i++)
+    {
+        const PipelineDesc& pipelineDesc = instanceDesc.pipelines[i];
+        if (std::find(shaderHashes.begin(), shaderHashes.end(), PrewarmList::GetShaderHash(pipelineDesc)) != shaderHashes.end())
+            shaderFileNames.push_back(pipelineDesc.shaderFileName);
+    }
+
+    if (!shaderFileNames.empty())
+        PrewarmPipelines(shaderFileNames.data(), (uint32_t)shaderFileNames.size());
+}
+
+void Integration::StorePrewarmList()
+{
+    if (!m_EnableLazyPipelineCreation || (m_PrewarmListPath.empty() && !m_PrewarmListCallbacks.Store))
+        return;
+
+    // Merge with the existing list, since different runs can use different denoisers
+    std::vector<uint64_t> shaderHashes;
+    uint64_t key = PrewarmList::GetKey(GetLibraryDesc(), m_NRI->GetDeviceDesc(*m_Device));
+
+    std::vector<uint8_t> data;
+    if (PrewarmList::Load(m_PrewarmListPath.c_str(), m_PrewarmListCallbacks, data))
+        PrewarmList::Deserialize(key, data.data(), data.size(), shaderHashes);
+
+    const InstanceDesc& instanceDesc = GetInstanceDesc(*m_Instance);
+    for (uint32_t i = 0; i < instanceDesc.pipelinesNum; i++)
+    {
+        uint64_t shaderHash = PrewarmList::GetShaderHash(instanceDesc.pipelines[i]);
+        if (m_PipelineStates[i] == PipelineState::READY && std::find(shaderHashes.begin(), shaderHashes.end(), shaderHash) == shaderHashes.end())
+            shaderHashes.push_back(shaderHash);
+    }
+
+    PrewarmList::Serialize(key, shaderHashes, data);
+    PrewarmList::Store(m_PrewarmListPath.c_str(), m_PrewarmListCallbacks, data);
+}
+
+void Integration::DestroyPipelines()
 {
     // Assuming that the device is in IDLE state
-    for (nri::Pipeline* pipeline : m_Pipelines)
-        m_NRI->DestroyPipeline(*pipeline);
+    for (size_t i = 0; i < m_Pipelines.size(); i++)
+    {
+        if (!m_Pipelines[i]) // not requested (lazy creation)
+            continue;
+
+        if (m_PipelineKeys[i])
+            PipelineRegistry::Release(m_PipelineKeys[i], *m_NRI);
+        else
+        {
+            m_NRI->DestroyPipeline(*m_Pipelines[i]);
+            m_NRI->DestroyPipelineLayout(*m_PipelineLayouts[i]);
+        }
+    }
+
     m_Pipelines.clear();
+    m_PipelineLayouts.clear();
+    m_PipelineKeys.clear();
+    m_PipelineStates.clear();
+}
 
-#ifdef PROJECT_NAME
-     utils::ShaderCodeStorage shaderCodeStorage;
-#endif
+void Integration::CreatePipelines()
+{
+    // Pipelines re-created after initialization use shaders from disk (if available)
+    m_ReloadShaders = !m_Pipelines.empty();
+
+    StopPipelineWorkers();
+    DestroyPipelines();
+
+    const InstanceDesc& instanceDesc = GetInstanceDesc(*m_Instance);
+    m_Pipelines.resize(instanceDesc.pipelinesNum, nullptr);
+    m_PipelineLayouts.resize(instanceDesc.pipelinesNum, nullptr);
+    m_PipelineKeys.resize(instanceDesc.pipelinesNum, 0);
+    m_PipelineStates.resize(instanceDesc.pipelinesNum, PipelineState::NOT_CREATED);
+
+    if (!m_EnableLazyPipelineCreation)
+    {
+        for (uint32_t i = 0; i < instanceDesc.pipelinesNum; i++)
+            CreatePipeline(i);
+
+        std::fill(m_PipelineStates.begin(), m_PipelineStates.end(), PipelineState::READY);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < m_PipelineCompilationThreadsNum; i++)
+            m_PipelineWorkers.push_back(std::thread(&Integration::PipelineWorker, this));
+    }
+}
+
+void Integration::PrewarmPipelines(const char* const* shaderFileNames, uint32_t shaderFileNamesNum)
+{
+    const InstanceDesc& instanceDesc = GetInstanceDesc(*m_Instance);
+
+    for (uint32_t i = 0; i < instanceDesc.pipelinesNum; i++)
+    {
+        // Filter
+        if (shaderFileNames)
+        {
+            uint32_t j = 0;
+            for (; j < shaderFileNamesNum; j++)
+            {
+                if (!strcmp(shaderFileNames[j], instanceDesc.pipelines[i].shaderFileName))
+                    break;
+            }
+
+            if (j == shaderFileNamesNum)
+                continue;
+        }
+
+        // Queue for background creation or create in place
+        if (!m_PipelineWorkers.empty())
+        {
+            std::lock_guard<std::mutex> lock(m_PipelineLock);
+
+            if (m_PipelineStates[i] == PipelineState::NOT_CREATED)
+            {
+                m_PipelineStates[i] = PipelineState::QUEUED;
+                m_PipelineQueue.push_back(i);
+                m_PipelineCondition.notify_one();
+            }
+        }
+        else
+            RequestPipeline(i);
+    }
+}
+
+void Integration::RequestPipeline(uint32_t pipelineIndex)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_PipelineLock);
+
+        PipelineState& state = m_PipelineStates[pipelineIndex];
+        if (state == PipelineState::READY)
+            return;
 
+        // Being created by a worker - wait
+        if (state == PipelineState::CREATING)
+        {
+            m_PipelineCondition.wait(lock, [&] { return state == PipelineState::READY; });
+            return;
+        }
+
+        // Not created or still in the queue - create right now (a worker will skip it)
+        state = PipelineState::CREATING;
+    }
+
+    CreatePipeline(pipelineIndex);
+
+    {
+        std::lock_guard<std::mutex> lock(m_PipelineLock);
+        m_PipelineStates[pipelineIndex] = PipelineState::READY;
+    }
+
+    m_PipelineCondition.notify_all();
+}
+
+void Integration::PipelineWorker()
+{
+    while (true)
+    {
+        uint32_t pipelineIndex = 0;
+        {
+            std::unique_lock<std::mutex> lock(m_PipelineLock);
+            m_PipelineCondition.wait(lock, [&] { return m_StopPipelineWorkers || !m_PipelineQueue.empty(); });
+
+            if (m_StopPipelineWorkers)
+                return;
+
+            pipelineIndex = m_PipelineQueue.front();
+            m_PipelineQueue.pop_front();
+
+            // Skip if already picked up by "RequestPipeline"
+            if (m_PipelineStates[pipelineIndex] != PipelineState::QUEUED)
+                continue;
+
+            m_PipelineStates[pipelineIndex] = PipelineState::CREATING;
+        }
+
+        CreatePipeline(pipelineIndex);
+
+        {
+            std::lock_guard<std::mutex> lock(m_PipelineLock);
+            m_PipelineStates[pipelineIndex] = PipelineState::READY;
+        }
+
+        m_PipelineCondition.notify_all();
+    }
+}
+
+void Integration::StopPipelineWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_PipelineLock);
+        m_StopPipelineWorkers = true;
+    }
+
+    m_PipelineCondition.notify_all();
+
+    for (std::thread& worker : m_PipelineWorkers)
+        worker.join();
+
+    m_PipelineWorkers.clear();
+    m_PipelineQueue.clear();
+    m_StopPipelineWorkers = false;
+}
+
+void Integration::CreatePipeline(uint32_t i)
+{
     const InstanceDesc& instanceDesc = GetInstanceDesc(*m_Instance);
     const nri::DeviceDesc& deviceDesc = m_NRI->GetDeviceDesc(*m_Device);
+    const PipelineDesc& nrdPipelineDesc = instanceDesc.pipelines[i];
+    const ComputeShaderDesc& nrdComputeShader = (&nrdPipelineDesc.computeShaderDXBC)[std::max((int32_t)deviceDesc.graphicsAPI - 1, 0)];
+
+    // Try to reuse a pipeline created by another instance (reloaded shaders are never shared)
+    bool isShared = true;
+#ifdef PROJECT_NAME
+    isShared = nrdComputeShader.bytecode && !m_ReloadShaders;
+#endif
+
+    uint64_t key = 0;
+    if (isShared)
+    {
+        key = HashBytes(14695981039346656037ull, &m_Device, sizeof(m_Device));
+        key = HashBytes(key, nrdPipelineDesc.shaderFileName, strlen(nrdPipelineDesc.shaderFileName));
+        key = HashBytes(key, &nrdPipelineDesc.hasConstantData, sizeof(nrdPipelineDesc.hasConstantData));
+        key = HashBytes(key, &nrdPipelineDesc.rootConstantDataSize, sizeof(nrdPipelineDesc.rootConstantDataSize));
+        key = HashBytes(key, nrdPipelineDesc.resourceRanges, nrdPipelineDesc.resourceRangesNum * sizeof(ResourceRangeDesc));
+        if (key == 0) // reserved
+            key = 1;
+
+        PipelineRegistry::Entry entry = {};
+        if (PipelineRegistry::Acquire(key, entry))
+        {
+            m_PipelineLayouts[i] = entry.pipelineLayout;
+            m_Pipelines[i] = entry.pipeline;
+            m_PipelineKeys[i] = key;
+
+            return;
+        }
+    }
 
     uint32_t constantBufferOffset = 0;
     uint32_t samplerOffset = 0;
@@ -183,13 +555,7 @@ void Integration::CreatePipelines()
     descriptorSetResources.registerSpace = instanceDesc.resourcesSpaceIndex;
 
     // Allocate memory for descriptor ranges
-    uint32_t resourceRangesNum = 0;
-    for (uint32_t i = 0; i < instanceDesc.pipelinesNum; i++)
-    {
-        const PipelineDesc& nrdPipelineDesc = instanceDesc.pipelines[i];
-        resourceRangesNum = std::max(resourceRangesNum, nrdPipelineDesc.resourceRangesNum);
-    }
-    resourceRangesNum += 1; // samplers
+    uint32_t resourceRangesNum = nrdPipelineDesc.resourceRangesNum + 1; // + samplers
 
     nri::DescriptorRangeDesc* descriptorRanges = (nri::DescriptorRangeDesc*)alloca(sizeof(nri::DescriptorRangeDesc) * resourceRangesNum);
     memset(descriptorRanges, 0, sizeof(nri::DescriptorRangeDesc) * resourceRangesNum);
@@ -207,146 +573,176 @@ void Integration::CreatePipelines()
     samplersRange->descriptorNum = instanceDesc.samplersNum;
     samplersRange->shaderStages =  nri::StageBits::COMPUTE_SHADER;
 
-    // Pipelines
-    for (uint32_t i = 0; i < instanceDesc.pipelinesNum; i++)
+    // Resources
+    for (uint32_t j = 0; j < nrdPipelineDesc.resourceRangesNum; j++)
     {
-        const PipelineDesc& nrdPipelineDesc = instanceDesc.pipelines[i];
-        const ComputeShaderDesc& nrdComputeShader = (&nrdPipelineDesc.computeShaderDXBC)[std::max((int32_t)deviceDesc.graphicsAPI - 1, 0)];
-
-        // Resources
-        for (uint32_t j = 0; j < nrdPipelineDesc.resourceRangesNum; j++)
-        {
-            const ResourceRangeDesc& nrdResourceRange = nrdPipelineDesc.resourceRanges[j];
-
-            if (nrdResourceRange.descriptorType == DescriptorType::TEXTURE)
-            {
-                resourcesRanges[j].baseRegisterIndex = textureOffset + nrdResourceRange.baseRegisterIndex;
-                resourcesRanges[j].descriptorType = nri::DescriptorType::TEXTURE;
-            }
-            else
-            {
-                resourcesRanges[j].baseRegisterIndex = storageTextureAndBufferOffset + nrdResourceRange.baseRegisterIndex;
-                resourcesRanges[j].descriptorType = nri::DescriptorType::STORAGE_TEXTURE;
-            }
-
-            resourcesRanges[j].descriptorNum = nrdResourceRange.descriptorsNum;
-            resourcesRanges[j].shaderStages = nri::StageBits::COMPUTE_SHADER;
-        }
+        const ResourceRangeDesc& nrdResourceRange = nrdPipelineDesc.resourceRanges[j];
 
-        // Descriptor sets
-        if (instanceDesc.resourcesSpaceIndex != instanceDesc.samplersSpaceIndex)
+        if (nrdResourceRange.descriptorType == DescriptorType::TEXTURE)
         {
-            descriptorSetSamplers.rangeNum = 1;
-            descriptorSetSamplers.ranges = samplersRange;
-
-            descriptorSetResources.ranges = resourcesRanges;
-            descriptorSetResources.rangeNum = nrdPipelineDesc.resourceRangesNum;
+            resourcesRanges[j].baseRegisterIndex = textureOffset + nrdResourceRange.baseRegisterIndex;
+            resourcesRanges[j].descriptorType = nri::DescriptorType::TEXTURE;
         }
         else
         {
-            descriptorSetResources.ranges = descriptorRanges;
-            descriptorSetResources.rangeNum = nrdPipelineDesc.resourceRangesNum + 1;
+            resourcesRanges[j].baseRegisterIndex = storageTextureAndBufferOffset + nrdResourceRange.baseRegisterIndex;
+            resourcesRanges[j].descriptorType = nri::DescriptorType::STORAGE_TEXTURE;
         }
 
-        descriptorSetConstantBuffer.dynamicConstantBufferNum = nrdPipelineDesc.hasConstantData ? 1 : 0;
+        resourcesRanges[j].descriptorNum = nrdResourceRange.descriptorsNum;
+        resourcesRanges[j].shaderStages = nri::StageBits::COMPUTE_SHADER;
+    }
+
+    // Descriptor sets
+    if (instanceDesc.resourcesSpaceIndex != instanceDesc.samplersSpaceIndex)
+    {
+        descriptorSetSamplers.rangeNum = 1;
+        descriptorSetSamplers.ranges = samplersRange;
+
+        descriptorSetResources.ranges = resourcesRanges;
+        descriptorSetResources.rangeNum = nrdPipelineDesc.resourceRangesNum;
+    }
+    else
+    {
+        descriptorSetResources.ranges = descriptorRanges;
+        descriptorSetResources.rangeNum = nrdPipelineDesc.resourceRangesNum + 1;
+    }
+
+    descriptorSetConstantBuffer.dynamicConstantBufferNum = nrdPipelineDesc.hasConstantData ? 1 : 0;
+
+    // Pipeline layout
+    nri::PipelineLayoutDesc pipelineLayoutDesc = {};
+    pipelineLayoutDesc.descriptorSetNum = descriptorSetNum;
+    pipelineLayoutDesc.descriptorSets = descriptorSetDescs;
+    pipelineLayoutDesc.ignoreGlobalSPIRVOffsets = true;
+    pipelineLayoutDesc.shaderStages = nri::StageBits::COMPUTE_SHADER;
+
+    // Root constants (push constants in VK)
+    const nri::RootConstantDesc rootConstantDesc = {constantBufferOffset + instanceDesc.rootConstantsRegisterIndex, nrdPipelineDesc.rootConstantDataSize, nri::StageBits::COMPUTE_SHADER};
+    if (nrdPipelineDesc.rootConstantDataSize)
+    {
+        pipelineLayoutDesc.rootConstants = &rootConstantDesc;
+        pipelineLayoutDesc.rootConstantNum = 1;
+        pipelineLayoutDesc.rootRegisterSpace = instanceDesc.constantBufferSpaceIndex;
+    }
+
+    nri::PipelineLayout* pipelineLayout = nullptr;
+    NRD_INTEGRATION_ABORT_ON_FAILURE(m_NRI->CreatePipelineLayout(*m_Device, pipelineLayoutDesc, pipelineLayout));
+
+    // Pipeline
+#ifdef PROJECT_NAME
+    utils::ShaderCodeStorage shaderCodeStorage;
+#endif
+
+    nri::ShaderDesc computeShader = {};
+#ifdef PROJECT_NAME
+    if (nrdComputeShader.bytecode && !m_ReloadShaders)
+    {
+#endif
+        computeShader.bytecode = nrdComputeShader.bytecode;
+        computeShader.size = nrdComputeShader.size;
+        computeShader.entryPointName = nrdPipelineDesc.shaderEntryPointName;
+        computeShader.stage = nri::StageBits::COMPUTE_SHADER;
+#ifdef PROJECT_NAME
+    }
+    else
+        computeShader = utils::LoadShader(deviceDesc.graphicsAPI, nrdPipelineDesc.shaderFileName, shaderCodeStorage, nrdPipelineDesc.shaderEntryPointName);
+#endif
+
+    nri::ComputePipelineDesc pipelineDesc = {};
+    pipelineDesc.pipelineLayout = pipelineLayout;
+    pipelineDesc.shader = computeShader;
 
-        // Pipeline layout
-        nri::PipelineLayoutDesc pipelineLayoutDesc = {};
-        pipelineLayoutDesc.descriptorSetNum = descriptorSetNum;
-        pipelineLayoutDesc.descriptorSets = descriptorSetDescs;
-        pipelineLayoutDesc.ignoreGlobalSPIRVOffsets = true;
-        pipelineLayoutDesc.shaderStages = nri::StageBits::COMPUTE_SHADER;
+    nri::Pipeline* pipeline = nullptr;
+    NRD_INTEGRATION_ABORT_ON_FAILURE(m_NRI->CreateComputePipeline(*m_Device, pipelineDesc, pipeline));
 
-        nri::PipelineLayout* pipelineLayout = nullptr;
-        NRD_INTEGRATION_ABORT_ON_FAILURE(m_NRI->CreatePipelineLayout(*m_Device, pipelineLayoutDesc, pipelineLayout));
-        m_PipelineLayouts.push_back(pipelineLayout);
+    if (isShared)
+    {
+        PipelineRegistry::Entry entry = {pipelineLayout, pipeline, 1};
+        PipelineRegistry::Register(key, entry);
 
-        // Pipeline
-        nri::ShaderDesc computeShader = {};
-    #ifdef PROJECT_NAME
-        if (nrdComputeShader.bytecode && !m_ReloadShaders)
+        if (entry.pipeline != pipeline)
         {
-    #endif
-            computeShader.bytecode = nrdComputeShader.bytecode;
-            computeShader.size = nrdComputeShader.size;
-            computeShader.entryPointName = nrdPipelineDesc.shaderEntryPointName;
-            computeShader.stage = nri::StageBits::COMPUTE_SHADER;
-    #ifdef PROJECT_NAME
+            m_NRI->DestroyPipeline(*pipeline);
+            m_NRI->DestroyPipelineLayout(*pipelineLayout);
         }
-        else
-            computeShader = utils::LoadShader(deviceDesc.graphicsAPI, nrdPipelineDesc.shaderFileName, shaderCodeStorage, nrdPipelineDesc.shaderEntryPointName);
-    #endif
-
-        nri::ComputePipelineDesc pipelineDesc = {};
-        pipelineDesc.pipelineLayout = pipelineLayout;
-        pipelineDesc.shader = computeShader;
 
-        nri::Pipeline* pipeline = nullptr;
-        NRD_INTEGRATION_ABORT_ON_FAILURE(m_NRI->CreateComputePipeline(*m_Device, pipelineDesc, pipeline));
-        m_Pipelines.push_back(pipeline);
+        pipelineLayout = entry.pipelineLayout;
+        pipeline = entry.pipeline;
     }
 
-    m_ReloadShaders = true;
+    m_PipelineLayouts[i] = pipelineLayout;
+    m_Pipelines[i] = pipeline;
+    m_PipelineKeys[i] = key;
 }
 
-void Integration::CreateResources(uint16_t resourceWidth, uint16_t resourceHeight)
+void Integration::CreateTextures(uint16_t resourceWidth, uint16_t resourceHeight)
 {
+    TraceScope traceScope(m_Tracer, "CreateTextures", "nrd");
+
     const InstanceDesc& instanceDesc = GetInstanceDesc(*m_Instance);
     const uint32_t poolSize = instanceDesc.permanentPoolSize + instanceDesc.transientPoolSize;
 
-    m_TexturePool.resize(poolSize); // No reallocation!
+    m_TexturePool.resize(poolSize); // No reallocation! Already set textures are kept (see "Reconfigure")
+    m_TextureMemoryIndices.resize(poolSize, uint32_t(-1));
+    m_PermanentPoolSize = 0;
+    m_TransientPoolSize = 0;
+
+    std::vector<nri::MemoryDesc> transientMemoryDescs;
+    std::vector<uint32_t> newTextures;
 
-    // Texture pool
     for (uint32_t i = 0; i < poolSize; i++)
     {
-        // Create NRI texture
         const TextureDesc& nrdTextureDesc = (i < instanceDesc.permanentPoolSize) ? instanceDesc.permanentPool[i] : instanceDesc.transientPool[i - instanceDesc.permanentPoolSize];
 
-        nri::Format format = GetNriFormat(nrdTextureDesc.format);
-        if (m_PromoteFloat16to32)
-        {
-            if (format == nri::Format::R16_SFLOAT)
-                format = nri::Format::R32_SFLOAT;
-            else if (format == nri::Format::RG16_SFLOAT)
-                format = nri::Format::RG32_SFLOAT;
-            else if (format == nri::Format::RGBA16_SFLOAT)
-                format = nri::Format::RGBA32_SFLOAT;
-        }
-        else if (m_DemoteFloat32to16)
+        // Create NRI texture
+        nri::Texture* texture = m_TexturePool[i].texture;
+        if (!texture)
         {
-            if (format == nri::Format::R32_SFLOAT)
-                format = nri::Format::R16_SFLOAT;
-            else if (format == nri::Format::RG32_SFLOAT)
-                format = nri::Format::RG16_SFLOAT;
-            else if (format == nri::Format::RGBA32_SFLOAT)
-                format = nri::Format::RGBA16_SFLOAT;
-        }
+            nri::Format format = GetNriFormat(nrdTextureDesc.format);
+            if (m_PromoteFloat16to32)
+            {
+                if (format == nri::Format::R16_SFLOAT)
+                    format = nri::Format::R32_SFLOAT;
+                else if (format == nri::Format::RG16_SFLOAT)
+                    format = nri::Format::RG32_SFLOAT;
+                else if (format == nri::Format::RGBA16_SFLOAT)
+                    format = nri::Format::RGBA32_SFLOAT;
+            }
+            else if (m_DemoteFloat32to16)
+            {
+                if (format == nri::Format::R32_SFLOAT)
+                    format = nri::Format::R16_SFLOAT;
+                else if (format == nri::Format::RG32_SFLOAT)
+                    format = nri::Format::RG16_SFLOAT;
+                else if (format == nri::Format::RGBA32_SFLOAT)
+                    format = nri::Format::RGBA16_SFLOAT;
+            }
 
-        uint16_t w = DivideUp(resourceWidth, nrdTextureDesc.downsampleFactor);
-        uint16_t h = DivideUp(resourceHeight, nrdTextureDesc.downsampleFactor);
+            uint16_t w = DivideUp(resourceWidth, nrdTextureDesc.downsampleFactor);
+            uint16_t h = DivideUp(resourceHeight, nrdTextureDesc.downsampleFactor);
 
-        nri::TextureDesc textureDesc = {};
-        textureDesc.type = nri::TextureType::TEXTURE_2D;
-        textureDesc.usage = nri::TextureUsageBits::SHADER_RESOURCE | nri::TextureUsageBits::SHADER_RESOURCE_STORAGE;
-        textureDesc.format = format;
-        textureDesc.width = w;
-        textureDesc.height = h;
-        textureDesc.mipNum = 1;
+            nri::TextureDesc textureDesc = {};
+            textureDesc.type = nri::TextureType::TEXTURE_2D;
+            textureDesc.usage = nri::TextureUsageBits::SHADER_RESOURCE | nri::TextureUsageBits::SHADER_RESOURCE_STORAGE;
+            textureDesc.format = format;
+            textureDesc.width = w;
+            textureDesc.height = h;
+            textureDesc.mipNum = 1;
 
-        nri::Texture* texture = nullptr;
-        NRD_INTEGRATION_ABORT_ON_FAILURE(m_NRI->CreateTexture(*m_Device, textureDesc, texture));
+            NRD_INTEGRATION_ABORT_ON_FAILURE(m_NRI->CreateTexture(*m_Device, textureDesc, texture));
+
+            m_TexturePool[i] = nri::TextureBarrierFromUnknown(texture, {nri::AccessBits::UNKNOWN, nri::Layout::UNKNOWN}, 0, 1);
+            newTextures.push_back(i);
+        }
 
         char name[128];
         if (i < instanceDesc.permanentPoolSize)
-            snprintf(name, sizeof(name), "%s::P(%u)", m_Name, i);
+            snprintf(name, sizeof(name), "%s::P(%u) %s", m_Name, i, nrdTextureDesc.name ? nrdTextureDesc.name : "");
         else
-            snprintf(name, sizeof(name), "%s::T(%u)", m_Name, i - instanceDesc.permanentPoolSize);
+            snprintf(name, sizeof(name), "%s::T(%u) %s", m_Name, i - instanceDesc.permanentPoolSize, nrdTextureDesc.name ? nrdTextureDesc.name : "");
         m_NRI->SetDebugName(texture, name);
 
-        // Construct NRD texture
-        nri::TextureBarrierDesc& nrdTexture = m_TexturePool[i];
-        nrdTexture = nri::TextureBarrierFromUnknown(texture, {nri::AccessBits::UNKNOWN, nri::Layout::UNKNOWN}, 0, 1);
-
         // Adjust memory usage
         nri::MemoryDesc memoryDesc = {};
         m_NRI->GetTextureMemoryDesc(*texture, nri::MemoryLocation::DEVICE, memoryDesc);
@@ -354,36 +750,115 @@ void Integration::CreateResources(uint16_t resourceWidth, uint16_t resourceHeigh
         if (i < instanceDesc.permanentPoolSize)
             m_PermanentPoolSize += memoryDesc.size;
         else
+        {
             m_TransientPoolSize += memoryDesc.size;
+            transientMemoryDescs.push_back(memoryDesc);
+        }
 
-    #if( NRD_INTEGRATION_DEBUG_LOGGING == 1 )
-        if (m_Log)
-            fprintf(m_Log, "%s\n\tformat=%u downsampleFactor=%u\n", name, nrdTextureDesc.format, nrdTextureDesc.downsampleFactor);
-    #endif
+        if (m_Tracer.IsEnabled())
+        {
+            char args[128];
+            snprintf(args, sizeof(args), "\"format\":%u,\"downsampleFactor\":%u,\"size\":%llu", (uint32_t)nrdTextureDesc.format, nrdTextureDesc.downsampleFactor, (unsigned long long)memoryDesc.size);
+            m_Tracer.Instant(name, "texture", args);
+        }
     }
 
-#if( NRD_INTEGRATION_DEBUG_LOGGING == 1 )
-    if (m_Log)
-        fprintf(m_Log, "%.1f Mb (permanent), %.1f Mb (transient)\n\n", double(m_PermanentPoolSize) / (1024.0f * 1024.0f), double(m_TransientPoolSize) / (1024.0f * 1024.0f));
-#endif
+    if (traceScope.IsEnabled())
+        traceScope.SetArgs("\"permanentMb\":%.1f,\"transientMb\":%.1f", GetPersistentMemoryUsageInMb(), GetAliasableMemoryUsageInMb());
 
-    // Samplers
-    for (uint32_t i = 0; i < instanceDesc.samplersNum; i++)
-    {
-        Sampler nrdSampler = instanceDesc.samplers[i];
+    // External transient pool (bound by the application later), if textures can share memory
+    bool isTransientPoolExternal = false;
+    m_TransientPoolPlacement = {};
+    m_IsTransientPoolBound = false;
 
-        nri::SamplerDesc samplerDesc = {};
-        samplerDesc.addressModes = {nri::AddressMode::CLAMP_TO_EDGE, nri::AddressMode::CLAMP_TO_EDGE};
-        samplerDesc.filters.min = nrdSampler == Sampler::NEAREST_CLAMP ? nri::Filter::NEAREST : nri::Filter::LINEAR;
-        samplerDesc.filters.mag = nrdSampler == Sampler::NEAREST_CLAMP ? nri::Filter::NEAREST : nri::Filter::LINEAR;
+    if (m_EnableExternalTransientPool)
+    {
+        m_TransientPoolOffsets.resize(transientMemoryDescs.size());
+        isTransientPoolExternal = CalculateTransientPoolPlacement(transientMemoryDescs.data(), (uint32_t)transientMemoryDescs.size(), m_TransientPoolOffsets.data(), m_TransientPoolPlacement);
+    }
 
-        nri::Descriptor* descriptor = nullptr;
-        NRD_INTEGRATION_ABORT_ON_FAILURE(m_NRI->CreateSampler(*m_Device, samplerDesc, descriptor));
-        m_Samplers.push_back(descriptor);
+    // Memory (only for new textures)
+    std::vector<nri::Texture*> textures;
+    for (uint32_t i : newTextures)
+    {
+        if (i < instanceDesc.permanentPoolSize || !isTransientPoolExternal)
+            textures.push_back(m_TexturePool[i].texture);
     }
 
-    // Constant buffer
-    const nri::DeviceDesc& deviceDesc = m_NRI->GetDeviceDesc(*m_Device);
+    if (!textures.empty())
+    {
+        uint32_t textureMemoryIndex = 0;
+        while (textureMemoryIndex < m_TextureMemories.size() && m_TextureMemories[textureMemoryIndex].textureNum)
+            textureMemoryIndex++;
+
+        if (textureMemoryIndex == m_TextureMemories.size())
+            m_TextureMemories.push_back({});
+
+        nri::ResourceGroupDesc resourceGroupDesc = {};
+        resourceGroupDesc.memoryLocation = nri::MemoryLocation::DEVICE;
+        resourceGroupDesc.textureNum = (uint32_t)textures.size();
+        resourceGroupDesc.textures = textures.data();
+
+        TextureMemory& textureMemory = m_TextureMemories[textureMemoryIndex];
+        textureMemory.allocations.resize(m_NRIHelper->CalculateAllocationNumber(*m_Device, resourceGroupDesc), nullptr);
+        textureMemory.textureNum = (uint32_t)textures.size();
+        NRD_INTEGRATION_ABORT_ON_FAILURE(m_NRIHelper->AllocateAndBindMemory(*m_Device, resourceGroupDesc, textureMemory.allocations.data()));
+
+        for (uint32_t i : newTextures)
+        {
+            if (i < instanceDesc.permanentPoolSize || !isTransientPoolExternal)
+                m_TextureMemoryIndices[i] = textureMemoryIndex;
+        }
+    }
+
+    m_Width = resourceWidth;
+    m_Height = resourceHeight;
+}
+
+void Integration::DestroyTexture(nri::Texture& texture, uint32_t textureMemoryIndex)
+{
+    m_NRI->DestroyTexture(texture);
+
+    if (textureMemoryIndex == uint32_t(-1))
+        return;
+
+    // Free memory with the last texture living in it
+    TextureMemory& textureMemory = m_TextureMemories[textureMemoryIndex];
+    if (--textureMemory.textureNum == 0)
+    {
+        for (nri::Memory* memory : textureMemory.allocations)
+            m_NRI->FreeMemory(*memory);
+        textureMemory.allocations.clear();
+    }
+}
+
+void Integration::CreateResources(uint16_t resourceWidth, uint16_t resourceHeight)
+{
+    CreateTextures(resourceWidth, resourceHeight);
+    CreateInstanceResources();
+}
+
+void Integration::CreateInstanceResources()
+{
+    const InstanceDesc& instanceDesc = GetInstanceDesc(*m_Instance);
+
+    // Samplers
+    for (uint32_t i = 0; i < instanceDesc.samplersNum; i++)
+    {
+        Sampler nrdSampler = instanceDesc.samplers[i];
+
+        nri::SamplerDesc samplerDesc = {};
+        samplerDesc.addressModes = {nri::AddressMode::CLAMP_TO_EDGE, nri::AddressMode::CLAMP_TO_EDGE};
+        samplerDesc.filters.min = nrdSampler == Sampler::NEAREST_CLAMP ? nri::Filter::NEAREST : nri::Filter::LINEAR;
+        samplerDesc.filters.mag = nrdSampler == Sampler::NEAREST_CLAMP ? nri::Filter::NEAREST : nri::Filter::LINEAR;
+
+        nri::Descriptor* descriptor = nullptr;
+        NRD_INTEGRATION_ABORT_ON_FAILURE(m_NRI->CreateSampler(*m_Device, samplerDesc, descriptor));
+        m_Samplers.push_back(descriptor);
+    }
+
+    // Constant buffer
+    const nri::DeviceDesc& deviceDesc = m_NRI->GetDeviceDesc(*m_Device);
     m_ConstantBufferViewSize = GetAlignedSize(instanceDesc.constantBufferMaxDataSize, deviceDesc.constantBufferOffsetAlignment);
     m_ConstantBufferSize = uint64_t(m_ConstantBufferViewSize) * instanceDesc.descriptorPoolDesc.setsMaxNum * m_BufferedFramesNum;
 
@@ -415,211 +890,654 @@ void Integration::CreateResources(uint16_t resourceWidth, uint16_t resourceHeigh
         m_DescriptorPools.push_back(descriptorPool);
 
         m_DescriptorSetSamplers.push_back(nullptr);
-        m_DescriptorsInFlight.push_back({});
+        m_RetiredResources.push_back({});
     }
+}
 
-    m_Width = resourceWidth;
-    m_Height = resourceHeight;
+void Integration::DestroyInstanceResources()
+{
+    m_NRI->DestroyDescriptor(*m_ConstantBufferView);
+    m_NRI->DestroyBuffer(*m_ConstantBuffer);
 
-#if( NRD_INTEGRATION_DEBUG_LOGGING == 1 )
-    if (m_Log)
-        fflush(m_Log);
-#endif
+    for (nri::Descriptor* descriptor : m_Samplers)
+        m_NRI->DestroyDescriptor(*descriptor);
+    m_Samplers.clear();
+
+    for (nri::Memory* memory : m_MemoryAllocations)
+        m_NRI->FreeMemory(*memory);
+    m_MemoryAllocations.clear();
+
+    for (nri::DescriptorPool* descriptorPool : m_DescriptorPools)
+        m_NRI->DestroyDescriptorPool(*descriptorPool);
+    m_DescriptorPools.clear();
+    m_DescriptorSetSamplers.clear();
+    m_DescriptorSetCache.clear();
+    m_DescriptorSetCacheDescriptors.clear();
+
+    m_ConstantBuffer = nullptr;
+    m_ConstantBufferView = nullptr;
+    m_ConstantBufferOffset = 0;
+    m_ConstantBufferOffsetPrev = 0;
 }
 
 void Integration::AllocateAndBindMemory()
 {
-    std::vector<nri::Texture*> textures(m_TexturePool.size(), nullptr);
-    for (size_t i = 0; i < m_TexturePool.size(); i++)
-        textures[i] = m_TexturePool[i].texture;
+    // Textures are handled in "CreateTextures"
+    nri::ResourceGroupDesc resourceGroupDesc = {};
+    resourceGroupDesc.memoryLocation = nri::MemoryLocation::HOST_UPLOAD;
+    resourceGroupDesc.bufferNum = 1;
+    resourceGroupDesc.buffers = &m_ConstantBuffer;
+
+    size_t baseAllocation = m_MemoryAllocations.size();
+    m_MemoryAllocations.resize(baseAllocation + 1, nullptr);
+    NRD_INTEGRATION_ABORT_ON_FAILURE(m_NRIHelper->AllocateAndBindMemory(*m_Device, resourceGroupDesc, m_MemoryAllocations.data() + baseAllocation));
+}
+
+void Integration::NewFrame()
+{
+    NRD_INTEGRATION_ASSERT(m_Instance, "Uninitialized! Did you forget to call 'Initialize'?");
+
+    if (m_Tracer.IsEnabled())
+    {
+        m_Tracer.Flush();
+
+        char args[32];
+        snprintf(args, sizeof(args), "\"frameIndex\":%u", m_FrameIndex + 1);
+        m_Tracer.Instant("NewFrame", "nrd", args);
+    }
+
+    m_FrameStats = {};
+
+    m_DescriptorPoolIndex = m_FrameIndex % m_BufferedFramesNum;
+    nri::DescriptorPool* descriptorPool = m_DescriptorPools[m_DescriptorPoolIndex];
+    m_NRI->ResetDescriptorPool(*descriptorPool);
+
+    // Needs to be reset because the corresponding descriptor pool has been just reset
+    m_DescriptorSetSamplers[m_DescriptorPoolIndex] = nullptr;
+
+    // Cached descriptor sets live in the previous descriptor pool
+    m_DescriptorSetCache.clear();
+    m_DescriptorSetCacheDescriptors.clear();
+
+    // Resources retired "bufferedFramesNum" frames ago (by "Resize" or descriptor cache eviction) are not in use by the GPU anymore
+    DestroyRetiredResources(m_RetiredResources[m_DescriptorPoolIndex]);
+
+    m_IsResized = false;
+    m_FrameIndex++;
+    m_PrevFrameIndexFromSettings++;
+}
+
+bool Integration::SetCommonSettings(const CommonSettings& commonSettings)
+{
+    return SetViewportSettings(0, commonSettings);
+}
+
+bool Integration::SetStereoSettings(const CommonSettings& leftEye, const CommonSettings& rightEye)
+{
+    NRD_INTEGRATION_ASSERT(m_Instance, "Uninitialized! Did you forget to call 'Initialize'?");
+    NRD_INTEGRATION_ASSERT(((leftEye.resourceSize[0] == leftEye.resourceSizePrev[0]
+        && leftEye.resourceSize[1] == leftEye.resourceSizePrev[1]) || m_IsResized) // "Prev" is ignored after "Resize"
+        && leftEye.resourceSize[0] == m_Width && leftEye.resourceSize[1] == m_Height,
+        "NRD integration preallocates resources statically: DRS is only supported via 'rectSize / rectSizePrev'");
+
+    Result result = nrd::SetStereoSettings(*m_Instance, leftEye, rightEye);
+    NRD_INTEGRATION_ASSERT(result == Result::SUCCESS, "SetStereoSettings(): failed!");
+
+    if (m_FrameIndex == 0 || leftEye.accumulationMode != AccumulationMode::CONTINUE)
+        m_PrevFrameIndexFromSettings = leftEye.frameIndex;
+    else
+        NRD_INTEGRATION_ASSERT(m_PrevFrameIndexFromSettings == leftEye.frameIndex, "'frameIndex' must be incremented by 1 on each frame");
+
+    return result == Result::SUCCESS;
+}
+
+bool Integration::SetViewportSettings(uint32_t viewportIndex, const CommonSettings& commonSettings)
+{
+    NRD_INTEGRATION_ASSERT(m_Instance, "Uninitialized! Did you forget to call 'Initialize'?");
+    NRD_INTEGRATION_ASSERT(((commonSettings.resourceSize[0] == commonSettings.resourceSizePrev[0]
+        && commonSettings.resourceSize[1] == commonSettings.resourceSizePrev[1]) || m_IsResized) // "Prev" is ignored after "Resize"
+        && commonSettings.resourceSize[0] == m_Width && commonSettings.resourceSize[1] == m_Height,
+        "NRD integration preallocates resources statically: DRS is only supported via 'rectSize / rectSizePrev'");
+
+    Result result = nrd::SetViewportSettings(*m_Instance, viewportIndex, commonSettings);
+    NRD_INTEGRATION_ASSERT(result == Result::SUCCESS, "SetViewportSettings(): failed!");
+
+    if (m_FrameIndex == 0 || commonSettings.accumulationMode != AccumulationMode::CONTINUE)
+        m_PrevFrameIndexFromSettings = commonSettings.frameIndex;
+    else
+        NRD_INTEGRATION_ASSERT(m_PrevFrameIndexFromSettings == commonSettings.frameIndex, "'frameIndex' must be incremented by 1 on each frame");
+
+    return result == Result::SUCCESS;
+}
+
+bool Integration::SetDenoiserSettings(Identifier denoiser, const void* denoiserSettings)
+{
+    NRD_INTEGRATION_ASSERT(m_Instance, "Uninitialized! Did you forget to call 'Initialize'?");
+
+    Result result = nrd::SetDenoiserSettings(*m_Instance, denoiser, denoiserSettings);
+    NRD_INTEGRATION_ASSERT(result == Result::SUCCESS, "SetDenoiserSettings(): failed!");
+
+    return result == Result::SUCCESS;
+}
+
+void Integration::Denoise(const Identifier* denoisers, uint32_t denoisersNum, nri::CommandBuffer& commandBuffer, UserPool& userPool, bool restoreInitialState)
+{
+    NRD_INTEGRATION_ASSERT(m_Instance, "Uninitialized! Did you forget to call 'Initialize'?");
+
+    NRD_INTEGRATION_ASSERT(m_IsTransientPoolBound || !m_TransientPoolPlacement.isExternal, "The external transient pool is not bound! Did you forget to call 'BindTransientPool'?");
+
+    TraceScope traceScope(m_Tracer, "Denoise", "nrd");
+
+    // Save initial state
+    nri::TextureBarrierDesc* initialStates = (nri::TextureBarrierDesc*)alloca(sizeof(nri::TextureBarrierDesc) * userPool.size());
+    if (restoreInitialState)
+    {
+        for (size_t i = 0; i < userPool.size(); i++)
+        {
+            const nri::TextureBarrierDesc* nrdTexture = userPool[i];
+            if (nrdTexture)
+                initialStates[i] = *nrdTexture;
+        }
+    }
+
+    // One time sanity check
+    if (m_FrameIndex == 0)
+    {
+        const nri::Texture* normalRoughnessTexture = userPool[(size_t)ResourceType::IN_NORMAL_ROUGHNESS]->texture;
+        const nri::TextureDesc& normalRoughnessDesc = m_NRI->GetTextureDesc(*normalRoughnessTexture);
+        const LibraryDesc& nrdLibraryDesc = GetLibraryDesc();
+
+        bool isNormalRoughnessFormatValid = false;
+        switch(nrdLibraryDesc.normalEncoding)
+        {
+            case NormalEncoding::RGBA8_UNORM:
+                isNormalRoughnessFormatValid = normalRoughnessDesc.format == nri::Format::RGBA8_UNORM;
+                break;
+            case NormalEncoding::RGBA8_SNORM:
+                isNormalRoughnessFormatValid = normalRoughnessDesc.format == nri::Format::RGBA8_SNORM;
+                break;
+            case NormalEncoding::R10_G10_B10_A2_UNORM:
+                isNormalRoughnessFormatValid = normalRoughnessDesc.format == nri::Format::R10_G10_B10_A2_UNORM;
+                break;
+            case NormalEncoding::RGBA16_UNORM:
+                isNormalRoughnessFormatValid = normalRoughnessDesc.format == nri::Format::RGBA16_UNORM;
+                break;
+            case NormalEncoding::RGBA16_SNORM:
+                isNormalRoughnessFormatValid = normalRoughnessDesc.format == nri::Format::RGBA16_SNORM || normalRoughnessDesc.format == nri::Format::RGBA16_SFLOAT || normalRoughnessDesc.format == nri::Format::RGBA32_SFLOAT;
+                break;
+        }
+
+        NRD_INTEGRATION_ASSERT(isNormalRoughnessFormatValid, "IN_NORMAL_ROUGHNESS format doesn't match NRD normal encoding");
+    }
+
+    // Retrieve dispatches
+    const DispatchDesc* dispatchDescs = nullptr;
+    uint32_t dispatchDescsNum = 0;
+    GetComputeDispatches(*m_Instance, denoisers, denoisersNum, dispatchDescs, dispatchDescsNum);
+    AccumulateDispatchStats(dispatchDescs, dispatchDescsNum);
+
+    if (traceScope.IsEnabled())
+        traceScope.SetArgs("\"denoiserNum\":%u,\"dispatchNum\":%u", denoisersNum, dispatchDescsNum);
+
+    // Even if descriptor caching is disabled it's better to cache descriptors inside a single "Denoise" call
+    if (!m_EnableDescriptorCaching)
+        m_DescriptorCache.Clear(m_RetiredResources[m_DescriptorPoolIndex].descriptors);
+
+    // Set descriptor pool
+    nri::DescriptorPool* descriptorPool = m_DescriptorPools[m_DescriptorPoolIndex];
+    m_NRI->CmdSetDescriptorPool(commandBuffer, *descriptorPool);
+
+    // Invoke dispatches
+    constexpr uint32_t lawnGreen = 0xFF7CFC00;
+    constexpr uint32_t limeGreen = 0xFF32CD32;
+
+    for (uint32_t i = 0; i < dispatchDescsNum; i++)
+    {
+        const DispatchDesc& dispatchDesc = dispatchDescs[i];
+        m_NRI->CmdBeginAnnotation(commandBuffer, dispatchDesc.name, (i & 0x1) ? lawnGreen : limeGreen);
+
+        Dispatch(commandBuffer, *descriptorPool, dispatchDesc, userPool);
+
+        m_NRI->CmdEndAnnotation(commandBuffer);
+    }
+
+    // Restore state
+    if (restoreInitialState)
+    {
+        nri::TextureBarrierDesc* uniqueBarriers = initialStates;
+        uint32_t uniqueBarrierNum = 0;
+
+        for (size_t i = 0; i < userPool.size(); i++)
+        {
+            nri::TextureBarrierDesc* nrdTexture = userPool[i];
+            if (!nrdTexture)
+                continue;
+
+            const nri::TextureBarrierDesc* nrdTextureInitial = &initialStates[i];
+            if (nrdTexture->after.access != nrdTextureInitial->after.access || nrdTexture->after.layout != nrdTextureInitial->after.layout)
+            {
+                nrdTexture->before = nrdTexture->after;
+                nrdTexture->after = nrdTextureInitial->after;
+
+                bool isDifferent = nrdTexture->after.access != nrdTexture->before.access || nrdTexture->after.layout != nrdTexture->before.layout;
+                bool isUnknown = nrdTexture->after.access == nri::AccessBits::UNKNOWN || nrdTexture->after.layout == nri::Layout::UNKNOWN;
+                if (isDifferent && !isUnknown)
+                    uniqueBarriers[uniqueBarrierNum++] = *nrdTexture;
+            }
+        }
+
+        if (uniqueBarrierNum)
+        {
+            TraceScope barrierTraceScope(m_Tracer, "RestoreInitialState", "barrier");
+            if (barrierTraceScope.IsEnabled())
+                barrierTraceScope.SetArgs("\"textureNum\":%u", uniqueBarrierNum);
+
+            nri::BarrierGroupDesc transitionBarriers = {};
+            transitionBarriers.textures = uniqueBarriers;
+            transitionBarriers.textureNum = uniqueBarrierNum;
+
+            m_NRI->CmdBarrier(commandBuffer, transitionBarriers);
+            m_FrameStats.barrierNum += uniqueBarrierNum;
+        }
+    }
+}
+
+bool Integration::Resize(nri::CommandBuffer& commandBuffer, uint16_t resourceWidth, uint16_t resourceHeight)
+{
+    NRD_INTEGRATION_ASSERT(m_Instance, "Uninitialized! Did you forget to call 'Initialize'?");
+
+    if (resourceWidth == m_Width && resourceHeight == m_Height)
+        return true;
+
+    TraceScope traceScope(m_Tracer, "Resize", "nrd");
+    if (traceScope.IsEnabled())
+        traceScope.SetArgs("\"resourceWidth\":%u,\"resourceHeight\":%u", resourceWidth, resourceHeight);
+
+    // Retire the old pool (destroyed in "NewFrame", when the GPU is done with it)
+    RetiredResources& retiredResources = m_RetiredResources[m_DescriptorPoolIndex];
+    std::vector<nri::TextureBarrierDesc> oldTexturePool = std::move(m_TexturePool);
+
+    for (const nri::TextureBarrierDesc& texture : oldTexturePool)
+        retiredResources.textures.push_back(texture.texture);
+
+    for (const TextureMemory& textureMemory : m_TextureMemories)
+        retiredResources.memoryAllocations.insert(retiredResources.memoryAllocations.end(), textureMemory.allocations.begin(), textureMemory.allocations.end());
+    m_TextureMemories.clear();
+    m_TextureMemoryIndices.clear();
+
+    // New pool (samplers, constant buffer, descriptor pools, pipelines and the instance are kept)
+    m_TexturePool.clear();
+    CreateTextures(resourceWidth, resourceHeight);
+
+    // Resample history (inputs are old permanent pool textures)
+    const DispatchDesc* dispatchDescs = nullptr;
+    uint32_t dispatchDescsNum = 0;
+    if (GetResizeDispatches(*m_Instance, resourceWidth, resourceHeight, dispatchDescs, dispatchDescsNum) != Result::SUCCESS)
+        return false;
+
+    // Cached descriptors can reference old textures (native objects can be reused by new textures)
+    m_DescriptorCache.Clear(retiredResources.descriptors);
+
+    AccumulateDispatchStats(dispatchDescs, dispatchDescsNum);
+
+    if (dispatchDescsNum)
+    {
+        m_ResampleTexturePool = &oldTexturePool;
+
+        nri::DescriptorPool* descriptorPool = m_DescriptorPools[m_DescriptorPoolIndex];
+        m_NRI->CmdSetDescriptorPool(commandBuffer, *descriptorPool);
+
+        UserPool userPool = {}; // not referenced
+        for (uint32_t i = 0; i < dispatchDescsNum; i++)
+        {
+            const DispatchDesc& dispatchDesc = dispatchDescs[i];
+            m_NRI->CmdBeginAnnotation(commandBuffer, dispatchDesc.name, 0xFF7CFC00);
+
+            Dispatch(commandBuffer, *descriptorPool, dispatchDesc, userPool);
+
+            m_NRI->CmdEndAnnotation(commandBuffer);
+        }
+
+        m_ResampleTexturePool = nullptr;
+    }
+
+    // Descriptors of the old pool, created by "resample" dispatches
+    m_DescriptorCache.Clear(retiredResources.descriptors);
+
+    m_IsResized = true;
+
+    return true;
+}
+
+bool Integration::Reconfigure(const InstanceCreationDesc& instanceCreationDesc)
+{
+    NRD_INTEGRATION_ASSERT(m_Instance, "Uninitialized! Did you forget to call 'Initialize'?");
+
+    TraceScope traceScope(m_Tracer, "Reconfigure", "nrd");
+
+    // New instance, inheriting history of kept denoisers
+    Instance* instance = nullptr;
+    if (CreateInstance(instanceCreationDesc, instance) != Result::SUCCESS)
+        return false;
+
+    const InstanceDesc& oldInstanceDesc = GetInstanceDesc(*m_Instance);
+    const InstanceDesc& newInstanceDesc = GetInstanceDesc(*instance);
+
+    std::vector<uint16_t> permanentPoolRemap(newInstanceDesc.permanentPoolSize);
+    if (InheritHistory(*instance, *m_Instance, permanentPoolRemap.data()) != Result::SUCCESS)
+    {
+        DestroyInstance(*instance);
+
+        return false;
+    }
+
+    // Assuming that the device is in IDLE state
+    StopPipelineWorkers();
+    StorePrewarmList();
+
+    std::vector<nri::Descriptor*> cachedDescriptors;
+    m_DescriptorCache.Clear(cachedDescriptors);
+    for (nri::Descriptor* descriptor : cachedDescriptors)
+        m_NRI->DestroyDescriptor(*descriptor);
+
+    for (RetiredResources& retiredResources : m_RetiredResources)
+        DestroyRetiredResources(retiredResources);
+    m_RetiredResources.clear();
+
+    DestroyInstanceResources();
+
+    // Keep permanent textures of kept denoisers, and transient textures (if not external), if descriptions match
+    std::vector<nri::TextureBarrierDesc> oldTexturePool = std::move(m_TexturePool);
+    std::vector<uint32_t> oldTextureMemoryIndices = std::move(m_TextureMemoryIndices);
+
+    const uint32_t newPoolSize = newInstanceDesc.permanentPoolSize + newInstanceDesc.transientPoolSize;
+    m_TexturePool.resize(newPoolSize, {});
+    m_TextureMemoryIndices.resize(newPoolSize, uint32_t(-1));
+
+    for (uint32_t i = 0; i < newInstanceDesc.permanentPoolSize; i++)
+    {
+        uint16_t j = permanentPoolRemap[i];
+        if (j != 0xFFFF)
+        {
+            std::swap(m_TexturePool[i], oldTexturePool[j]);
+            m_TextureMemoryIndices[i] = oldTextureMemoryIndices[j];
+        }
+    }
+
+    if (!m_EnableExternalTransientPool)
+    {
+        for (uint32_t i = 0; i < newInstanceDesc.transientPoolSize; i++)
+        {
+            const TextureDesc& newTextureDesc = newInstanceDesc.transientPool[i];
+
+            for (uint32_t j = 0; j < oldInstanceDesc.transientPoolSize; j++)
+            {
+                const TextureDesc& oldTextureDesc = oldInstanceDesc.transientPool[j];
+                nri::TextureBarrierDesc& oldTexture = oldTexturePool[oldInstanceDesc.permanentPoolSize + j];
+
+                if (oldTexture.texture && oldTextureDesc.format == newTextureDesc.format && oldTextureDesc.downsampleFactor == newTextureDesc.downsampleFactor)
+                {
+                    std::swap(m_TexturePool[newInstanceDesc.permanentPoolSize + i], oldTexture);
+                    m_TextureMemoryIndices[newInstanceDesc.permanentPoolSize + i] = oldTextureMemoryIndices[oldInstanceDesc.permanentPoolSize + j];
+                    break;
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < oldTexturePool.size(); i++)
+    {
+        if (oldTexturePool[i].texture)
+            DestroyTexture(*oldTexturePool[i].texture, oldTextureMemoryIndices[i]);
+    }
+
+    DestroyInstance(*m_Instance);
+    m_Instance = instance;
+
+    // Create missing textures
+    CreateTextures(m_Width, m_Height);
+
+    // Pipelines (old ones are released after creation of new ones, i.e. pipelines used by both instances are shared)
+    std::vector<nri::Pipeline*> oldPipelines = std::move(m_Pipelines);
+    std::vector<nri::PipelineLayout*> oldPipelineLayouts = std::move(m_PipelineLayouts);
+    std::vector<uint64_t> oldPipelineKeys = std::move(m_PipelineKeys);
+    m_Pipelines.clear();
+    m_PipelineLayouts.clear();
+    m_PipelineKeys.clear();
+    m_PipelineStates.clear();
+
+    CreatePipelines();
+
+    for (size_t i = 0; i < oldPipelines.size(); i++)
+    {
+        if (!oldPipelines[i]) // not requested (lazy creation)
+            continue;
 
-    nri::ResourceGroupDesc resourceGroupDesc = {};
-    resourceGroupDesc.memoryLocation = nri::MemoryLocation::DEVICE;
-    resourceGroupDesc.textureNum = (uint32_t)textures.size();
-    resourceGroupDesc.textures = textures.data();
+        if (oldPipelineKeys[i])
+            PipelineRegistry::Release(oldPipelineKeys[i], *m_NRI);
+        else
+        {
+            m_NRI->DestroyPipeline(*oldPipelines[i]);
+            m_NRI->DestroyPipelineLayout(*oldPipelineLayouts[i]);
+        }
+    }
 
-    size_t baseAllocation = m_MemoryAllocations.size();
-    const size_t allocationNum = m_NRIHelper->CalculateAllocationNumber(*m_Device, resourceGroupDesc);
-    m_MemoryAllocations.resize(baseAllocation + allocationNum, nullptr);
-    NRD_INTEGRATION_ABORT_ON_FAILURE(m_NRIHelper->AllocateAndBindMemory(*m_Device, resourceGroupDesc, m_MemoryAllocations.data() + baseAllocation));
+    LoadPrewarmList();
 
-    resourceGroupDesc = {};
-    resourceGroupDesc.memoryLocation = nri::MemoryLocation::HOST_UPLOAD;
-    resourceGroupDesc.bufferNum = 1;
-    resourceGroupDesc.buffers = &m_ConstantBuffer;
+    // Samplers, constant buffer and descriptor pools
+    CreateInstanceResources();
 
-    baseAllocation = m_MemoryAllocations.size();
-    m_MemoryAllocations.resize(baseAllocation + 1, nullptr);
-    NRD_INTEGRATION_ABORT_ON_FAILURE(m_NRIHelper->AllocateAndBindMemory(*m_Device, resourceGroupDesc, m_MemoryAllocations.data() + baseAllocation));
+    if (traceScope.IsEnabled())
+        traceScope.SetArgs("\"permanentMb\":%.1f,\"transientMb\":%.1f", GetPersistentMemoryUsageInMb(), GetAliasableMemoryUsageInMb());
+
+    return true;
 }
 
-void Integration::NewFrame()
+bool Integration::BindTransientPool(nri::Memory& memory, uint64_t offset)
 {
     NRD_INTEGRATION_ASSERT(m_Instance, "Uninitialized! Did you forget to call 'Initialize'?");
+    NRD_INTEGRATION_ASSERT(m_EnableExternalTransientPool, "'enableExternalTransientPool' is not set!");
+    NRD_INTEGRATION_ASSERT(!m_IsTransientPoolBound, "Already bound! Rebinding is allowed only after 'Resize'");
+
+    if (!m_TransientPoolPlacement.isExternal)
+        return true;
 
-#if( NRD_INTEGRATION_DEBUG_LOGGING == 1 )
-    if (m_Log)
+    if (offset % m_TransientPoolPlacement.alignment)
     {
-        fflush(m_Log);
-        fprintf(m_Log, "(frame %u) ==============================================================================\n\n", m_FrameIndex);
+        NRD_INTEGRATION_ASSERT(false, "'offset' must be aligned to 'TransientPoolPlacement::alignment'!");
+        return false;
     }
-#endif
 
-    m_DescriptorPoolIndex = m_FrameIndex % m_BufferedFramesNum;
-    nri::DescriptorPool* descriptorPool = m_DescriptorPools[m_DescriptorPoolIndex];
-    m_NRI->ResetDescriptorPool(*descriptorPool);
+    const InstanceDesc& instanceDesc = GetInstanceDesc(*m_Instance);
 
-    // Needs to be reset because the corresponding descriptor pool has been just reset
-    m_DescriptorSetSamplers[m_DescriptorPoolIndex] = nullptr;
+    std::vector<nri::TextureMemoryBindingDesc> bindings(instanceDesc.transientPoolSize);
+    for (uint32_t i = 0; i < instanceDesc.transientPoolSize; i++)
+        bindings[i] = {&memory, m_TexturePool[instanceDesc.permanentPoolSize + i].texture, offset + m_TransientPoolOffsets[i]};
 
-    // Referenced by the GPU descriptors can't be destroyed...
-    if (!m_EnableDescriptorCaching)
-    {
-        for (const auto& entry : m_DescriptorsInFlight[m_DescriptorPoolIndex])
-            m_NRI->DestroyDescriptor(*entry);
-        m_DescriptorsInFlight[m_DescriptorPoolIndex].clear();
-    }
+    if (m_NRI->BindTextureMemory(*m_Device, bindings.data(), (uint32_t)bindings.size()) != nri::Result::SUCCESS)
+        return false;
 
-    m_FrameIndex++;
-    m_PrevFrameIndexFromSettings++;
+    m_IsTransientPoolBound = true;
+
+    return true;
 }
 
-bool Integration::SetCommonSettings(const CommonSettings& commonSettings)
+void Integration::GetMemoryReport(std::vector<IntegrationResourceMemory>& report) const
 {
     NRD_INTEGRATION_ASSERT(m_Instance, "Uninitialized! Did you forget to call 'Initialize'?");
-    NRD_INTEGRATION_ASSERT(commonSettings.resourceSize[0] == commonSettings.resourceSizePrev[0]
-        && commonSettings.resourceSize[1] == commonSettings.resourceSizePrev[1]
-        && commonSettings.resourceSize[0] == m_Width && commonSettings.resourceSize[1] == m_Height,
-        "NRD integration preallocates resources statically: DRS is only supported via 'rectSize / rectSizePrev'");
 
-    Result result = nrd::SetCommonSettings(*m_Instance, commonSettings);
-    NRD_INTEGRATION_ASSERT(result == Result::SUCCESS, "SetCommonSettings(): failed!");
+    const InstanceDesc& instanceDesc = GetInstanceDesc(*m_Instance);
 
-    if (m_FrameIndex == 0 || commonSettings.accumulationMode != AccumulationMode::CONTINUE)
-        m_PrevFrameIndexFromSettings = commonSettings.frameIndex;
-    else
-        NRD_INTEGRATION_ASSERT(m_PrevFrameIndexFromSettings == commonSettings.frameIndex, "'frameIndex' must be incremented by 1 on each frame");
+    report.clear();
+    report.reserve(m_TexturePool.size());
 
-    return result == Result::SUCCESS;
+    for (uint32_t i = 0; i < (uint32_t)m_TexturePool.size(); i++)
+    {
+        bool isPermanent = i < instanceDesc.permanentPoolSize;
+        uint32_t indexInPool = isPermanent ? i : i - instanceDesc.permanentPoolSize;
+        const TextureDesc& nrdTextureDesc = isPermanent ? instanceDesc.permanentPool[indexInPool] : instanceDesc.transientPool[indexInPool];
+
+        nri::MemoryDesc memoryDesc = {};
+        m_NRI->GetTextureMemoryDesc(*m_TexturePool[i].texture, nri::MemoryLocation::DEVICE, memoryDesc);
+
+        report.push_back({nrdTextureDesc.name ? nrdTextureDesc.name : "", memoryDesc.size, indexInPool, isPermanent});
+    }
 }
 
-bool Integration::SetDenoiserSettings(Identifier denoiser, const void* denoiserSettings)
+void Integration::AccumulateDispatchStats(const DispatchDesc* dispatchDescs, uint32_t dispatchDescsNum)
 {
-    NRD_INTEGRATION_ASSERT(m_Instance, "Uninitialized! Did you forget to call 'Initialize'?");
+    DispatchStats dispatchStats = {};
+    GetDispatchStats(*m_Instance, dispatchDescs, dispatchDescsNum, dispatchStats);
+
+    DispatchStats& frameDispatchStats = m_FrameStats.dispatchStats;
+    frameDispatchStats.dispatchNum += dispatchStats.dispatchNum;
+    frameDispatchStats.clearDispatchNum += dispatchStats.clearDispatchNum;
+    frameDispatchStats.threadGroupNum += dispatchStats.threadGroupNum;
+    frameDispatchStats.constantBufferBytesWritten += dispatchStats.constantBufferBytesWritten;
+    frameDispatchStats.constantBufferBytesSkipped += dispatchStats.constantBufferBytesSkipped;
+}
 
-    Result result = nrd::SetDenoiserSettings(*m_Instance, denoiser, denoiserSettings);
-    NRD_INTEGRATION_ASSERT(result == Result::SUCCESS, "SetDenoiserSettings(): failed!");
+void Integration::DestroyRetiredResources(RetiredResources& retiredResources)
+{
+    for (nri::Descriptor* descriptor : retiredResources.descriptors)
+        m_NRI->DestroyDescriptor(*descriptor);
+    retiredResources.descriptors.clear();
 
-    return result == Result::SUCCESS;
+    for (nri::Texture* texture : retiredResources.textures)
+        m_NRI->DestroyTexture(*texture);
+    retiredResources.textures.clear();
+
+    for (nri::Memory* memory : retiredResources.memoryAllocations)
+        m_NRI->FreeMemory(*memory);
+    retiredResources.memoryAllocations.clear();
 }
 
-void Integration::Denoise(const Identifier* denoisers, uint32_t denoisersNum, nri::CommandBuffer& commandBuffer, UserPool& userPool, bool restoreInitialState)
+bool Integration::ExportHistory(nri::CommandBuffer& commandBuffer, IntegrationHistory& history)
 {
     NRD_INTEGRATION_ASSERT(m_Instance, "Uninitialized! Did you forget to call 'Initialize'?");
 
-    // Save initial state
-    nri::TextureBarrierDesc* initialStates = (nri::TextureBarrierDesc*)alloca(sizeof(nri::TextureBarrierDesc) * userPool.size());
-    if (restoreInitialState)
+    const InstanceDesc& instanceDesc = GetInstanceDesc(*m_Instance);
+
+    // (Re)create textures, if the layout has changed
+    bool isCompatible = history.textures.size() == instanceDesc.permanentPoolSize;
+    for (size_t i = 0; i < history.textures.size() && isCompatible; i++)
     {
-        for (size_t i = 0; i < userPool.size(); i++)
-        {
-            const nri::TextureBarrierDesc* nrdTexture = userPool[i];
-            if (nrdTexture)
-                initialStates[i] = *nrdTexture;
-        }
+        const nri::TextureDesc& srcDesc = m_NRI->GetTextureDesc(*m_TexturePool[i].texture);
+        const nri::TextureDesc& dstDesc = m_NRI->GetTextureDesc(*history.textures[i].texture);
+
+        isCompatible = srcDesc.format == dstDesc.format && srcDesc.width == dstDesc.width && srcDesc.height == dstDesc.height;
     }
 
-    // One time sanity check
-    if (m_FrameIndex == 0)
+    if (!isCompatible)
     {
-        const nri::Texture* normalRoughnessTexture = userPool[(size_t)ResourceType::IN_NORMAL_ROUGHNESS]->texture;
-        const nri::TextureDesc& normalRoughnessDesc = m_NRI->GetTextureDesc(*normalRoughnessTexture);
-        const LibraryDesc& nrdLibraryDesc = GetLibraryDesc();
+        DestroyHistory(history);
 
-        bool isNormalRoughnessFormatValid = false;
-        switch(nrdLibraryDesc.normalEncoding)
+        std::vector<nri::Texture*> textures(instanceDesc.permanentPoolSize, nullptr);
+        for (uint32_t i = 0; i < instanceDesc.permanentPoolSize; i++)
         {
-            case NormalEncoding::RGBA8_UNORM:
-                isNormalRoughnessFormatValid = normalRoughnessDesc.format == nri::Format::RGBA8_UNORM;
-                break;
-            case NormalEncoding::RGBA8_SNORM:
-                isNormalRoughnessFormatValid = normalRoughnessDesc.format == nri::Format::RGBA8_SNORM;
-                break;
-            case NormalEncoding::R10_G10_B10_A2_UNORM:
-                isNormalRoughnessFormatValid = normalRoughnessDesc.format == nri::Format::R10_G10_B10_A2_UNORM;
-                break;
-            case NormalEncoding::RGBA16_UNORM:
-                isNormalRoughnessFormatValid = normalRoughnessDesc.format == nri::Format::RGBA16_UNORM;
-                break;
-            case NormalEncoding::RGBA16_SNORM:
-                isNormalRoughnessFormatValid = normalRoughnessDesc.format == nri::Format::RGBA16_SNORM || normalRoughnessDesc.format == nri::Format::RGBA16_SFLOAT || normalRoughnessDesc.format == nri::Format::RGBA32_SFLOAT;
-                break;
+            nri::TextureDesc textureDesc = m_NRI->GetTextureDesc(*m_TexturePool[i].texture);
+            textureDesc.usage = nri::TextureUsageBits::SHADER_RESOURCE;
+
+            NRD_INTEGRATION_ABORT_ON_FAILURE(m_NRI->CreateTexture(*m_Device, textureDesc, textures[i]));
+
+            char name[128];
+            snprintf(name, sizeof(name), "%s::History(%u)", m_Name, i);
+            m_NRI->SetDebugName(textures[i], name);
+
+            history.textures.push_back(nri::TextureBarrierFromUnknown(textures[i], {nri::AccessBits::UNKNOWN, nri::Layout::UNKNOWN}, 0, 1));
         }
 
-        NRD_INTEGRATION_ASSERT(isNormalRoughnessFormatValid, "IN_NORMAL_ROUGHNESS format doesn't match NRD normal encoding");
+        nri::ResourceGroupDesc resourceGroupDesc = {};
+        resourceGroupDesc.memoryLocation = nri::MemoryLocation::DEVICE;
+        resourceGroupDesc.textureNum = (uint32_t)textures.size();
+        resourceGroupDesc.textures = textures.data();
+
+        const size_t allocationNum = m_NRIHelper->CalculateAllocationNumber(*m_Device, resourceGroupDesc);
+        history.memoryAllocations.resize(allocationNum, nullptr);
+        NRD_INTEGRATION_ABORT_ON_FAILURE(m_NRIHelper->AllocateAndBindMemory(*m_Device, resourceGroupDesc, history.memoryAllocations.data()));
     }
 
-    // Retrieve dispatches
-    const DispatchDesc* dispatchDescs = nullptr;
-    uint32_t dispatchDescsNum = 0;
-    GetComputeDispatches(*m_Instance, denoisers, denoisersNum, dispatchDescs, dispatchDescsNum);
+    // CPU state
+    uint32_t stateSize = 0;
+    nrd::ExportHistory(*m_Instance, nullptr, stateSize);
 
-    // Even if descriptor caching is disabled it's better to cache descriptors inside a single "Denoise" call
-    if (!m_EnableDescriptorCaching)
-        m_CachedDescriptors.clear();
+    history.state.resize(stateSize);
+    if (nrd::ExportHistory(*m_Instance, history.state.data(), stateSize) != Result::SUCCESS)
+    {
+        history.state.clear();
 
-    // Set descriptor pool
-    nri::DescriptorPool* descriptorPool = m_DescriptorPools[m_DescriptorPoolIndex];
-    m_NRI->CmdSetDescriptorPool(commandBuffer, *descriptorPool);
+        return false;
+    }
 
-    // Invoke dispatches
-    constexpr uint32_t lawnGreen = 0xFF7CFC00;
-    constexpr uint32_t limeGreen = 0xFF32CD32;
+    // GPU state
+    for (uint32_t i = 0; i < instanceDesc.permanentPoolSize; i++)
+        CopyTexture(commandBuffer, history.textures[i], m_TexturePool[i]);
 
-    for (uint32_t i = 0; i < dispatchDescsNum; i++)
+    return true;
+}
+
+bool Integration::ImportHistory(nri::CommandBuffer& commandBuffer, IntegrationHistory& history)
+{
+    NRD_INTEGRATION_ASSERT(m_Instance, "Uninitialized! Did you forget to call 'Initialize'?");
+
+    const InstanceDesc& instanceDesc = GetInstanceDesc(*m_Instance);
+
+    // CPU state
+    std::vector<uint16_t> permanentPoolRemap(instanceDesc.permanentPoolSize, 0);
+    if (nrd::ImportHistory(*m_Instance, history.state.data(), (uint32_t)history.state.size(), permanentPoolRemap.data()) != Result::SUCCESS)
+        return false;
+
+    // GPU state
+    for (uint32_t i = 0; i < instanceDesc.permanentPoolSize; i++)
     {
-        const DispatchDesc& dispatchDesc = dispatchDescs[i];
-        m_NRI->CmdBeginAnnotation(commandBuffer, dispatchDesc.name, (i & 0x1) ? lawnGreen : limeGreen);
+        uint16_t j = permanentPoolRemap[i];
+        NRD_INTEGRATION_ASSERT(j < history.textures.size(), "Unexpected remap!");
 
-        Dispatch(commandBuffer, *descriptorPool, dispatchDesc, userPool);
+        const nri::TextureDesc& srcDesc = m_NRI->GetTextureDesc(*history.textures[j].texture);
+        const nri::TextureDesc& dstDesc = m_NRI->GetTextureDesc(*m_TexturePool[i].texture);
+        NRD_INTEGRATION_ASSERT(srcDesc.format == dstDesc.format, "Format mismatch! 'promoteFloat16to32' and 'demoteFloat32to16' must match");
 
-        m_NRI->CmdEndAnnotation(commandBuffer);
+        CopyTexture(commandBuffer, m_TexturePool[i], history.textures[j]);
     }
 
-    // Restore state
-    if (restoreInitialState)
-    {
-        nri::TextureBarrierDesc* uniqueBarriers = initialStates;
-        uint32_t uniqueBarrierNum = 0;
+    return true;
+}
 
-        for (size_t i = 0; i < userPool.size(); i++)
-        {
-            nri::TextureBarrierDesc* nrdTexture = userPool[i];
-            if (!nrdTexture)
-                continue;
+void Integration::DestroyHistory(IntegrationHistory& history)
+{
+    for (const nri::TextureBarrierDesc& texture : history.textures)
+        m_NRI->DestroyTexture(*texture.texture);
+    history.textures.clear();
 
-            const nri::TextureBarrierDesc* nrdTextureInitial = &initialStates[i];
-            if (nrdTexture->after.access != nrdTextureInitial->after.access || nrdTexture->after.layout != nrdTextureInitial->after.layout)
-            {
-                nrdTexture->before = nrdTexture->after;
-                nrdTexture->after = nrdTextureInitial->after;
+    for (nri::Memory* memory : history.memoryAllocations)
+        m_NRI->FreeMemory(*memory);
+    history.memoryAllocations.clear();
 
-                bool isDifferent = nrdTexture->after.access != nrdTexture->before.access || nrdTexture->after.layout != nrdTexture->before.layout;
-                bool isUnknown = nrdTexture->after.access == nri::AccessBits::UNKNOWN || nrdTexture->after.layout == nri::Layout::UNKNOWN;
-                if (isDifferent && !isUnknown)
-                    uniqueBarriers[uniqueBarrierNum++] = *nrdTexture;
-            }
-        }
+    history.state.clear();
+}
 
-        if (uniqueBarrierNum)
-        {
-            nri::BarrierGroupDesc transitionBarriers = {};
-            transitionBarriers.textures = uniqueBarriers;
-            transitionBarriers.textureNum = uniqueBarrierNum;
+void Integration::CopyTexture(nri::CommandBuffer& commandBuffer, nri::TextureBarrierDesc& dst, nri::TextureBarrierDesc& src)
+{
+    const nri::TextureDesc& srcDesc = m_NRI->GetTextureDesc(*src.texture);
+    const nri::TextureDesc& dstDesc = m_NRI->GetTextureDesc(*dst.texture);
 
-            m_NRI->CmdBarrier(commandBuffer, transitionBarriers);
-        }
-    }
+    nri::TextureBarrierDesc transitions[2] = {
+        nri::TextureBarrierFromState(src, {nri::AccessBits::COPY_SOURCE, nri::Layout::COPY_SOURCE, nri::StageBits::COPY}),
+        nri::TextureBarrierFromState(dst, {nri::AccessBits::COPY_DESTINATION, nri::Layout::COPY_DESTINATION, nri::StageBits::COPY}),
+    };
+
+    nri::BarrierGroupDesc transitionBarriers = {};
+    transitionBarriers.textures = transitions;
+    transitionBarriers.textureNum = 2;
+    m_NRI->CmdBarrier(commandBuffer, transitionBarriers);
+
+    // The history is in the top-left corner (different sizes are allowed)
+    nri::TextureRegionDesc region = {};
+    region.width = std::min(srcDesc.width, dstDesc.width);
+    region.height = std::min(srcDesc.height, dstDesc.height);
+    region.depth = 1;
+
+    m_NRI->CmdCopyTexture(commandBuffer, *dst.texture, &region, *src.texture, &region);
 }
 
 void Integration::Dispatch(nri::CommandBuffer& commandBuffer, nri::DescriptorPool& descriptorPool, const DispatchDesc& dispatchDesc, UserPool& userPool)
@@ -627,6 +1545,30 @@ void Integration::Dispatch(nri::CommandBuffer& commandBuffer, nri::DescriptorPoo
     const InstanceDesc& instanceDesc = GetInstanceDesc(*m_Instance);
     const PipelineDesc& pipelineDesc = instanceDesc.pipelines[dispatchDesc.pipelineIndex];
 
+    TraceScope traceScope(m_Tracer, dispatchDesc.name, "dispatch");
+    if (traceScope.IsEnabled())
+    {
+        char resources[384] = {};
+        size_t length = 0;
+        for (uint32_t i = 0; i < dispatchDesc.resourcesNum && length < sizeof(resources); i++)
+        {
+            const ResourceDesc& r = dispatchDesc.resources[i];
+
+            if (r.type == ResourceType::PERMANENT_POOL)
+                length += snprintf(resources + length, sizeof(resources) - length, "P(%u) ", r.indexInPool);
+            else if (r.type == ResourceType::TRANSIENT_POOL)
+                length += snprintf(resources + length, sizeof(resources) - length, "T(%u) ", r.indexInPool);
+            else
+                length += snprintf(resources + length, sizeof(resources) - length, "%s ", GetResourceTypeString(r.type));
+        }
+
+        traceScope.SetArgs("\"pipelineIndex\":%u,\"grid\":\"%ux%u\",\"constantsReused\":%u,\"resources\":\"%s\"",
+            dispatchDesc.pipelineIndex, dispatchDesc.gridWidth, dispatchDesc.gridHeight, dispatchDesc.constantBufferDataMatchesPreviousDispatch ? 1 : 0, resources);
+    }
+
+    if (m_EnableLazyPipelineCreation)
+        RequestPipeline(dispatchDesc.pipelineIndex);
+
     nri::Descriptor** descriptors = (nri::Descriptor**)alloca(sizeof(nri::Descriptor*) * dispatchDesc.resourcesNum);
     memset(descriptors, 0, sizeof(nri::Descriptor*) * dispatchDesc.resourcesNum);
 
@@ -657,7 +1599,11 @@ void Integration::Dispatch(nri::CommandBuffer& commandBuffer, nri::DescriptorPoo
             if (nrdResource.type == ResourceType::TRANSIENT_POOL)
                 nrdTexture = &m_TexturePool[nrdResource.indexInPool + instanceDesc.permanentPoolSize];
             else if (nrdResource.type == ResourceType::PERMANENT_POOL)
-                nrdTexture = &m_TexturePool[nrdResource.indexInPool];
+            {
+                // Inputs of "resample" dispatches refer to the pool before "Resize"
+                bool isResampleInput = m_ResampleTexturePool && nrdResource.descriptorType == DescriptorType::TEXTURE;
+                nrdTexture = isResampleInput ? &(*m_ResampleTexturePool)[nrdResource.indexInPool] : &m_TexturePool[nrdResource.indexInPool];
+            }
             else
             {
                 nrdTexture = userPool[(uint32_t)nrdResource.type];
@@ -678,22 +1624,21 @@ void Integration::Dispatch(nri::CommandBuffer& commandBuffer, nri::DescriptorPoo
 
             // Create descriptor
             uint64_t resource = m_NRI->GetTextureNativeObject(*nrdTexture->texture);
-            uint64_t key = CreateDescriptorKey(resource, isStorage);
-            const auto& entry = m_CachedDescriptors.find(key);
-
-            nri::Descriptor* descriptor = nullptr;
-            if (entry == m_CachedDescriptors.end())
+            uint64_t key = CreateDescriptorKey(resource, isStorage, nrdTexture->layerOffset);
+            nri::Descriptor* descriptor = m_DescriptorCache.Find(key, m_FrameIndex);
+            if (!descriptor)
             {
+                TraceScope descriptorTraceScope(m_Tracer, "CreateDescriptor", "descriptor");
+
                 const nri::TextureDesc& textureDesc = m_NRI->GetTextureDesc(*nrdTexture->texture);
 
-                nri::Texture2DViewDesc desc = {nrdTexture->texture, isStorage ? nri::Texture2DViewType::SHADER_RESOURCE_STORAGE_2D : nri::Texture2DViewType::SHADER_RESOURCE_2D, textureDesc.format, 0, 1};
+                // A user texture can be a layer of a texture array (for example, an eye in stereo rendering)
+                nri::Texture2DViewDesc desc = {nrdTexture->texture, isStorage ? nri::Texture2DViewType::SHADER_RESOURCE_STORAGE_2D : nri::Texture2DViewType::SHADER_RESOURCE_2D, textureDesc.format, 0, 1, nrdTexture->layerOffset, 1};
                 NRD_INTEGRATION_ABORT_ON_FAILURE(m_NRI->CreateTexture2DView(desc, descriptor));
 
-                m_CachedDescriptors.insert( std::make_pair(key, descriptor) );
-                m_DescriptorsInFlight[m_DescriptorPoolIndex].push_back(descriptor);
+                uint32_t capacity = m_EnableDescriptorCaching ? m_DescriptorCacheCapacity : 0;
+                m_DescriptorCache.Insert(key, descriptor, m_FrameIndex, capacity, m_RetiredResources[m_DescriptorPoolIndex].descriptors);
             }
-            else
-                descriptor = entry->second;
 
             // Add descriptor to the range
             descriptors[n++] = descriptor;
@@ -701,7 +1646,14 @@ void Integration::Dispatch(nri::CommandBuffer& commandBuffer, nri::DescriptorPoo
     }
 
     // Barriers
-    m_NRI->CmdBarrier(commandBuffer, transitionBarriers);
+    {
+        TraceScope barrierTraceScope(m_Tracer, "Barriers", "barrier");
+        if (barrierTraceScope.IsEnabled())
+            barrierTraceScope.SetArgs("\"textureNum\":%u", transitionBarriers.textureNum);
+
+        m_NRI->CmdBarrier(commandBuffer, transitionBarriers);
+        m_FrameStats.barrierNum += transitionBarriers.textureNum;
+    }
 
     // Allocating descriptor sets
     uint32_t descriptorSetSamplersIndex = instanceDesc.constantBufferSpaceIndex == instanceDesc.samplersSpaceIndex ? 0 : 1;
@@ -712,60 +1664,121 @@ void Integration::Dispatch(nri::CommandBuffer& commandBuffer, nri::DescriptorPoo
     nri::DescriptorSet** descriptorSets = (nri::DescriptorSet**)alloca(sizeof(nri::DescriptorSet*) * descriptorSetNum);
     nri::PipelineLayout* pipelineLayout = m_PipelineLayouts[dispatchDesc.pipelineIndex];
 
-    for (uint32_t i = 0; i < descriptorSetNum; i++)
+    // Content of descriptor sets depends only on the pipeline and the descriptors (the constant buffer offset is dynamic), i.e. sets of an identical
+    // dispatch recorded earlier in this frame can be reused (for example, by "RELAX" A-trous iterations, which ping-pong between the same textures)
+    uint64_t descriptorSetKey = HashBytes(14695981039346656037ull, &dispatchDesc.pipelineIndex, sizeof(dispatchDesc.pipelineIndex));
+    descriptorSetKey = HashBytes(descriptorSetKey, descriptors, sizeof(nri::Descriptor*) * dispatchDesc.resourcesNum);
+
+    const DescriptorSetCacheEntry* cachedDescriptorSets = nullptr;
+    for (const DescriptorSetCacheEntry& entry : m_DescriptorSetCache)
     {
-        if (!samplersAreInSeparateSet || i != descriptorSetSamplersIndex)
-            NRD_INTEGRATION_ABORT_ON_FAILURE(m_NRI->AllocateDescriptorSets(descriptorPool, *pipelineLayout, i, &descriptorSets[i], 1, 0));
+        if (entry.key == descriptorSetKey && entry.pipelineIndex == dispatchDesc.pipelineIndex
+            && !memcmp(&m_DescriptorSetCacheDescriptors[entry.descriptorsOffset], descriptors, sizeof(nri::Descriptor*) * dispatchDesc.resourcesNum))
+        {
+            cachedDescriptorSets = &entry;
+            break;
+        }
     }
 
-    // Updating constants
-    uint32_t dynamicConstantBufferOffset = m_ConstantBufferOffsetPrev;
-    if (dispatchDesc.constantBufferDataSize)
+    if (cachedDescriptorSets)
     {
-        if (!dispatchDesc.constantBufferDataMatchesPreviousDispatch)
+        for (uint32_t i = 0; i < descriptorSetNum; i++)
+            descriptorSets[i] = cachedDescriptorSets->descriptorSets[i];
+
+        m_FrameStats.descriptorSetReuseNum++;
+    }
+    else
+    {
+        NRD_INTEGRATION_ASSERT(descriptorSetNum <= sizeof(DescriptorSetCacheEntry::descriptorSets) / sizeof(nri::DescriptorSet*), "Unexpected number of descriptor sets!");
+
         {
-            // Ring-buffer logic
-            if (m_ConstantBufferOffset + m_ConstantBufferViewSize > m_ConstantBufferSize)
-                m_ConstantBufferOffset = 0;
+            TraceScope descriptorTraceScope(m_Tracer, "AllocateDescriptorSets", "descriptor");
+            if (descriptorTraceScope.IsEnabled())
+                descriptorTraceScope.SetArgs("\"descriptorSetNum\":%u", descriptorSetNum);
 
-            // Upload CB data
-            // TODO: persistent mapping? But no D3D11 support...
-            void* data = m_NRI->MapBuffer(*m_ConstantBuffer, m_ConstantBufferOffset, dispatchDesc.constantBufferDataSize);
-            if (data)
+            for (uint32_t i = 0; i < descriptorSetNum; i++)
             {
-                memcpy(data, dispatchDesc.constantBufferData, dispatchDesc.constantBufferDataSize);
-                m_NRI->UnmapBuffer(*m_ConstantBuffer);
+                if (!samplersAreInSeparateSet || i != descriptorSetSamplersIndex)
+                {
+                    NRD_INTEGRATION_ABORT_ON_FAILURE(m_NRI->AllocateDescriptorSets(descriptorPool, *pipelineLayout, i, &descriptorSets[i], 1, 0));
+                    m_FrameStats.descriptorSetNum++;
+                }
             }
+        }
+
+        // Updating constant buffer view
+        if (dispatchDesc.constantBufferDataSize)
+        {
+            m_NRI->UpdateDynamicConstantBuffers(*descriptorSets[0], 0, 1, &m_ConstantBufferView);
+            m_FrameStats.descriptorWriteNum++;
+        }
+
+        // Updating samplers
+        const nri::DescriptorRangeUpdateDesc samplersDescriptorRange = {m_Samplers.data(), instanceDesc.samplersNum, 0};
+        if (samplersAreInSeparateSet)
+        {
+            nri::DescriptorSet*& descriptorSetSamplers = m_DescriptorSetSamplers[m_DescriptorPoolIndex];
+            if (!descriptorSetSamplers)
+            {
+                NRD_INTEGRATION_ABORT_ON_FAILURE(m_NRI->AllocateDescriptorSets(descriptorPool, *pipelineLayout, descriptorSetSamplersIndex, &descriptorSetSamplers, 1, 0));
+                m_NRI->UpdateDescriptorRanges(*descriptorSetSamplers, 0, 1, &samplersDescriptorRange);
 
-            // Ring-buffer logic
-            dynamicConstantBufferOffset = m_ConstantBufferOffset;
-            m_ConstantBufferOffset += m_ConstantBufferViewSize;
+                m_FrameStats.descriptorSetNum++;
+                m_FrameStats.descriptorWriteNum += instanceDesc.samplersNum;
+            }
 
-            // Save previous offset for potential CB data reuse
-            m_ConstantBufferOffsetPrev = dynamicConstantBufferOffset;
+            descriptorSets[descriptorSetSamplersIndex] = descriptorSetSamplers;
+        }
+        else
+        {
+            m_NRI->UpdateDescriptorRanges(*descriptorSets[descriptorSetSamplersIndex], 0, 1, &samplersDescriptorRange);
+            m_FrameStats.descriptorWriteNum += instanceDesc.samplersNum;
         }
 
-        m_NRI->UpdateDynamicConstantBuffers(*descriptorSets[0], 0, 1, &m_ConstantBufferView);
+        // Updating resources
+        m_NRI->UpdateDescriptorRanges(*descriptorSets[descriptorSetResourcesIndex], instanceDesc.samplersSpaceIndex == instanceDesc.resourcesSpaceIndex ? 1 : 0, pipelineDesc.resourceRangesNum, resourceRanges);
+        m_FrameStats.descriptorWriteNum += dispatchDesc.resourcesNum;
+
+        // Cache
+        DescriptorSetCacheEntry entry = {};
+        entry.key = descriptorSetKey;
+        entry.descriptorsOffset = (uint32_t)m_DescriptorSetCacheDescriptors.size();
+        entry.pipelineIndex = dispatchDesc.pipelineIndex;
+        for (uint32_t i = 0; i < descriptorSetNum; i++)
+            entry.descriptorSets[i] = descriptorSets[i];
+
+        m_DescriptorSetCache.push_back(entry);
+        m_DescriptorSetCacheDescriptors.insert(m_DescriptorSetCacheDescriptors.end(), descriptors, descriptors + dispatchDesc.resourcesNum);
     }
 
-    // Updating samplers
-    const nri::DescriptorRangeUpdateDesc samplersDescriptorRange = {m_Samplers.data(), instanceDesc.samplersNum, 0};
-    if (samplersAreInSeparateSet)
+    // Updating constants
+    uint32_t dynamicConstantBufferOffset = m_ConstantBufferOffsetPrev;
+    if (dispatchDesc.constantBufferDataSize && !dispatchDesc.constantBufferDataMatchesPreviousDispatch)
     {
-        nri::DescriptorSet*& descriptorSetSamplers = m_DescriptorSetSamplers[m_DescriptorPoolIndex];
-        if (!descriptorSetSamplers)
+        TraceScope uploadTraceScope(m_Tracer, "UploadConstants", "constants");
+        if (uploadTraceScope.IsEnabled())
+            uploadTraceScope.SetArgs("\"size\":%u", dispatchDesc.constantBufferDataSize);
+
+        // Ring-buffer logic
+        if (m_ConstantBufferOffset + m_ConstantBufferViewSize > m_ConstantBufferSize)
+            m_ConstantBufferOffset = 0;
+
+        // Upload CB data
+        // TODO: persistent mapping? But no D3D11 support...
+        void* data = m_NRI->MapBuffer(*m_ConstantBuffer, m_ConstantBufferOffset, dispatchDesc.constantBufferDataSize);
+        if (data)
         {
-            NRD_INTEGRATION_ABORT_ON_FAILURE(m_NRI->AllocateDescriptorSets(descriptorPool, *pipelineLayout, descriptorSetSamplersIndex, &descriptorSetSamplers, 1, 0));
-            m_NRI->UpdateDescriptorRanges(*descriptorSetSamplers, 0, 1, &samplersDescriptorRange);
+            memcpy(data, dispatchDesc.constantBufferData, dispatchDesc.constantBufferDataSize);
+            m_NRI->UnmapBuffer(*m_ConstantBuffer);
         }
 
-        descriptorSets[descriptorSetSamplersIndex] = descriptorSetSamplers;
-    }
-    else
-        m_NRI->UpdateDescriptorRanges(*descriptorSets[descriptorSetSamplersIndex], 0, 1, &samplersDescriptorRange);
+        // Ring-buffer logic
+        dynamicConstantBufferOffset = m_ConstantBufferOffset;
+        m_ConstantBufferOffset += m_ConstantBufferViewSize;
 
-    // Updating resources
-    m_NRI->UpdateDescriptorRanges(*descriptorSets[descriptorSetResourcesIndex], instanceDesc.samplersSpaceIndex == instanceDesc.resourcesSpaceIndex ? 1 : 0, pipelineDesc.resourceRangesNum, resourceRanges);
+        // Save previous offset for potential CB data reuse
+        m_ConstantBufferOffsetPrev = dynamicConstantBufferOffset;
+    }
 
     // Rendering
     m_NRI->CmdSetPipelineLayout(commandBuffer, *pipelineLayout);
@@ -776,96 +1789,74 @@ void Integration::Dispatch(nri::CommandBuffer& commandBuffer, nri::DescriptorPoo
     for (uint32_t i = 0; i < descriptorSetNum; i++)
         m_NRI->CmdSetDescriptorSet(commandBuffer, i, *descriptorSets[i], i == 0 ? &dynamicConstantBufferOffset : nullptr);
 
-    m_NRI->CmdDispatch(commandBuffer, {dispatchDesc.gridWidth, dispatchDesc.gridHeight, 1});
-
-    // Debug logging
-#if( NRD_INTEGRATION_DEBUG_LOGGING == 1 )
-    if (m_Log)
-    {
-        fprintf(m_Log, "%c Pipeline #%u : %s\n\t", dispatchDesc.constantBufferDataMatchesPreviousDispatch ? ' ' : '!', dispatchDesc.pipelineIndex, dispatchDesc.name);
-        for( uint32_t i = 0; i < dispatchDesc.resourcesNum; i++ )
-        {
-            const ResourceDesc& r = dispatchDesc.resources[i];
+    if (dispatchDesc.rootConstantDataSize)
+        m_NRI->CmdSetRootConstants(commandBuffer, 0, dispatchDesc.rootConstantData, dispatchDesc.rootConstantDataSize);
 
-            if( r.type == ResourceType::PERMANENT_POOL )
-                fprintf(m_Log, "P(%u) ", r.indexInPool);
-            else if( r.type == ResourceType::TRANSIENT_POOL )
-                fprintf(m_Log, "T(%u) ", r.indexInPool);
-            else
-            {
-                const char* s = GetResourceTypeString(r.type);
-                fprintf(m_Log, "%s ", s);
-            }
-        }
-        fprintf(m_Log, "\n\n");
-    }
-#endif
+    m_NRI->CmdDispatch(commandBuffer, {dispatchDesc.gridWidth, dispatchDesc.gridHeight, 1});
 }
 
 void Integration::Destroy()
 {
     NRD_INTEGRATION_ASSERT(m_Instance, "Already destroyed! Did you forget to call 'Initialize'?");
 
-    m_NRI->DestroyDescriptor(*m_ConstantBufferView);
-    m_NRI->DestroyBuffer(*m_ConstantBuffer);
-
-    for (auto& descriptors : m_DescriptorsInFlight)
-    {
-        for (const auto& entry : descriptors)
-            m_NRI->DestroyDescriptor(*entry);
-        descriptors.clear();
-    }
-    m_DescriptorsInFlight.clear();
-    m_CachedDescriptors.clear();
-
-    for (const nri::TextureBarrierDesc& nrdTexture : m_TexturePool)
-        m_NRI->DestroyTexture(*nrdTexture.texture);
-    m_TexturePool.clear();
+    m_Tracer.Flush(); // tracing stays enabled
 
-    for (nri::Descriptor* descriptor : m_Samplers)
+    std::vector<nri::Descriptor*> cachedDescriptors;
+    m_DescriptorCache.Clear(cachedDescriptors);
+    m_DescriptorCache.ResetStats();
+    for (nri::Descriptor* descriptor : cachedDescriptors)
         m_NRI->DestroyDescriptor(*descriptor);
-    m_Samplers.clear();
 
-    for (nri::Pipeline* pipeline : m_Pipelines)
-        m_NRI->DestroyPipeline(*pipeline);
-    m_Pipelines.clear();
-
-    for (nri::PipelineLayout* pipelineLayout : m_PipelineLayouts)
-        m_NRI->DestroyPipelineLayout(*pipelineLayout);
-    m_PipelineLayouts.clear();
+    for (size_t i = 0; i < m_TexturePool.size(); i++)
+        DestroyTexture(*m_TexturePool[i].texture, m_TextureMemoryIndices[i]);
+    m_TexturePool.clear();
+    m_TextureMemories.clear();
+    m_TextureMemoryIndices.clear();
 
-    for (nri::Memory* memory : m_MemoryAllocations)
-        m_NRI->FreeMemory(*memory);
-    m_MemoryAllocations.clear();
+    StopPipelineWorkers();
+    StorePrewarmList();
+    DestroyPipelines();
 
-    for (nri::DescriptorPool* descriptorPool : m_DescriptorPools)
-        m_NRI->DestroyDescriptorPool(*descriptorPool);
-    m_DescriptorPools.clear();
-    m_DescriptorSetSamplers.clear();
+    for (RetiredResources& retiredResources : m_RetiredResources)
+        DestroyRetiredResources(retiredResources);
+    m_RetiredResources.clear();
 
+    DestroyInstanceResources();
     DestroyInstance(*m_Instance);
 
     m_NRI = nullptr;
     m_NRIHelper = nullptr;
     m_Device = nullptr;
-    m_ConstantBuffer = nullptr;
-    m_ConstantBufferView = nullptr;
     m_Instance = nullptr;
     m_PermanentPoolSize = 0;
     m_TransientPoolSize = 0;
     m_ConstantBufferSize = 0;
     m_ConstantBufferViewSize = 0;
-    m_ConstantBufferOffset = 0;
     m_BufferedFramesNum = 0;
     m_DescriptorPoolIndex = 0;
     m_FrameIndex = 0;
     m_ReloadShaders = false;
+    m_IsResized = false;
+    m_EnableLazyPipelineCreation = false;
+    m_PipelineCompilationThreadsNum = 0;
     m_EnableDescriptorCaching = false;
+    m_DescriptorCacheCapacity = 0;
+    m_EnableExternalTransientPool = false;
+    m_IsTransientPoolBound = false;
+    m_TransientPoolPlacement = {};
+    m_TransientPoolOffsets.clear();
+    m_PrewarmListPath.clear();
+    m_PrewarmListCallbacks = {};
+}
 
-#if( NRD_INTEGRATION_DEBUG_LOGGING == 1 )
-    if (m_Log)
-        fclose(m_Log);
-#endif
+void Integration::EnableTracing(const TraceCallbacks& traceCallbacks)
+{
+    NRD_INTEGRATION_ASSERT(traceCallbacks.Write, "'Write' can't be NULL!");
+
+    m_Tracer.Enable(traceCallbacks, m_Name[0] ? m_Name : "NRD");
 }
 
+void Integration::DisableTracing()
+{ m_Tracer.Disable(); }
+
 }
@@ -0,0 +1,306 @@
+/*
+Copyright (c) 2022, NVIDIA CORPORATION. All rights reserved.
+
+NVIDIA CORPORATION and its licensors retain all intellectual property
+and proprietary rights in and to this software, related documentation
+and any modifications thereto. Any use, reproduction, disclosure or
+distribution of this software and related documentation without an express
+license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+// Parts of the NRD integration, which don't depend on a device (included by "NRDIntegration.h", can be used and tested standalone)
+// IMPORTANT: "NRD.h" and "NRI.h" must be included beforehand (only "nri::Descriptor", "nri::MemoryDesc", "nri::MemoryType" and
+// "nri::DeviceDesc" are used)
+
+#include <algorithm>
+#include <cstring>
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include <stdio.h>
+
+namespace nrd
+{
+
+inline uint64_t HashBytes(uint64_t hash, const void* data, size_t size) // FNV-1a
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++)
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+
+    return hash;
+}
+
+// Descriptor (texture view) cache counters, accumulated over the lifetime of an integration
+struct DescriptorCacheStats
+{
+    uint64_t hitNum;
+    uint64_t missNum;
+    uint64_t evictionNum;
+    uint32_t descriptorNum; // currently cached
+};
+
+// Layout of the transient pool in application-owned memory (see "IntegrationCreationDesc::enableExternalTransientPool")
+struct TransientPoolPlacement
+{
+    uint64_t size; // the window, which NRD touches only within "Denoise" (can be aliased outside of it)
+    uint64_t alignment; // required alignment of the window offset
+    nri::MemoryType memoryType; // memory must be allocated with this type
+    bool isExternal; // false - not supported by the device (dedicated memory is used instead, no binding is needed)
+};
+
+// Packs textures into a window. Returns "false" if textures can't share memory (different memory types or dedicated allocations
+// are required), "offsets" are relative to the window start
+inline bool CalculateTransientPoolPlacement(const nri::MemoryDesc* memoryDescs, uint32_t memoryDescsNum, uint64_t* offsets, TransientPoolPlacement& placement)
+{
+    placement = {};
+    placement.alignment = 1;
+
+    for (uint32_t i = 0; i < memoryDescsNum; i++)
+    {
+        const nri::MemoryDesc& memoryDesc = memoryDescs[i];
+        if (memoryDesc.mustBeDedicated || (i && memoryDesc.type != placement.memoryType))
+        {
+            placement = {};
+            return false;
+        }
+
+        // Sequential placement (NRD has already aliased transient textures across denoisers)
+        uint64_t alignment = memoryDesc.alignment ? memoryDesc.alignment : 1;
+        offsets[i] = ((placement.size + alignment - 1) / alignment) * alignment;
+
+        placement.size = offsets[i] + memoryDesc.size;
+        placement.alignment = std::max(placement.alignment, alignment);
+        placement.memoryType = memoryDesc.type;
+    }
+
+    placement.isExternal = true;
+
+    return true;
+}
+
+// Bounded LRU map "view key => descriptor" (doesn't create or destroy descriptors).
+// Evicted descriptors are returned to the caller, which must keep them alive until the GPU is done with them
+class DescriptorCache
+{
+public:
+    inline nri::Descriptor* Find(uint64_t key, uint32_t frameIndex)
+    {
+        auto it = m_Entries.find(key);
+        if (it == m_Entries.end())
+        {
+            m_Stats.missNum++;
+            return nullptr;
+        }
+
+        Entry& entry = it->second;
+        entry.lastUsedFrame = frameIndex;
+        m_Lru.splice(m_Lru.begin(), m_Lru, entry.lruPos);
+        m_Stats.hitNum++;
+
+        return entry.descriptor;
+    }
+
+    // "capacity = 0" - unbounded
+    inline void Insert(uint64_t key, nri::Descriptor* descriptor, uint32_t frameIndex, uint32_t capacity, std::vector<nri::Descriptor*>& evicted)
+    {
+        // Evict least recently used entries, but not the ones referenced by the current frame (they would be recreated right away)
+        while (capacity && m_Entries.size() >= capacity)
+        {
+            auto it = m_Entries.find(m_Lru.back());
+            if (it->second.lastUsedFrame == frameIndex)
+                break;
+
+            evicted.push_back(it->second.descriptor);
+            m_Entries.erase(it);
+            m_Lru.pop_back();
+            m_Stats.evictionNum++;
+        }
+
+        m_Lru.push_front(key);
+        m_Entries.insert( std::make_pair(key, Entry{descriptor, frameIndex, m_Lru.begin()}) );
+    }
+
+    inline void Clear(std::vector<nri::Descriptor*>& evicted)
+    {
+        for (const auto& entry : m_Entries)
+            evicted.push_back(entry.second.descriptor);
+
+        m_Stats.evictionNum += m_Entries.size();
+        m_Entries.clear();
+        m_Lru.clear();
+    }
+
+    inline DescriptorCacheStats GetStats() const
+    {
+        DescriptorCacheStats stats = m_Stats;
+        stats.descriptorNum = (uint32_t)m_Entries.size();
+
+        return stats;
+    }
+
+    inline void ResetStats()
+    { m_Stats = {}; }
+
+private:
+    struct Entry
+    {
+        nri::Descriptor* descriptor;
+        uint32_t lastUsedFrame;
+        std::list<uint64_t>::iterator lruPos;
+    };
+
+    std::unordered_map<uint64_t, Entry> m_Entries;
+    std::list<uint64_t> m_Lru; // most recently used first
+    DescriptorCacheStats m_Stats = {};
+};
+
+
+// (Optional) application-side storage for the prewarm list blob (for example, a save game system or a cloud storage)
+struct PrewarmListCallbacks
+{
+    bool (*Load)(void* userArg, std::vector<uint8_t>& data); // "false" - no data
+    void (*Store)(void* userArg, const uint8_t* data, size_t size);
+    void* userArg;
+};
+
+// Prewarm list blob handling: names (hashes) of pipelines used in previous runs. It's not a driver pipeline cache (NRI doesn't
+// expose one), i.e. it only tells which pipelines to create early
+class PrewarmList
+{
+public:
+    static inline uint64_t GetKey(const LibraryDesc& libraryDesc, const nri::DeviceDesc& deviceDesc)
+    {
+        // Only fields affecting generated code (NRI doesn't expose a driver version, a driver update may leave the list stale, which is harmless)
+        uint32_t values[] =
+        {
+            libraryDesc.versionMajor,
+            libraryDesc.versionMinor,
+            libraryDesc.versionBuild,
+            (uint32_t)libraryDesc.normalEncoding,
+            (uint32_t)libraryDesc.roughnessEncoding,
+            (uint32_t)deviceDesc.graphicsAPI,
+            (uint32_t)deviceDesc.adapterDesc.vendor,
+            deviceDesc.adapterDesc.deviceId,
+            deviceDesc.nriVersionMajor,
+            deviceDesc.nriVersionMinor,
+        };
+
+        return HashBytes(14695981039346656037ull, values, sizeof(values));
+    }
+
+    static inline uint64_t GetShaderHash(const PipelineDesc& pipelineDesc)
+    { return HashBytes(14695981039346656037ull, pipelineDesc.shaderFileName, strlen(pipelineDesc.shaderFileName)); }
+
+    static inline void Serialize(uint64_t key, const std::vector<uint64_t>& shaderHashes, std::vector<uint8_t>& data)
+    {
+        size_t shaderHashesSize = shaderHashes.size() * sizeof(uint64_t);
+
+        Header header = {};
+        header.magic = MAGIC;
+        header.version = VERSION;
+        header.key = key;
+        header.shaderHashesNum = shaderHashes.size();
+        header.checksum = HashBytes(14695981039346656037ull, shaderHashes.data(), shaderHashesSize);
+
+        data.resize(sizeof(Header) + shaderHashesSize);
+        memcpy(data.data(), &header, sizeof(Header));
+        if (shaderHashesSize)
+            memcpy(data.data() + sizeof(Header), shaderHashes.data(), shaderHashesSize);
+    }
+
+    // "false" - the blob is corrupted or was produced for another key ("shaderHashes" is empty)
+    static inline bool Deserialize(uint64_t key, const uint8_t* data, size_t size, std::vector<uint64_t>& shaderHashes)
+    {
+        shaderHashes.clear();
+
+        Header header = {};
+        if (!data || size < sizeof(Header))
+            return false;
+
+        memcpy(&header, data, sizeof(Header));
+        if (header.magic != MAGIC || header.version != VERSION || header.key != key)
+            return false;
+
+        if (header.shaderHashesNum != (size - sizeof(Header)) / sizeof(uint64_t) || (size - sizeof(Header)) % sizeof(uint64_t))
+            return false;
+
+        shaderHashes.resize((size_t)header.shaderHashesNum);
+        if (header.shaderHashesNum)
+            memcpy(shaderHashes.data(), data + sizeof(Header), size - sizeof(Header));
+
+        if (HashBytes(14695981039346656037ull, shaderHashes.data(), size - sizeof(Header)) != header.checksum)
+        {
+            shaderHashes.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    static inline bool Load(const char* path, const PrewarmListCallbacks& callbacks, std::vector<uint8_t>& data)
+    {
+        data.clear();
+
+        if (callbacks.Load)
+            return callbacks.Load(callbacks.userArg, data);
+
+        if (!path || !*path)
+            return false;
+
+        FILE* file = fopen(path, "rb");
+        if (!file)
+            return false;
+
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+
+        if (size > 0)
+        {
+            data.resize((size_t)size);
+            if (fread(data.data(), 1, data.size(), file) != data.size())
+                data.clear();
+        }
+
+        fclose(file);
+
+        return !data.empty();
+    }
+
+    static inline void Store(const char* path, const PrewarmListCallbacks& callbacks, const std::vector<uint8_t>& data)
+    {
+        if (callbacks.Store)
+        {
+            callbacks.Store(callbacks.userArg, data.data(), data.size());
+            return;
+        }
+
+        if (!path || !*path)
+            return;
+
+        FILE* file = fopen(path, "wb");
+        if (!file)
+            return;
+
+        fwrite(data.data(), 1, data.size(), file);
+        fclose(file);
+    }
+
+private:
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t key;
+        uint64_t shaderHashesNum;
+        uint64_t checksum;
+    };
+
+    static constexpr uint32_t MAGIC = 0x4344524E; // "NRDC"
+    static constexpr uint32_t VERSION = 1;
+};
+
+}
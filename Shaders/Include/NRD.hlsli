@@ -78,6 +78,7 @@ NOISY INPUTS:
 // ( Optional ) Bindings
 #define NRD_CONSTANT_BUFFER_SPACE_INDEX                                                 0
 #define NRD_CONSTANT_BUFFER_REGISTER_INDEX                                              0
+#define NRD_ROOT_CONSTANTS_REGISTER_INDEX                                               1 // root (push) constants, the space is shared with the constant buffer
 
 #define NRD_SAMPLERS_SPACE_INDEX                                                        0 // TODO: better keep in a separate space for sharing
 
@@ -239,6 +240,22 @@ NOISY INPUTS:
 
 #endif
 
+// Root constants ( "push constants" in VK ), accessible via "gRootConstants" (a custom engine can define these macros too)
+#ifndef NRD_ROOT_CONSTANTS_START
+    #define NRD_ROOT_CONSTANTS_START( resourceName )                                    struct resourceName {
+    #define NRD_ROOT_CONSTANT( constantType, constantName )                             constantType constantName;
+
+    #if( defined( NRD_COMPILER_DXC ) && defined( __spirv__ ) )
+        #define NRD_ROOT_CONSTANTS_END( resourceName )                                  }; [[vk::push_constant]] resourceName gRootConstants;
+    #elif( defined( NRD_COMPILER_DXC ) )
+        #define NRD_ROOT_CONSTANTS_END( resourceName )                                  }; ConstantBuffer<resourceName> gRootConstants : register( NRD_MERGE_TOKENS( b, NRD_ROOT_CONSTANTS_REGISTER_INDEX ), NRD_MERGE_TOKENS( space, NRD_CONSTANT_BUFFER_SPACE_INDEX ) );
+    #elif( defined( NRD_COMPILER_UNREAL_ENGINE ) )
+        #define NRD_ROOT_CONSTANTS_END( resourceName )                                  }; resourceName gRootConstants;
+    #else
+        #define NRD_ROOT_CONSTANTS_END( resourceName )                                  }; cbuffer NRD_MERGE_TOKENS( resourceName, Buffer ) : register( NRD_MERGE_TOKENS( b, NRD_ROOT_CONSTANTS_REGISTER_INDEX ) ) { resourceName gRootConstants; };
+    #endif
+#endif
+
 //=================================================================================================================================
 // GLSL
 //=================================================================================================================================
@@ -31,9 +31,9 @@ NRD_EXPORT void NRD_CS_MAIN( NRD_CS_MAIN_ARGS )
 
     // Diffuse normal weight is used for diffuse and can be used for specular depending on settings.
     // Weight strictness is higher as the Atrous step size increases.
-    float diffuseLobeAngleFraction = gLobeAngleFraction / sqrt(gStepSize);
+    float diffuseLobeAngleFraction = gLobeAngleFraction / sqrt(gRootConstants.gStepSize);
     #ifdef RELAX_SH
-        diffuseLobeAngleFraction = 1.0 / sqrt(gStepSize);
+        diffuseLobeAngleFraction = 1.0 / sqrt(gRootConstants.gStepSize);
     #endif
     diffuseLobeAngleFraction = lerp(0.99, diffuseLobeAngleFraction, saturate(historyLength / 5.0));
 
@@ -49,7 +49,7 @@ NRD_EXPORT void NRD_CS_MAIN( NRD_CS_MAIN_ARGS )
 
     float specularReprojectionConfidence = gIn_SpecReprojectionConfidence[pixelPos];
     float specularLuminanceWeightRelaxation = 1.0;
-    if (gStepSize <= 4)
+    if (gRootConstants.gStepSize <= 4)
         specularLuminanceWeightRelaxation = lerp(1.0, specularReprojectionConfidence, gLuminanceEdgeStoppingRelaxation);
 
     if (gHasHistoryConfidence && NRD_USE_HISTORY_CONFIDENCE)
@@ -121,10 +121,10 @@ NRD_EXPORT void NRD_CS_MAIN( NRD_CS_MAIN_ARGS )
 
     // Adding random offsets to minimize "ringing" at large A-Trous steps
     int2 offset = 0;
-    if (gStepSize > 4)
+    if (gRootConstants.gStepSize > 4)
     {
         Rng::Hash::Initialize(pixelPos, gFrameIndex);
-        offset = int2(gStepSize.xx * 0.5 * (Rng::Hash::GetFloat2() - 0.5));
+        offset = int2(gRootConstants.gStepSize.xx * 0.5 * (Rng::Hash::GetFloat2() - 0.5));
     }
 
     [unroll]
@@ -133,7 +133,7 @@ NRD_EXPORT void NRD_CS_MAIN( NRD_CS_MAIN_ARGS )
         [unroll]
         for (int xx = -1; xx <= 1; xx++)
         {
-            int2 p = pixelPos + offset + int2(xx, yy) * gStepSize;
+            int2 p = pixelPos + offset + int2(xx, yy) * gRootConstants.gStepSize;
             bool isCenter = ((xx == 0) && (yy == 0));
             if (isCenter)
                 continue;
@@ -223,7 +223,7 @@ NRD_EXPORT void NRD_CS_MAIN( NRD_CS_MAIN_ARGS )
     float4 filteredSpecularIlluminationAndVariance = float4(sumSpecularIlluminationAndVariance / float4(sumWSpecular.xxx, sumWSpecular * sumWSpecular));
     #ifdef RELAX_SH
         // Luminance output is expected in YCoCg color space in SH mode, converting to YCoCg in last A-Trous pass
-        if (gIsLastPass == 1)
+        if (gRootConstants.gIsLastPass == 1)
             filteredSpecularIlluminationAndVariance.rgb = _NRD_LinearToYCoCg(filteredSpecularIlluminationAndVariance.rgb);
         gOut_SpecSh[pixelPos] = float4(sumSpecularSH.rgb / sumWSpecular, roughnessModified);
     #endif
@@ -234,7 +234,7 @@ NRD_EXPORT void NRD_CS_MAIN( NRD_CS_MAIN_ARGS )
     float4 filteredDiffuseIlluminationAndVariance = float4(sumDiffuseIlluminationAndVariance / float4(sumWDiffuse.xxx, sumWDiffuse * sumWDiffuse));
     #ifdef RELAX_SH
         // Luminance output is expected in YCoCg color space in SH mode, converting to YCoCg in last A-Trous pass
-        if (gIsLastPass == 1)
+        if (gRootConstants.gIsLastPass == 1)
             filteredDiffuseIlluminationAndVariance.rgb = _NRD_LinearToYCoCg(filteredDiffuseIlluminationAndVariance.rgb);
         gOut_DiffSh[pixelPos] = sumDiffuseSH / sumWDiffuse;
     #endif
@@ -10,10 +10,13 @@ license agreement from NVIDIA CORPORATION is strictly prohibited.
 
 NRD_CONSTANTS_START( REBLUR_ValidationConstants )
     REBLUR_SHARED_CONSTANTS
-    NRD_CONSTANT( uint, gHasDiffuse )
-    NRD_CONSTANT( uint, gHasSpecular )
 NRD_CONSTANTS_END
 
+NRD_ROOT_CONSTANTS_START( REBLUR_ValidationRootConstants )
+    NRD_ROOT_CONSTANT( uint, gHasDiffuse )
+    NRD_ROOT_CONSTANT( uint, gHasSpecular )
+NRD_ROOT_CONSTANTS_END( REBLUR_ValidationRootConstants )
+
 NRD_SAMPLERS_START
     NRD_SAMPLER( SamplerState, gNearestClamp, s, 0 )
     NRD_SAMPLER( SamplerState, gLinearClamp, s, 1 )
@@ -10,10 +10,13 @@ license agreement from NVIDIA CORPORATION is strictly prohibited.
 
 NRD_CONSTANTS_START( RELAX_AtrousConstants )
     RELAX_SHARED_CONSTANTS
-    NRD_CONSTANT( uint, gStepSize )
-    NRD_CONSTANT( uint, gIsLastPass )
 NRD_CONSTANTS_END
 
+NRD_ROOT_CONSTANTS_START( RELAX_AtrousRootConstants )
+    NRD_ROOT_CONSTANT( uint, gStepSize )
+    NRD_ROOT_CONSTANT( uint, gIsLastPass )
+NRD_ROOT_CONSTANTS_END( RELAX_AtrousRootConstants )
+
 NRD_SAMPLERS_START
     NRD_SAMPLER( SamplerState, gNearestClamp, s, 0 )
     NRD_SAMPLER( SamplerState, gLinearClamp, s, 1 )
@@ -10,8 +10,6 @@ license agreement from NVIDIA CORPORATION is strictly prohibited.
 
 NRD_CONSTANTS_START( RELAX_AtrousSmemConstants )
     RELAX_SHARED_CONSTANTS
-    NRD_CONSTANT( uint, gStepSize )
-    NRD_CONSTANT( uint, gIsLastPass )
 NRD_CONSTANTS_END
 
 NRD_SAMPLERS_START
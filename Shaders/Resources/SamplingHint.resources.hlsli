@@ -0,0 +1,48 @@
+/*
+Copyright (c) 2022, NVIDIA CORPORATION. All rights reserved.
+
+NVIDIA CORPORATION and its licensors retain all intellectual property
+and proprietary rights in and to this software, related documentation
+and any modifications thereto. Any use, reproduction, disclosure or
+distribution of this software and related documentation without an express
+license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+NRD_CONSTANTS_START( SamplingHintConstants )
+    NRD_CONSTANT( uint2, gRectOrigin )
+    NRD_CONSTANT( uint2, gRectSize )
+    NRD_CONSTANT( float2, gMaxAccumulatedFrameNum ) // diffuse, specular
+    NRD_CONSTANT( float, gHistoryLengthScale ) // normalized history length => frames
+    NRD_CONSTANT( float, gDenoisingRange )
+    NRD_CONSTANT( float, gViewZScale )
+    NRD_CONSTANT( float, gDebug ) // only for availability in Common.hlsl
+NRD_CONSTANTS_END
+
+NRD_ROOT_CONSTANTS_START( SamplingHintRootConstants )
+    NRD_ROOT_CONSTANT( uint, gHasDiffuse )
+    NRD_ROOT_CONSTANT( uint, gHasSpecular )
+    NRD_ROOT_CONSTANT( uint, gIsReblur ) // YCoCg radiance, separate history length for diffuse and specular
+NRD_ROOT_CONSTANTS_END( SamplingHintRootConstants )
+
+NRD_INPUTS_START
+    NRD_INPUT( Texture2D<float>, gIn_ViewZ, t, 0 )
+    NRD_INPUT( Texture2D<float2>, gIn_HistoryLength, t, 1 )
+    NRD_INPUT( Texture2D<float4>, gIn_Diff, t, 2 )
+    NRD_INPUT( Texture2D<float4>, gIn_Spec, t, 3 )
+    NRD_INPUT( Texture2D<float4>, gIn_DiffDenoised, t, 4 )
+    NRD_INPUT( Texture2D<float4>, gIn_SpecDenoised, t, 5 )
+NRD_INPUTS_END
+
+NRD_OUTPUTS_START
+    NRD_OUTPUT( RWTexture2D<float>, gOut_SamplingHint, u, 0 )
+NRD_OUTPUTS_END
+
+// Macro magic
+#define SamplingHintGroupX 16 // a tile, processed by 8x4 threads
+#define SamplingHintGroupY 16
+
+// Redirection
+#undef GROUP_X
+#undef GROUP_Y
+#define GROUP_X SamplingHintGroupX
+#define GROUP_Y SamplingHintGroupY
@@ -0,0 +1,45 @@
+/*
+Copyright (c) 2022, NVIDIA CORPORATION. All rights reserved.
+
+NVIDIA CORPORATION and its licensors retain all intellectual property
+and proprietary rights in and to this software, related documentation
+and any modifications thereto. Any use, reproduction, disclosure or
+distribution of this software and related documentation without an express
+license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+NRD_CONSTANTS_START( UpscaleConstants )
+    NRD_CONSTANT( float2, gRectSize )
+    NRD_CONSTANT( float2, gOutputSizeInv )
+    NRD_CONSTANT( float2, gJitter )
+    NRD_CONSTANT( uint2, gOutputSize )
+    NRD_CONSTANT( float, gDenoisingRange )
+    NRD_CONSTANT( float, gViewZScale )
+    NRD_CONSTANT( float, gDebug ) // only for availability in Common.hlsl
+NRD_CONSTANTS_END
+
+NRD_ROOT_CONSTANTS_START( UpscaleRootConstants )
+    NRD_ROOT_CONSTANT( uint, gHasDiffuse )
+    NRD_ROOT_CONSTANT( uint, gHasSpecular )
+NRD_ROOT_CONSTANTS_END( UpscaleRootConstants )
+
+NRD_INPUTS_START
+    NRD_INPUT( Texture2D<float>, gIn_ViewZ, t, 0 )
+    NRD_INPUT( Texture2D<float4>, gIn_Diff, t, 1 )
+    NRD_INPUT( Texture2D<float4>, gIn_Spec, t, 2 )
+NRD_INPUTS_END
+
+NRD_OUTPUTS_START
+    NRD_OUTPUT( RWTexture2D<float4>, gOut_Diff, u, 0 )
+    NRD_OUTPUT( RWTexture2D<float4>, gOut_Spec, u, 1 )
+NRD_OUTPUTS_END
+
+// Macro magic
+#define UpscaleGroupX 16
+#define UpscaleGroupY 16
+
+// Redirection
+#undef GROUP_X
+#undef GROUP_Y
+#define GROUP_X UpscaleGroupX
+#define GROUP_Y UpscaleGroupY
@@ -55,7 +55,7 @@ NRD_EXPORT void NRD_CS_MAIN( NRD_CS_MAIN_ARGS )
 
     // See "UnpackData1"
     REBLUR_DATA1_TYPE data1 = gIn_Data1.SampleLevel( gNearestClamp, viewportUvScaled, 0 );
-    if( !gHasDiffuse )
+    if( !gRootConstants.gHasDiffuse )
         data1.y = data1.x;
     data1 *= REBLUR_MAX_ACCUM_FRAME_NUM;
 
@@ -236,7 +236,7 @@ NRD_EXPORT void NRD_CS_MAIN( NRD_CS_MAIN_ARGS )
         result.w = 1.0;
     }
     // Virtual history
-    else if( viewportIndex == 7 && gHasSpecular )
+    else if( viewportIndex == 7 && gRootConstants.gHasSpecular )
     {
         Text::Print_ch( 'V', textState );
         Text::Print_ch( 'I', textState );
@@ -258,7 +258,7 @@ NRD_EXPORT void NRD_CS_MAIN( NRD_CS_MAIN_ARGS )
         result.w = 1.0;
     }
     // Diffuse frames
-    else if( viewportIndex == 8 && gHasDiffuse )
+    else if( viewportIndex == 8 && gRootConstants.gHasDiffuse )
     {
         Text::Print_ch( 'D', textState );
         Text::Print_ch( 'I', textState );
@@ -279,7 +279,7 @@ NRD_EXPORT void NRD_CS_MAIN( NRD_CS_MAIN_ARGS )
         result.w = 1.0;
     }
     // Specular frames
-    else if( viewportIndex == 11 && gHasSpecular )
+    else if( viewportIndex == 11 && gRootConstants.gHasSpecular )
     {
         Text::Print_ch( 'S', textState );
         Text::Print_ch( 'P', textState );
@@ -300,7 +300,7 @@ NRD_EXPORT void NRD_CS_MAIN( NRD_CS_MAIN_ARGS )
         result.w = 1.0;
     }
     // Diff hitT
-    else if( viewportIndex == 12 && gHasDiffuse )
+    else if( viewportIndex == 12 && gRootConstants.gHasDiffuse )
     {
         Text::Print_ch( 'D', textState );
         Text::Print_ch( 'I', textState );
@@ -321,7 +321,7 @@ NRD_EXPORT void NRD_CS_MAIN( NRD_CS_MAIN_ARGS )
         result.w = 1.0;
     }
     // Spec hitT
-    else if( viewportIndex == 15 && gHasSpecular )
+    else if( viewportIndex == 15 && gRootConstants.gHasSpecular )
     {
         Text::Print_ch( 'S', textState );
         Text::Print_ch( 'P', textState );
@@ -0,0 +1,31 @@
+/*
+Copyright (c) 2022, NVIDIA CORPORATION. All rights reserved.
+
+NVIDIA CORPORATION and its licensors retain all intellectual property
+and proprietary rights in and to this software, related documentation
+and any modifications thereto. Any use, reproduction, disclosure or
+distribution of this software and related documentation without an express
+license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "NRD.hlsli"
+#include "ml.hlsli"
+
+#include "Resample_Float.resources.hlsli"
+
+#include "Common.hlsli"
+
+// History resampling on resize: nearest, because history textures hold packed and non-linear data
+[numthreads( 16, 16, 1 )]
+NRD_EXPORT void NRD_CS_MAIN( NRD_CS_MAIN_ARGS )
+{
+    NRD_CTA_ORDER_DEFAULT;
+
+    if( any( uint2( pixelPos ) >= gRootConstants.gOutSize ) )
+        return;
+
+    uint2 pixelPosIn = ( uint2( pixelPos ) * 2 + 1 ) * gRootConstants.gInRectSize / ( gRootConstants.gOutSize * 2 );
+    pixelPosIn = min( pixelPosIn, gRootConstants.gInRectSize - 1 );
+
+    gOut[ pixelPos ] = gIn[ pixelPosIn ];
+}
@@ -0,0 +1,101 @@
+/*
+Copyright (c) 2022, NVIDIA CORPORATION. All rights reserved.
+
+NVIDIA CORPORATION and its licensors retain all intellectual property
+and proprietary rights in and to this software, related documentation
+and any modifications thereto. Any use, reproduction, disclosure or
+distribution of this software and related documentation without an express
+license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "NRD.hlsli"
+#include "ml.hlsli"
+
+#include "SamplingHint.resources.hlsli"
+
+#include "Common.hlsli"
+
+/*
+Output stage turning denoiser history into a per-tile (16x16) ray budget in [0; 1]:
+ - "frames" - accumulated frame number, "noise" - relative difference between noisy input and denoised output luminance
+ - per pixel: budget = max( 1 - frames / maxAccumulatedFrameNum, noise / sqrt( 1 + frames ) ), max of diffuse and specular
+ - i.e. disoccluded pixels ask for all rays, converged pixels ask for rays proportionally to the residual error of the accumulated estimate
+ - per tile: average over pixels inside of the denoising range, 0 if there are no such pixels
+*/
+
+#define SAMPLING_HINT_MAX_NOISE 4.0 // relative
+
+groupshared uint s_Sum;
+groupshared uint s_Num;
+
+float GetLuminance( float4 radiance )
+{
+    return gRootConstants.gIsReblur ? radiance.x : Color::Luminance( radiance.xyz );
+}
+
+float GetBudget( float4 noisy, float4 denoised, float frames, float maxAccumulatedFrameNum )
+{
+    float noisyLum = GetLuminance( noisy );
+    float denoisedLum = GetLuminance( denoised );
+
+    float noise = min( abs( noisyLum - denoisedLum ) / max( denoisedLum, NRD_EPS ), SAMPLING_HINT_MAX_NOISE );
+    float lag = 1.0 - saturate( frames / max( maxAccumulatedFrameNum, 1.0 ) );
+
+    return saturate( max( lag, noise * rsqrt( 1.0 + frames ) ) );
+}
+
+[numthreads( 8, 4, 1 )]
+NRD_EXPORT void NRD_CS_MAIN( uint2 threadPos : SV_GroupThreadId, uint2 tilePos : SV_GroupId, uint threadIndex : SV_GroupIndex )
+{
+    if( threadIndex == 0 )
+    {
+        s_Sum = 0;
+        s_Num = 0;
+    }
+
+    GroupMemoryBarrierWithGroupSync();
+
+    uint2 pixelPos = tilePos * 16 + threadPos * uint2( 2, 4 );
+    uint sum = 0;
+    uint num = 0;
+
+    [unroll]
+    for( uint i = 0; i < 2; i++ )
+    {
+        [unroll]
+        for( uint j = 0; j < 4; j++ )
+        {
+            uint2 pos = pixelPos + uint2( i, j );
+            if( any( pos >= gRectSize ) )
+                continue;
+
+            float viewZ = UnpackViewZ( gIn_ViewZ[ WithRectOrigin( pos ) ] );
+            if( viewZ > gDenoisingRange )
+                continue;
+
+            float2 frames = gIn_HistoryLength[ pos ] * gHistoryLengthScale;
+            float budget = 0.0;
+
+            if( gRootConstants.gHasDiffuse )
+                budget = GetBudget( gIn_Diff[ pos ], gIn_DiffDenoised[ pos ], frames.x, gMaxAccumulatedFrameNum.x );
+
+            // REBLUR: specular is in ".y" if diffuse is present, RELAX: history length is shared
+            if( gRootConstants.gHasSpecular )
+            {
+                float specFrames = ( gRootConstants.gIsReblur && gRootConstants.gHasDiffuse ) ? frames.y : frames.x;
+                budget = max( budget, GetBudget( gIn_Spec[ pos ], gIn_SpecDenoised[ pos ], specFrames, gMaxAccumulatedFrameNum.y ) );
+            }
+
+            sum += uint( budget * 255.0 + 0.5 );
+            num++;
+        }
+    }
+
+    InterlockedAdd( s_Sum, sum );
+    InterlockedAdd( s_Num, num );
+
+    GroupMemoryBarrierWithGroupSync();
+
+    if( threadIndex == 0 )
+        gOut_SamplingHint[ tilePos ] = s_Num ? float( s_Sum ) / ( 255.0 * float( s_Num ) ) : 0.0;
+}
@@ -0,0 +1,97 @@
+/*
+Copyright (c) 2022, NVIDIA CORPORATION. All rights reserved.
+
+NVIDIA CORPORATION and its licensors retain all intellectual property
+and proprietary rights in and to this software, related documentation
+and any modifications thereto. Any use, reproduction, disclosure or
+distribution of this software and related documentation without an express
+license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "NRD.hlsli"
+#include "ml.hlsli"
+
+#include "Upscale.resources.hlsli"
+
+#include "Common.hlsli"
+
+/*
+Output stage upscaling the denoised (temporally stable) signal from "rectSize" to "outputSize":
+ - Catmull-Rom (4x4) around the jittered sample position, taps outside of the denoising range are excluded
+ - anti-ringing: the result is clamped to the range of the closest 2x2 taps
+Both REBLUR and RELAX outputs are linear encodings, i.e. packed values are filtered directly
+*/
+
+[numthreads( GROUP_X, GROUP_Y, 1 )]
+NRD_EXPORT void NRD_CS_MAIN( NRD_CS_MAIN_ARGS )
+{
+    NRD_CTA_ORDER_DEFAULT;
+
+    if( any( uint2( pixelPos ) >= gOutputSize ) )
+        return;
+
+    // Sample "i" lives at "i + 0.5 + jitter"
+    float2 samplePos = ( float2( pixelPos ) + 0.5 ) * gOutputSizeInv * gRectSize - gJitter;
+    float2 centerPos = floor( samplePos - 0.5 );
+    float2 f = saturate( samplePos - 0.5 - centerPos );
+
+    float2 w[ 4 ];
+    w[ 0 ] = f * ( f * ( -NRD_CATROM_SHARPNESS * f + 2.0 * NRD_CATROM_SHARPNESS ) - NRD_CATROM_SHARPNESS );
+    w[ 1 ] = f * ( f * ( ( 2.0 - NRD_CATROM_SHARPNESS ) * f - ( 3.0 - NRD_CATROM_SHARPNESS ) ) ) + 1.0;
+    w[ 2 ] = f * ( f * ( -( 2.0 - NRD_CATROM_SHARPNESS ) * f + ( 3.0 - 2.0 * NRD_CATROM_SHARPNESS ) ) + NRD_CATROM_SHARPNESS );
+    w[ 3 ] = f * ( f * ( NRD_CATROM_SHARPNESS * f - NRD_CATROM_SHARPNESS ) );
+
+    int2 rectSizeMinusOne = int2( gRectSize ) - 1;
+
+    float4 diff = 0;
+    float4 spec = 0;
+    float4 diffMin = NRD_INF;
+    float4 diffMax = -NRD_INF;
+    float4 specMin = NRD_INF;
+    float4 specMax = -NRD_INF;
+    float sum = 0;
+
+    [unroll]
+    for( int j = 0; j < 4; j++ )
+    {
+        [unroll]
+        for( int i = 0; i < 4; i++ )
+        {
+            int2 pos = clamp( int2( centerPos ) + int2( i - 1, j - 1 ), 0, rectSizeMinusOne );
+
+            float viewZ = UnpackViewZ( gIn_ViewZ[ pos ] );
+            float weight = w[ i ].x * w[ j ].y * float( viewZ < gDenoisingRange );
+            bool isFootprint = i == 1 || i == 2 ? ( j == 1 || j == 2 ) && viewZ < gDenoisingRange : false;
+
+            if( gRootConstants.gHasDiffuse )
+            {
+                float4 s = gIn_Diff[ pos ];
+                diff += s * weight;
+                diffMin = isFootprint ? min( diffMin, s ) : diffMin;
+                diffMax = isFootprint ? max( diffMax, s ) : diffMax;
+            }
+
+            if( gRootConstants.gHasSpecular )
+            {
+                float4 s = gIn_Spec[ pos ];
+                spec += s * weight;
+                specMin = isFootprint ? min( specMin, s ) : specMin;
+                specMax = isFootprint ? max( specMax, s ) : specMax;
+            }
+
+            sum += weight;
+        }
+    }
+
+    // Nothing valid in the footprint (outside of the denoising range) - fall back to the nearest sample
+    bool isValid = sum > 0.0001 && ( diffMin.x != NRD_INF || specMin.x != NRD_INF );
+    float invSum = isValid ? 1.0 / sum : 0.0;
+
+    int2 nearestPos = clamp( int2( samplePos ), 0, rectSizeMinusOne );
+
+    if( gRootConstants.gHasDiffuse )
+        gOut_Diff[ pixelPos ] = isValid ? clamp( diff * invSum, diffMin, diffMax ) : gIn_Diff[ nearestPos ];
+
+    if( gRootConstants.gHasSpecular )
+        gOut_Spec[ pixelPos ] = isValid ? clamp( spec * invSum, specMin, specMax ) : gIn_Spec[ nearestPos ];
+}
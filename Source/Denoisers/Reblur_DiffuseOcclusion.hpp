@@ -25,10 +25,10 @@ void nrd::InstanceImpl::Add_ReblurDiffuseOcclusion(DenoiserData& denoiserData)
         DIFF_FAST_HISTORY,
     };
 
-    AddTextureToPermanentPool( {REBLUR_FORMAT_PREV_VIEWZ, 1} );
-    AddTextureToPermanentPool( {REBLUR_FORMAT_PREV_NORMAL_ROUGHNESS, 1} );
-    AddTextureToPermanentPool( {REBLUR_FORMAT_PREV_INTERNAL_DATA, 1} );
-    AddTextureToPermanentPool( {REBLUR_FORMAT_OCCLUSION_FAST_HISTORY, 1} );
+    AddTextureToPermanentPool( PREV_VIEWZ, REBLUR_FORMAT_PREV_VIEWZ, 1 );
+    AddTextureToPermanentPool( PREV_NORMAL_ROUGHNESS, REBLUR_FORMAT_PREV_NORMAL_ROUGHNESS, 1 );
+    AddTextureToPermanentPool( PREV_INTERNAL_DATA, REBLUR_FORMAT_PREV_INTERNAL_DATA, 1 );
+    AddTextureToPermanentPool( DIFF_FAST_HISTORY, REBLUR_FORMAT_OCCLUSION_FAST_HISTORY, 1 );
 
     enum class Transient
     {
@@ -38,10 +38,10 @@ void nrd::InstanceImpl::Add_ReblurDiffuseOcclusion(DenoiserData& denoiserData)
         TILES,
     };
 
-    AddTextureToTransientPool( {Format::R8_UNORM, 1} );
-    AddTextureToTransientPool( {REBLUR_FORMAT_OCCLUSION, 1} );
-    AddTextureToTransientPool( {REBLUR_FORMAT_OCCLUSION_FAST_HISTORY, 1} );
-    AddTextureToTransientPool( {REBLUR_FORMAT_TILES, 16} );
+    AddTextureToTransientPool( DATA1, Format::R8_UNORM, 1 );
+    AddTextureToTransientPool( DIFF_TMP2, REBLUR_FORMAT_OCCLUSION, 1 );
+    AddTextureToTransientPool( DIFF_FAST_HISTORY, REBLUR_FORMAT_OCCLUSION_FAST_HISTORY, 1 );
+    AddTextureToTransientPool( TILES, REBLUR_FORMAT_TILES, 16 );
 
     PushPass("Classify tiles");
     {
@@ -36,19 +36,19 @@ void nrd::InstanceImpl::Add_ReblurDiffuseSpecular(DenoiserData& denoiserData)
         SPEC_HITDIST_FOR_TRACKING_PONG,
     };
 
-    AddTextureToPermanentPool( {REBLUR_FORMAT_PREV_VIEWZ, 1} );
-    AddTextureToPermanentPool( {REBLUR_FORMAT_PREV_NORMAL_ROUGHNESS, 1} );
-    AddTextureToPermanentPool( {REBLUR_FORMAT_PREV_INTERNAL_DATA, 1} );
-    AddTextureToPermanentPool( {REBLUR_FORMAT, 1} );
-    AddTextureToPermanentPool( {REBLUR_FORMAT_FAST_HISTORY, 1} );
-    AddTextureToPermanentPool( {Format::R16_SFLOAT, 1} );
-    AddTextureToPermanentPool( {Format::R16_SFLOAT, 1} );
-    AddTextureToPermanentPool( {REBLUR_FORMAT, 1} );
-    AddTextureToPermanentPool( {REBLUR_FORMAT_FAST_HISTORY, 1} );
-    AddTextureToPermanentPool( {Format::R16_SFLOAT, 1} );
-    AddTextureToPermanentPool( {Format::R16_SFLOAT, 1} );
-    AddTextureToPermanentPool( {REBLUR_FORMAT_HITDIST_FOR_TRACKING, 1} );
-    AddTextureToPermanentPool( {REBLUR_FORMAT_HITDIST_FOR_TRACKING, 1} );
+    AddTextureToPermanentPool( PREV_VIEWZ, REBLUR_FORMAT_PREV_VIEWZ, 1 );
+    AddTextureToPermanentPool( PREV_NORMAL_ROUGHNESS, REBLUR_FORMAT_PREV_NORMAL_ROUGHNESS, 1 );
+    AddTextureToPermanentPool( PREV_INTERNAL_DATA, REBLUR_FORMAT_PREV_INTERNAL_DATA, 1 );
+    AddTextureToPermanentPool( DIFF_HISTORY, REBLUR_FORMAT, 1 );
+    AddTextureToPermanentPool( DIFF_FAST_HISTORY, REBLUR_FORMAT_FAST_HISTORY, 1 );
+    AddTextureToPermanentPool( DIFF_HISTORY_STABILIZED_PING, Format::R16_SFLOAT, 1 );
+    AddTextureToPermanentPool( DIFF_HISTORY_STABILIZED_PONG, Format::R16_SFLOAT, 1 );
+    AddTextureToPermanentPool( SPEC_HISTORY, REBLUR_FORMAT, 1 );
+    AddTextureToPermanentPool( SPEC_FAST_HISTORY, REBLUR_FORMAT_FAST_HISTORY, 1 );
+    AddTextureToPermanentPool( SPEC_HISTORY_STABILIZED_PING, Format::R16_SFLOAT, 1 );
+    AddTextureToPermanentPool( SPEC_HISTORY_STABILIZED_PONG, Format::R16_SFLOAT, 1 );
+    AddTextureToPermanentPool( SPEC_HITDIST_FOR_TRACKING_PING, REBLUR_FORMAT_HITDIST_FOR_TRACKING, 1 );
+    AddTextureToPermanentPool( SPEC_HITDIST_FOR_TRACKING_PONG, REBLUR_FORMAT_HITDIST_FOR_TRACKING, 1 );
 
     enum class Transient
     {
@@ -62,14 +62,14 @@ void nrd::InstanceImpl::Add_ReblurDiffuseSpecular(DenoiserData& denoiserData)
         TILES,
     };
 
-    AddTextureToTransientPool( {Format::RG8_UNORM, 1} );
-    AddTextureToTransientPool( {Format::R32_UINT, 1} );
-    AddTextureToTransientPool( {REBLUR_FORMAT_HITDIST_FOR_TRACKING, 1} );
-    AddTextureToTransientPool( {REBLUR_FORMAT, 1} );
-    AddTextureToTransientPool( {REBLUR_FORMAT_FAST_HISTORY, 1} );
-    AddTextureToTransientPool( {REBLUR_FORMAT, 1} );
-    AddTextureToTransientPool( {REBLUR_FORMAT_FAST_HISTORY, 1} );
-    AddTextureToTransientPool( {REBLUR_FORMAT_TILES, 16} );
+    AddTextureToTransientPool( DATA1, Format::RG8_UNORM, 1 );
+    AddTextureToTransientPool( DATA2, Format::R32_UINT, 1 );
+    AddTextureToTransientPool( SPEC_HITDIST_FOR_TRACKING, REBLUR_FORMAT_HITDIST_FOR_TRACKING, 1 );
+    AddTextureToTransientPool( DIFF_TMP2, REBLUR_FORMAT, 1 );
+    AddTextureToTransientPool( DIFF_FAST_HISTORY, REBLUR_FORMAT_FAST_HISTORY, 1 );
+    AddTextureToTransientPool( SPEC_TMP2, REBLUR_FORMAT, 1 );
+    AddTextureToTransientPool( SPEC_FAST_HISTORY, REBLUR_FORMAT_FAST_HISTORY, 1 );
+    AddTextureToTransientPool( TILES, REBLUR_FORMAT_TILES, 16 );
 
     PushPass("Classify tiles");
     {
@@ -315,6 +315,10 @@ void nrd::InstanceImpl::Add_ReblurDiffuseSpecular(DenoiserData& denoiserData)
 
     REBLUR_ADD_VALIDATION_DISPATCH( Transient::DATA2, ResourceType::IN_DIFF_RADIANCE_HITDIST, ResourceType::IN_SPEC_RADIANCE_HITDIST );
 
+    NRD_ADD_UPSCALE_DISPATCH( ResourceType::OUT_DIFF_RADIANCE_HITDIST, ResourceType::OUT_SPEC_RADIANCE_HITDIST, ResourceType::OUT_DIFF_RADIANCE_HITDIST_UPSCALED, ResourceType::OUT_SPEC_RADIANCE_HITDIST_UPSCALED );
+
+    NRD_ADD_SAMPLING_HINT_DISPATCH( Transient::DATA1, ResourceType::IN_DIFF_RADIANCE_HITDIST, ResourceType::IN_SPEC_RADIANCE_HITDIST, ResourceType::OUT_DIFF_RADIANCE_HITDIST, ResourceType::OUT_SPEC_RADIANCE_HITDIST );
+
     #undef DENOISER_NAME
     #undef DIFF_TEMP1
     #undef SPEC_TEMP1
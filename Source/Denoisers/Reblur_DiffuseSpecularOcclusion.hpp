@@ -30,13 +30,13 @@ void nrd::InstanceImpl::Add_ReblurDiffuseSpecularOcclusion(DenoiserData& denoise
         SPEC_HITDIST_FOR_TRACKING_PONG,
     };
 
-    AddTextureToPermanentPool( {REBLUR_FORMAT_PREV_VIEWZ, 1} );
-    AddTextureToPermanentPool( {REBLUR_FORMAT_PREV_NORMAL_ROUGHNESS, 1} );
-    AddTextureToPermanentPool( {REBLUR_FORMAT_PREV_INTERNAL_DATA, 1} );
-    AddTextureToPermanentPool( {REBLUR_FORMAT_OCCLUSION_FAST_HISTORY, 1} );
-    AddTextureToPermanentPool( {REBLUR_FORMAT_OCCLUSION_FAST_HISTORY, 1} );
-    AddTextureToPermanentPool( {REBLUR_FORMAT_HITDIST_FOR_TRACKING, 1} );
-    AddTextureToPermanentPool( {REBLUR_FORMAT_HITDIST_FOR_TRACKING, 1} );
+    AddTextureToPermanentPool( PREV_VIEWZ, REBLUR_FORMAT_PREV_VIEWZ, 1 );
+    AddTextureToPermanentPool( PREV_NORMAL_ROUGHNESS, REBLUR_FORMAT_PREV_NORMAL_ROUGHNESS, 1 );
+    AddTextureToPermanentPool( PREV_INTERNAL_DATA, REBLUR_FORMAT_PREV_INTERNAL_DATA, 1 );
+    AddTextureToPermanentPool( DIFF_FAST_HISTORY, REBLUR_FORMAT_OCCLUSION_FAST_HISTORY, 1 );
+    AddTextureToPermanentPool( SPEC_FAST_HISTORY, REBLUR_FORMAT_OCCLUSION_FAST_HISTORY, 1 );
+    AddTextureToPermanentPool( SPEC_HITDIST_FOR_TRACKING_PING, REBLUR_FORMAT_HITDIST_FOR_TRACKING, 1 );
+    AddTextureToPermanentPool( SPEC_HITDIST_FOR_TRACKING_PONG, REBLUR_FORMAT_HITDIST_FOR_TRACKING, 1 );
 
     enum class Transient
     {
@@ -48,12 +48,12 @@ void nrd::InstanceImpl::Add_ReblurDiffuseSpecularOcclusion(DenoiserData& denoise
         TILES,
     };
 
-    AddTextureToTransientPool( {Format::RG8_UNORM, 1} );
-    AddTextureToTransientPool( {REBLUR_FORMAT_OCCLUSION, 1} );
-    AddTextureToTransientPool( {REBLUR_FORMAT_OCCLUSION_FAST_HISTORY, 1} );
-    AddTextureToTransientPool( {REBLUR_FORMAT_OCCLUSION, 1} );
-    AddTextureToTransientPool( {REBLUR_FORMAT_OCCLUSION_FAST_HISTORY, 1} );
-    AddTextureToTransientPool( {REBLUR_FORMAT_TILES, 16} );
+    AddTextureToTransientPool( DATA1, Format::RG8_UNORM, 1 );
+    AddTextureToTransientPool( DIFF_TMP2, REBLUR_FORMAT_OCCLUSION, 1 );
+    AddTextureToTransientPool( DIFF_FAST_HISTORY, REBLUR_FORMAT_OCCLUSION_FAST_HISTORY, 1 );
+    AddTextureToTransientPool( SPEC_TMP2, REBLUR_FORMAT_OCCLUSION, 1 );
+    AddTextureToTransientPool( SPEC_FAST_HISTORY, REBLUR_FORMAT_OCCLUSION_FAST_HISTORY, 1 );
+    AddTextureToTransientPool( TILES, REBLUR_FORMAT_TILES, 16 );
 
     PushPass("Classify tiles");
     {
@@ -23,7 +23,7 @@ void nrd::InstanceImpl::Add_Reference(DenoiserData& denoiserData)
         HISTORY = PERMANENT_POOL_START,
     };
 
-    AddTextureToPermanentPool( {Format::RGBA32_SFLOAT, 1} );
+    AddTextureToPermanentPool( HISTORY, Format::RGBA32_SFLOAT, 1 );
 
     PushPass("Temporal accumulation");
     {
@@ -52,39 +52,44 @@ void nrd::InstanceImpl::Add_Reference(DenoiserData& denoiserData)
     #undef DENOISER_NAME
 }
 
-void nrd::InstanceImpl::Update_Reference(const DenoiserData& denoiserData)
+void nrd::InstanceImpl::Advance_Reference(DenoiserData& denoiserData, const DispatchContext& context)
 {
-    enum class Dispatch
-    {
-        ACCUMULATE,
-        COPY,
-    };
-
+    const ViewState& view = *context.view;
     const ReferenceSettings& settings = denoiserData.settings.reference;
 
-    if (m_WorldToClip != m_WorldToClipPrev || m_CommonSettings.accumulationMode != AccumulationMode::CONTINUE ||
-        m_CommonSettings.rectSize[0] != m_CommonSettings.rectSizePrev[0] ||
-        m_CommonSettings.rectSize[1] != m_CommonSettings.rectSizePrev[1]
+    if (view.worldToClip != view.worldToClipPrev || context.accumulationMode != AccumulationMode::CONTINUE ||
+        view.commonSettings.rectSize[0] != view.commonSettings.rectSizePrev[0] ||
+        view.commonSettings.rectSize[1] != view.commonSettings.rectSizePrev[1]
     )
-        m_AccumulatedFrameNum = 0;
+        denoiserData.accumulatedFrameNum = 0;
     else
     {
         uint32_t maxAccumulatedFRameNum = min(settings.maxAccumulatedFrameNum, REFERENCE_MAX_HISTORY_FRAME_NUM);
-        m_AccumulatedFrameNum = min(m_AccumulatedFrameNum + 1, maxAccumulatedFRameNum);
+        denoiserData.accumulatedFrameNum = min(denoiserData.accumulatedFrameNum + 1, maxAccumulatedFRameNum);
     }
+}
+
+void nrd::InstanceImpl::Update_Reference(const DenoiserData& denoiserData, DispatchContext& context)
+{
+    enum class Dispatch
+    {
+        ACCUMULATE,
+        COPY,
+    };
 
+    const ViewState& view = *context.view;
     NRD_DECLARE_DIMS;
 
     { // ACCUMULATE
-        REFERENCE_TemporalAccumulationConstants* consts = (REFERENCE_TemporalAccumulationConstants*)PushDispatch(denoiserData, AsUint(Dispatch::ACCUMULATE));
-        consts->gRectOrigin     = uint2(m_CommonSettings.rectOrigin[0], m_CommonSettings.rectOrigin[1]);
-        consts->gAccumSpeed     = 1.0f / (1.0f + m_AccumulatedFrameNum);
-        consts->gDebug          = m_CommonSettings.debug;
+        REFERENCE_TemporalAccumulationConstants* consts = (REFERENCE_TemporalAccumulationConstants*)PushDispatch(context, denoiserData, AsUint(Dispatch::ACCUMULATE));
+        consts->gRectOrigin     = uint2(view.commonSettings.rectOrigin[0], view.commonSettings.rectOrigin[1]);
+        consts->gAccumSpeed     = 1.0f / (1.0f + denoiserData.accumulatedFrameNum);
+        consts->gDebug          = view.commonSettings.debug;
     }
 
     { // COPY
-        REFERENCE_CopyConstants* consts = (REFERENCE_CopyConstants*)PushDispatch(denoiserData, AsUint(Dispatch::COPY));
+        REFERENCE_CopyConstants* consts = (REFERENCE_CopyConstants*)PushDispatch(context, denoiserData, AsUint(Dispatch::COPY));
         consts->gRectSizeInv    = float2(1.0f / float(rectW), 1.0f / float(rectH));
-        consts->gSplitScreen    = m_CommonSettings.splitScreen;
+        consts->gSplitScreen    = view.commonSettings.splitScreen;
     }
 }
@@ -29,16 +29,16 @@ void nrd::InstanceImpl::Add_RelaxDiffuseSpecular(DenoiserData& denoiserData)
         VIEWZ_PREV,
     };
 
-    AddTextureToPermanentPool( {Format::RGBA16_SFLOAT, 1} );
-    AddTextureToPermanentPool( {Format::RGBA16_SFLOAT, 1} );
-    AddTextureToPermanentPool( {Format::RGBA16_SFLOAT, 1} );
-    AddTextureToPermanentPool( {Format::RGBA16_SFLOAT, 1} );
-    AddTextureToPermanentPool( {Format::R16_SFLOAT, 1} );
-    AddTextureToPermanentPool( {Format::R16_SFLOAT, 1} );
-    AddTextureToPermanentPool( {Format::R8_UNORM, 1} );
-    AddTextureToPermanentPool( {Format::RGBA8_UNORM, 1} );
-    AddTextureToPermanentPool( {Format::R8_UNORM, 1} );
-    AddTextureToPermanentPool( {Format::R32_SFLOAT, 1} );
+    AddTextureToPermanentPool( SPEC_ILLUM_PREV, Format::RGBA16_SFLOAT, 1 );
+    AddTextureToPermanentPool( DIFF_ILLUM_PREV, Format::RGBA16_SFLOAT, 1 );
+    AddTextureToPermanentPool( SPEC_ILLUM_RESPONSIVE_PREV, Format::RGBA16_SFLOAT, 1 );
+    AddTextureToPermanentPool( DIFF_ILLUM_RESPONSIVE_PREV, Format::RGBA16_SFLOAT, 1 );
+    AddTextureToPermanentPool( REFLECTION_HIT_T_CURR, Format::R16_SFLOAT, 1 );
+    AddTextureToPermanentPool( REFLECTION_HIT_T_PREV, Format::R16_SFLOAT, 1 );
+    AddTextureToPermanentPool( HISTORY_LENGTH_PREV, Format::R8_UNORM, 1 );
+    AddTextureToPermanentPool( NORMAL_ROUGHNESS_PREV, Format::RGBA8_UNORM, 1 );
+    AddTextureToPermanentPool( MATERIAL_ID_PREV, Format::R8_UNORM, 1 );
+    AddTextureToPermanentPool( VIEWZ_PREV, Format::R32_SFLOAT, 1 );
 
     enum class Transient
     {
@@ -51,13 +51,13 @@ void nrd::InstanceImpl::Add_RelaxDiffuseSpecular(DenoiserData& denoiserData)
         HISTORY_LENGTH
     };
 
-    AddTextureToTransientPool( {Format::RGBA16_SFLOAT, 1} );
-    AddTextureToTransientPool( {Format::RGBA16_SFLOAT, 1} );
-    AddTextureToTransientPool( {Format::RGBA16_SFLOAT, 1} );
-    AddTextureToTransientPool( {Format::RGBA16_SFLOAT, 1} );
-    AddTextureToTransientPool( {Format::R8_UNORM, 1} );
-    AddTextureToTransientPool( {Format::R8_UNORM, 16} );
-    AddTextureToTransientPool( {Format::R8_UNORM, 1} );
+    AddTextureToTransientPool( SPEC_ILLUM_PING, Format::RGBA16_SFLOAT, 1 );
+    AddTextureToTransientPool( SPEC_ILLUM_PONG, Format::RGBA16_SFLOAT, 1 );
+    AddTextureToTransientPool( DIFF_ILLUM_PING, Format::RGBA16_SFLOAT, 1 );
+    AddTextureToTransientPool( DIFF_ILLUM_PONG, Format::RGBA16_SFLOAT, 1 );
+    AddTextureToTransientPool( SPEC_REPROJECTION_CONFIDENCE, Format::R8_UNORM, 1 );
+    AddTextureToTransientPool( TILES, Format::R8_UNORM, 16 );
+    AddTextureToTransientPool( HISTORY_LENGTH, Format::R8_UNORM, 1 );
 
     PushPass("Classify tiles");
     {
@@ -293,7 +293,7 @@ void nrd::InstanceImpl::Add_RelaxDiffuseSpecular(DenoiserData& denoiserData)
                 if (isSmem)
                     AddDispatch( RELAX_DiffuseSpecular_AtrousSmem, RELAX_AtrousSmem, 1 );
                 else
-                    AddDispatchRepeated( RELAX_DiffuseSpecular_Atrous, RELAX_Atrous, 1, repeatNum );
+                    AddDispatchRepeatedWithRootConstants( RELAX_DiffuseSpecular_Atrous, RELAX_Atrous, 1, repeatNum );
             }
         }
     }
@@ -315,5 +315,9 @@ void nrd::InstanceImpl::Add_RelaxDiffuseSpecular(DenoiserData& denoiserData)
 
     RELAX_ADD_VALIDATION_DISPATCH;
 
+    NRD_ADD_UPSCALE_DISPATCH( ResourceType::OUT_DIFF_RADIANCE_HITDIST, ResourceType::OUT_SPEC_RADIANCE_HITDIST, ResourceType::OUT_DIFF_RADIANCE_HITDIST_UPSCALED, ResourceType::OUT_SPEC_RADIANCE_HITDIST_UPSCALED );
+
+    NRD_ADD_SAMPLING_HINT_DISPATCH( Transient::HISTORY_LENGTH, ResourceType::IN_DIFF_RADIANCE_HITDIST, ResourceType::IN_SPEC_RADIANCE_HITDIST, ResourceType::OUT_DIFF_RADIANCE_HITDIST, ResourceType::OUT_SPEC_RADIANCE_HITDIST );
+
     #undef DENOISER_NAME
 }
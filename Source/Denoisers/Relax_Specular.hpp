@@ -27,14 +27,14 @@ void nrd::InstanceImpl::Add_RelaxSpecular(DenoiserData& denoiserData)
         VIEWZ_PREV
     };
 
-    AddTextureToPermanentPool( {Format::RGBA16_SFLOAT, 1} );
-    AddTextureToPermanentPool( {Format::RGBA16_SFLOAT, 1} );
-    AddTextureToPermanentPool( {Format::R16_SFLOAT, 1} );
-    AddTextureToPermanentPool( {Format::R16_SFLOAT, 1} );
-    AddTextureToPermanentPool( {Format::R8_UNORM, 1} );
-    AddTextureToPermanentPool( {Format::RGBA8_UNORM, 1} );
-    AddTextureToPermanentPool( {Format::R8_UNORM, 1} );
-    AddTextureToPermanentPool( {Format::R32_SFLOAT, 1} );
+    AddTextureToPermanentPool( SPEC_ILLUM_PREV, Format::RGBA16_SFLOAT, 1 );
+    AddTextureToPermanentPool( SPEC_ILLUM_RESPONSIVE_PREV, Format::RGBA16_SFLOAT, 1 );
+    AddTextureToPermanentPool( REFLECTION_HIT_T_CURR, Format::R16_SFLOAT, 1 );
+    AddTextureToPermanentPool( REFLECTION_HIT_T_PREV, Format::R16_SFLOAT, 1 );
+    AddTextureToPermanentPool( HISTORY_LENGTH_PREV, Format::R8_UNORM, 1 );
+    AddTextureToPermanentPool( NORMAL_ROUGHNESS_PREV, Format::RGBA8_UNORM, 1 );
+    AddTextureToPermanentPool( MATERIAL_ID_PREV, Format::R8_UNORM, 1 );
+    AddTextureToPermanentPool( VIEWZ_PREV, Format::R32_SFLOAT, 1 );
 
     enum class Transient
     {
@@ -45,11 +45,11 @@ void nrd::InstanceImpl::Add_RelaxSpecular(DenoiserData& denoiserData)
         HISTORY_LENGTH
     };
 
-    AddTextureToTransientPool( {Format::RGBA16_SFLOAT, 1} );
-    AddTextureToTransientPool( {Format::RGBA16_SFLOAT, 1} );
-    AddTextureToTransientPool( {Format::R8_UNORM, 1} );
-    AddTextureToTransientPool( {Format::R8_UNORM, 16} );
-    AddTextureToTransientPool( {Format::R8_UNORM, 1} );
+    AddTextureToTransientPool( SPEC_ILLUM_PING, Format::RGBA16_SFLOAT, 1 );
+    AddTextureToTransientPool( SPEC_ILLUM_PONG, Format::RGBA16_SFLOAT, 1 );
+    AddTextureToTransientPool( SPEC_REPROJECTION_CONFIDENCE, Format::R8_UNORM, 1 );
+    AddTextureToTransientPool( TILES, Format::R8_UNORM, 16 );
+    AddTextureToTransientPool( HISTORY_LENGTH, Format::R8_UNORM, 1 );
 
     PushPass("Classify tiles");
     {
@@ -247,7 +247,7 @@ void nrd::InstanceImpl::Add_RelaxSpecular(DenoiserData& denoiserData)
                 if (isSmem)
                     AddDispatch( RELAX_Specular_AtrousSmem, RELAX_AtrousSmem, 1 );
                 else
-                    AddDispatchRepeated( RELAX_Specular_Atrous, RELAX_Atrous, 1, repeatNum );
+                    AddDispatchRepeatedWithRootConstants( RELAX_Specular_Atrous, RELAX_Atrous, 1, repeatNum );
             }
         }
     }
@@ -267,5 +267,9 @@ void nrd::InstanceImpl::Add_RelaxSpecular(DenoiserData& denoiserData)
 
     RELAX_ADD_VALIDATION_DISPATCH;
 
+    NRD_ADD_UPSCALE_DISPATCH( ResourceType::OUT_SPEC_RADIANCE_HITDIST, ResourceType::OUT_SPEC_RADIANCE_HITDIST, ResourceType::OUT_SPEC_RADIANCE_HITDIST_UPSCALED, ResourceType::OUT_SPEC_RADIANCE_HITDIST_UPSCALED );
+
+    NRD_ADD_SAMPLING_HINT_DISPATCH( Transient::HISTORY_LENGTH, ResourceType::IN_SPEC_RADIANCE_HITDIST, ResourceType::IN_SPEC_RADIANCE_HITDIST, ResourceType::OUT_SPEC_RADIANCE_HITDIST, ResourceType::OUT_SPEC_RADIANCE_HITDIST );
+
     #undef DENOISER_NAME
 }
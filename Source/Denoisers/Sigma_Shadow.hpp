@@ -20,7 +20,7 @@ void nrd::InstanceImpl::Add_SigmaShadow(DenoiserData& denoiserData)
         HISTORY_LENGTH = PERMANENT_POOL_START,
     };
 
-    AddTextureToPermanentPool( {Format::R32_UINT, 1} );
+    AddTextureToPermanentPool( HISTORY_LENGTH, Format::R32_UINT, 1 );
 
     enum class Transient
     {
@@ -34,14 +34,14 @@ void nrd::InstanceImpl::Add_SigmaShadow(DenoiserData& denoiserData)
         SMOOTHED_TILES,
     };
 
-    AddTextureToTransientPool( {Format::R16_SFLOAT, 1} );
-    AddTextureToTransientPool( {Format::R16_SFLOAT, 1} );
-    AddTextureToTransientPool( {Format::R8_UNORM, 1} );
-    AddTextureToTransientPool( {Format::R8_UNORM, 1} );
-    AddTextureToTransientPool( {Format::R8_UNORM, 1} );
-    AddTextureToTransientPool( {Format::R32_UINT, 1} );
-    AddTextureToTransientPool( {Format::RGBA8_UNORM, 16} );
-    AddTextureToTransientPool( {Format::RG8_UNORM, 16} );
+    AddTextureToTransientPool( DATA_1, Format::R16_SFLOAT, 1 );
+    AddTextureToTransientPool( DATA_2, Format::R16_SFLOAT, 1 );
+    AddTextureToTransientPool( TEMP_1, Format::R8_UNORM, 1 );
+    AddTextureToTransientPool( TEMP_2, Format::R8_UNORM, 1 );
+    AddTextureToTransientPool( HISTORY, Format::R8_UNORM, 1 );
+    AddTextureToTransientPool( HISTORY_LENGTH, Format::R32_UINT, 1 );
+    AddTextureToTransientPool( TILES, Format::RGBA8_UNORM, 16 );
+    AddTextureToTransientPool( SMOOTHED_TILES, Format::RG8_UNORM, 16 );
 
     PushPass("Classify tiles");
     {
@@ -10,9 +10,11 @@ license agreement from NVIDIA CORPORATION is strictly prohibited.
 
 #include "../Shaders/Include/NRD.hlsli"
 #include "InstanceImpl.h"
+#include "ShaderPack.h"
 
 #include <assert.h> // assert
 #include <array>
+#include <utility> // std::swap
 
 constexpr std::array<nrd::Sampler, (size_t)nrd::Sampler::MAX_NUM> g_Samplers =
 {
@@ -68,22 +70,160 @@ constexpr std::array<bool, (size_t)nrd::Format::MAX_NUM> g_IsIntegerFormat =
     false,        // R9_G9_B9_E5_UFLOAT
 };
 
+constexpr std::array<uint8_t, (size_t)nrd::Format::MAX_NUM> g_FormatBytesPerPixel =
+{
+    1,            // R8_UNORM
+    1,            // R8_SNORM
+    1,            // R8_UINT
+    1,            // R8_SINT
+    2,            // RG8_UNORM
+    2,            // RG8_SNORM
+    2,            // RG8_UINT
+    2,            // RG8_SINT
+    4,            // RGBA8_UNORM
+    4,            // RGBA8_SNORM
+    4,            // RGBA8_UINT
+    4,            // RGBA8_SINT
+    4,            // RGBA8_SRGB
+    2,            // R16_UNORM
+    2,            // R16_SNORM
+    2,            // R16_UINT
+    2,            // R16_SINT
+    2,            // R16_SFLOAT
+    4,            // RG16_UNORM
+    4,            // RG16_SNORM
+    4,            // RG16_UINT
+    4,            // RG16_SINT
+    4,            // RG16_SFLOAT
+    8,            // RGBA16_UNORM
+    8,            // RGBA16_SNORM
+    8,            // RGBA16_UINT
+    8,            // RGBA16_SINT
+    8,            // RGBA16_SFLOAT
+    4,            // R32_UINT
+    4,            // R32_SINT
+    4,            // R32_SFLOAT
+    8,            // RG32_UINT
+    8,            // RG32_SINT
+    8,            // RG32_SFLOAT
+    12,           // RGB32_UINT
+    12,           // RGB32_SINT
+    12,           // RGB32_SFLOAT
+    16,           // RGBA32_UINT
+    16,           // RGBA32_SINT
+    16,           // RGBA32_SFLOAT
+    4,            // R10_G10_B10_A2_UNORM
+    4,            // R10_G10_B10_A2_UINT
+    4,            // R11_G11_B10_UFLOAT
+    4,            // R9_G9_B9_E5_UFLOAT
+};
+
 #include "../Shaders/Resources/Clear_Float.resources.hlsli"
 #include "../Shaders/Resources/Clear_Uint.resources.hlsli"
+#include "../Shaders/Resources/Resample_Float.resources.hlsli"
+#include "../Shaders/Resources/Resample_Uint.resources.hlsli"
+#include "../Shaders/Resources/Upscale.resources.hlsli"
+#include "../Shaders/Resources/SamplingHint.resources.hlsli"
 
 #ifdef NRD_EMBEDS_DXBC_SHADERS
     #include "Clear_Float.cs.dxbc.h"
     #include "Clear_Uint.cs.dxbc.h"
+    #include "Resample_Float.cs.dxbc.h"
+    #include "Resample_Uint.cs.dxbc.h"
+    #include "Upscale.cs.dxbc.h"
+    #include "SamplingHint.cs.dxbc.h"
 #endif
 
 #ifdef NRD_EMBEDS_DXIL_SHADERS
     #include "Clear_Float.cs.dxil.h"
     #include "Clear_Uint.cs.dxil.h"
+    #include "Resample_Float.cs.dxil.h"
+    #include "Resample_Uint.cs.dxil.h"
+    #include "Upscale.cs.dxil.h"
+    #include "SamplingHint.cs.dxil.h"
 #endif
 
 #ifdef NRD_EMBEDS_SPIRV_SHADERS
     #include "Clear_Float.cs.spirv.h"
     #include "Clear_Uint.cs.spirv.h"
+    #include "Resample_Float.cs.spirv.h"
+    #include "Resample_Uint.cs.spirv.h"
+    #include "Upscale.cs.spirv.h"
+    #include "SamplingHint.cs.spirv.h"
+#endif
+
+#ifdef NRD_EMBEDS_COMPRESSED_SHADERS
+    #include "NRDShaderBlobs.h"
+
+// LZ4 block format
+static bool DecompressLz4(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize)
+{
+    const uint8_t* srcEnd = src + srcSize;
+    uint8_t* dstCur = dst;
+    uint8_t* dstEnd = dst + dstSize;
+
+    while (src < srcEnd)
+    {
+        uint8_t token = *src++;
+
+        // Literals
+        size_t literalNum = token >> 4;
+        if (literalNum == 15)
+        {
+            uint8_t b = 255;
+            while (b == 255 && src < srcEnd)
+            {
+                b = *src++;
+                literalNum += b;
+            }
+        }
+
+        if (literalNum > size_t(srcEnd - src) || literalNum > size_t(dstEnd - dstCur))
+            return false;
+
+        memcpy(dstCur, src, literalNum);
+        dstCur += literalNum;
+        src += literalNum;
+
+        // The last sequence has no match
+        if (src == srcEnd)
+            break;
+
+        // Match
+        if (srcEnd - src < 2)
+            return false;
+
+        size_t offset = src[0] | (src[1] << 8);
+        src += 2;
+
+        if (offset == 0 || offset > size_t(dstCur - dst))
+            return false;
+
+        size_t matchLength = token & 0xF;
+        if (matchLength == 15)
+        {
+            uint8_t b = 255;
+            while (b == 255 && src < srcEnd)
+            {
+                b = *src++;
+                matchLength += b;
+            }
+        }
+        matchLength += 4;
+
+        if (matchLength > size_t(dstEnd - dstCur))
+            return false;
+
+        // Can overlap
+        const uint8_t* match = dstCur - offset;
+        for (size_t i = 0; i < matchLength; i++)
+            dstCur[i] = match[i];
+
+        dstCur += matchLength;
+    }
+
+    return dstCur == dstEnd;
+}
 #endif
 
 inline bool IsInList(nrd::Identifier identifier, const nrd::Identifier* identifiers, uint32_t identifiersNum)
@@ -101,6 +241,13 @@ nrd::Result nrd::InstanceImpl::Create(const InstanceCreationDesc& instanceCreati
 {
     const LibraryDesc& libraryDesc = GetLibraryDesc();
 
+    m_ShaderPacks = instanceCreationDesc.shaderPacks;
+    m_ShaderPacksNum = instanceCreationDesc.shaderPacksNum;
+
+    uint32_t viewportsNum = instanceCreationDesc.viewportsNum ? instanceCreationDesc.viewportsNum : 1;
+    if (viewportsNum > 0xFFFF)
+        return Result::INVALID_ARGUMENT;
+
     // Collect dispatches from all denoisers
     for (uint32_t i = 0; i < instanceCreationDesc.denoisersNum; i++)
     {
@@ -116,6 +263,10 @@ nrd::Result nrd::InstanceImpl::Create(const InstanceCreationDesc& instanceCreati
         if (j == libraryDesc.supportedDenoisersNum)
             return Result::UNSUPPORTED;
 
+        // Check that viewport exists
+        if (denoiserDesc.viewportIndex >= viewportsNum)
+            return Result::INVALID_ARGUMENT;
+
         // Check that identifier is unique
         for (j = 0; j < instanceCreationDesc.denoisersNum; j++)
         {
@@ -136,48 +287,111 @@ nrd::Result nrd::InstanceImpl::Create(const InstanceCreationDesc& instanceCreati
 
         size_t resourceOffset = m_Resources.size();
 
-        if (denoiserDesc.denoiser == Denoiser::REBLUR_DIFFUSE)
-            Add_ReblurDiffuse(denoiserData);
-        else if (denoiserDesc.denoiser == Denoiser::REBLUR_DIFFUSE_OCCLUSION)
-            Add_ReblurDiffuseOcclusion(denoiserData);
-        else if (denoiserDesc.denoiser == Denoiser::REBLUR_DIFFUSE_SH)
-            Add_ReblurDiffuseSh(denoiserData);
-        else if (denoiserDesc.denoiser == Denoiser::REBLUR_SPECULAR)
-            Add_ReblurSpecular(denoiserData);
-        else if (denoiserDesc.denoiser == Denoiser::REBLUR_SPECULAR_OCCLUSION)
-            Add_ReblurSpecularOcclusion(denoiserData);
-        else if (denoiserDesc.denoiser == Denoiser::REBLUR_SPECULAR_SH)
-            Add_ReblurSpecularSh(denoiserData);
-        else if (denoiserDesc.denoiser == Denoiser::REBLUR_DIFFUSE_SPECULAR)
-            Add_ReblurDiffuseSpecular(denoiserData);
-        else if (denoiserDesc.denoiser == Denoiser::REBLUR_DIFFUSE_SPECULAR_OCCLUSION)
-            Add_ReblurDiffuseSpecularOcclusion(denoiserData);
-        else if (denoiserDesc.denoiser == Denoiser::REBLUR_DIFFUSE_SPECULAR_SH)
-            Add_ReblurDiffuseSpecularSh(denoiserData);
-        else if (denoiserDesc.denoiser == Denoiser::REBLUR_DIFFUSE_DIRECTIONAL_OCCLUSION)
-            Add_ReblurDiffuseDirectionalOcclusion(denoiserData);
-        else if (denoiserDesc.denoiser == Denoiser::RELAX_DIFFUSE)
-            Add_RelaxDiffuse(denoiserData);
-        else if (denoiserDesc.denoiser == Denoiser::RELAX_DIFFUSE_SH)
-            Add_RelaxDiffuseSh(denoiserData);
-        else if (denoiserDesc.denoiser == Denoiser::RELAX_SPECULAR)
-            Add_RelaxSpecular(denoiserData);
-        else if (denoiserDesc.denoiser == Denoiser::RELAX_SPECULAR_SH)
-            Add_RelaxSpecularSh(denoiserData);
-        else if (denoiserDesc.denoiser == Denoiser::RELAX_DIFFUSE_SPECULAR)
-            Add_RelaxDiffuseSpecular(denoiserData);
-        else if (denoiserDesc.denoiser == Denoiser::RELAX_DIFFUSE_SPECULAR_SH)
-            Add_RelaxDiffuseSpecularSh(denoiserData);
-        else if (denoiserDesc.denoiser == Denoiser::SIGMA_SHADOW)
-            Add_SigmaShadow(denoiserData);
-        else if (denoiserDesc.denoiser == Denoiser::SIGMA_SHADOW_TRANSLUCENCY)
-            Add_SigmaShadowTranslucency(denoiserData);
-        else if (denoiserDesc.denoiser == Denoiser::REFERENCE)
-            Add_Reference(denoiserData);
-        else // Should not be here
-            return Result::INVALID_ARGUMENT;
+        // Excluded denoisers are not in "LibraryDesc::supportedDenoisers", i.e. can't get here
+        switch (denoiserDesc.denoiser)
+        {
+#ifdef NRD_DENOISER_REBLUR_DIFFUSE
+            case Denoiser::REBLUR_DIFFUSE:
+                Add_ReblurDiffuse(denoiserData);
+                break;
+#endif
+#ifdef NRD_DENOISER_REBLUR_DIFFUSE_OCCLUSION
+            case Denoiser::REBLUR_DIFFUSE_OCCLUSION:
+                Add_ReblurDiffuseOcclusion(denoiserData);
+                break;
+#endif
+#ifdef NRD_DENOISER_REBLUR_DIFFUSE_SH
+            case Denoiser::REBLUR_DIFFUSE_SH:
+                Add_ReblurDiffuseSh(denoiserData);
+                break;
+#endif
+#ifdef NRD_DENOISER_REBLUR_SPECULAR
+            case Denoiser::REBLUR_SPECULAR:
+                Add_ReblurSpecular(denoiserData);
+                break;
+#endif
+#ifdef NRD_DENOISER_REBLUR_SPECULAR_OCCLUSION
+            case Denoiser::REBLUR_SPECULAR_OCCLUSION:
+                Add_ReblurSpecularOcclusion(denoiserData);
+                break;
+#endif
+#ifdef NRD_DENOISER_REBLUR_SPECULAR_SH
+            case Denoiser::REBLUR_SPECULAR_SH:
+                Add_ReblurSpecularSh(denoiserData);
+                break;
+#endif
+#ifdef NRD_DENOISER_REBLUR_DIFFUSE_SPECULAR
+            case Denoiser::REBLUR_DIFFUSE_SPECULAR:
+                Add_ReblurDiffuseSpecular(denoiserData);
+                break;
+#endif
+#ifdef NRD_DENOISER_REBLUR_DIFFUSE_SPECULAR_OCCLUSION
+            case Denoiser::REBLUR_DIFFUSE_SPECULAR_OCCLUSION:
+                Add_ReblurDiffuseSpecularOcclusion(denoiserData);
+                break;
+#endif
+#ifdef NRD_DENOISER_REBLUR_DIFFUSE_SPECULAR_SH
+            case Denoiser::REBLUR_DIFFUSE_SPECULAR_SH:
+                Add_ReblurDiffuseSpecularSh(denoiserData);
+                break;
+#endif
+#ifdef NRD_DENOISER_REBLUR_DIFFUSE_DIRECTIONAL_OCCLUSION
+            case Denoiser::REBLUR_DIFFUSE_DIRECTIONAL_OCCLUSION:
+                Add_ReblurDiffuseDirectionalOcclusion(denoiserData);
+                break;
+#endif
+#ifdef NRD_DENOISER_RELAX_DIFFUSE
+            case Denoiser::RELAX_DIFFUSE:
+                Add_RelaxDiffuse(denoiserData);
+                break;
+#endif
+#ifdef NRD_DENOISER_RELAX_DIFFUSE_SH
+            case Denoiser::RELAX_DIFFUSE_SH:
+                Add_RelaxDiffuseSh(denoiserData);
+                break;
+#endif
+#ifdef NRD_DENOISER_RELAX_SPECULAR
+            case Denoiser::RELAX_SPECULAR:
+                Add_RelaxSpecular(denoiserData);
+                break;
+#endif
+#ifdef NRD_DENOISER_RELAX_SPECULAR_SH
+            case Denoiser::RELAX_SPECULAR_SH:
+                Add_RelaxSpecularSh(denoiserData);
+                break;
+#endif
+#ifdef NRD_DENOISER_RELAX_DIFFUSE_SPECULAR
+            case Denoiser::RELAX_DIFFUSE_SPECULAR:
+                Add_RelaxDiffuseSpecular(denoiserData);
+                break;
+#endif
+#ifdef NRD_DENOISER_RELAX_DIFFUSE_SPECULAR_SH
+            case Denoiser::RELAX_DIFFUSE_SPECULAR_SH:
+                Add_RelaxDiffuseSpecularSh(denoiserData);
+                break;
+#endif
+#ifdef NRD_DENOISER_SIGMA_SHADOW
+            case Denoiser::SIGMA_SHADOW:
+                Add_SigmaShadow(denoiserData);
+                break;
+#endif
+#ifdef NRD_DENOISER_SIGMA_SHADOW_TRANSLUCENCY
+            case Denoiser::SIGMA_SHADOW_TRANSLUCENCY:
+                Add_SigmaShadowTranslucency(denoiserData);
+                break;
+#endif
+#ifdef NRD_DENOISER_REFERENCE
+            case Denoiser::REFERENCE:
+                Add_Reference(denoiserData);
+                break;
+#endif
+            default: // Should not be here
+                return Result::INVALID_ARGUMENT;
+        }
 
         denoiserData.pingPongNum = m_PingPongs.size() - denoiserData.pingPongOffset;
+        denoiserData.permanentPoolOffset = m_PermanentPoolOffset;
+        denoiserData.permanentPoolNum = uint16_t(m_PermanentPool.size() - m_PermanentPoolOffset);
 
         // Patch identifiers
         for (size_t dispatchIndex = denoiserData.dispatchOffset; dispatchIndex < m_Dispatches.size(); dispatchIndex++)
@@ -195,8 +409,9 @@ nrd::Result nrd::InstanceImpl::Create(const InstanceCreationDesc& instanceCreati
             if (resource.descriptorType != DescriptorType::STORAGE_TEXTURE)
                 continue;
 
-            // Skip "OUT_VALIDATION" resource because it can be not provided
-            if (resource.type == ResourceType::OUT_VALIDATION)
+            // Skip "OUT_VALIDATION", upscaled and sampling hint resources because they can be not provided
+            if (resource.type == ResourceType::OUT_VALIDATION || resource.type == ResourceType::OUT_DIFF_RADIANCE_HITDIST_UPSCALED || resource.type == ResourceType::OUT_SPEC_RADIANCE_HITDIST_UPSCALED
+                || resource.type == ResourceType::OUT_SAMPLING_HINT)
                 continue;
 
             // Keep only unique instances
@@ -225,7 +440,7 @@ nrd::Result nrd::InstanceImpl::Create(const InstanceCreationDesc& instanceCreati
                 }
 
                 // Add PING resource
-                m_ClearResources.push_back( {denoiserDesc.identifier, resource, downsampleFactor, isInteger} );
+                m_ClearResources.push_back( {denoiserDesc.identifier, resource, downsampleFactor, (uint16_t)denoiserDesc.viewportIndex, isInteger} );
 
                 // Add PONG resource
                 for (uint32_t p = 0; p < denoiserData.pingPongNum; p++)
@@ -234,7 +449,7 @@ nrd::Result nrd::InstanceImpl::Create(const InstanceCreationDesc& instanceCreati
                     if (pingPong.resourceIndex == (uint32_t)resourceIndex)
                     {
                         ResourceDesc resourcePong = {resource.descriptorType, resource.type, pingPong.indexInPoolToSwapWith};
-                        m_ClearResources.push_back( {denoiserDesc.identifier, resourcePong, downsampleFactor, isInteger} );
+                        m_ClearResources.push_back( {denoiserDesc.identifier, resourcePong, downsampleFactor, (uint16_t)denoiserDesc.viewportIndex, isInteger} );
                         break;
                     }
                 }
@@ -259,6 +474,25 @@ nrd::Result nrd::InstanceImpl::Create(const InstanceCreationDesc& instanceCreati
         AddDispatchNoConstants( Clear_Uint, Clear_Uint, 1 );
     }
 
+    // Add "resample" dispatches (history resizing)
+    m_DispatchResampleIndex[0] = m_Dispatches.size();
+    _PushPass("Resample (f)");
+    {
+        PushInput(0);
+        PushOutput(0);
+        AddDispatchNoConstantsWithRootConstants( Resample_Float, Resample_Float, 1 );
+    }
+
+    m_DispatchResampleIndex[1] = m_Dispatches.size();
+    _PushPass("Resample (ui)");
+    {
+        PushInput(0);
+        PushOutput(0);
+        AddDispatchNoConstantsWithRootConstants( Resample_Uint, Resample_Uint, 1 );
+    }
+
+    m_Viewports.resize(viewportsNum);
+
     PrepareDesc();
 
     // IMPORTANT: since now all std::vectors become "locked" (no reallocations)
@@ -266,208 +500,308 @@ nrd::Result nrd::InstanceImpl::Create(const InstanceCreationDesc& instanceCreati
     return Result::SUCCESS;
 }
 
-nrd::Result nrd::InstanceImpl::SetCommonSettings(const CommonSettings& commonSettings)
+nrd::Result nrd::InstanceImpl::SetViewportSettings(uint32_t viewportIndex, const CommonSettings& commonSettings)
+{
+    if (viewportIndex >= m_Viewports.size())
+        return Result::INVALID_ARGUMENT;
+
+    // Pools are shared, i.e. all viewports must live in resources of the same size (ignoring viewports, which haven't been used yet or resized)
+    bool isValid = true;
+    for (uint32_t i = 0; i < (uint32_t)m_Viewports.size(); i++)
+    {
+        const ViewState& viewState = m_Viewports[i];
+        if (i == viewportIndex || viewState.isFirstUse || viewState.isHistoryImported)
+            continue;
+
+        isValid &= viewState.commonSettings.resourceSize[0] == commonSettings.resourceSize[0] && viewState.commonSettings.resourceSize[1] == commonSettings.resourceSize[1];
+    }
+    assert("'resourceSize' must be the same for all viewports" && isValid);
+
+    Result result = UpdateViewState(viewportIndex, commonSettings);
+
+    return isValid ? result : Result::INVALID_ARGUMENT;
+}
+
+nrd::Result nrd::InstanceImpl::SetStereoSettings(const CommonSettings& leftEye, const CommonSettings& rightEye)
 {
-    m_SplitScreenPrev = m_CommonSettings.splitScreen;
+    if (m_Viewports.size() < 2)
+        return Result::INVALID_ARGUMENT;
+
+    bool isValid = leftEye.frameIndex == rightEye.frameIndex;
+    assert("'frameIndex' must be the same for both eyes" && isValid);
 
-    memcpy(&m_CommonSettings, &commonSettings, sizeof(commonSettings));
+    isValid &= leftEye.resourceSize[0] == rightEye.resourceSize[0] && leftEye.resourceSize[1] == rightEye.resourceSize[1];
+    assert("'resourceSize' must be the same for both eyes" && isValid);
+
+    isValid &= leftEye.rectSize[0] == rightEye.rectSize[0] && leftEye.rectSize[1] == rightEye.rectSize[1];
+    assert("'rectSize' must be the same for both eyes" && isValid);
+
+    // Restart both eyes if needed, otherwise histories differ for a while (very noticeable in VR)
+    AccumulationMode accumulationMode = leftEye.accumulationMode > rightEye.accumulationMode ? leftEye.accumulationMode : rightEye.accumulationMode;
+
+    CommonSettings eye = leftEye;
+    eye.accumulationMode = accumulationMode;
+    Result result = SetViewportSettings(0, eye);
+
+    eye = rightEye;
+    eye.accumulationMode = accumulationMode;
+    Result resultRight = SetViewportSettings(1, eye);
+
+    if (result == Result::SUCCESS)
+        result = resultRight;
+
+    return isValid ? result : Result::INVALID_ARGUMENT;
+}
+
+nrd::Result nrd::InstanceImpl::UpdateViewState(uint32_t viewportIndex, const CommonSettings& commonSettings)
+{
+    ViewState& view = m_Viewports[viewportIndex];
+
+    // Denoisers advance (ping-pong) only once per "frameIndex", i.e. a stuck "frameIndex" would silently freeze the history
+    bool isFrameIndexChecked = !view.isFirstUse && !view.isHistoryImported;
+    uint32_t frameIndexPrev = view.commonSettings.frameIndex;
+
+    view.splitScreenPrev = view.commonSettings.splitScreen;
+
+    memcpy(&view.commonSettings, &commonSettings, sizeof(commonSettings));
+
+    // Warm start: the previous frame is the last frame of the imported history. Textures are new, i.e. "resourceSizePrev = resourceSize",
+    // and the history is expected in the top-left corner (like with DRS), so the old "rect" must fit into the new "resource"
+    if (view.isHistoryImported)
+    {
+        const CommonSettings& history = view.historyCommonSettings;
+
+        memcpy(view.commonSettings.viewToClipMatrixPrev, history.viewToClipMatrix, sizeof(history.viewToClipMatrix));
+        memcpy(view.commonSettings.worldToViewMatrixPrev, history.worldToViewMatrix, sizeof(history.worldToViewMatrix));
+
+        view.commonSettings.cameraJitterPrev[0] = history.cameraJitter[0];
+        view.commonSettings.cameraJitterPrev[1] = history.cameraJitter[1];
+
+        view.commonSettings.resourceSizePrev[0] = view.commonSettings.resourceSize[0];
+        view.commonSettings.resourceSizePrev[1] = view.commonSettings.resourceSize[1];
+
+        view.commonSettings.rectSizePrev[0] = history.rectSize[0];
+        view.commonSettings.rectSizePrev[1] = history.rectSize[1];
+
+        if (history.rectSize[0] > view.commonSettings.resourceSize[0] || history.rectSize[1] > view.commonSettings.resourceSize[1])
+            view.commonSettings.accumulationMode = AccumulationMode::CLEAR_AND_RESTART;
+
+        view.splitScreenPrev = history.splitScreen;
+        view.isHistoryImported = false;
+    }
 
     // Silently fix settings for known cases
-    if (m_IsFirstUse)
+    if (view.isFirstUse)
+    {
+        view.commonSettings.accumulationMode = AccumulationMode::CLEAR_AND_RESTART;
+        view.isFirstUse = false;
+    }
+
+    // Denoisers added by "InheritHistory" restart alone during this frame
+    for (DenoiserData& denoiserData : m_DenoiserData)
     {
-        m_CommonSettings.accumulationMode = AccumulationMode::CLEAR_AND_RESTART;
-        m_IsFirstUse = false;
+        if (denoiserData.desc.viewportIndex == viewportIndex)
+        {
+            denoiserData.isRestarting = denoiserData.isRestartPending;
+            denoiserData.isRestartPending = false;
+        }
     }
 
-    if (m_CommonSettings.accumulationMode != AccumulationMode::CONTINUE)
+    if (view.commonSettings.accumulationMode != AccumulationMode::CONTINUE)
     {
-        m_SplitScreenPrev = 0.0f;
+        view.splitScreenPrev = 0.0f;
 
-        m_WorldToViewPrev = m_WorldToView;
-        m_ViewToClipPrev = m_ViewToClip;
+        view.worldToViewPrev = view.worldToView;
+        view.viewToClipPrev = view.viewToClip;
 
-        m_CommonSettings.resourceSizePrev[0] = m_CommonSettings.resourceSize[0];
-        m_CommonSettings.resourceSizePrev[1] = m_CommonSettings.resourceSize[1];
+        view.commonSettings.resourceSizePrev[0] = view.commonSettings.resourceSize[0];
+        view.commonSettings.resourceSizePrev[1] = view.commonSettings.resourceSize[1];
 
-        m_CommonSettings.rectSizePrev[0] = m_CommonSettings.rectSize[0];
-        m_CommonSettings.rectSizePrev[1] = m_CommonSettings.rectSize[1];
+        view.commonSettings.rectSizePrev[0] = view.commonSettings.rectSize[0];
+        view.commonSettings.rectSizePrev[1] = view.commonSettings.rectSize[1];
 
-        m_CommonSettings.cameraJitterPrev[0] = m_CommonSettings.cameraJitter[0];
-        m_CommonSettings.cameraJitterPrev[1] = m_CommonSettings.cameraJitter[1];
+        view.commonSettings.cameraJitterPrev[0] = view.commonSettings.cameraJitter[0];
+        view.commonSettings.cameraJitterPrev[1] = view.commonSettings.cameraJitter[1];
     }
 
     // TODO: matrix verifications?
-    bool isValid = m_CommonSettings.viewZScale > 0.0f;
+    bool isValid = !isFrameIndexChecked || view.commonSettings.frameIndex != frameIndexPrev || view.commonSettings.accumulationMode != AccumulationMode::CONTINUE;
+    assert("'frameIndex' must change on each frame" && isValid);
+
+    isValid &= view.commonSettings.viewZScale > 0.0f;
     assert("'viewZScale' can't be <= 0" && isValid);
 
-    isValid &= m_CommonSettings.resourceSize[0] != 0 && m_CommonSettings.resourceSize[1] != 0;
+    isValid &= view.commonSettings.resourceSize[0] != 0 && view.commonSettings.resourceSize[1] != 0;
     assert("'resourceSize' can't be 0" && isValid);
 
-    isValid &= m_CommonSettings.resourceSizePrev[0] != 0 && m_CommonSettings.resourceSizePrev[1] != 0;
+    isValid &= view.commonSettings.resourceSizePrev[0] != 0 && view.commonSettings.resourceSizePrev[1] != 0;
     assert("'resourceSizePrev' can't be 0" && isValid);
 
-    isValid &= m_CommonSettings.rectSize[0] != 0 && m_CommonSettings.rectSize[1] != 0;
+    isValid &= view.commonSettings.rectSize[0] != 0 && view.commonSettings.rectSize[1] != 0;
     assert("'rectSize' can't be 0" && isValid);
 
-    isValid &= m_CommonSettings.rectSizePrev[0] != 0 && m_CommonSettings.rectSizePrev[1] != 0;
+    isValid &= view.commonSettings.rectSizePrev[0] != 0 && view.commonSettings.rectSizePrev[1] != 0;
     assert("'rectSizePrev' can't be 0" && isValid);
 
-    isValid &= ((m_CommonSettings.motionVectorScale[0] != 0.0f && m_CommonSettings.motionVectorScale[1] != 0.0f) || m_CommonSettings.isMotionVectorInWorldSpace);
+    isValid &= (view.commonSettings.outputSize[0] == 0) == (view.commonSettings.outputSize[1] == 0);
+    assert("'outputSize' must be either 0 or non-0 in both dimensions" && isValid);
+
+    isValid &= ((view.commonSettings.motionVectorScale[0] != 0.0f && view.commonSettings.motionVectorScale[1] != 0.0f) || view.commonSettings.isMotionVectorInWorldSpace);
     assert("'mvScale.xy' can't be 0" && isValid);
 
-    isValid &= m_CommonSettings.cameraJitter[0] >= -0.5f && m_CommonSettings.cameraJitter[0] <= 0.5f && m_CommonSettings.cameraJitter[1] >= -0.5f && m_CommonSettings.cameraJitter[1] <= 0.5f;
+    isValid &= view.commonSettings.cameraJitter[0] >= -0.5f && view.commonSettings.cameraJitter[0] <= 0.5f && view.commonSettings.cameraJitter[1] >= -0.5f && view.commonSettings.cameraJitter[1] <= 0.5f;
     assert("'cameraJitter' must be in range [-0.5; 0.5]" && isValid);
 
-    isValid &= m_CommonSettings.cameraJitterPrev[0] >= -0.5f && m_CommonSettings.cameraJitterPrev[0] <= 0.5f && m_CommonSettings.cameraJitterPrev[1] >= -0.5f && m_CommonSettings.cameraJitterPrev[1] <= 0.5f;
+    isValid &= view.commonSettings.cameraJitterPrev[0] >= -0.5f && view.commonSettings.cameraJitterPrev[0] <= 0.5f && view.commonSettings.cameraJitterPrev[1] >= -0.5f && view.commonSettings.cameraJitterPrev[1] <= 0.5f;
     assert("'cameraJitterPrev' must be in range [-0.5; 0.5]" && isValid);
 
-    isValid &= m_CommonSettings.denoisingRange > 0.0f;
+    isValid &= view.commonSettings.denoisingRange > 0.0f;
     assert("'denoisingRange' must be >= 0" && isValid);
 
-    isValid &= m_CommonSettings.disocclusionThreshold > 0.0f;
+    isValid &= view.commonSettings.disocclusionThreshold > 0.0f;
     assert("'disocclusionThreshold' must be > 0" && isValid);
 
-    isValid &= m_CommonSettings.disocclusionThresholdAlternate > 0.0f;
+    isValid &= view.commonSettings.disocclusionThresholdAlternate > 0.0f;
     assert("'disocclusionThresholdAlternate' must be > 0" && isValid);
 
-    isValid &= m_CommonSettings.strandMaterialID != 0.0f || GetLibraryDesc().normalEncoding == NormalEncoding::R10_G10_B10_A2_UNORM;
+    isValid &= view.commonSettings.strandMaterialID != 0.0f || GetLibraryDesc().normalEncoding == NormalEncoding::R10_G10_B10_A2_UNORM;
     assert("'strandMaterialID' can't be 0 if material ID is not supported by encoding" && isValid);
 
-    isValid &= m_CommonSettings.cameraAttachedReflectionMaterialID != 0.0f || GetLibraryDesc().normalEncoding == NormalEncoding::R10_G10_B10_A2_UNORM;
+    isValid &= view.commonSettings.cameraAttachedReflectionMaterialID != 0.0f || GetLibraryDesc().normalEncoding == NormalEncoding::R10_G10_B10_A2_UNORM;
     assert("'cameraAttachedReflectionMaterialID' can't be 0 if material ID is not supported by encoding" && isValid);
 
     // Rotators (respecting sample patterns symmetry)
-    float angle1 = Sequence::Weyl1D(0.5f, m_CommonSettings.frameIndex) * radians(90.0f);
-    m_RotatorPre = Geometry::GetRotator(angle1);
+    float angle1 = Sequence::Weyl1D(0.5f, view.commonSettings.frameIndex) * radians(90.0f);
+    view.rotatorPre = Geometry::GetRotator(angle1);
 
-    float a0 = Sequence::Weyl1D(0.0f, m_CommonSettings.frameIndex * 2) * radians(90.0f);
-    float a1 = Sequence::Bayer4x4(uint2(0, 0), m_CommonSettings.frameIndex * 2) * radians(360.0f);
-    m_Rotator = Geometry::CombineRotators(Geometry::GetRotator(a0), Geometry::GetRotator(a1));
+    float a0 = Sequence::Weyl1D(0.0f, view.commonSettings.frameIndex * 2) * radians(90.0f);
+    float a1 = Sequence::Bayer4x4(uint2(0, 0), view.commonSettings.frameIndex * 2) * radians(360.0f);
+    view.rotator = Geometry::CombineRotators(Geometry::GetRotator(a0), Geometry::GetRotator(a1));
 
-    float a2 = Sequence::Weyl1D(0.0f, m_CommonSettings.frameIndex * 2 + 1) * radians(90.0f);
-    float a3 = Sequence::Bayer4x4(uint2(0, 0), m_CommonSettings.frameIndex * 2 + 1) * radians(360.0f);
-    m_RotatorPost = Geometry::CombineRotators(Geometry::GetRotator(a2), Geometry::GetRotator(a3));
+    float a2 = Sequence::Weyl1D(0.0f, view.commonSettings.frameIndex * 2 + 1) * radians(90.0f);
+    float a3 = Sequence::Bayer4x4(uint2(0, 0), view.commonSettings.frameIndex * 2 + 1) * radians(360.0f);
+    view.rotatorPost = Geometry::CombineRotators(Geometry::GetRotator(a2), Geometry::GetRotator(a3));
 
     // Main matrices
-    m_ViewToClip = float4x4
+    view.viewToClip = float4x4
     (
-        float4(m_CommonSettings.viewToClipMatrix),
-        float4(m_CommonSettings.viewToClipMatrix + 4),
-        float4(m_CommonSettings.viewToClipMatrix + 8),
-        float4(m_CommonSettings.viewToClipMatrix + 12)
+        float4(view.commonSettings.viewToClipMatrix),
+        float4(view.commonSettings.viewToClipMatrix + 4),
+        float4(view.commonSettings.viewToClipMatrix + 8),
+        float4(view.commonSettings.viewToClipMatrix + 12)
     );
 
-    m_ViewToClipPrev = float4x4
+    view.viewToClipPrev = float4x4
     (
-        float4(m_CommonSettings.viewToClipMatrixPrev),
-        float4(m_CommonSettings.viewToClipMatrixPrev + 4),
-        float4(m_CommonSettings.viewToClipMatrixPrev + 8),
-        float4(m_CommonSettings.viewToClipMatrixPrev + 12)
+        float4(view.commonSettings.viewToClipMatrixPrev),
+        float4(view.commonSettings.viewToClipMatrixPrev + 4),
+        float4(view.commonSettings.viewToClipMatrixPrev + 8),
+        float4(view.commonSettings.viewToClipMatrixPrev + 12)
     );
 
-    m_WorldToView = float4x4
+    view.worldToView = float4x4
     (
-        float4(m_CommonSettings.worldToViewMatrix),
-        float4(m_CommonSettings.worldToViewMatrix + 4),
-        float4(m_CommonSettings.worldToViewMatrix + 8),
-        float4(m_CommonSettings.worldToViewMatrix + 12)
+        float4(view.commonSettings.worldToViewMatrix),
+        float4(view.commonSettings.worldToViewMatrix + 4),
+        float4(view.commonSettings.worldToViewMatrix + 8),
+        float4(view.commonSettings.worldToViewMatrix + 12)
     );
 
-    m_WorldToViewPrev = float4x4
+    view.worldToViewPrev = float4x4
     (
-        float4(m_CommonSettings.worldToViewMatrixPrev),
-        float4(m_CommonSettings.worldToViewMatrixPrev + 4),
-        float4(m_CommonSettings.worldToViewMatrixPrev + 8),
-        float4(m_CommonSettings.worldToViewMatrixPrev + 12)
+        float4(view.commonSettings.worldToViewMatrixPrev),
+        float4(view.commonSettings.worldToViewMatrixPrev + 4),
+        float4(view.commonSettings.worldToViewMatrixPrev + 8),
+        float4(view.commonSettings.worldToViewMatrixPrev + 12)
     );
 
-    m_WorldPrevToWorld = float4x4
+    view.worldPrevToWorld = float4x4
     (
-        float4(m_CommonSettings.worldPrevToWorldMatrix),
-        float4(m_CommonSettings.worldPrevToWorldMatrix + 4),
-        float4(m_CommonSettings.worldPrevToWorldMatrix + 8),
-        float4(m_CommonSettings.worldPrevToWorldMatrix + 12)
+        float4(view.commonSettings.worldPrevToWorldMatrix),
+        float4(view.commonSettings.worldPrevToWorldMatrix + 4),
+        float4(view.commonSettings.worldPrevToWorldMatrix + 8),
+        float4(view.commonSettings.worldPrevToWorldMatrix + 12)
     );
 
     // Convert to LH
     uint32_t flags = 0;
-    DecomposeProjection(STYLE_D3D, STYLE_D3D, m_ViewToClip, &flags, nullptr, nullptr, m_Frustum.a, nullptr, nullptr);
+    DecomposeProjection(STYLE_D3D, STYLE_D3D, view.viewToClip, &flags, nullptr, nullptr, view.frustum.a, nullptr, nullptr);
 
     if ( !(flags & PROJ_LEFT_HANDED) )
     {
-        m_ViewToClip.col2 = -m_ViewToClip[2];
-        m_ViewToClipPrev.col2 = -m_ViewToClipPrev[2];
+        view.viewToClip.col2 = -view.viewToClip[2];
+        view.viewToClipPrev.col2 = -view.viewToClipPrev[2];
 
-        m_WorldToView.Transpose();
-        m_WorldToView.col2 = -m_WorldToView[2];
-        m_WorldToView.Transpose();
+        view.worldToView.Transpose();
+        view.worldToView.col2 = -view.worldToView[2];
+        view.worldToView.Transpose();
 
-        m_WorldToViewPrev.Transpose();
-        m_WorldToViewPrev.col2 = -m_WorldToViewPrev[2];
-        m_WorldToViewPrev.Transpose();
+        view.worldToViewPrev.Transpose();
+        view.worldToViewPrev.col2 = -view.worldToViewPrev[2];
+        view.worldToViewPrev.Transpose();
     }
 
     // Compute other matrices
-    m_ViewToWorld = m_WorldToView;
-    m_ViewToWorld.InvertOrtho();
+    view.viewToWorld = view.worldToView;
+    view.viewToWorld.InvertOrtho();
 
-    m_ViewToWorldPrev = m_WorldToViewPrev;
-    m_ViewToWorldPrev.InvertOrtho();
+    view.viewToWorldPrev = view.worldToViewPrev;
+    view.viewToWorldPrev.InvertOrtho();
 
-    const float3& cameraPosition = m_ViewToWorld[3].xyz;
-    const float3& cameraPositionPrev = m_ViewToWorldPrev[3].xyz;
+    const float3& cameraPosition = view.viewToWorld[3].xyz;
+    const float3& cameraPositionPrev = view.viewToWorldPrev[3].xyz;
     float3 translationDelta = cameraPositionPrev - cameraPosition;
 
     // IMPORTANT: this part is mandatory needed to preserve precision by making matrices camera relative
-    m_ViewToWorld.SetTranslation( float3::Zero() );
-    m_WorldToView = m_ViewToWorld;
-    m_WorldToView.InvertOrtho();
+    view.viewToWorld.SetTranslation( float3::Zero() );
+    view.worldToView = view.viewToWorld;
+    view.worldToView.InvertOrtho();
 
-    m_ViewToWorldPrev.SetTranslation( translationDelta );
-    m_WorldToViewPrev = m_ViewToWorldPrev;
-    m_WorldToViewPrev.InvertOrtho();
+    view.viewToWorldPrev.SetTranslation( translationDelta );
+    view.worldToViewPrev = view.viewToWorldPrev;
+    view.worldToViewPrev.InvertOrtho();
 
-    m_WorldToClip = m_ViewToClip * m_WorldToView;
-    m_WorldToClipPrev = m_ViewToClipPrev * m_WorldToViewPrev;
+    view.worldToClip = view.viewToClip * view.worldToView;
+    view.worldToClipPrev = view.viewToClipPrev * view.worldToViewPrev;
 
-    m_ClipToWorldPrev = m_WorldToClipPrev;
-    m_ClipToWorldPrev.Invert();
+    view.clipToWorldPrev = view.worldToClipPrev;
+    view.clipToWorldPrev.Invert();
 
-    m_ClipToView = m_ViewToClip;
-    m_ClipToView.Invert();
+    view.clipToView = view.viewToClip;
+    view.clipToView.Invert();
 
-    m_ClipToViewPrev = m_ViewToClipPrev;
-    m_ClipToViewPrev.Invert();
+    view.clipToViewPrev = view.viewToClipPrev;
+    view.clipToViewPrev.Invert();
 
-    m_ClipToWorld = m_WorldToClip;
-    m_ClipToWorld.Invert();
+    view.clipToWorld = view.worldToClip;
+    view.clipToWorld.Invert();
 
     float project[3];
-    DecomposeProjection(STYLE_D3D, STYLE_D3D, m_ViewToClip, &flags, nullptr, nullptr, m_Frustum.a, project, nullptr);
+    DecomposeProjection(STYLE_D3D, STYLE_D3D, view.viewToClip, &flags, nullptr, nullptr, view.frustum.a, project, nullptr);
 
-    m_ProjectY = project[1];
-    m_OrthoMode = (flags & PROJ_ORTHO) ? -1.0f : 0.0f;
+    view.projectY = project[1];
+    view.orthoMode = (flags & PROJ_ORTHO) ? -1.0f : 0.0f;
 
-    DecomposeProjection(STYLE_D3D, STYLE_D3D, m_ViewToClipPrev, &flags, nullptr, nullptr, m_FrustumPrev.a, nullptr, nullptr);
+    DecomposeProjection(STYLE_D3D, STYLE_D3D, view.viewToClipPrev, &flags, nullptr, nullptr, view.frustumPrev.a, nullptr, nullptr);
 
-    m_ViewDirection = -float3(m_ViewToWorld[2]);
-    m_ViewDirectionPrev = -float3(m_ViewToWorldPrev[2]);
+    view.viewDirection = -float3(view.viewToWorld[2]);
+    view.viewDirectionPrev = -float3(view.viewToWorldPrev[2]);
 
-    m_CameraDelta = float3(translationDelta.x, translationDelta.y, translationDelta.z);
+    view.cameraDelta = float3(translationDelta.x, translationDelta.y, translationDelta.z);
 
-    m_Timer.UpdateElapsedTimeSinceLastSave();
-    m_Timer.SaveCurrentTime();
+    view.timer.UpdateElapsedTimeSinceLastSave();
+    view.timer.SaveCurrentTime();
 
-    m_TimeDelta = m_CommonSettings.timeDeltaBetweenFrames > 0.0f ? m_CommonSettings.timeDeltaBetweenFrames : m_Timer.GetSmoothedElapsedTime();
-    m_FrameRateScale = max(33.333f / m_TimeDelta, 1.0f);
+    view.timeDelta = view.commonSettings.timeDeltaBetweenFrames > 0.0f ? view.commonSettings.timeDeltaBetweenFrames : view.timer.GetSmoothedElapsedTime();
+    view.frameRateScale = max(33.333f / view.timeDelta, 1.0f);
 
-    float dx = abs(m_CommonSettings.cameraJitter[0] - m_CommonSettings.cameraJitterPrev[0]);
-    float dy = abs(m_CommonSettings.cameraJitter[1] - m_CommonSettings.cameraJitterPrev[1]);
-    m_JitterDelta = max(dx, dy);
+    float dx = abs(view.commonSettings.cameraJitter[0] - view.commonSettings.cameraJitterPrev[0]);
+    float dy = abs(view.commonSettings.cameraJitter[1] - view.commonSettings.cameraJitterPrev[1]);
+    view.jitterDelta = max(dx, dy);
 
-    float FPS = m_FrameRateScale * 30.0f;
+    float FPS = view.frameRateScale * 30.0f;
     float nonLinearAccumSpeed = FPS * 0.25f / (1.0f + FPS * 0.25f);
-    m_CheckerboardResolveAccumSpeed = lerp(nonLinearAccumSpeed, 0.5f, m_JitterDelta);
+    view.checkerboardResolveAccumSpeed = lerp(nonLinearAccumSpeed, 0.5f, view.jitterDelta);
 
     return isValid ? Result::SUCCESS : Result::INVALID_ARGUMENT;
 }
@@ -489,92 +823,477 @@ nrd::Result nrd::InstanceImpl::SetDenoiserSettings(Identifier identifier, const
 
 nrd::Result nrd::InstanceImpl::GetComputeDispatches(const Identifier* identifiers, uint32_t identifiersNum, const DispatchDesc*& dispatchDescs, uint32_t& dispatchDescsNum)
 {
-    m_ConstantDataOffset = 0;
-    m_ActiveDispatches.clear();
+    // Internal storage is sized for the worst case in "PrepareDesc", i.e. the output always fits
+    uint32_t constantDataSize = (uint32_t)m_ConstantDataSize;
+    dispatchDescsNum = (uint32_t)m_ActiveDispatches.size();
 
+    Result result = GetComputeDispatches(identifiers, identifiersNum, m_ActiveDispatches.data(), dispatchDescsNum, m_ConstantData, constantDataSize, CONSTANT_DATA_ALIGNMENT);
+    assert("Internal storage is too small!" && result != Result::INSUFFICIENT_MEMORY);
+
+    dispatchDescs = dispatchDescsNum ? m_ActiveDispatches.data() : nullptr;
+
+    return result;
+}
+
+nrd::Result nrd::InstanceImpl::GetComputeDispatches(const Identifier* identifiers, uint32_t identifiersNum, DispatchDesc* dispatchDescs, uint32_t& dispatchDescsNum, uint8_t* constantData, uint32_t& constantDataSize, uint32_t constantDataAlignment)
+{
     // Trivial checks
     if (!identifiers || !identifiersNum)
     {
-        dispatchDescs = nullptr;
         dispatchDescsNum = 0;
+        constantDataSize = 0;
 
         return !identifiersNum ? Result::SUCCESS : Result::INVALID_ARGUMENT;
     }
 
+    // IMPORTANT: memory for constants must be aligned, as well as any individual SSE-type containing member,
+    // because a compiler can generate dangerous "movaps" instruction!
+    bool isValid = constantDataAlignment >= CONSTANT_DATA_ALIGNMENT && (constantDataAlignment & (constantDataAlignment - 1)) == 0;
+    assert("'constantDataAlignment' must be a power of 2 and >= 16" && isValid);
+
+    isValid &= ((size_t)constantData & (CONSTANT_DATA_ALIGNMENT - 1)) == 0;
+    assert("'constantData' must be 16 bytes aligned" && isValid);
+
+    if (!isValid)
+        return Result::INVALID_ARGUMENT;
+
+    // Bind output ("dispatchDescs = NULL" means "query sizes only")
+    bool isSizeQuery = dispatchDescs == nullptr || constantData == nullptr;
+
+    // Constants are built and compared on the stack, the output is only written (it can be write-combined memory)
+    alignas(CONSTANT_DATA_ALIGNMENT) uint8_t constantStaging[2][CONSTANT_DATA_MAX_SIZE];
+
+    DispatchContext context = {};
+    context.dispatchDescs = dispatchDescs;
+    context.dispatchDescsCapacity = isSizeQuery ? 0 : dispatchDescsNum;
+    context.constantData = constantData;
+    context.constantStaging = constantStaging[0];
+    context.constantStagingPrev = constantStaging[1];
+    context.constantDataCapacity = isSizeQuery ? 0 : constantDataSize;
+    context.constantDataAlignment = constantDataAlignment;
+
     // Inject "clear" calls if needed
-    if (m_CommonSettings.accumulationMode == AccumulationMode::CLEAR_AND_RESTART)
+    for (const ClearResource& clearResource : m_ClearResources)
     {
-        for (const ClearResource& clearResource : m_ClearResources)
-        {
-            // If current denoiser is in list
-            if (!IsInList(clearResource.identifier, identifiers, identifiersNum))
-                continue;
+        // If current denoiser is in list
+        if (!IsInList(clearResource.identifier, identifiers, identifiersNum))
+            continue;
 
-            // Add a clear dispatch
-            const InternalDispatchDesc& internalDispatchDesc = m_Dispatches[ m_DispatchClearIndex[clearResource.isInteger ? 1 : 0] ];
+        if (GetAccumulationMode(clearResource.identifier) != AccumulationMode::CLEAR_AND_RESTART)
+            continue;
 
-            uint16_t w = DivideUp(m_CommonSettings.resourceSize[0], clearResource.downsampleFactor);
-            uint16_t h = DivideUp(m_CommonSettings.resourceSize[1], clearResource.downsampleFactor);
+        const ViewState& view = m_Viewports[clearResource.viewportIndex];
 
-            DispatchDesc dispatchDesc = {};
-            dispatchDesc.name = internalDispatchDesc.name;
-            dispatchDesc.identifier = clearResource.identifier;
-            dispatchDesc.resources = &clearResource.resource;
-            dispatchDesc.resourcesNum = 1;
-            dispatchDesc.pipelineIndex = internalDispatchDesc.pipelineIndex;
-            dispatchDesc.gridWidth = DivideUp(w, internalDispatchDesc.numThreads.width);
-            dispatchDesc.gridHeight = DivideUp(h, internalDispatchDesc.numThreads.height);
+        // Add a clear dispatch
+        const InternalDispatchDesc& internalDispatchDesc = m_Dispatches[ m_DispatchClearIndex[clearResource.isInteger ? 1 : 0] ];
 
-            m_ActiveDispatches.push_back(dispatchDesc);
-        }
+        uint16_t w = DivideUp(view.commonSettings.resourceSize[0], clearResource.downsampleFactor);
+        uint16_t h = DivideUp(view.commonSettings.resourceSize[1], clearResource.downsampleFactor);
+
+        DispatchDesc dispatchDesc = {};
+        dispatchDesc.name = internalDispatchDesc.name;
+        dispatchDesc.identifier = clearResource.identifier;
+        dispatchDesc.resources = &clearResource.resource;
+        dispatchDesc.resourcesNum = 1;
+        dispatchDesc.pipelineIndex = internalDispatchDesc.pipelineIndex;
+        dispatchDesc.gridWidth = DivideUp(w, internalDispatchDesc.numThreads.width);
+        dispatchDesc.gridHeight = DivideUp(h, internalDispatchDesc.numThreads.height);
+
+        StoreDispatch(context, dispatchDesc);
     }
 
     // Collect dispatches for requested denoisers
-    for (const DenoiserData& denoiserData : m_DenoiserData)
+    for (DenoiserData& denoiserData : m_DenoiserData)
     {
         // If current denoiser is in list
         if (!IsInList(denoiserData.desc.identifier, identifiers, identifiersNum))
             continue;
 
         // Update denoiser and gather dispatches
-        UpdatePingPong(denoiserData);
+        context.view = &m_Viewports[denoiserData.desc.viewportIndex];
+        context.accumulationMode = GetAccumulationMode(denoiserData);
+
+        AdvanceFrame(denoiserData, context);
 
         if (denoiserData.desc.denoiser == Denoiser::REBLUR_DIFFUSE || denoiserData.desc.denoiser == Denoiser::REBLUR_DIFFUSE_SH ||
             denoiserData.desc.denoiser == Denoiser::REBLUR_SPECULAR || denoiserData.desc.denoiser == Denoiser::REBLUR_SPECULAR_SH ||
             denoiserData.desc.denoiser == Denoiser::REBLUR_DIFFUSE_SPECULAR || denoiserData.desc.denoiser == Denoiser::REBLUR_DIFFUSE_SPECULAR_SH ||
             denoiserData.desc.denoiser == Denoiser::REBLUR_DIFFUSE_DIRECTIONAL_OCCLUSION)
-            Update_Reblur(denoiserData);
+            Update_Reblur(denoiserData, context);
         else if (denoiserData.desc.denoiser == Denoiser::REBLUR_DIFFUSE_OCCLUSION ||
             denoiserData.desc.denoiser == Denoiser::REBLUR_SPECULAR_OCCLUSION ||
             denoiserData.desc.denoiser == Denoiser::REBLUR_DIFFUSE_SPECULAR_OCCLUSION)
-            Update_ReblurOcclusion(denoiserData);
+            Update_ReblurOcclusion(denoiserData, context);
         else if (denoiserData.desc.denoiser == Denoiser::RELAX_DIFFUSE || denoiserData.desc.denoiser == Denoiser::RELAX_DIFFUSE_SH ||
             denoiserData.desc.denoiser == Denoiser::RELAX_SPECULAR || denoiserData.desc.denoiser == Denoiser::RELAX_SPECULAR_SH ||
             denoiserData.desc.denoiser == Denoiser::RELAX_DIFFUSE_SPECULAR || denoiserData.desc.denoiser == Denoiser::RELAX_DIFFUSE_SPECULAR_SH)
-            Update_Relax(denoiserData);
+            Update_Relax(denoiserData, context);
         else if (denoiserData.desc.denoiser == Denoiser::SIGMA_SHADOW || denoiserData.desc.denoiser == Denoiser::SIGMA_SHADOW_TRANSLUCENCY)
-            Update_SigmaShadow(denoiserData);
+            Update_SigmaShadow(denoiserData, context);
+#ifdef NRD_DENOISER_REFERENCE
         else if (denoiserData.desc.denoiser == Denoiser::REFERENCE)
-            Update_Reference(denoiserData);
+            Update_Reference(denoiserData, context);
+#endif
+    }
+
+    FlushConstants(context);
+
+    // Output sizes (the state is advanced once per frame, i.e. the call can be repeated with bigger buffers)
+    dispatchDescsNum = context.dispatchDescsNum;
+    constantDataSize = (uint32_t)context.constantDataOffset;
+
+    if (context.dispatchDescsNum > context.dispatchDescsCapacity || context.constantDataOffset > context.constantDataCapacity)
+        return isSizeQuery ? Result::SUCCESS : Result::INSUFFICIENT_MEMORY;
+
+    return dispatchDescsNum ? Result::SUCCESS : Result::INVALID_ARGUMENT;
+}
+
+nrd::Result nrd::InstanceImpl::GetDispatchStats(const DispatchDesc* dispatchDescs, uint32_t dispatchDescsNum, DispatchStats& dispatchStats) const
+{
+    dispatchStats = {};
+
+    if (!dispatchDescs && dispatchDescsNum)
+        return Result::INVALID_ARGUMENT;
+
+    uint16_t clearPipelineIndex0 = m_Dispatches[m_DispatchClearIndex[0]].pipelineIndex;
+    uint16_t clearPipelineIndex1 = m_Dispatches[m_DispatchClearIndex[1]].pipelineIndex;
+
+    for (uint32_t i = 0; i < dispatchDescsNum; i++)
+    {
+        const DispatchDesc& dispatchDesc = dispatchDescs[i];
+
+        dispatchStats.dispatchNum++;
+        dispatchStats.threadGroupNum += uint64_t(dispatchDesc.gridWidth) * dispatchDesc.gridHeight;
+
+        if (dispatchDesc.pipelineIndex == clearPipelineIndex0 || dispatchDesc.pipelineIndex == clearPipelineIndex1)
+            dispatchStats.clearDispatchNum++;
+
+        if (dispatchDesc.constantBufferDataMatchesPreviousDispatch)
+            dispatchStats.constantBufferBytesSkipped += dispatchDesc.constantBufferDataSize;
+        else
+            dispatchStats.constantBufferBytesWritten += dispatchDesc.constantBufferDataSize;
     }
 
-    // Maximize CB reuse
-    for (size_t i = 1; i < m_ActiveDispatches.size(); i++)
+    return Result::SUCCESS;
+}
+
+nrd::Result nrd::InstanceImpl::Plan(uint16_t resourceWidth, uint16_t resourceHeight, InstancePlan& instancePlan, PassPlan* passPlans, uint32_t& passPlansNum) const
+{
+    const uint64_t pixelNum = uint64_t(resourceWidth) * resourceHeight;
+
+    auto GetTextureSize = [&](const TextureDesc& textureDesc)
+    {
+        uint64_t w = DivideUp(resourceWidth, textureDesc.downsampleFactor);
+        uint64_t h = DivideUp(resourceHeight, textureDesc.downsampleFactor);
+
+        return w * h * g_FormatBytesPerPixel[(size_t)textureDesc.format];
+    };
+
+    // Memory
+    instancePlan = {};
+
+    for (const TextureDesc& textureDesc : m_PermanentPool)
+        instancePlan.permanentPoolSize += GetTextureSize(textureDesc);
+
+    for (const TextureDesc& textureDesc : m_TransientPool)
+        instancePlan.transientPoolSize += GetTextureSize(textureDesc);
+
+    // Passes (clears and resamples are not per frame work)
+    uint32_t capacity = passPlans ? passPlansNum : 0;
+    uint32_t n = 0;
+
+    for (size_t i = 0; i < m_Dispatches.size(); i++)
     {
-        const DispatchDesc& dispatchDescPrev = m_ActiveDispatches[i - 1];
-        DispatchDesc& dispatchDescCurr = m_ActiveDispatches[i];
-        if (dispatchDescPrev.constantBufferDataSize == dispatchDescCurr.constantBufferDataSize)
+        if (i == m_DispatchClearIndex[0] || i == m_DispatchClearIndex[1] || i == m_DispatchResampleIndex[0] || i == m_DispatchResampleIndex[1])
+            continue;
+
+        const InternalDispatchDesc& internalDispatchDesc = m_Dispatches[i];
+
+        // Bandwidth
+        uint64_t bytesRead = 0;
+        uint64_t bytesWritten = 0;
+
+        for (uint32_t r = 0; r < internalDispatchDesc.resourcesNum; r++)
+        {
+            const ResourceDesc& resource = internalDispatchDesc.resources[r];
+
+            uint64_t size = 0;
+            if (resource.type == ResourceType::PERMANENT_POOL)
+                size = GetTextureSize(m_PermanentPool[resource.indexInPool]);
+            else if (resource.type == ResourceType::TRANSIENT_POOL)
+                size = GetTextureSize(m_TransientPool[resource.indexInPool]);
+            else
+                size = pixelNum * ((resource.type == ResourceType::IN_VIEWZ || resource.type == ResourceType::IN_NORMAL_ROUGHNESS) ? 4 : 8);
+
+            if (resource.descriptorType == DescriptorType::TEXTURE)
+                bytesRead += size;
+            else
+                bytesWritten += size;
+        }
+
+        instancePlan.bytesReadPerFrame += bytesRead * internalDispatchDesc.maxRepeatsNum;
+        instancePlan.bytesWrittenPerFrame += bytesWritten * internalDispatchDesc.maxRepeatsNum;
+
+        // Grid (the same logic as in "PushDispatch", assuming "rectSize = outputSize = resourceSize")
+        uint16_t d = internalDispatchDesc.downsampleFactor;
+        if (d == USE_MAX_DIMS || d == IGNORE_RS || d == USE_OUTPUT_SIZE)
+            d = 1;
+
+        uint16_t w = DivideUp(resourceWidth, d);
+        uint16_t h = DivideUp(resourceHeight, d);
+
+        if (n < capacity)
         {
-            if (!memcmp(dispatchDescPrev.constantBufferData, dispatchDescCurr.constantBufferData, dispatchDescCurr.constantBufferDataSize))
-                dispatchDescCurr.constantBufferDataMatchesPreviousDispatch = true;
+            PassPlan& passPlan = passPlans[n];
+            passPlan.name = internalDispatchDesc.name;
+            passPlan.identifier = internalDispatchDesc.identifier;
+            passPlan.bytesRead = bytesRead;
+            passPlan.bytesWritten = bytesWritten;
+            passPlan.gridWidth = DivideUp(w, internalDispatchDesc.numThreads.width);
+            passPlan.gridHeight = DivideUp(h, internalDispatchDesc.numThreads.height);
+            passPlan.maxRepeatsNum = internalDispatchDesc.maxRepeatsNum;
         }
+
+        n++;
     }
 
-    // Output
+    instancePlan.passesNum = n;
+    passPlansNum = n;
+
+    return (!passPlans || n <= capacity) ? Result::SUCCESS : Result::INSUFFICIENT_MEMORY;
+}
+
+nrd::Result nrd::InstanceImpl::ExportHistory(void* data, uint32_t& dataSize) const
+{
+    uint32_t requiredSize = uint32_t(sizeof(HistoryHeader) + sizeof(HistoryDenoiser) * m_DenoiserData.size());
+    uint32_t capacity = dataSize;
+    dataSize = requiredSize;
+
+    if (!data)
+        return Result::SUCCESS;
+
+    if (capacity < requiredSize)
+        return Result::INSUFFICIENT_MEMORY;
+
+    // The format stores one "CommonSettings"
+    if (m_Viewports.size() > 1)
+        return Result::UNSUPPORTED;
+
+    // No history yet
+    const ViewState& view = m_Viewports[0];
+    if (view.isFirstUse)
+        return Result::FAILURE;
+
+    HistoryHeader* header = (HistoryHeader*)data;
+    memset(header, 0, requiredSize);
+
+    header->magic = HISTORY_MAGIC;
+    header->version = HISTORY_VERSION;
+    header->libraryVersion = (NRD_VERSION_MAJOR << 16) | NRD_VERSION_MINOR;
+    header->denoisersNum = (uint32_t)m_DenoiserData.size();
+    memcpy(&header->commonSettings, &view.commonSettings, sizeof(view.commonSettings));
+
+    HistoryDenoiser* historyDenoisers = (HistoryDenoiser*)(header + 1);
+    for (size_t i = 0; i < m_DenoiserData.size(); i++)
+    {
+        const DenoiserData& denoiserData = m_DenoiserData[i];
+
+        HistoryDenoiser& historyDenoiser = historyDenoisers[i];
+        historyDenoiser.identifier = denoiserData.desc.identifier;
+        historyDenoiser.denoiser = denoiserData.desc.denoiser;
+        historyDenoiser.frameIndex = denoiserData.frameIndex;
+        historyDenoiser.accumulatedFrameNum = denoiserData.accumulatedFrameNum;
+        historyDenoiser.permanentPoolOffset = denoiserData.permanentPoolOffset;
+        historyDenoiser.permanentPoolNum = denoiserData.permanentPoolNum;
+        historyDenoiser.isPingPongOdd = denoiserData.isPingPongOdd ? 1 : 0;
+    }
+
+    return Result::SUCCESS;
+}
+
+nrd::Result nrd::InstanceImpl::GetResizeDispatches(uint16_t resourceWidth, uint16_t resourceHeight, const DispatchDesc*& dispatchDescs, uint32_t& dispatchDescsNum)
+{
     dispatchDescs = m_ActiveDispatches.data();
-    dispatchDescsNum = (uint32_t)m_ActiveDispatches.size();
+    dispatchDescsNum = 0;
 
-    return dispatchDescsNum ? Result::SUCCESS : Result::INVALID_ARGUMENT;
+    if (resourceWidth == 0 || resourceHeight == 0)
+        return Result::INVALID_ARGUMENT;
+
+    for (uint32_t viewportIndex = 0; viewportIndex < (uint32_t)m_Viewports.size(); viewportIndex++)
+    {
+        ViewState& view = m_Viewports[viewportIndex];
+
+        // No history yet
+        if (view.isFirstUse)
+            continue;
+
+        // The last frame (or the not yet used imported history)
+        CommonSettings& history = view.historyCommonSettings;
+        if (!view.isHistoryImported)
+            memcpy(&history, &view.commonSettings, sizeof(history));
+
+        for (const DenoiserData& denoiserData : m_DenoiserData)
+        {
+            if (denoiserData.desc.viewportIndex != viewportIndex)
+                continue;
+
+            for (uint16_t i = denoiserData.permanentPoolOffset; i < denoiserData.permanentPoolOffset + denoiserData.permanentPoolNum; i++)
+            {
+                const TextureDesc& textureDesc = m_PermanentPool[i];
+                const InternalDispatchDesc& internalDispatchDesc = m_Dispatches[ m_DispatchResampleIndex[g_IsIntegerFormat[(size_t)textureDesc.format] ? 1 : 0] ];
+
+                uint16_t w = DivideUp(resourceWidth, textureDesc.downsampleFactor);
+                uint16_t h = DivideUp(resourceHeight, textureDesc.downsampleFactor);
+
+                Resample_FloatRootConstants rootConstants = {}; // same as "Resample_UintRootConstants"
+                rootConstants.gInRectSize = uint2(DivideUp(history.rectSize[0], textureDesc.downsampleFactor), DivideUp(history.rectSize[1], textureDesc.downsampleFactor));
+                rootConstants.gOutSize = uint2(w, h);
+
+                DispatchDesc& dispatchDesc = m_ActiveDispatches[dispatchDescsNum++];
+                dispatchDesc = {};
+                dispatchDesc.name = internalDispatchDesc.name;
+                dispatchDesc.identifier = denoiserData.desc.identifier;
+                dispatchDesc.resources = &m_Resources[m_ResampleResourcesOffset + i * 2];
+                dispatchDesc.resourcesNum = 2;
+                dispatchDesc.pipelineIndex = internalDispatchDesc.pipelineIndex;
+                dispatchDesc.gridWidth = DivideUp(w, internalDispatchDesc.numThreads.width);
+                dispatchDesc.gridHeight = DivideUp(h, internalDispatchDesc.numThreads.height);
+                dispatchDesc.rootConstantDataSize = sizeof(rootConstants);
+                memcpy(dispatchDesc.rootConstantData, &rootConstants, sizeof(rootConstants));
+            }
+        }
+
+        // The next frame continues accumulation, the history covers new textures entirely
+        history.rectSize[0] = resourceWidth;
+        history.rectSize[1] = resourceHeight;
+        view.isHistoryImported = true;
+    }
+
+    return Result::SUCCESS;
+}
+
+nrd::Result nrd::InstanceImpl::ImportHistory(const void* data, uint32_t dataSize, uint16_t* permanentPoolRemap)
+{
+    // Validate
+    const HistoryHeader* header = (const HistoryHeader*)data;
+    if (!data || dataSize < sizeof(HistoryHeader))
+        return Result::INVALID_ARGUMENT;
+
+    if (header->magic != HISTORY_MAGIC || header->version != HISTORY_VERSION || header->libraryVersion != uint32_t((NRD_VERSION_MAJOR << 16) | NRD_VERSION_MINOR))
+        return Result::UNSUPPORTED;
+
+    if (m_Viewports.size() > 1)
+        return Result::UNSUPPORTED;
+
+    if (dataSize < sizeof(HistoryHeader) + sizeof(HistoryDenoiser) * uint64_t(header->denoisersNum))
+        return Result::INVALID_ARGUMENT;
+
+    // All denoisers must be found (with the same permanent pool layout), otherwise the history is incomplete
+    const HistoryDenoiser* historyDenoisers = (const HistoryDenoiser*)(header + 1);
+    for (const DenoiserData& denoiserData : m_DenoiserData)
+    {
+        uint32_t i = 0;
+        for (; i < header->denoisersNum; i++)
+        {
+            const HistoryDenoiser& historyDenoiser = historyDenoisers[i];
+            if (historyDenoiser.identifier == denoiserData.desc.identifier && historyDenoiser.denoiser == denoiserData.desc.denoiser && historyDenoiser.permanentPoolNum == denoiserData.permanentPoolNum)
+                break;
+        }
+
+        if (i == header->denoisersNum)
+            return Result::INVALID_ARGUMENT;
+    }
+
+    // Apply (the next frame advances all denoisers, even if "frameIndex" matches)
+    for (DenoiserData& denoiserData : m_DenoiserData)
+    {
+        const HistoryDenoiser* historyDenoiser = historyDenoisers;
+        while (historyDenoiser->identifier != denoiserData.desc.identifier)
+            historyDenoiser++;
+
+        denoiserData.frameIndex = historyDenoiser->frameIndex;
+        denoiserData.accumulatedFrameNum = historyDenoiser->accumulatedFrameNum;
+        denoiserData.isPingPongOdd = historyDenoiser->isPingPongOdd != 0;
+        denoiserData.isStarted = false;
+
+        if (permanentPoolRemap)
+        {
+            for (uint16_t i = 0; i < denoiserData.permanentPoolNum; i++)
+                permanentPoolRemap[denoiserData.permanentPoolOffset + i] = historyDenoiser->permanentPoolOffset + i;
+        }
+    }
+
+    ViewState& view = m_Viewports[0];
+    memcpy(&view.historyCommonSettings, &header->commonSettings, sizeof(view.historyCommonSettings));
+    view.isHistoryImported = true;
+    view.isFirstUse = false;
+
+    return Result::SUCCESS;
+}
+
+nrd::Result nrd::InstanceImpl::InheritHistory(const InstanceImpl& source, uint16_t* permanentPoolRemap)
+{
+    if (&source == this)
+        return Result::INVALID_ARGUMENT;
+
+    // Viewport states (viewports not found in "source" start from scratch)
+    uint32_t viewportsNum = (uint32_t)(m_Viewports.size() < source.m_Viewports.size() ? m_Viewports.size() : source.m_Viewports.size());
+    for (uint32_t i = 0; i < viewportsNum; i++)
+        m_Viewports[i] = source.m_Viewports[i];
+
+    // Denoisers
+    for (DenoiserData& denoiserData : m_DenoiserData)
+    {
+        const DenoiserData* sourceDenoiserData = nullptr;
+        for (const DenoiserData& temp : source.m_DenoiserData)
+        {
+            if (temp.desc.identifier == denoiserData.desc.identifier && temp.desc.denoiser == denoiserData.desc.denoiser
+                && temp.desc.viewportIndex == denoiserData.desc.viewportIndex && temp.permanentPoolNum == denoiserData.permanentPoolNum)
+            {
+                sourceDenoiserData = &temp;
+                break;
+            }
+        }
+
+        if (sourceDenoiserData)
+        {
+            memcpy(&denoiserData.settings, &sourceDenoiserData->settings, denoiserData.settingsSize);
+            denoiserData.frameIndex = sourceDenoiserData->frameIndex;
+            denoiserData.accumulatedFrameNum = sourceDenoiserData->accumulatedFrameNum;
+            denoiserData.isPingPongOdd = sourceDenoiserData->isPingPongOdd;
+            denoiserData.isStarted = sourceDenoiserData->isStarted;
+            denoiserData.isRestartPending = sourceDenoiserData->isRestartPending;
+        }
+        else
+            denoiserData.isRestartPending = true; // new textures must be cleared
+
+        if (permanentPoolRemap)
+        {
+            for (uint16_t i = 0; i < denoiserData.permanentPoolNum; i++)
+                permanentPoolRemap[denoiserData.permanentPoolOffset + i] = sourceDenoiserData ? uint16_t(sourceDenoiserData->permanentPoolOffset + i) : uint16_t(-1);
+        }
+    }
+
+    return Result::SUCCESS;
+}
+
+nrd::AccumulationMode nrd::InstanceImpl::GetAccumulationMode(Identifier identifier) const
+{
+    for (const DenoiserData& denoiserData : m_DenoiserData)
+    {
+        if (denoiserData.desc.identifier == identifier)
+            return GetAccumulationMode(denoiserData);
+    }
+
+    return AccumulationMode::CONTINUE;
+}
+
+nrd::AccumulationMode nrd::InstanceImpl::GetAccumulationMode(const DenoiserData& denoiserData) const
+{
+    // A denoiser added by "InheritHistory" restarts alone, "ViewState::commonSettings" stays untouched (it's shared by all denoisers of the viewport)
+    const ViewState& view = m_Viewports[denoiserData.desc.viewportIndex];
+
+    return denoiserData.isRestarting ? AccumulationMode::CLEAR_AND_RESTART : view.commonSettings.accumulationMode;
 }
 
 void nrd::InstanceImpl::AddComputeDispatchDesc
@@ -582,6 +1301,7 @@ void nrd::InstanceImpl::AddComputeDispatchDesc
     NumThreads numThreads,
     uint16_t downsampleFactor,
     uint32_t constantBufferDataSize,
+    uint32_t rootConstantDataSize,
     uint32_t maxRepeatNum,
     const char* shaderFileName,
     const ComputeShaderDesc& dxbc,
@@ -590,12 +1310,12 @@ void nrd::InstanceImpl::AddComputeDispatchDesc
 )
 {
     // Pipeline (unique only)
+    uint64_t shaderFileNameHash = HashString(shaderFileName);
+
     size_t pipelineIndex = 0;
     for (; pipelineIndex < m_Pipelines.size(); pipelineIndex++)
     {
-        const PipelineDesc& pipeline = m_Pipelines[pipelineIndex];
-
-        if (!strcmp(pipeline.shaderFileName, shaderFileName))
+        if (m_PipelineHashes[pipelineIndex] == shaderFileNameHash && !strcmp(m_Pipelines[pipelineIndex].shaderFileName, shaderFileName))
             break;
     }
 
@@ -607,7 +1327,19 @@ void nrd::InstanceImpl::AddComputeDispatchDesc
         pipelineDesc.computeShaderDXBC = dxbc;
         pipelineDesc.computeShaderDXIL = dxil;
         pipelineDesc.computeShaderSPIRV = spirv;
+
+        // Formats not embedded into the library come from shader packs (if any)
+        ComputeShaderDesc* computeShaders = &pipelineDesc.computeShaderDXBC;
+        for (uint32_t i = 0; i < m_ShaderPacksNum; i++)
+        {
+            const ShaderPackImpl& shaderPack = *(const ShaderPackImpl*)m_ShaderPacks[i];
+
+            ComputeShaderDesc& computeShader = computeShaders[(uint32_t)shaderPack.GetFormat()];
+            if (!computeShader.bytecode)
+                computeShader = shaderPack.Find(shaderFileName);
+        }
         pipelineDesc.resourceRanges = (ResourceRangeDesc*)m_ResourceRanges.size();
+        pipelineDesc.rootConstantDataSize = rootConstantDataSize;
         pipelineDesc.hasConstantData = constantBufferDataSize != 0;
 
         for (size_t r = 0; r < 2; r++)
@@ -630,8 +1362,12 @@ void nrd::InstanceImpl::AddComputeDispatchDesc
         }
 
         m_Pipelines.push_back( pipelineDesc );
+        m_PipelineHashes.push_back(shaderFileNameHash);
     }
 
+    assert("Root constants must match across dispatches sharing a pipeline!" && m_Pipelines[pipelineIndex].rootConstantDataSize == rootConstantDataSize);
+    assert("Root constants don't fit into 'DispatchDesc::rootConstantData'!" && rootConstantDataSize <= sizeof(DispatchDesc::rootConstantData));
+
     // Dispatch
     InternalDispatchDesc computeDispatchDesc = {};
     computeDispatchDesc.name = m_PassName;
@@ -639,6 +1375,7 @@ void nrd::InstanceImpl::AddComputeDispatchDesc
     computeDispatchDesc.downsampleFactor = downsampleFactor;
     computeDispatchDesc.maxRepeatsNum = (uint16_t)maxRepeatNum;
     computeDispatchDesc.constantBufferDataSize = constantBufferDataSize;
+    computeDispatchDesc.rootConstantDataSize = rootConstantDataSize;
     computeDispatchDesc.resourcesNum = uint32_t(m_Resources.size() - m_ResourceOffset);
     computeDispatchDesc.resources = (ResourceDesc*)m_ResourceOffset;
     computeDispatchDesc.numThreads = numThreads;
@@ -646,18 +1383,86 @@ void nrd::InstanceImpl::AddComputeDispatchDesc
     m_Dispatches.push_back(computeDispatchDesc);
 }
 
+nrd::ComputeShaderDesc nrd::InstanceImpl::DecompressShader(const CompressedShaderBlob& blob)
+{
+    if (m_SkipShaders)
+        return {};
+
+    // Decompress on first use, shared by all pipelines of the instance using the same bytecode
+    for (const DecompressedShader& decompressedShader : m_DecompressedShaders)
+    {
+        if (decompressedShader.offset == blob.offset)
+            return {decompressedShader.bytecode, blob.size};
+    }
+
+#ifdef NRD_EMBEDS_COMPRESSED_SHADERS
+    uint8_t* bytecode = m_StdAllocator.allocate(blob.size);
+    if (bytecode && DecompressLz4(g_NrdShaderBlobs + blob.offset, blob.compressedSize, bytecode, blob.size))
+    {
+        m_DecompressedShaders.push_back({blob.offset, bytecode});
+
+        return {bytecode, blob.size};
+    }
+
+    m_StdAllocator.deallocate(bytecode, 0);
+#endif
+
+    assert("Shader decompression failed!" && false);
+
+    return {};
+}
+
 void nrd::InstanceImpl::PrepareDesc()
 {
     m_Desc = {};
 
     m_Desc.constantBufferRegisterIndex = NRD_CONSTANT_BUFFER_REGISTER_INDEX;
     m_Desc.constantBufferSpaceIndex = NRD_CONSTANT_BUFFER_SPACE_INDEX;
+    m_Desc.rootConstantsRegisterIndex = NRD_ROOT_CONSTANTS_REGISTER_INDEX;
 
     m_Desc.samplers = g_Samplers.data();
     m_Desc.samplersNum = (uint32_t)g_Samplers.size();
     m_Desc.samplersSpaceIndex = NRD_SAMPLERS_SPACE_INDEX;
     m_Desc.samplersBaseRegisterIndex = 0;
 
+    // Resources for odd frames, i.e. with applied ping-pong swaps (the graph stays immutable after creation)
+    m_ResourcesOddOffset = m_Resources.size();
+    m_Resources.resize(m_ResourcesOddOffset * 2);
+
+    for (size_t i = 0; i < m_ResourcesOddOffset; i++)
+        m_Resources[m_ResourcesOddOffset + i] = m_Resources[i];
+
+    for (const PingPong& pingPong : m_PingPongs)
+        m_Resources[m_ResourcesOddOffset + pingPong.resourceIndex].indexInPool = pingPong.indexInPoolToSwapWith;
+
+    // Resources for "resample" dispatches (input - the old texture, output - the new one)
+    m_ResampleResourcesOffset = m_Resources.size();
+
+    for (uint16_t i = 0; i < (uint16_t)m_PermanentPool.size(); i++)
+    {
+        m_Resources.push_back( {DescriptorType::TEXTURE, ResourceType::PERMANENT_POOL, i} );
+        m_Resources.push_back( {DescriptorType::STORAGE_TEXTURE, ResourceType::PERMANENT_POOL, i} );
+    }
+
+    // Internal output storage (worst case: all dispatches with all repeats + all clears, or all resamples)
+    uint32_t dispatchesMaxNum = (uint32_t)m_ClearResources.size();
+    m_ConstantDataSize = 0;
+
+    for (size_t i = 0; i < m_Dispatches.size(); i++)
+    {
+        if (i == m_DispatchClearIndex[0] || i == m_DispatchClearIndex[1] || i == m_DispatchResampleIndex[0] || i == m_DispatchResampleIndex[1])
+            continue;
+
+        const InternalDispatchDesc& dispatchDesc = m_Dispatches[i];
+        dispatchesMaxNum += dispatchDesc.maxRepeatsNum;
+        m_ConstantDataSize += GetAlignedSize(dispatchDesc.constantBufferDataSize, CONSTANT_DATA_ALIGNMENT) * dispatchDesc.maxRepeatsNum;
+    }
+
+    dispatchesMaxNum = max(dispatchesMaxNum, (uint32_t)m_PermanentPool.size());
+
+    // Since now all containers are "locked" (pointers below stay valid)
+    MoveToArena(dispatchesMaxNum);
+
     m_Desc.pipelines = m_Pipelines.data();
     m_Desc.pipelinesNum = (uint32_t)m_Pipelines.size();
     m_Desc.resourcesSpaceIndex = NRD_RESOURCES_SPACE_INDEX;
@@ -696,6 +1501,7 @@ void nrd::InstanceImpl::PrepareDesc()
         {
             m_Desc.descriptorPoolDesc.constantBuffersMaxNum += dispatchDesc.maxRepeatsNum;
             m_Desc.constantBufferMaxDataSize = max(dispatchDesc.constantBufferDataSize, m_Desc.constantBufferMaxDataSize);
+            assert("'CONSTANT_DATA_MAX_SIZE' is too small!" && dispatchDesc.constantBufferDataSize <= CONSTANT_DATA_MAX_SIZE);
         }
     }
 
@@ -707,6 +1513,15 @@ void nrd::InstanceImpl::PrepareDesc()
     if (!samplersAreInSeparateSet)
         m_Desc.descriptorPoolDesc.samplersMaxNum += clearNum * m_Desc.samplersNum;
 
+    // For potential resamples (a resize frame)
+    uint32_t resampleNum = (uint32_t)m_PermanentPool.size();
+    m_Desc.descriptorPoolDesc.texturesMaxNum += resampleNum;
+    m_Desc.descriptorPoolDesc.storageTexturesMaxNum += resampleNum;
+    m_Desc.descriptorPoolDesc.setsMaxNum += resampleNum;
+
+    if (!samplersAreInSeparateSet)
+        m_Desc.descriptorPoolDesc.samplersMaxNum += resampleNum * m_Desc.samplersNum;
+
     // Assign resources
     for (PipelineDesc& pipelineDesc : m_Pipelines)
     {
@@ -724,15 +1539,100 @@ void nrd::InstanceImpl::PrepareDesc()
     m_Desc.descriptorPoolDesc.setsMaxNum *= descriptorSetNum;
 }
 
-void nrd::InstanceImpl::UpdatePingPong(const DenoiserData& denoiserData)
+static void* ArenaAllocate(void* userArg, size_t size, size_t alignment)
 {
-    for (uint32_t i = 0; i < denoiserData.pingPongNum; i++)
-    {
-        PingPong& pingPong = m_PingPongs[denoiserData.pingPongOffset + i];
-        ResourceDesc& resource = m_Resources[pingPong.resourceIndex];
+    nrd::Arena& arena = *(nrd::Arena*)userArg;
 
-        Swap(resource.indexInPool, pingPong.indexInPoolToSwapWith);
+    size_t offset = GetAlignedSize(arena.offset, (uint32_t)(alignment > nrd::ARENA_ALIGNMENT ? alignment : nrd::ARENA_ALIGNMENT));
+    if (offset + size > arena.size)
+    {
+        assert("Arena overflow: containers must not grow after 'Create'!" && false);
+        return nullptr;
     }
+
+    arena.offset = offset + size;
+
+    return arena.memory + offset;
+}
+
+static void* ArenaReallocate(void*, void*, size_t, size_t)
+{
+    assert("Not supported!" && false);
+
+    return nullptr;
+}
+
+static void ArenaFree(void*, void*)
+{
+}
+
+void nrd::InstanceImpl::MoveToArena(size_t activeDispatchesNum)
+{
+    // Measure (hot data goes first for better locality in "GetComputeDispatches")
+    size_t arenaSize = GetArenaSize<InternalDispatchDesc>(m_Dispatches.size())
+        + GetArenaSize<ResourceDesc>(m_Resources.size())
+        + GetArenaSize<DenoiserData>(m_DenoiserData.size())
+        + GetArenaSize<ClearResource>(m_ClearResources.size())
+        + GetArenaSize<DispatchDesc>(activeDispatchesNum)
+        + GetArenaSize<uint8_t>(m_ConstantDataSize)
+        + GetArenaSize<PipelineDesc>(m_Pipelines.size())
+        + GetArenaSize<uint64_t>(m_PipelineHashes.size())
+        + GetArenaSize<ResourceRangeDesc>(m_ResourceRanges.size())
+        + GetArenaSize<TextureDesc>(m_PermanentPool.size())
+        + GetArenaSize<TextureDesc>(m_TransientPool.size())
+        + GetArenaSize<PingPong>(m_PingPongs.size())
+        + GetArenaSize<ViewState>(m_Viewports.size());
+
+    // Allocate once
+    const AllocationCallbacks& allocationCallbacks = m_StdAllocator.GetInterface();
+
+    m_Arena.memory = (uint8_t*)allocationCallbacks.Allocate(allocationCallbacks.userArg, arenaSize, ARENA_ALIGNMENT);
+    m_Arena.size = m_Arena.memory ? arenaSize : 0;
+    m_Arena.offset = 0;
+
+    m_ArenaCallbacks.Allocate = ArenaAllocate;
+    m_ArenaCallbacks.Reallocate = ArenaReallocate;
+    m_ArenaCallbacks.Free = ArenaFree;
+    m_ArenaCallbacks.userArg = &m_Arena;
+
+    // Lay out (must match the order above)
+    MoveToArena(m_Dispatches, m_Dispatches.size());
+    MoveToArena(m_Resources, m_Resources.size());
+    MoveToArena(m_DenoiserData, m_DenoiserData.size());
+    MoveToArena(m_ClearResources, m_ClearResources.size());
+    MoveToArena(m_ActiveDispatches, activeDispatchesNum);
+
+    m_ConstantData = (uint8_t*)ArenaAllocate(&m_Arena, m_ConstantDataSize, ARENA_ALIGNMENT);
+
+    MoveToArena(m_Pipelines, m_Pipelines.size());
+    MoveToArena(m_PipelineHashes, m_PipelineHashes.size());
+    MoveToArena(m_ResourceRanges, m_ResourceRanges.size());
+    MoveToArena(m_PermanentPool, m_PermanentPool.size());
+    MoveToArena(m_TransientPool, m_TransientPool.size());
+    MoveToArena(m_PingPongs, m_PingPongs.size());
+    MoveToArena(m_Viewports, m_Viewports.size());
+
+    // Not needed anymore
+    m_IndexRemap.clear();
+    m_IndexRemap.shrink_to_fit();
+}
+
+void nrd::InstanceImpl::AdvanceFrame(DenoiserData& denoiserData, const DispatchContext& context)
+{
+    const ViewState& view = *context.view;
+
+    // Idempotent for a given "frameIndex", i.e. repeated calls within a frame produce the same dispatches
+    if (denoiserData.isStarted && denoiserData.frameIndex == view.commonSettings.frameIndex)
+        return;
+
+    denoiserData.frameIndex = view.commonSettings.frameIndex;
+    denoiserData.isPingPongOdd = !denoiserData.isPingPongOdd;
+    denoiserData.isStarted = true;
+
+#ifdef NRD_DENOISER_REFERENCE
+    if (denoiserData.desc.denoiser == Denoiser::REFERENCE)
+        Advance_Reference(denoiserData, context);
+#endif
 }
 
 void nrd::InstanceImpl::PushTexture(DescriptorType descriptorType, uint16_t localIndex, uint16_t indexToSwapWith)
@@ -770,8 +1670,48 @@ void nrd::InstanceImpl::PushTexture(DescriptorType descriptorType, uint16_t loca
     m_Resources.push_back( {descriptorType, resourceType, globalIndex} );
 }
 
-void nrd::InstanceImpl::AddTextureToTransientPool(const TextureDesc& textureDesc)
+void nrd::InstanceImpl::StoreDispatch(DispatchContext& context, const DispatchDesc& dispatchDesc)
+{
+    // Keep counting if the output is full (or absent) to report the required size
+    if (context.dispatchDescsNum < context.dispatchDescsCapacity)
+        context.dispatchDescs[context.dispatchDescsNum] = dispatchDesc;
+
+    context.dispatchDescsNum++;
+}
+
+void nrd::InstanceImpl::FlushConstants(DispatchContext& context)
+{
+    if (!context.constantStagingSize)
+        return;
+
+    // Maximize CB reuse (compared with the previous dispatch on the stack, not in the output)
+    bool isSameAsPrev = context.constantStagingPrevSize == context.constantStagingSize && context.constantStagingPrevIndex + 1 == context.constantStagingIndex
+        && !memcmp(context.constantStagingPrev, context.constantStaging, context.constantStagingSize);
+
+    if (isSameAsPrev && context.constantStagingIndex < context.dispatchDescsCapacity)
+        context.dispatchDescs[context.constantStagingIndex].constantBufferDataMatchesPreviousDispatch = true;
+
+    // The only write to the output
+    if (context.constantStagingDst)
+        memcpy(context.constantStagingDst, context.constantStaging, context.constantStagingSize);
+
+    std::swap(context.constantStaging, context.constantStagingPrev);
+    context.constantStagingPrevSize = context.constantStagingSize;
+    context.constantStagingPrevIndex = context.constantStagingIndex;
+    context.constantStagingSize = 0;
+}
+
+void nrd::InstanceImpl::_AddTextureToPermanentPool([[maybe_unused]] uint16_t slot, const TextureDesc& textureDesc)
+{
+    assert("'Permanent' entries and textures mismatch!" && slot == PERMANENT_POOL_START + m_PermanentPool.size() - m_PermanentPoolOffset);
+
+    m_PermanentPool.push_back(textureDesc);
+}
+
+void nrd::InstanceImpl::_AddTextureToTransientPool([[maybe_unused]] uint16_t slot, const TextureDesc& textureDesc)
 {
+    assert("'Transient' entries and textures mismatch!" && slot == TRANSIENT_POOL_START + m_IndexRemap.size());
+
     // Try to find a replacement from previous denoisers
     for (uint16_t i = 0; i < m_TransientPoolOffset; i++)
     {
@@ -802,8 +1742,10 @@ void nrd::InstanceImpl::AddTextureToTransientPool(const TextureDesc& textureDesc
     m_TransientPool.push_back(textureDesc);
 }
 
-void* nrd::InstanceImpl::PushDispatch(const DenoiserData& denoiserData, uint32_t localIndex)
+void* nrd::InstanceImpl::PushDispatch(DispatchContext& context, const DenoiserData& denoiserData, uint32_t localIndex, const void* rootConstantData)
 {
+    const ViewState& view = *context.view;
+
     size_t dispatchIndex = denoiserData.dispatchOffset + localIndex;
     const InternalDispatchDesc& internalDispatchDesc = m_Dispatches[dispatchIndex];
 
@@ -811,41 +1753,60 @@ void* nrd::InstanceImpl::PushDispatch(const DenoiserData& denoiserData, uint32_t
     DispatchDesc dispatchDesc = {};
     dispatchDesc.name = internalDispatchDesc.name;
     dispatchDesc.identifier = internalDispatchDesc.identifier;
-    dispatchDesc.resources = internalDispatchDesc.resources;
+    dispatchDesc.resources = internalDispatchDesc.resources + (denoiserData.isPingPongOdd ? m_ResourcesOddOffset : 0);
     dispatchDesc.resourcesNum = internalDispatchDesc.resourcesNum;
     dispatchDesc.pipelineIndex = internalDispatchDesc.pipelineIndex;
 
-    // Update constant data
-    if (m_ConstantDataOffset + internalDispatchDesc.constantBufferDataSize > CONSTANT_DATA_SIZE)
+    // Update constant data: denoisers fill the staging block, which goes to the output on the next push (if the output is full,
+    // "constantBufferData" is NULL, but constants are still staged to keep denoisers unaware of it)
+    FlushConstants(context);
+
+    if (internalDispatchDesc.constantBufferDataSize)
     {
-        assert("Constant data doesn't fit into the prealocated array!" && false);
-        dispatchDesc.constantBufferData = nullptr; // TODO: better crash
+        size_t offset = GetAlignedSize(context.constantDataOffset, context.constantDataAlignment);
+        context.constantDataOffset = offset + internalDispatchDesc.constantBufferDataSize;
+
+        context.constantStagingDst = context.constantDataOffset <= context.constantDataCapacity ? context.constantData + offset : nullptr;
+        context.constantStagingSize = internalDispatchDesc.constantBufferDataSize;
+        context.constantStagingIndex = context.dispatchDescsNum;
+
+        dispatchDesc.constantBufferData = context.constantStagingDst;
+        dispatchDesc.constantBufferDataSize = internalDispatchDesc.constantBufferDataSize;
+
+        // Needed for "constantBufferDataMatchesPreviousDispatch"
+        memset(context.constantStaging, 0, context.constantStagingSize);
     }
-    else
-        dispatchDesc.constantBufferData = m_ConstantData + m_ConstantDataOffset;
 
-    dispatchDesc.constantBufferDataSize = internalDispatchDesc.constantBufferDataSize;
-    m_ConstantDataOffset += internalDispatchDesc.constantBufferDataSize;
+    // Root constants (per-pass values, which would otherwise make constant buffers differ across repeats)
+    if (internalDispatchDesc.rootConstantDataSize)
+    {
+        assert("Root constants are expected!" && rootConstantData);
 
-    // Needed for "constantBufferDataMatchesPreviousDispatch"
-    if (dispatchDesc.constantBufferData)
-        memset((void*)dispatchDesc.constantBufferData, 0, dispatchDesc.constantBufferDataSize);
+        dispatchDesc.rootConstantDataSize = internalDispatchDesc.rootConstantDataSize;
+        memcpy(dispatchDesc.rootConstantData, rootConstantData, internalDispatchDesc.rootConstantDataSize);
+    }
 
     // Update grid size
-    uint16_t w = m_CommonSettings.rectSize[0];
-    uint16_t h = m_CommonSettings.rectSize[1];
+    uint16_t w = view.commonSettings.rectSize[0];
+    uint16_t h = view.commonSettings.rectSize[1];
     uint16_t d = internalDispatchDesc.downsampleFactor;
 
     if (d == USE_MAX_DIMS)
     {
-        w = max(w, m_CommonSettings.rectSizePrev[0]);
-        h = max(h, m_CommonSettings.rectSizePrev[1]);
+        w = max(w, view.commonSettings.rectSizePrev[0]);
+        h = max(h, view.commonSettings.rectSizePrev[1]);
         d = 1;
     }
     else if (d == IGNORE_RS)
     {
-        w = m_CommonSettings.resourceSize[0];
-        h = m_CommonSettings.resourceSize[1];
+        w = view.commonSettings.resourceSize[0];
+        h = view.commonSettings.resourceSize[1];
+        d = 1;
+    }
+    else if (d == USE_OUTPUT_SIZE)
+    {
+        w = view.commonSettings.outputSize[0];
+        h = view.commonSettings.outputSize[1];
         d = 1;
     }
 
@@ -856,7 +1817,76 @@ void* nrd::InstanceImpl::PushDispatch(const DenoiserData& denoiserData, uint32_t
     dispatchDesc.gridHeight = DivideUp(h, internalDispatchDesc.numThreads.height);
 
     // Store
-    m_ActiveDispatches.push_back(dispatchDesc);
+    StoreDispatch(context, dispatchDesc);
 
-    return (void*)dispatchDesc.constantBufferData;
+    return internalDispatchDesc.constantBufferDataSize ? context.constantStaging : nullptr;
+}
+
+void nrd::InstanceImpl::AddUpscaleDispatch(uint16_t diff, uint16_t spec, uint16_t diffOut, uint16_t specOut)
+{
+    PushInput( AsUint(ResourceType::IN_VIEWZ) );
+    PushInput( diff );
+    PushInput( spec );
+    PushOutput( diffOut );
+    PushOutput( specOut );
+    AddDispatchWithRootConstants( Upscale, Upscale, USE_OUTPUT_SIZE );
+}
+
+void nrd::InstanceImpl::PushUpscaleDispatch(DispatchContext& context, const DenoiserData& denoiserData, uint32_t localIndex)
+{
+    const ViewState& view = *context.view;
+
+    Denoiser denoiser = denoiserData.desc.denoiser;
+
+    UpscaleRootConstants rootConstants = {};
+    rootConstants.gHasDiffuse = (denoiser == Denoiser::REBLUR_SPECULAR || denoiser == Denoiser::RELAX_SPECULAR) ? 0 : 1;
+    rootConstants.gHasSpecular = (denoiser == Denoiser::REBLUR_DIFFUSE || denoiser == Denoiser::RELAX_DIFFUSE) ? 0 : 1;
+
+    UpscaleConstants* consts = (UpscaleConstants*)PushDispatch(context, denoiserData, localIndex, &rootConstants);
+    consts->gRectSize               = float2(view.commonSettings.rectSize[0], view.commonSettings.rectSize[1]);
+    consts->gOutputSizeInv          = float2(1.0f / float(view.commonSettings.outputSize[0]), 1.0f / float(view.commonSettings.outputSize[1]));
+    consts->gJitter                 = float2(view.commonSettings.cameraJitter[0], view.commonSettings.cameraJitter[1]);
+    consts->gOutputSize             = uint2(view.commonSettings.outputSize[0], view.commonSettings.outputSize[1]);
+    consts->gDenoisingRange         = view.commonSettings.denoisingRange;
+    consts->gViewZScale             = view.commonSettings.viewZScale;
+    consts->gDebug                  = view.commonSettings.debug;
+}
+
+void nrd::InstanceImpl::AddSamplingHintDispatch(uint16_t historyLength, uint16_t diffIn, uint16_t specIn, uint16_t diff, uint16_t spec)
+{
+    PushInput( AsUint(ResourceType::IN_VIEWZ) );
+    PushInput( historyLength );
+    PushInput( diffIn );
+    PushInput( specIn );
+    PushInput( diff );
+    PushInput( spec );
+    PushOutput( AsUint(ResourceType::OUT_SAMPLING_HINT) );
+    AddDispatchWithRootConstants( SamplingHint, SamplingHint, 1 );
+}
+
+void nrd::InstanceImpl::PushSamplingHintDispatch(DispatchContext& context, const DenoiserData& denoiserData, uint32_t localIndex)
+{
+    const ViewState& view = *context.view;
+
+    Denoiser denoiser = denoiserData.desc.denoiser;
+    bool isReblur = denoiser == Denoiser::REBLUR_DIFFUSE || denoiser == Denoiser::REBLUR_SPECULAR || denoiser == Denoiser::REBLUR_DIFFUSE_SPECULAR;
+
+    SamplingHintRootConstants rootConstants = {};
+    rootConstants.gHasDiffuse = (denoiser == Denoiser::REBLUR_SPECULAR || denoiser == Denoiser::RELAX_SPECULAR) ? 0 : 1;
+    rootConstants.gHasSpecular = (denoiser == Denoiser::REBLUR_DIFFUSE || denoiser == Denoiser::RELAX_DIFFUSE) ? 0 : 1;
+    rootConstants.gIsReblur = isReblur ? 1 : 0;
+
+    // History length is stored normalized: REBLUR - "accumSpeed / REBLUR_MAX_HISTORY_FRAME_NUM", RELAX - "historyLength / 255",
+    // i.e. it can't exceed the storage limit (clamped like in the denoisers)
+    uint32_t diffMaxAccumulatedFrameNum = isReblur ? min(denoiserData.settings.reblur.maxAccumulatedFrameNum, REBLUR_MAX_HISTORY_FRAME_NUM) : min(denoiserData.settings.relax.diffuseMaxAccumulatedFrameNum, RELAX_MAX_HISTORY_FRAME_NUM);
+    uint32_t specMaxAccumulatedFrameNum = isReblur ? diffMaxAccumulatedFrameNum : min(denoiserData.settings.relax.specularMaxAccumulatedFrameNum, RELAX_MAX_HISTORY_FRAME_NUM);
+
+    SamplingHintConstants* consts = (SamplingHintConstants*)PushDispatch(context, denoiserData, localIndex, &rootConstants);
+    consts->gRectOrigin             = uint2(view.commonSettings.rectOrigin[0], view.commonSettings.rectOrigin[1]);
+    consts->gRectSize               = uint2(view.commonSettings.rectSize[0], view.commonSettings.rectSize[1]);
+    consts->gMaxAccumulatedFrameNum = float2(float(diffMaxAccumulatedFrameNum), float(specMaxAccumulatedFrameNum));
+    consts->gHistoryLengthScale     = float(isReblur ? REBLUR_MAX_HISTORY_FRAME_NUM : RELAX_MAX_HISTORY_FRAME_NUM);
+    consts->gDenoisingRange         = view.commonSettings.denoisingRange;
+    consts->gViewZScale             = view.commonSettings.viewZScale;
+    consts->gDebug                  = view.commonSettings.debug;
 }
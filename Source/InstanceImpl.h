@@ -17,26 +17,73 @@ license agreement from NVIDIA CORPORATION is strictly prohibited.
 typedef nrd::AllocationCallbacks AllocationCallbacks;
 #include "StdAllocator.h"
 
+#include "ShaderPackFormat.h"
 #include "Timer.h"
 #include "ml.h"
 #include "ml.hlsli"
 
+// "NRD_DENOISER_SUBSET": only denoisers listed in "NRD_DENOISERS" (CMake) are compiled in, otherwise all of them
+#ifndef NRD_DENOISER_SUBSET
+    #define NRD_DENOISER_REBLUR_DIFFUSE
+    #define NRD_DENOISER_REBLUR_DIFFUSE_OCCLUSION
+    #define NRD_DENOISER_REBLUR_DIFFUSE_SH
+    #define NRD_DENOISER_REBLUR_SPECULAR
+    #define NRD_DENOISER_REBLUR_SPECULAR_OCCLUSION
+    #define NRD_DENOISER_REBLUR_SPECULAR_SH
+    #define NRD_DENOISER_REBLUR_DIFFUSE_SPECULAR
+    #define NRD_DENOISER_REBLUR_DIFFUSE_SPECULAR_OCCLUSION
+    #define NRD_DENOISER_REBLUR_DIFFUSE_SPECULAR_SH
+    #define NRD_DENOISER_REBLUR_DIFFUSE_DIRECTIONAL_OCCLUSION
+    #define NRD_DENOISER_RELAX_DIFFUSE
+    #define NRD_DENOISER_RELAX_DIFFUSE_SH
+    #define NRD_DENOISER_RELAX_SPECULAR
+    #define NRD_DENOISER_RELAX_SPECULAR_SH
+    #define NRD_DENOISER_RELAX_DIFFUSE_SPECULAR
+    #define NRD_DENOISER_RELAX_DIFFUSE_SPECULAR_SH
+    #define NRD_DENOISER_SIGMA_SHADOW
+    #define NRD_DENOISER_SIGMA_SHADOW_TRANSLUCENCY
+    #define NRD_DENOISER_REFERENCE
+#endif
+
+#if defined(NRD_DENOISER_REBLUR_DIFFUSE) || defined(NRD_DENOISER_REBLUR_DIFFUSE_OCCLUSION) || defined(NRD_DENOISER_REBLUR_DIFFUSE_SH) || \
+    defined(NRD_DENOISER_REBLUR_SPECULAR) || defined(NRD_DENOISER_REBLUR_SPECULAR_OCCLUSION) || defined(NRD_DENOISER_REBLUR_SPECULAR_SH) || \
+    defined(NRD_DENOISER_REBLUR_DIFFUSE_SPECULAR) || defined(NRD_DENOISER_REBLUR_DIFFUSE_SPECULAR_OCCLUSION) || \
+    defined(NRD_DENOISER_REBLUR_DIFFUSE_SPECULAR_SH) || defined(NRD_DENOISER_REBLUR_DIFFUSE_DIRECTIONAL_OCCLUSION)
+    #define NRD_DENOISER_REBLUR_SHARED
+#endif
+
+#if defined(NRD_DENOISER_RELAX_DIFFUSE) || defined(NRD_DENOISER_RELAX_DIFFUSE_SH) || defined(NRD_DENOISER_RELAX_SPECULAR) || \
+    defined(NRD_DENOISER_RELAX_SPECULAR_SH) || defined(NRD_DENOISER_RELAX_DIFFUSE_SPECULAR) || defined(NRD_DENOISER_RELAX_DIFFUSE_SPECULAR_SH)
+    #define NRD_DENOISER_RELAX_SHARED
+#endif
+
+#if defined(NRD_DENOISER_SIGMA_SHADOW) || defined(NRD_DENOISER_SIGMA_SHADOW_TRANSLUCENCY)
+    #define NRD_DENOISER_SIGMA_SHARED
+#endif
+
 #define _NRD_STRINGIFY(s) #s
 #define NRD_STRINGIFY(s) _NRD_STRINGIFY(s)
 
-#ifdef NRD_EMBEDS_DXBC_SHADERS
+// "NRD_EMBEDS_COMPRESSED_SHADERS": shader headers declare "CompressedShaderBlob" instead of bytecode (see "Tools/ShaderCompressor.cpp")
+#if defined(NRD_EMBEDS_DXBC_SHADERS) && defined(NRD_EMBEDS_COMPRESSED_SHADERS)
+    #define GET_DXBC_SHADER_DESC(shaderName) DecompressShader(g_##shaderName##_cs_dxbc)
+#elif defined(NRD_EMBEDS_DXBC_SHADERS)
     #define GET_DXBC_SHADER_DESC(shaderName) {g_##shaderName##_cs_dxbc, GetCountOf(g_##shaderName##_cs_dxbc)}
 #else
     #define GET_DXBC_SHADER_DESC(shaderName) {}
 #endif
 
-#ifdef NRD_EMBEDS_DXIL_SHADERS
+#if defined(NRD_EMBEDS_DXIL_SHADERS) && defined(NRD_EMBEDS_COMPRESSED_SHADERS)
+    #define GET_DXIL_SHADER_DESC(shaderName) DecompressShader(g_##shaderName##_cs_dxil)
+#elif defined(NRD_EMBEDS_DXIL_SHADERS)
     #define GET_DXIL_SHADER_DESC(shaderName) {g_##shaderName##_cs_dxil, GetCountOf(g_## shaderName##_cs_dxil)}
 #else
     #define GET_DXIL_SHADER_DESC(shaderName) {}
 #endif
 
-#ifdef NRD_EMBEDS_SPIRV_SHADERS
+#if defined(NRD_EMBEDS_SPIRV_SHADERS) && defined(NRD_EMBEDS_COMPRESSED_SHADERS)
+    #define GET_SPIRV_SHADER_DESC(shaderName) DecompressShader(g_##shaderName##_cs_spirv)
+#elif defined(NRD_EMBEDS_SPIRV_SHADERS)
     #define GET_SPIRV_SHADER_DESC(shaderName) {g_##shaderName##_cs_spirv, GetCountOf(g_##shaderName##_cs_spirv)}
 #else
     #define GET_SPIRV_SHADER_DESC(shaderName) {}
@@ -44,32 +91,65 @@ typedef nrd::AllocationCallbacks AllocationCallbacks;
 
 #define AddDispatch(shaderName, passName, downsampleFactor) \
     AddComputeDispatchDesc(NumThreads(passName ## GroupX, passName ## GroupY), \
-        downsampleFactor, sizeof(passName ## Constants), 1, #shaderName ".cs", \
+        downsampleFactor, sizeof(passName ## Constants), 0, 1, #shaderName ".cs", \
         GET_DXBC_SHADER_DESC(shaderName), GET_DXIL_SHADER_DESC(shaderName), GET_SPIRV_SHADER_DESC(shaderName))
 
 #define AddDispatchNoConstants(shaderName, passName, downsampleFactor) \
     AddComputeDispatchDesc(NumThreads(passName ## GroupX, passName ## GroupY), \
-        downsampleFactor, 0, 1, #shaderName ".cs", \
+        downsampleFactor, 0, 0, 1, #shaderName ".cs", \
         GET_DXBC_SHADER_DESC(shaderName), GET_DXIL_SHADER_DESC(shaderName), GET_SPIRV_SHADER_DESC(shaderName))
 
 #define AddDispatchRepeated(shaderName, passName, downsampleFactor, repeatNum) \
     AddComputeDispatchDesc(NumThreads(passName ## GroupX, passName ## GroupY), \
-        downsampleFactor, sizeof(passName ## Constants), repeatNum, #shaderName ".cs", \
+        downsampleFactor, sizeof(passName ## Constants), 0, repeatNum, #shaderName ".cs", \
+        GET_DXBC_SHADER_DESC(shaderName), GET_DXIL_SHADER_DESC(shaderName), GET_SPIRV_SHADER_DESC(shaderName))
+
+// Passes with "passName ## RootConstants", which are passed to "PushDispatch"
+#define AddDispatchNoConstantsWithRootConstants(shaderName, passName, downsampleFactor) \
+    AddComputeDispatchDesc(NumThreads(passName ## GroupX, passName ## GroupY), \
+        downsampleFactor, 0, sizeof(passName ## RootConstants), 1, #shaderName ".cs", \
+        GET_DXBC_SHADER_DESC(shaderName), GET_DXIL_SHADER_DESC(shaderName), GET_SPIRV_SHADER_DESC(shaderName))
+
+#define AddDispatchWithRootConstants(shaderName, passName, downsampleFactor) \
+    AddComputeDispatchDesc(NumThreads(passName ## GroupX, passName ## GroupY), \
+        downsampleFactor, sizeof(passName ## Constants), sizeof(passName ## RootConstants), 1, #shaderName ".cs", \
+        GET_DXBC_SHADER_DESC(shaderName), GET_DXIL_SHADER_DESC(shaderName), GET_SPIRV_SHADER_DESC(shaderName))
+
+#define AddDispatchRepeatedWithRootConstants(shaderName, passName, downsampleFactor, repeatNum) \
+    AddComputeDispatchDesc(NumThreads(passName ## GroupX, passName ## GroupY), \
+        downsampleFactor, sizeof(passName ## Constants), sizeof(passName ## RootConstants), repeatNum, #shaderName ".cs", \
         GET_DXBC_SHADER_DESC(shaderName), GET_DXIL_SHADER_DESC(shaderName), GET_SPIRV_SHADER_DESC(shaderName))
 
 #define PushPass(passName) \
     _PushPass(NRD_STRINGIFY(DENOISER_NAME) " - " passName)
 
+// Textures must be added in the order of "Permanent" / "Transient" entries, names are derived from them ("DENOISER::SLOT")
+#define AddTextureToPermanentPool(slot, format, downsampleFactor) \
+    _AddTextureToPermanentPool(AsUint(Permanent::slot), {format, downsampleFactor, NRD_STRINGIFY(DENOISER_NAME) "::" #slot})
+
+#define AddTextureToTransientPool(slot, format, downsampleFactor) \
+    _AddTextureToTransientPool(AsUint(Transient::slot), {format, downsampleFactor, NRD_STRINGIFY(DENOISER_NAME) "::" #slot})
+
+// Optional output stage, shared by REBLUR and RELAX radiance denoisers (see "CommonSettings::outputSize")
+#define NRD_ADD_UPSCALE_DISPATCH( diff, spec, diffOut, specOut ) \
+    PushPass("Upscale"); \
+    AddUpscaleDispatch( AsUint(diff), AsUint(spec), AsUint(diffOut), AsUint(specOut) )
+
+// Optional output stage, shared by REBLUR and RELAX radiance denoisers (see "CommonSettings::enableSamplingHint")
+#define NRD_ADD_SAMPLING_HINT_DISPATCH( historyLength, diffIn, specIn, diff, spec ) \
+    PushPass("Sampling hint"); \
+    AddSamplingHintDispatch( AsUint(historyLength), AsUint(diffIn), AsUint(specIn), AsUint(diff), AsUint(spec) )
+
 // TODO: rework is needed, but still better than copy-pasting
 #define NRD_DECLARE_DIMS \
-    [[maybe_unused]] uint16_t resourceW = m_CommonSettings.resourceSize[0]; \
-    [[maybe_unused]] uint16_t resourceH = m_CommonSettings.resourceSize[1]; \
-    [[maybe_unused]] uint16_t resourceWprev = m_CommonSettings.resourceSizePrev[0]; \
-    [[maybe_unused]] uint16_t resourceHprev = m_CommonSettings.resourceSizePrev[1]; \
-    [[maybe_unused]] uint16_t rectW = m_CommonSettings.rectSize[0]; \
-    [[maybe_unused]] uint16_t rectH = m_CommonSettings.rectSize[1]; \
-    [[maybe_unused]] uint16_t rectWprev = m_CommonSettings.rectSizePrev[0]; \
-    [[maybe_unused]] uint16_t rectHprev = m_CommonSettings.rectSizePrev[1];
+    [[maybe_unused]] uint16_t resourceW = view.commonSettings.resourceSize[0]; \
+    [[maybe_unused]] uint16_t resourceH = view.commonSettings.resourceSize[1]; \
+    [[maybe_unused]] uint16_t resourceWprev = view.commonSettings.resourceSizePrev[0]; \
+    [[maybe_unused]] uint16_t resourceHprev = view.commonSettings.resourceSizePrev[1]; \
+    [[maybe_unused]] uint16_t rectW = view.commonSettings.rectSize[0]; \
+    [[maybe_unused]] uint16_t rectH = view.commonSettings.rectSize[1]; \
+    [[maybe_unused]] uint16_t rectWprev = view.commonSettings.rectSizePrev[0]; \
+    [[maybe_unused]] uint16_t rectHprev = view.commonSettings.rectSizePrev[1];
 
 
 // IMPORTANT: needed only for DXBC produced by ShaderMake without "--useAPI"
@@ -82,6 +162,10 @@ typedef nrd::AllocationCallbacks AllocationCallbacks;
 #define NRD_CONSTANT( type, name ) type name;
 #define NRD_CONSTANTS_END };
 
+#define NRD_ROOT_CONSTANTS_START( name ) struct name {
+#define NRD_ROOT_CONSTANT( type, name ) type name;
+#define NRD_ROOT_CONSTANTS_END( name ) };
+
 #define NRD_INPUTS_START
 #define NRD_INPUT(...)
 #define NRD_INPUTS_END
@@ -99,14 +183,26 @@ namespace nrd
 {
     constexpr uint16_t PERMANENT_POOL_START = 1000;
     constexpr uint16_t TRANSIENT_POOL_START = 2000;
-    constexpr size_t CONSTANT_DATA_SIZE = 128 * 1024; // TODO: improve
+    constexpr uint32_t CONSTANT_DATA_ALIGNMENT = sizeof(float4); // minimal, see "PushDispatch"
+    constexpr uint32_t CONSTANT_DATA_MAX_SIZE = 2048; // per dispatch, constants are staged on the stack (see "GetComputeDispatches")
+    constexpr uint32_t ARENA_ALIGNMENT = 64; // cache line
+    constexpr uint32_t HISTORY_MAGIC = 0x4844524E; // "NRDH"
+    constexpr uint32_t HISTORY_VERSION = 3; // 2 - "CommonSettings::outputSize", 3 - "CommonSettings::enableSamplingHint"
 
     constexpr uint16_t USE_MAX_DIMS = 0xFFFF;
     constexpr uint16_t IGNORE_RS = 0xFFFE;
+    constexpr uint16_t USE_OUTPUT_SIZE = 0xFFFD;
 
     inline uint16_t DivideUp(uint32_t x, uint16_t y)
     { return uint16_t((x + y - 1) / y); }
 
+    // Radiance denoisers, which have output stages ("Upscale" and "Sampling hint")
+    inline bool IsUpscaleSupported(Denoiser denoiser)
+    {
+        return denoiser == Denoiser::REBLUR_DIFFUSE || denoiser == Denoiser::REBLUR_SPECULAR || denoiser == Denoiser::REBLUR_DIFFUSE_SPECULAR ||
+            denoiser == Denoiser::RELAX_DIFFUSE || denoiser == Denoiser::RELAX_SPECULAR || denoiser == Denoiser::RELAX_DIFFUSE_SPECULAR;
+    }
+
     template <class T>
     inline uint16_t AsUint(T x)
     { return (uint16_t)x; }
@@ -127,6 +223,16 @@ namespace nrd
         size_t dispatchOffset;
         size_t pingPongOffset;
         size_t pingPongNum;
+        uint16_t permanentPoolOffset;
+        uint16_t permanentPoolNum;
+
+        // Per-frame state, advanced once per "CommonSettings::frameIndex" (see "AdvanceFrame")
+        uint32_t frameIndex;
+        uint32_t accumulatedFrameNum;
+        bool isPingPongOdd;
+        bool isStarted;
+        bool isRestartPending; // added to a live instance (see "InheritHistory"), the next frame restarts accumulation
+        bool isRestarting; // the current frame restarts accumulation (regardless of "CommonSettings::accumulationMode")
     };
 
     struct PingPong
@@ -154,6 +260,7 @@ namespace nrd
         uint32_t resourcesNum;
         const uint8_t* constantBufferData;
         uint32_t constantBufferDataSize;
+        uint32_t rootConstantDataSize;
         Identifier identifier;
         uint16_t pipelineIndex;
         uint16_t downsampleFactor;
@@ -161,14 +268,119 @@ namespace nrd
         NumThreads numThreads;
     };
 
+    struct ViewState;
+
+    // Per "GetComputeDispatches" call state, i.e. concurrent calls don't share anything mutable
+    struct DispatchContext
+    {
+        const ViewState* view; // the viewport of the current denoiser
+        DispatchDesc* dispatchDescs;
+        uint8_t* constantData;
+        uint8_t* constantStaging; // constants of the last pushed dispatch, written to "constantData" once (see "FlushConstants")
+        uint8_t* constantStagingPrev; // constants of the previously flushed dispatch
+        uint8_t* constantStagingDst; // NULL if constants don't fit into the output
+        size_t constantDataOffset;
+        size_t constantDataCapacity;
+        uint32_t dispatchDescsNum;
+        uint32_t dispatchDescsCapacity;
+        uint32_t constantDataAlignment;
+        uint32_t constantStagingSize; // 0 - nothing is staged
+        uint32_t constantStagingPrevSize;
+        uint32_t constantStagingIndex; // dispatch index
+        uint32_t constantStagingPrevIndex;
+        AccumulationMode accumulationMode; // effective for the current denoiser (see "GetAccumulationMode")
+    };
+
+    struct CompressedShaderBlob // a range in "g_NrdShaderBlobs"
+    {
+        uint32_t offset;
+        uint32_t compressedSize;
+        uint32_t size;
+    };
+
+    struct DecompressedShader
+    {
+        uint32_t offset; // blob identity
+        uint8_t* bytecode;
+    };
+
+    // Linear allocator for containers locked after "Create" (all of them live in a single allocation, "Free" is a no-op)
+    struct Arena
+    {
+        uint8_t* memory;
+        size_t size;
+        size_t offset;
+    };
+
+    // Warm start blob ("ExportHistory"): HistoryHeader, HistoryDenoiser[ denoisersNum ]
+    struct HistoryHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t libraryVersion; // major << 16 | minor
+        uint32_t denoisersNum;
+        CommonSettings commonSettings; // the last frame
+    };
+
+    struct HistoryDenoiser
+    {
+        Identifier identifier;
+        Denoiser denoiser;
+        uint32_t frameIndex;
+        uint32_t accumulatedFrameNum;
+        uint16_t permanentPoolOffset;
+        uint16_t permanentPoolNum;
+        uint32_t isPingPongOdd;
+    };
+
     struct ClearResource
     {
         Identifier identifier;
         ResourceDesc resource;
         uint16_t downsampleFactor;
+        uint16_t viewportIndex;
         bool isInteger;
     };
 
+    // Everything derived from "CommonSettings", one per viewport. Denoisers access it via "DispatchContext::view", i.e. calls
+    // for different viewports don't share anything mutable
+    struct ViewState
+    {
+        Timer timer;
+        CommonSettings commonSettings = {};
+        CommonSettings historyCommonSettings = {}; // the last frame of the imported history
+        float4x4 viewToClip = float4x4::Identity();
+        float4x4 viewToClipPrev = float4x4::Identity();
+        float4x4 clipToView = float4x4::Identity();
+        float4x4 clipToViewPrev = float4x4::Identity();
+        float4x4 worldToView = float4x4::Identity();
+        float4x4 worldToViewPrev = float4x4::Identity();
+        float4x4 viewToWorld = float4x4::Identity();
+        float4x4 viewToWorldPrev = float4x4::Identity();
+        float4x4 worldToClip = float4x4::Identity();
+        float4x4 worldToClipPrev = float4x4::Identity();
+        float4x4 clipToWorld = float4x4::Identity();
+        float4x4 clipToWorldPrev = float4x4::Identity();
+        float4x4 worldPrevToWorld = float4x4::Identity();
+        float4 rotatorPre = float4::Zero();
+        float4 rotator = float4::Zero();
+        float4 rotatorPost = float4::Zero();
+        float4 frustum = float4::Zero();
+        float4 frustumPrev = float4::Zero();
+        float3 cameraDelta = float3::Zero();
+        float3 viewDirection = float3::Zero();
+        float3 viewDirectionPrev = float3::Zero();
+        float splitScreenPrev = 0.0f;
+        float orthoMode = 0.0f;
+        float checkerboardResolveAccumSpeed = 0.0f;
+        float jitterDelta = 0.0f;
+        float timeDelta = 0.0f;
+        float frameRateScale = 0.0f;
+        float projectY = 0.0f;
+        bool isFirstUse = true;
+        bool isHistoryImported = false;
+    };
+
     class InstanceImpl
     {
     // Add denoisers here
@@ -184,9 +396,9 @@ namespace nrd
         void Add_ReblurDiffuseSpecularOcclusion(DenoiserData& denoiserData);
         void Add_ReblurDiffuseSpecularSh(DenoiserData& denoiserData);
         void Add_ReblurDiffuseDirectionalOcclusion(DenoiserData& denoiserData);
-        void Update_Reblur(const DenoiserData& denoiserData);
-        void Update_ReblurOcclusion(const DenoiserData& denoiserData);
-        void AddSharedConstants_Reblur(const ReblurSettings& settings, void* data);
+        void Update_Reblur(const DenoiserData& denoiserData, DispatchContext& context);
+        void Update_ReblurOcclusion(const DenoiserData& denoiserData, DispatchContext& context);
+        void AddSharedConstants_Reblur(const ReblurSettings& settings, const DispatchContext& context, void* data);
 
         // Relax
         void Add_RelaxDiffuse(DenoiserData& denoiserData);
@@ -195,18 +407,19 @@ namespace nrd
         void Add_RelaxSpecularSh(DenoiserData& denoiserData);
         void Add_RelaxDiffuseSpecular(DenoiserData& denoiserData);
         void Add_RelaxDiffuseSpecularSh(DenoiserData& denoiserData);
-        void Update_Relax(const DenoiserData& denoiserData);
-        void AddSharedConstants_Relax(const RelaxSettings& settings, void* data);
+        void Update_Relax(const DenoiserData& denoiserData, DispatchContext& context);
+        void AddSharedConstants_Relax(const RelaxSettings& settings, const DispatchContext& context, void* data);
 
         // Sigma
         void Add_SigmaShadow(DenoiserData& denoiserData);
         void Add_SigmaShadowTranslucency(DenoiserData& denoiserData);
-        void Update_SigmaShadow(const DenoiserData& denoiserData);
-        void AddSharedConstants_Sigma(const SigmaSettings& settings, void* data);
+        void Update_SigmaShadow(const DenoiserData& denoiserData, DispatchContext& context);
+        void AddSharedConstants_Sigma(const SigmaSettings& settings, const DispatchContext& context, void* data);
 
         // Other
         void Add_Reference(DenoiserData& denoiserData);
-        void Update_Reference(const DenoiserData& denoiserData);
+        void Advance_Reference(DenoiserData& denoiserData, const DispatchContext& context);
+        void Update_Reference(const DenoiserData& denoiserData, DispatchContext& context);
 
     // Internal
     public:
@@ -220,17 +433,13 @@ namespace nrd
             , m_PingPongs(GetStdAllocator())
             , m_ResourceRanges(GetStdAllocator())
             , m_Pipelines(GetStdAllocator())
+            , m_PipelineHashes(GetStdAllocator())
             , m_Dispatches(GetStdAllocator())
             , m_ActiveDispatches(GetStdAllocator())
             , m_IndexRemap(GetStdAllocator())
+            , m_DecompressedShaders(GetStdAllocator())
+            , m_Viewports(GetStdAllocator())
         {
-            m_ConstantDataUnaligned = m_StdAllocator.allocate(CONSTANT_DATA_SIZE + sizeof(float4));
-
-            // IMPORTANT: underlying memory for constants must be aligned, as well as any individual SSE-type containing member,
-            // because a compiler can generate dangerous "movaps" instruction!
-            m_ConstantData = Align(m_ConstantDataUnaligned, sizeof(float4));
-            memset(m_ConstantData, 0, CONSTANT_DATA_SIZE);
-
             m_DenoiserData.reserve(8);
             m_PermanentPool.reserve(32);
             m_TransientPool.reserve(32);
@@ -239,12 +448,20 @@ namespace nrd
             m_PingPongs.reserve(32);
             m_ResourceRanges.reserve(64);
             m_Pipelines.reserve(32);
+            m_PipelineHashes.reserve(32);
             m_Dispatches.reserve(32);
             m_ActiveDispatches.reserve(32);
         }
 
         ~InstanceImpl()
-        { m_StdAllocator.deallocate(m_ConstantDataUnaligned, 0); }
+        {
+            // Containers moved to the arena don't touch memory on destruction (trivial types, no-op "Free")
+            if (m_Arena.memory)
+                m_StdAllocator.GetInterface().Free(m_StdAllocator.GetInterface().userArg, m_Arena.memory);
+
+            for (const DecompressedShader& decompressedShader : m_DecompressedShaders)
+                m_StdAllocator.deallocate(decompressedShader.bytecode, 0);
+        }
 
         inline const InstanceDesc& GetDesc() const
         { return m_Desc; }
@@ -252,10 +469,21 @@ namespace nrd
         inline StdAllocator<uint8_t>& GetStdAllocator()
         { return m_StdAllocator; }
 
+        inline void SkipShaders() // planning only, must be called before "Create"
+        { m_SkipShaders = true; }
+
         Result Create(const InstanceCreationDesc& instanceCreationDesc);
-        Result SetCommonSettings(const CommonSettings& commonSettings);
+        Result SetViewportSettings(uint32_t viewportIndex, const CommonSettings& commonSettings);
+        Result SetStereoSettings(const CommonSettings& leftEye, const CommonSettings& rightEye);
         Result SetDenoiserSettings(Identifier identifier, const void* denoiserSettings);
         Result GetComputeDispatches(const Identifier* identifiers, uint32_t identifiersNum, const DispatchDesc*& dispatchDescs, uint32_t& dispatchDescsNum);
+        Result GetComputeDispatches(const Identifier* identifiers, uint32_t identifiersNum, DispatchDesc* dispatchDescs, uint32_t& dispatchDescsNum, uint8_t* constantData, uint32_t& constantDataSize, uint32_t constantDataAlignment);
+        Result GetResizeDispatches(uint16_t resourceWidth, uint16_t resourceHeight, const DispatchDesc*& dispatchDescs, uint32_t& dispatchDescsNum);
+        Result GetDispatchStats(const DispatchDesc* dispatchDescs, uint32_t dispatchDescsNum, DispatchStats& dispatchStats) const;
+        Result Plan(uint16_t resourceWidth, uint16_t resourceHeight, InstancePlan& instancePlan, PassPlan* passPlans, uint32_t& passPlansNum) const;
+        Result ExportHistory(void* data, uint32_t& dataSize) const;
+        Result ImportHistory(const void* data, uint32_t dataSize, uint16_t* permanentPoolRemap);
+        Result InheritHistory(const InstanceImpl& source, uint16_t* permanentPoolRemap);
 
     private:
         void AddComputeDispatchDesc
@@ -263,6 +491,7 @@ namespace nrd
             NumThreads numThreads,
             uint16_t downsampleFactor,
             uint32_t constantBufferDataSize,
+            uint32_t rootConstantDataSize,
             uint32_t maxRepeatNum,
             const char* shaderFileName,
             const ComputeShaderDesc& dxbc,
@@ -270,17 +499,26 @@ namespace nrd
             const ComputeShaderDesc& spirv
         );
 
+        Result UpdateViewState(uint32_t viewportIndex, const CommonSettings& commonSettings);
         void PrepareDesc();
-        void UpdatePingPong(const DenoiserData& denoiserData);
+        void MoveToArena(size_t activeDispatchesNum);
+        ComputeShaderDesc DecompressShader(const CompressedShaderBlob& blob);
+        void AdvanceFrame(DenoiserData& denoiserData, const DispatchContext& context);
+        AccumulationMode GetAccumulationMode(Identifier identifier) const;
+        AccumulationMode GetAccumulationMode(const DenoiserData& denoiserData) const;
         void PushTexture(DescriptorType descriptorType, uint16_t localIndex, uint16_t indexToSwapWith = uint16_t(-1));
+        void StoreDispatch(DispatchContext& context, const DispatchDesc& dispatchDesc);
+        void FlushConstants(DispatchContext& context);
 
     // Available in denoiser implementations
     private:
-        void AddTextureToTransientPool(const TextureDesc& textureDesc);
-        void* PushDispatch(const DenoiserData& denoiserData, uint32_t localIndex);
-
-        inline void AddTextureToPermanentPool(const TextureDesc& textureDesc)
-        { m_PermanentPool.push_back(textureDesc); }
+        void _AddTextureToPermanentPool(uint16_t slot, const TextureDesc& textureDesc);
+        void _AddTextureToTransientPool(uint16_t slot, const TextureDesc& textureDesc);
+        void* PushDispatch(DispatchContext& context, const DenoiserData& denoiserData, uint32_t localIndex, const void* rootConstantData = nullptr);
+        void AddUpscaleDispatch(uint16_t diff, uint16_t spec, uint16_t diffOut, uint16_t specOut);
+        void PushUpscaleDispatch(DispatchContext& context, const DenoiserData& denoiserData, uint32_t localIndex);
+        void AddSamplingHintDispatch(uint16_t historyLength, uint16_t diffIn, uint16_t specIn, uint16_t diff, uint16_t spec);
+        void PushSamplingHintDispatch(DispatchContext& context, const DenoiserData& denoiserData, uint32_t localIndex);
 
         inline void PushInput(uint16_t indexInPool, uint16_t indexToSwapWith = uint16_t(-1))
         { PushTexture(DescriptorType::TEXTURE, indexInPool, indexToSwapWith); }
@@ -294,6 +532,21 @@ namespace nrd
             m_ResourceOffset = m_Resources.size();
         }
 
+        template<typename T>
+        static inline size_t GetArenaSize(size_t num)
+        { return GetAlignedSize(num * sizeof(T), ARENA_ALIGNMENT); }
+
+        template<typename T>
+        inline void MoveToArena(Vector<T>& v, size_t num)
+        {
+            Vector<T> relocated{StdAllocator<T>(m_ArenaCallbacks)};
+            relocated.reserve(num);
+            relocated.assign(v.begin(), v.end());
+            relocated.insert(relocated.end(), num - relocated.size(), T{}); // "resize" needs a default constructor
+
+            v = std::move(relocated); // the allocator is propagated, the old storage is freed
+        }
+
     private:
         StdAllocator<uint8_t> m_StdAllocator;
         Vector<DenoiserData> m_DenoiserData;
@@ -304,49 +557,27 @@ namespace nrd
         Vector<PingPong> m_PingPongs;
         Vector<ResourceRangeDesc> m_ResourceRanges;
         Vector<PipelineDesc> m_Pipelines;
+        Vector<uint64_t> m_PipelineHashes; // "shaderFileName" hashes for fast lookup
         Vector<InternalDispatchDesc> m_Dispatches;
-        Vector<DispatchDesc> m_ActiveDispatches;
+        Vector<DispatchDesc> m_ActiveDispatches; // storage for "GetComputeDispatches" with instance-owned output
         Vector<uint16_t> m_IndexRemap;
-        Timer m_Timer;
+        Vector<DecompressedShader> m_DecompressedShaders;
+        Vector<ViewState> m_Viewports;
         InstanceDesc m_Desc = {};
-        CommonSettings m_CommonSettings = {};
-        float4x4 m_ViewToClip = float4x4::Identity();
-        float4x4 m_ViewToClipPrev = float4x4::Identity();
-        float4x4 m_ClipToView = float4x4::Identity();
-        float4x4 m_ClipToViewPrev = float4x4::Identity();
-        float4x4 m_WorldToView = float4x4::Identity();
-        float4x4 m_WorldToViewPrev = float4x4::Identity();
-        float4x4 m_ViewToWorld = float4x4::Identity();
-        float4x4 m_ViewToWorldPrev = float4x4::Identity();
-        float4x4 m_WorldToClip = float4x4::Identity();
-        float4x4 m_WorldToClipPrev = float4x4::Identity();
-        float4x4 m_ClipToWorld = float4x4::Identity();
-        float4x4 m_ClipToWorldPrev = float4x4::Identity();
-        float4x4 m_WorldPrevToWorld = float4x4::Identity();
-        float4 m_RotatorPre = float4::Zero();
-        float4 m_Rotator = float4::Zero();
-        float4 m_RotatorPost = float4::Zero();
-        float4 m_Frustum = float4::Zero();
-        float4 m_FrustumPrev = float4::Zero();
-        float3 m_CameraDelta = float3::Zero();
-        float3 m_ViewDirection = float3::Zero();
-        float3 m_ViewDirectionPrev = float3::Zero();
-        float m_SplitScreenPrev = 0.0f;
         const char* m_PassName = nullptr;
-        uint8_t* m_ConstantDataUnaligned = nullptr;
-        uint8_t* m_ConstantData = nullptr;
-        size_t m_ConstantDataOffset = 0;
+        const ShaderPack* const* m_ShaderPacks = nullptr;
+        AllocationCallbacks m_ArenaCallbacks = {};
+        Arena m_Arena = {};
+        uint8_t* m_ConstantData = nullptr; // storage for "GetComputeDispatches" with instance-owned output
+        size_t m_ConstantDataSize = 0;
+        size_t m_ResourcesOddOffset = 0;
         size_t m_ResourceOffset = 0;
+        size_t m_ResampleResourcesOffset = 0;
         size_t m_DispatchClearIndex[2] = {};
-        float m_OrthoMode = 0.0f;
-        float m_CheckerboardResolveAccumSpeed = 0.0f;
-        float m_JitterDelta = 0.0f;
-        float m_TimeDelta = 0.0f;
-        float m_FrameRateScale = 0.0f;
-        float m_ProjectY = 0.0f;
-        uint32_t m_AccumulatedFrameNum = 0;
+        size_t m_DispatchResampleIndex[2] = {};
+        uint32_t m_ShaderPacksNum = 0;
         uint16_t m_TransientPoolOffset = 0;
         uint16_t m_PermanentPoolOffset = 0;
-        bool m_IsFirstUse = true;
+        bool m_SkipShaders = false;
     };
 }
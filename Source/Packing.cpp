@@ -0,0 +1,811 @@
+/*
+Copyright (c) 2022, NVIDIA CORPORATION. All rights reserved.
+
+NVIDIA CORPORATION and its licensors retain all intellectual property
+and proprietary rights in and to this software, related documentation
+and any modifications thereto. Any use, reproduction, disclosure or
+distribution of this software and related documentation without an express
+license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+// Host-side port of "NRD.hlsli" packing. Every function is written once as a template over the lane type ("float" or "vfloat"),
+// i.e. SIMD and scalar (tail) paths execute the same sequence of IEEE operations and produce identical bits:
+//  - "Min" / "Max" follow "minps" / "maxps" semantics, "rsqrt" is "1 / sqrt", "exp2" is evaluated per lane
+//  - FMA contraction is disabled for this file (see CMakeLists.txt)
+
+#include "NRDPacking.h"
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX2__)
+    #define NRD_SIMD_WIDTH 8
+#elif defined(__SSE4_1__) || (defined(_M_X64) && !defined(__clang__))
+    #define NRD_SIMD_WIDTH 4
+#else
+    #define NRD_SIMD_WIDTH 1
+#endif
+
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+    #define NRD_F16C 1
+#else
+    #define NRD_F16C 0
+#endif
+
+#if (NRD_SIMD_WIDTH > 1 || NRD_F16C)
+    #include <immintrin.h>
+#endif
+
+constexpr float FP16_MAX = 65504.0f;
+constexpr float EPS = 1e-6f;
+
+//=================================================================================================================================
+// Lane types
+//=================================================================================================================================
+
+static inline float Min(float a, float b)
+{ return a < b ? a : b; }
+
+static inline float Max(float a, float b)
+{ return a > b ? a : b; }
+
+static inline float Abs(float x)
+{ return std::fabs(x); }
+
+static inline float Sqrt(float x)
+{ return std::sqrt(x); }
+
+static inline float Exp2(float x)
+{ return std::exp2(x); }
+
+static inline float Select(bool mask, float a, float b)
+{ return mask ? a : b; }
+
+static inline bool Or(bool a, bool b)
+{ return a || b; }
+
+static inline bool IsInvalid(float x) // NAN or INF
+{ return (x - x) != 0.0f; }
+
+static inline void Load(const float* p, float& x)
+{ x = p[0]; }
+
+static inline void Load(const float* p, float& x, float& y, float& z)
+{ x = p[0]; y = p[1]; z = p[2]; }
+
+static inline void Load(const float* p, float& x, float& y, float& z, float& w)
+{ x = p[0]; y = p[1]; z = p[2]; w = p[3]; }
+
+static inline void Store(float* p, float x)
+{ p[0] = x; }
+
+static inline void Store(float* p, float x, float y, float z, float w)
+{ p[0] = x; p[1] = y; p[2] = z; p[3] = w; }
+
+#if (NRD_SIMD_WIDTH > 1)
+
+// 4 interleaved elements <=> SoA
+static inline void Load3x4(const float* p, __m128& x, __m128& y, __m128& z)
+{
+    __m128 r0 = _mm_loadu_ps(p);     // x0 y0 z0 x1
+    __m128 r1 = _mm_loadu_ps(p + 3); // x1 y1 z1 x2
+    __m128 r2 = _mm_loadu_ps(p + 6); // x2 y2 z2 x3
+    __m128 r3 = _mm_loadu_ps(p + 8); // z2 x3 y3 z3, doesn't read past the last element
+    r3 = _mm_shuffle_ps(r3, r3, _MM_SHUFFLE(3, 3, 2, 1));
+
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+    x = r0;
+    y = r1;
+    z = r2;
+}
+
+static inline void Load4x4(const float* p, __m128& x, __m128& y, __m128& z, __m128& w)
+{
+    x = _mm_loadu_ps(p);
+    y = _mm_loadu_ps(p + 4);
+    z = _mm_loadu_ps(p + 8);
+    w = _mm_loadu_ps(p + 12);
+
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+}
+
+static inline void Store4x4(float* p, __m128 x, __m128 y, __m128 z, __m128 w)
+{
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+
+    _mm_storeu_ps(p, x);
+    _mm_storeu_ps(p + 4, y);
+    _mm_storeu_ps(p + 8, z);
+    _mm_storeu_ps(p + 12, w);
+}
+
+#if (NRD_SIMD_WIDTH == 8)
+
+typedef __m256 vreg;
+
+#define NRD_V(name) _mm256_##name
+
+static inline __m256 Combine(__m128 lo, __m128 hi)
+{ return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1); }
+
+static inline __m128 Lo(__m256 x)
+{ return _mm256_castps256_ps128(x); }
+
+static inline __m128 Hi(__m256 x)
+{ return _mm256_extractf128_ps(x, 1); }
+
+#else
+
+typedef __m128 vreg;
+
+#define NRD_V(name) _mm_##name
+
+#endif
+
+struct vfloat
+{
+    vreg v;
+
+    inline vfloat()
+    {}
+
+    inline vfloat(vreg x) :
+        v(x)
+    {}
+
+    inline vfloat(float x) :
+        v(NRD_V(set1_ps)(x))
+    {}
+};
+
+struct vmask
+{
+    vreg v;
+};
+
+static inline vfloat operator+(vfloat a, vfloat b)
+{ return NRD_V(add_ps)(a.v, b.v); }
+
+static inline vfloat operator-(vfloat a, vfloat b)
+{ return NRD_V(sub_ps)(a.v, b.v); }
+
+static inline vfloat operator*(vfloat a, vfloat b)
+{ return NRD_V(mul_ps)(a.v, b.v); }
+
+static inline vfloat operator/(vfloat a, vfloat b)
+{ return NRD_V(div_ps)(a.v, b.v); }
+
+static inline vfloat operator-(vfloat a)
+{ return NRD_V(xor_ps)(a.v, NRD_V(set1_ps)(-0.0f)); }
+
+static inline vfloat Min(vfloat a, vfloat b)
+{ return NRD_V(min_ps)(a.v, b.v); }
+
+static inline vfloat Max(vfloat a, vfloat b)
+{ return NRD_V(max_ps)(a.v, b.v); }
+
+static inline vfloat Abs(vfloat x)
+{ return NRD_V(andnot_ps)(NRD_V(set1_ps)(-0.0f), x.v); }
+
+static inline vfloat Sqrt(vfloat x)
+{ return NRD_V(sqrt_ps)(x.v); }
+
+static inline vfloat Exp2(vfloat x)
+{
+    // No exact SIMD "exp2", lanes use the scalar path
+    float t[NRD_SIMD_WIDTH];
+    NRD_V(storeu_ps)(t, x.v);
+
+    for (uint32_t i = 0; i < NRD_SIMD_WIDTH; i++)
+        t[i] = std::exp2(t[i]);
+
+    return NRD_V(loadu_ps)(t);
+}
+
+static inline vfloat Select(vmask mask, vfloat a, vfloat b)
+{ return NRD_V(blendv_ps)(b.v, a.v, mask.v); }
+
+static inline vmask Or(vmask a, vmask b)
+{ return {NRD_V(or_ps)(a.v, b.v)}; }
+
+#if (NRD_SIMD_WIDTH == 8)
+
+static inline vmask operator>=(vfloat a, vfloat b)
+{ return {_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)}; }
+
+static inline vmask IsInvalid(vfloat x)
+{ return {_mm256_cmp_ps(_mm256_sub_ps(x.v, x.v), _mm256_setzero_ps(), _CMP_NEQ_UQ)}; }
+
+static inline void Load(const float* p, vfloat& x)
+{ x = _mm256_loadu_ps(p); }
+
+static inline void Load(const float* p, vfloat& x, vfloat& y, vfloat& z)
+{
+    __m128 x0, y0, z0, x1, y1, z1;
+    Load3x4(p, x0, y0, z0);
+    Load3x4(p + 12, x1, y1, z1);
+
+    x = Combine(x0, x1);
+    y = Combine(y0, y1);
+    z = Combine(z0, z1);
+}
+
+static inline void Load(const float* p, vfloat& x, vfloat& y, vfloat& z, vfloat& w)
+{
+    __m128 x0, y0, z0, w0, x1, y1, z1, w1;
+    Load4x4(p, x0, y0, z0, w0);
+    Load4x4(p + 16, x1, y1, z1, w1);
+
+    x = Combine(x0, x1);
+    y = Combine(y0, y1);
+    z = Combine(z0, z1);
+    w = Combine(w0, w1);
+}
+
+static inline void Store(float* p, vfloat x)
+{ _mm256_storeu_ps(p, x.v); }
+
+static inline void Store(float* p, vfloat x, vfloat y, vfloat z, vfloat w)
+{
+    Store4x4(p, Lo(x.v), Lo(y.v), Lo(z.v), Lo(w.v));
+    Store4x4(p + 16, Hi(x.v), Hi(y.v), Hi(z.v), Hi(w.v));
+}
+
+#else
+
+static inline vmask operator>=(vfloat a, vfloat b)
+{ return {_mm_cmpge_ps(a.v, b.v)}; }
+
+static inline vmask IsInvalid(vfloat x)
+{ return {_mm_cmpneq_ps(_mm_sub_ps(x.v, x.v), _mm_setzero_ps())}; }
+
+static inline void Load(const float* p, vfloat& x)
+{ x = _mm_loadu_ps(p); }
+
+static inline void Load(const float* p, vfloat& x, vfloat& y, vfloat& z)
+{ Load3x4(p, x.v, y.v, z.v); }
+
+static inline void Load(const float* p, vfloat& x, vfloat& y, vfloat& z, vfloat& w)
+{ Load4x4(p, x.v, y.v, z.v, w.v); }
+
+static inline void Store(float* p, vfloat x)
+{ _mm_storeu_ps(p, x.v); }
+
+static inline void Store(float* p, vfloat x, vfloat y, vfloat z, vfloat w)
+{ Store4x4(p, x.v, y.v, z.v, w.v); }
+
+#endif
+
+#undef NRD_V
+
+// Emits the SIMD loop and the scalar tail for the same body ("T" - lane type, "i" - first element)
+#define NRD_BATCH(...) \
+    uint32_t i = 0; \
+    for (; i + NRD_SIMD_WIDTH <= num; i += NRD_SIMD_WIDTH) \
+    { \
+        typedef vfloat T; \
+        __VA_ARGS__ \
+    } \
+    for (; i < num; i++) \
+    { \
+        typedef float T; \
+        __VA_ARGS__ \
+    }
+
+#else
+
+#define NRD_BATCH(...) \
+    for (uint32_t i = 0; i < num; i++) \
+    { \
+        typedef float T; \
+        __VA_ARGS__ \
+    }
+
+#endif
+
+//=================================================================================================================================
+// "NRD.hlsli" port
+//=================================================================================================================================
+
+template <class T>
+static inline T Saturate(T x)
+{ return Min(Max(x, T(0.0f)), T(1.0f)); }
+
+template <class T>
+static inline T Clamp(T x, float a, float b)
+{ return Min(Max(x, T(a)), T(b)); }
+
+template <class T>
+static inline T SignNotNegative(T x) // "step( 0.0, x ) * 2.0 - 1.0"
+{ return Select(x >= T(0.0f), T(1.0f), T(-1.0f)); }
+
+template <class T>
+static inline void Sanitize(T& x, float a, float b)
+{ x = Select(IsInvalid(x), T(0.0f), Clamp(x, a, b)); }
+
+template <class T>
+static inline void Sanitize(T& x, T& y, T& z, float a, float b)
+{
+    auto isInvalid = Or(Or(IsInvalid(x), IsInvalid(y)), IsInvalid(z));
+
+    x = Select(isInvalid, T(0.0f), Clamp(x, a, b));
+    y = Select(isInvalid, T(0.0f), Clamp(y, a, b));
+    z = Select(isInvalid, T(0.0f), Clamp(z, a, b));
+}
+
+template <class T>
+static inline void EncodeUnitVector(T x, T y, T z, T& px, T& py)
+{
+    T norm = Abs(x) + Abs(y) + Abs(z);
+    x = x / norm;
+    y = y / norm;
+    z = z / norm;
+
+    T octWrapX = (T(1.0f) - Abs(y)) * SignNotNegative(x);
+    T octWrapY = (T(1.0f) - Abs(x)) * SignNotNegative(y);
+
+    auto isUpper = z >= T(0.0f);
+    x = Select(isUpper, x, octWrapX);
+    y = Select(isUpper, y, octWrapY);
+
+    px = x * 0.5f + 0.5f;
+    py = y * 0.5f + 0.5f;
+}
+
+template <class T>
+static inline void DecodeUnitVector(T px, T py, T& x, T& y, T& z)
+{
+    px = px * 2.0f - 1.0f;
+    py = py * 2.0f - 1.0f;
+
+    z = T(1.0f) - Abs(px) - Abs(py);
+
+    T t = Saturate(-z);
+    x = px - t * SignNotNegative(px);
+    y = py - t * SignNotNegative(py);
+}
+
+template <class T>
+static inline void SafeNormalize(T& x, T& y, T& z)
+{
+    T invLength = T(1.0f) / Sqrt(x * x + y * y + z * z + 1e-9f);
+
+    x = x * invLength;
+    y = y * invLength;
+    z = z * invLength;
+}
+
+template <class T>
+static inline void LinearToYCoCg(T& r, T& g, T& b)
+{
+    T Y = r * 0.25f + g * 0.5f + b * 0.25f;
+    T Co = r * 0.5f + g * 0.0f + b * -0.5f;
+    T Cg = r * -0.25f + g * 0.5f + b * -0.25f;
+
+    r = Y;
+    g = Co;
+    b = Cg;
+}
+
+template <class T>
+static inline void YCoCgToLinear(T& Y, T& Co, T& Cg)
+{
+    T t = Y - Cg;
+    T g = Y + Cg;
+    T r = t + Co;
+    T b = t - Co;
+
+    Y = Max(r, T(0.0f));
+    Co = Max(g, T(0.0f));
+    Cg = Max(b, T(0.0f));
+}
+
+template <class T>
+static inline T Luminance(T r, T g, T b)
+{ return r * 0.2126f + g * 0.7152f + b * 0.0722f; } // IMPORTANT: must be in sync with ML_LUMINANCE_DEFAULT
+
+template <class T>
+static inline void PackNormalAndRoughness(T x, T y, T z, T roughness, T materialID, T& p0, T& p1, T& p2, T& p3)
+{
+#if (NRD_ROUGHNESS_ENCODING == 2) // SQRT_LINEAR
+    roughness = Sqrt(Saturate(roughness));
+#elif (NRD_ROUGHNESS_ENCODING == 0) // SQ_LINEAR
+    roughness = roughness * roughness;
+#endif
+
+#if (NRD_NORMAL_ENCODING == 2) // R10G10B10A2_UNORM
+    EncodeUnitVector(x, y, z, p0, p1);
+    p2 = roughness;
+    p3 = Saturate(materialID / 3.0f);
+#else
+    // Best fit
+    T maxAbs = Max(Abs(x), Max(Abs(y), Abs(z)));
+    x = x / maxAbs;
+    y = y / maxAbs;
+    z = z / maxAbs;
+
+    #if (NRD_NORMAL_ENCODING == 0 || NRD_NORMAL_ENCODING == 3) // RGBA8_UNORM, RGBA16_UNORM
+        x = x * 0.5f + 0.5f;
+        y = y * 0.5f + 0.5f;
+        z = z * 0.5f + 0.5f;
+    #endif
+
+    p0 = x;
+    p1 = y;
+    p2 = z;
+    p3 = roughness;
+
+    (void)materialID;
+#endif
+}
+
+template <class T>
+static inline void UnpackNormalAndRoughness(T p0, T p1, T p2, T p3, T& x, T& y, T& z, T& roughness, T& materialID)
+{
+#if (NRD_NORMAL_ENCODING == 2) // R10G10B10A2_UNORM
+    DecodeUnitVector(p0, p1, x, y, z);
+    roughness = p2;
+    materialID = p3 * 3.0f;
+#else
+    #if (NRD_NORMAL_ENCODING == 0 || NRD_NORMAL_ENCODING == 3) // RGBA8_UNORM, RGBA16_UNORM
+        p0 = p0 * 2.0f - 1.0f;
+        p1 = p1 * 2.0f - 1.0f;
+        p2 = p2 * 2.0f - 1.0f;
+    #endif
+
+    x = p0;
+    y = p1;
+    z = p2;
+    roughness = p3;
+    materialID = 0.0f;
+#endif
+
+    SafeNormalize(x, y, z);
+
+#if (NRD_ROUGHNESS_ENCODING == 2) // SQRT_LINEAR
+    roughness = roughness * roughness;
+#elif (NRD_ROUGHNESS_ENCODING == 0) // SQ_LINEAR
+    roughness = Sqrt(Saturate(roughness));
+#endif
+}
+
+template <class T>
+static inline T PackPenumbra(T distanceToOccluder, T penumbraSize)
+{
+    T penumbraRadius = penumbraSize * 0.5f;
+
+    return Select(distanceToOccluder >= T(FP16_MAX), T(FP16_MAX), Min(penumbraRadius, T(32768.0f)));
+}
+
+//=================================================================================================================================
+// API
+//=================================================================================================================================
+
+NRD_API void NRD_CALL nrd::NRD_FrontEnd_PackNormalAndRoughness(const float* normal, const float* roughness, const float* materialID, uint32_t num, float* packed)
+{
+    NRD_BATCH(
+        T x, y, z, r;
+        Load(normal + i * 3, x, y, z);
+        Load(roughness + i, r);
+
+        T m = 0.0f;
+        if (materialID)
+            Load(materialID + i, m);
+
+        T p0, p1, p2, p3;
+        PackNormalAndRoughness(x, y, z, r, m, p0, p1, p2, p3);
+
+        Store(packed + i * 4, p0, p1, p2, p3);
+    )
+}
+
+NRD_API void NRD_CALL nrd::NRD_FrontEnd_UnpackNormalAndRoughness(const float* packed, uint32_t num, float* normalAndRoughness, float* materialID)
+{
+    NRD_BATCH(
+        T p0, p1, p2, p3;
+        Load(packed + i * 4, p0, p1, p2, p3);
+
+        T x, y, z, r, m;
+        UnpackNormalAndRoughness(p0, p1, p2, p3, x, y, z, r, m);
+
+        Store(normalAndRoughness + i * 4, x, y, z, r);
+
+        if (materialID)
+            Store(materialID + i, m);
+    )
+}
+
+NRD_API void NRD_CALL nrd::REBLUR_FrontEnd_GetNormHitDist(const float* hitDist, const float* viewZ, const float* roughness, const HitDistanceParameters& hitDistanceParameters, uint32_t num, float* normHitDist)
+{
+    const float A = hitDistanceParameters.A;
+    const float B = hitDistanceParameters.B;
+    const float C = hitDistanceParameters.C;
+    const float D = hitDistanceParameters.D;
+
+    NRD_BATCH(
+        T h, z, r;
+        Load(hitDist + i, h);
+        Load(viewZ + i, z);
+        Load(roughness + i, r);
+
+        // "lerp( 1.0, C, s )" is "1.0 + s * ( C - 1.0 )"
+        T s = Saturate(Exp2(T(D) * r * r));
+        T f = (T(A) + Abs(z) * B) * (T(1.0f) + s * (T(C) - 1.0f));
+
+        Store(normHitDist + i, Saturate(h / f));
+    )
+}
+
+NRD_API void NRD_CALL nrd::REBLUR_FrontEnd_PackRadianceAndNormHitDist(const float* radiance, const float* normHitDist, uint32_t num, bool sanitize, float* packed)
+{
+    NRD_BATCH(
+        T r, g, b, h;
+        Load(radiance + i * 3, r, g, b);
+        Load(normHitDist + i, h);
+
+        if (sanitize)
+        {
+            Sanitize(r, g, b, 0.0f, FP16_MAX);
+            Sanitize(h, 0.0f, 1.0f);
+        }
+
+        LinearToYCoCg(r, g, b);
+
+        Store(packed + i * 4, r, g, b, h);
+    )
+}
+
+NRD_API void NRD_CALL nrd::REBLUR_FrontEnd_PackSh(const float* radiance, const float* normHitDist, const float* direction, uint32_t num, bool sanitize, float* packed0, float* packed1)
+{
+    NRD_BATCH(
+        T r, g, b, h, x, y, z;
+        Load(radiance + i * 3, r, g, b);
+        Load(normHitDist + i, h);
+        Load(direction + i * 3, x, y, z);
+
+        if (sanitize)
+        {
+            Sanitize(r, g, b, 0.0f, FP16_MAX);
+            Sanitize(h, 0.0f, 1.0f);
+            Sanitize(x, y, z, -1.0f, 1.0f);
+        }
+
+        LinearToYCoCg(r, g, b);
+
+        Store(packed0 + i * 4, r, g, b, h);
+        Store(packed1 + i * 4, x * r, y * r, z * r, T(0.0f));
+    )
+}
+
+NRD_API void NRD_CALL nrd::REBLUR_FrontEnd_PackDirectionalOcclusion(const float* direction, const float* normHitDist, uint32_t num, bool sanitize, float* packed)
+{
+    NRD_BATCH(
+        T x, y, z, h;
+        Load(direction + i * 3, x, y, z);
+        Load(normHitDist + i, h);
+
+        if (sanitize)
+        {
+            Sanitize(x, y, z, -1.0f, 1.0f);
+            Sanitize(h, 0.0f, 1.0f);
+        }
+
+        T Y = h;
+        T Co = h;
+        T Cg = h;
+        LinearToYCoCg(Y, Co, Cg);
+
+        Store(packed + i * 4, x * Y, y * Y, z * Y, Y);
+    )
+}
+
+NRD_API void NRD_CALL nrd::RELAX_FrontEnd_PackRadianceAndHitDist(const float* radiance, const float* hitDist, uint32_t num, bool sanitize, float* packed)
+{
+    NRD_BATCH(
+        T r, g, b, h;
+        Load(radiance + i * 3, r, g, b);
+        Load(hitDist + i, h);
+
+        if (sanitize)
+        {
+            Sanitize(r, g, b, 0.0f, FP16_MAX);
+            Sanitize(h, 0.0f, FP16_MAX);
+        }
+
+        Store(packed + i * 4, r, g, b, h);
+    )
+}
+
+NRD_API void NRD_CALL nrd::RELAX_FrontEnd_PackSh(const float* radiance, const float* hitDist, const float* direction, uint32_t num, bool sanitize, float* packed0, float* packed1)
+{
+    NRD_BATCH(
+        T r, g, b, h, x, y, z;
+        Load(radiance + i * 3, r, g, b);
+        Load(hitDist + i, h);
+        Load(direction + i * 3, x, y, z);
+
+        if (sanitize)
+        {
+            Sanitize(r, g, b, 0.0f, FP16_MAX);
+            Sanitize(h, 0.0f, FP16_MAX);
+            Sanitize(x, y, z, -1.0f, 1.0f);
+        }
+
+        T luminance = Luminance(r, g, b);
+
+        Store(packed0 + i * 4, r, g, b, h);
+        Store(packed1 + i * 4, x * luminance, y * luminance, z * luminance, T(0.0f));
+    )
+}
+
+NRD_API void NRD_CALL nrd::SIGMA_FrontEnd_PackPenumbra(const float* distanceToOccluder, float tanOfLightAngularRadius, uint32_t num, float* penumbra)
+{
+    NRD_BATCH(
+        T d;
+        Load(distanceToOccluder + i, d);
+
+        Store(penumbra + i, PackPenumbra(d, d * tanOfLightAngularRadius));
+    )
+}
+
+NRD_API void NRD_CALL nrd::SIGMA_FrontEnd_PackPenumbraLocal(const float* distanceToOccluder, const float* distanceToLight, float lightSize, uint32_t num, float* penumbra)
+{
+    NRD_BATCH(
+        T d, l;
+        Load(distanceToOccluder + i, d);
+        Load(distanceToLight + i, l);
+
+        T penumbraSize = T(lightSize) * d / Max(l - d, T(EPS));
+
+        Store(penumbra + i, PackPenumbra(d, penumbraSize));
+    )
+}
+
+NRD_API void NRD_CALL nrd::SIGMA_FrontEnd_PackTranslucency(const float* distanceToOccluder, const float* translucency, uint32_t num, float* packed)
+{
+    NRD_BATCH(
+        T d, r, g, b;
+        Load(distanceToOccluder + i, d);
+        Load(translucency + i * 3, r, g, b);
+
+        T isMiss = Select(d >= T(FP16_MAX), T(1.0f), T(0.0f));
+
+        Store(packed + i * 4, isMiss, Saturate(r), Saturate(g), Saturate(b));
+    )
+}
+
+NRD_API void NRD_CALL nrd::REBLUR_BackEnd_UnpackRadianceAndNormHitDist(const float* packed, uint32_t num, float* radianceAndNormHitDist)
+{
+    NRD_BATCH(
+        T Y, Co, Cg, h;
+        Load(packed + i * 4, Y, Co, Cg, h);
+
+        YCoCgToLinear(Y, Co, Cg);
+
+        Store(radianceAndNormHitDist + i * 4, Y, Co, Cg, h);
+    )
+}
+
+NRD_API void NRD_CALL nrd::SIGMA_BackEnd_UnpackShadow(const float* packed, uint32_t num, float* shadow)
+{
+    NRD_BATCH(
+        T s;
+        Load(packed + i, s);
+
+        Store(shadow + i, s * s);
+    )
+}
+
+#undef NRD_BATCH
+
+//=================================================================================================================================
+// FP16
+//=================================================================================================================================
+
+// Round to nearest even, matches "vcvtps2ph" with "_MM_FROUND_TO_NEAREST_INT"
+static inline uint16_t FloatToHalf(float x)
+{
+    uint32_t f;
+    memcpy(&f, &x, sizeof(f));
+
+    uint32_t sign = (f >> 16) & 0x8000;
+    uint32_t a = f & 0x7FFFFFFF;
+
+    if (a >= 0x7F800000) // INF or NAN (quieted, payload is truncated)
+        return uint16_t(sign | (a == 0x7F800000 ? 0x7C00 : (0x7E00 | ((a >> 13) & 0x3FF))));
+
+    if (a >= 0x477FF000) // rounds to INF
+        return uint16_t(sign | 0x7C00);
+
+    if (a < 0x38800000) // denormal or zero
+    {
+        if (a <= 0x33000000) // <= 2^-25, rounds to zero
+            return uint16_t(sign);
+
+        uint32_t mantissa = (a & 0x7FFFFF) | 0x800000;
+        uint32_t shift = 126 - (a >> 23);
+        uint32_t h = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+
+        if (remainder > halfway || (remainder == halfway && (h & 1)))
+            h++;
+
+        return uint16_t(sign | h);
+    }
+
+    uint32_t h = (a - 0x38000000) >> 13;
+    uint32_t remainder = a & 0x1FFF;
+
+    if (remainder > 0x1000 || (remainder == 0x1000 && (h & 1)))
+        h++; // can carry into the exponent
+
+    return uint16_t(sign | h);
+}
+
+static inline float HalfToFloat(uint16_t h)
+{
+    uint32_t sign = uint32_t(h & 0x8000) << 16;
+    uint32_t exponent = (h >> 10) & 0x1F;
+    uint32_t mantissa = h & 0x3FF;
+
+    uint32_t f;
+    if (exponent == 0x1F) // INF or NAN (quieted)
+        f = sign | 0x7F800000 | (mantissa << 13) | (mantissa ? 0x400000 : 0);
+    else if (exponent == 0)
+    {
+        if (mantissa == 0)
+            f = sign;
+        else
+        {
+            exponent = 113;
+            while (!(mantissa & 0x400))
+            {
+                mantissa <<= 1;
+                exponent--;
+            }
+
+            f = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+        }
+    }
+    else
+        f = sign | ((exponent + 112) << 23) | (mantissa << 13);
+
+    float x;
+    memcpy(&x, &f, sizeof(x));
+
+    return x;
+}
+
+NRD_API void NRD_CALL nrd::ConvertFloatToHalf(const float* src, uint32_t num, uint16_t* dst)
+{
+    uint32_t i = 0;
+
+#if NRD_F16C
+    for (; i + 8 <= num; i += 8)
+    {
+        __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i*)(dst + i), h);
+    }
+#endif
+
+    for (; i < num; i++)
+        dst[i] = FloatToHalf(src[i]);
+}
+
+NRD_API void NRD_CALL nrd::ConvertHalfToFloat(const uint16_t* src, uint32_t num, float* dst)
+{
+    uint32_t i = 0;
+
+#if NRD_F16C
+    for (; i + 8 <= num; i += 8)
+    {
+        __m256 f = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(src + i)));
+        _mm256_storeu_ps(dst + i, f);
+    }
+#endif
+
+    for (; i < num; i++)
+        dst[i] = HalfToFloat(src[i]);
+}
@@ -78,7 +78,7 @@ license agreement from NVIDIA CORPORATION is strictly prohibited.
         PushInput( AsUint(diff) ); \
         PushInput( AsUint(spec) ); \
         PushOutput( AsUint(ResourceType::OUT_VALIDATION) ); \
-        AddDispatch( REBLUR_Validation, REBLUR_Validation, IGNORE_RS ); \
+        AddDispatchWithRootConstants( REBLUR_Validation, REBLUR_Validation, IGNORE_RS ); \
     }
 
 struct ReblurProps
@@ -101,7 +101,7 @@ constexpr std::array<ReblurProps, 10> g_ReblurProps =
     {true, false},      // REBLUR_DIFFUSE_DIRECTIONAL_OCCLUSION
 }};
 
-void nrd::InstanceImpl::Update_Reblur(const DenoiserData& denoiserData)
+void nrd::InstanceImpl::Update_Reblur(const DenoiserData& denoiserData, DispatchContext& context)
 {
     enum class Dispatch
     {
@@ -115,8 +115,11 @@ void nrd::InstanceImpl::Update_Reblur(const DenoiserData& denoiserData)
         TEMPORAL_STABILIZATION  = POST_BLUR + REBLUR_POST_BLUR_PERMUTATION_NUM * 2,
         SPLIT_SCREEN            = TEMPORAL_STABILIZATION + REBLUR_TEMPORAL_STABILIZATION_PERMUTATION_NUM * 2,
         VALIDATION              = SPLIT_SCREEN + REBLUR_NO_PERMUTATIONS * 1, // SPLIT_SCREEN doesn't have perf mode
+        UPSCALE                 = VALIDATION + 1,
+        SAMPLING_HINT           = UPSCALE + 1, // "UPSCALE" doesn't have permutations
     };
 
+    const ViewState& view = *context.view;
     NRD_DECLARE_DIMS;
 
     const ReblurSettings& settings = denoiserData.settings.reblur;
@@ -127,89 +130,105 @@ void nrd::InstanceImpl::Update_Reblur(const DenoiserData& denoiserData)
     bool skipPrePass = (settings.diffusePrepassBlurRadius == 0.0f || !props.hasDiffuse) &&
         (settings.specularPrepassBlurRadius == 0.0f || !props.hasSpecular) &&
         settings.checkerboardMode == CheckerboardMode::OFF;
+    bool enableUpscale = view.commonSettings.outputSize[0] != 0 && IsUpscaleSupported(denoiserData.desc.denoiser);
+    bool enableSamplingHint = view.commonSettings.enableSamplingHint && IsUpscaleSupported(denoiserData.desc.denoiser);
 
     // SPLIT_SCREEN (passthrough)
-    if (m_CommonSettings.splitScreen >= 1.0f)
+    if (view.commonSettings.splitScreen >= 1.0f)
     {
-        void* consts = PushDispatch(denoiserData, AsUint(Dispatch::SPLIT_SCREEN));
-        AddSharedConstants_Reblur(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, AsUint(Dispatch::SPLIT_SCREEN));
+        AddSharedConstants_Reblur(settings, context, consts);
+
+        // UPSCALE
+        if (enableUpscale)
+            PushUpscaleDispatch(context, denoiserData, AsUint(Dispatch::UPSCALE));
 
         return;
     }
 
     { // CLASSIFY_TILES
-        void* consts = PushDispatch(denoiserData, AsUint(Dispatch::CLASSIFY_TILES));
-        AddSharedConstants_Reblur(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, AsUint(Dispatch::CLASSIFY_TILES));
+        AddSharedConstants_Reblur(settings, context, consts);
     }
 
     // HITDIST_RECONSTRUCTION
     if (enableHitDistanceReconstruction)
     {
         uint32_t passIndex = AsUint(Dispatch::HITDIST_RECONSTRUCTION) + (settings.hitDistanceReconstructionMode == HitDistanceReconstructionMode::AREA_5X5 ? 4 : 0) + (!skipPrePass ? 2 : 0) + (settings.enablePerformanceMode ? 1 : 0);
-        void* consts = PushDispatch(denoiserData, passIndex);
-        AddSharedConstants_Reblur(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, passIndex);
+        AddSharedConstants_Reblur(settings, context, consts);
     }
 
     // PREPASS
     if (!skipPrePass)
     {
         uint32_t passIndex = AsUint(Dispatch::PREPASS) + (enableHitDistanceReconstruction ? 2 : 0) + (settings.enablePerformanceMode ? 1 : 0);
-        void* consts = PushDispatch(denoiserData, passIndex);
-        AddSharedConstants_Reblur(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, passIndex);
+        AddSharedConstants_Reblur(settings, context, consts);
     }
 
     { // TEMPORAL_ACCUMULATION
-        uint32_t passIndex = AsUint(Dispatch::TEMPORAL_ACCUMULATION) + (m_CommonSettings.isDisocclusionThresholdMixAvailable ? 8 : 0) +
-            (m_CommonSettings.isHistoryConfidenceAvailable ? 4 : 0) +
+        uint32_t passIndex = AsUint(Dispatch::TEMPORAL_ACCUMULATION) + (view.commonSettings.isDisocclusionThresholdMixAvailable ? 8 : 0) +
+            (view.commonSettings.isHistoryConfidenceAvailable ? 4 : 0) +
             ((!skipPrePass || enableHitDistanceReconstruction) ? 2 : 0) + (settings.enablePerformanceMode ? 1 : 0);
-        void* consts = PushDispatch(denoiserData, passIndex);
-        AddSharedConstants_Reblur(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, passIndex);
+        AddSharedConstants_Reblur(settings, context, consts);
     }
 
     { // HISTORY_FIX
         uint32_t passIndex = AsUint(Dispatch::HISTORY_FIX) + (settings.enablePerformanceMode ? 1 : 0);
-        void* consts = PushDispatch(denoiserData, passIndex);
-        AddSharedConstants_Reblur(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, passIndex);
+        AddSharedConstants_Reblur(settings, context, consts);
     }
 
     { // BLUR
         uint32_t passIndex = AsUint(Dispatch::BLUR) + (settings.enablePerformanceMode ? 1 : 0);
-        void* consts = PushDispatch(denoiserData, passIndex);
-        AddSharedConstants_Reblur(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, passIndex);
+        AddSharedConstants_Reblur(settings, context, consts);
     }
 
     { // POST_BLUR
         uint32_t passIndex = AsUint(Dispatch::POST_BLUR) + (skipTemporalStabilization ? 0 : 2) + (settings.enablePerformanceMode ? 1 : 0);
-        void* consts = PushDispatch(denoiserData, passIndex);
-        AddSharedConstants_Reblur(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, passIndex);
+        AddSharedConstants_Reblur(settings, context, consts);
     }
 
     // TEMPORAL_STABILIZATION
     if (!skipTemporalStabilization)
     {
-        uint32_t passIndex = AsUint(Dispatch::TEMPORAL_STABILIZATION) + (m_CommonSettings.isBaseColorMetalnessAvailable ? 2 : 0) + (settings.enablePerformanceMode ? 1 : 0);
-        void* consts = PushDispatch(denoiserData, passIndex);
-        AddSharedConstants_Reblur(settings, consts);
+        uint32_t passIndex = AsUint(Dispatch::TEMPORAL_STABILIZATION) + (view.commonSettings.isBaseColorMetalnessAvailable ? 2 : 0) + (settings.enablePerformanceMode ? 1 : 0);
+        void* consts = PushDispatch(context, denoiserData, passIndex);
+        AddSharedConstants_Reblur(settings, context, consts);
     }
 
     // SPLIT_SCREEN
-    if (m_CommonSettings.splitScreen > 0.0f)
+    if (view.commonSettings.splitScreen > 0.0f)
     {
-        void* consts = PushDispatch(denoiserData, AsUint(Dispatch::SPLIT_SCREEN));
-        AddSharedConstants_Reblur(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, AsUint(Dispatch::SPLIT_SCREEN));
+        AddSharedConstants_Reblur(settings, context, consts);
     }
 
     // VALIDATION
-    if (m_CommonSettings.enableValidation)
+    if (view.commonSettings.enableValidation)
     {
-        REBLUR_ValidationConstants* consts = (REBLUR_ValidationConstants*)PushDispatch(denoiserData, AsUint(Dispatch::VALIDATION));
-        AddSharedConstants_Reblur(settings, consts);
-        consts->gHasDiffuse = props.hasDiffuse ? 1 : 0; // TODO: push constant
-        consts->gHasSpecular = props.hasSpecular ? 1 : 0; // TODO: push constant
+        REBLUR_ValidationRootConstants rootConstants = {};
+        rootConstants.gHasDiffuse = props.hasDiffuse ? 1 : 0;
+        rootConstants.gHasSpecular = props.hasSpecular ? 1 : 0;
+
+        REBLUR_ValidationConstants* consts = (REBLUR_ValidationConstants*)PushDispatch(context, denoiserData, AsUint(Dispatch::VALIDATION), &rootConstants);
+        AddSharedConstants_Reblur(settings, context, consts);
     }
+
+    // UPSCALE
+    if (enableUpscale)
+        PushUpscaleDispatch(context, denoiserData, AsUint(Dispatch::UPSCALE));
+
+    // SAMPLING_HINT
+    if (enableSamplingHint)
+        PushSamplingHintDispatch(context, denoiserData, AsUint(Dispatch::SAMPLING_HINT));
 }
 
-void nrd::InstanceImpl::Update_ReblurOcclusion(const DenoiserData& denoiserData)
+void nrd::InstanceImpl::Update_ReblurOcclusion(const DenoiserData& denoiserData, DispatchContext& context)
 {
     enum class Dispatch
     {
@@ -223,6 +242,7 @@ void nrd::InstanceImpl::Update_ReblurOcclusion(const DenoiserData& denoiserData)
         VALIDATION              = SPLIT_SCREEN + REBLUR_NO_PERMUTATIONS * 1, // SPLIT_SCREEN doesn't have perf mode
     };
 
+    const ViewState& view = *context.view;
     NRD_DECLARE_DIMS;
 
     const ReblurSettings& settings = denoiserData.settings.reblur;
@@ -231,86 +251,89 @@ void nrd::InstanceImpl::Update_ReblurOcclusion(const DenoiserData& denoiserData)
     bool enableHitDistanceReconstruction = settings.hitDistanceReconstructionMode != HitDistanceReconstructionMode::OFF && settings.checkerboardMode == CheckerboardMode::OFF;
 
     // SPLIT_SCREEN (passthrough)
-    if (m_CommonSettings.splitScreen >= 1.0f)
+    if (view.commonSettings.splitScreen >= 1.0f)
     {
-        void* consts = PushDispatch(denoiserData, AsUint(Dispatch::SPLIT_SCREEN));
-        AddSharedConstants_Reblur(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, AsUint(Dispatch::SPLIT_SCREEN));
+        AddSharedConstants_Reblur(settings, context, consts);
 
         return;
     }
 
     { // CLASSIFY_TILES
-        void* consts = PushDispatch(denoiserData, AsUint(Dispatch::CLASSIFY_TILES));
-        AddSharedConstants_Reblur(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, AsUint(Dispatch::CLASSIFY_TILES));
+        AddSharedConstants_Reblur(settings, context, consts);
     }
 
     // HITDIST_RECONSTRUCTION
     if (enableHitDistanceReconstruction)
     {
         uint32_t passIndex = AsUint(Dispatch::HITDIST_RECONSTRUCTION) + (settings.hitDistanceReconstructionMode == HitDistanceReconstructionMode::AREA_5X5 ? 2 : 0) + (settings.enablePerformanceMode ? 1 : 0);
-        void* consts = PushDispatch(denoiserData, passIndex);
-        AddSharedConstants_Reblur(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, passIndex);
+        AddSharedConstants_Reblur(settings, context, consts);
     }
 
     { // TEMPORAL_ACCUMULATION
-        uint32_t passIndex = AsUint(Dispatch::TEMPORAL_ACCUMULATION) + (m_CommonSettings.isDisocclusionThresholdMixAvailable ? 8 : 0) +
-            (m_CommonSettings.isHistoryConfidenceAvailable ? 4 : 0) + (enableHitDistanceReconstruction ? 2 : 0) + (settings.enablePerformanceMode ? 1 : 0);
-        void* consts = PushDispatch(denoiserData, passIndex);
-        AddSharedConstants_Reblur(settings, consts);
+        uint32_t passIndex = AsUint(Dispatch::TEMPORAL_ACCUMULATION) + (view.commonSettings.isDisocclusionThresholdMixAvailable ? 8 : 0) +
+            (view.commonSettings.isHistoryConfidenceAvailable ? 4 : 0) + (enableHitDistanceReconstruction ? 2 : 0) + (settings.enablePerformanceMode ? 1 : 0);
+        void* consts = PushDispatch(context, denoiserData, passIndex);
+        AddSharedConstants_Reblur(settings, context, consts);
     }
 
     { // HISTORY_FIX
         uint32_t passIndex = AsUint(Dispatch::HISTORY_FIX) + (!settings.enableAntiFirefly ? 1 : 0);
-        void* consts = PushDispatch(denoiserData, passIndex);
-        AddSharedConstants_Reblur(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, passIndex);
+        AddSharedConstants_Reblur(settings, context, consts);
     }
 
     { // BLUR
         uint32_t passIndex = AsUint(Dispatch::BLUR) + (settings.enablePerformanceMode ? 1 : 0);
-        void* consts = PushDispatch(denoiserData, passIndex);
-        AddSharedConstants_Reblur(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, passIndex);
+        AddSharedConstants_Reblur(settings, context, consts);
     }
 
     { // POST_BLUR
         uint32_t passIndex = AsUint(Dispatch::POST_BLUR) + (settings.enablePerformanceMode ? 1 : 0);
-        void* consts = PushDispatch(denoiserData, passIndex);
-        AddSharedConstants_Reblur(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, passIndex);
+        AddSharedConstants_Reblur(settings, context, consts);
     }
 
     // SPLIT_SCREEN
-    if (m_CommonSettings.splitScreen > 0.0f)
+    if (view.commonSettings.splitScreen > 0.0f)
     {
-        void* consts = PushDispatch(denoiserData, AsUint(Dispatch::SPLIT_SCREEN));
-        AddSharedConstants_Reblur(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, AsUint(Dispatch::SPLIT_SCREEN));
+        AddSharedConstants_Reblur(settings, context, consts);
     }
 
     // VALIDATION
-    if (m_CommonSettings.enableValidation)
+    if (view.commonSettings.enableValidation)
     {
-        REBLUR_ValidationConstants* consts = (REBLUR_ValidationConstants*)PushDispatch(denoiserData, AsUint(Dispatch::VALIDATION));
-        AddSharedConstants_Reblur(settings, consts);
-        consts->gHasDiffuse = props.hasDiffuse ? 1 : 0; // TODO: push constant
-        consts->gHasSpecular = props.hasSpecular ? 1 : 0; // TODO: push constant
+        REBLUR_ValidationRootConstants rootConstants = {};
+        rootConstants.gHasDiffuse = props.hasDiffuse ? 1 : 0;
+        rootConstants.gHasSpecular = props.hasSpecular ? 1 : 0;
+
+        REBLUR_ValidationConstants* consts = (REBLUR_ValidationConstants*)PushDispatch(context, denoiserData, AsUint(Dispatch::VALIDATION), &rootConstants);
+        AddSharedConstants_Reblur(settings, context, consts);
     }
 }
 
-void nrd::InstanceImpl::AddSharedConstants_Reblur(const ReblurSettings& settings, void* data)
+void nrd::InstanceImpl::AddSharedConstants_Reblur(const ReblurSettings& settings, const DispatchContext& context, void* data)
 {
     struct SharedConstants
     {
         REBLUR_SHARED_CONSTANTS
     };
 
+    const ViewState& view = *context.view;
     NRD_DECLARE_DIMS;
 
     bool isRectChanged = rectW != rectWprev || rectH != rectHprev;
-    bool isHistoryReset = m_CommonSettings.accumulationMode != AccumulationMode::CONTINUE;
-    float unproject = 1.0f / (0.5f * rectH * m_ProjectY);
+    bool isHistoryReset = context.accumulationMode != AccumulationMode::CONTINUE;
+    float unproject = 1.0f / (0.5f * rectH * view.projectY);
     float worstResolutionScale = min(float(rectW) / float(resourceW), float(rectH) / float(resourceH));
     float maxBlurRadius = settings.maxBlurRadius * worstResolutionScale;
     float diffusePrepassBlurRadius = settings.diffusePrepassBlurRadius * worstResolutionScale;
     float specularPrepassBlurRadius = settings.specularPrepassBlurRadius * worstResolutionScale;
-    float disocclusionThresholdBonus = (1.0f + m_JitterDelta) / float(rectH);
+    float disocclusionThresholdBonus = (1.0f + view.jitterDelta) / float(rectH);
     float stabilizationStrength = settings.maxStabilizedFrameNum / (1.0f + settings.maxStabilizedFrameNum);
     float hitDistanceStabilizationStrength = settings.maxStabilizedFrameNumForHitDistance / (1.0f + settings.maxStabilizedFrameNumForHitDistance);
     uint32_t maxAccumulatedFrameNum = min(settings.maxAccumulatedFrameNum, REBLUR_MAX_HISTORY_FRAME_NUM);
@@ -330,22 +353,22 @@ void nrd::InstanceImpl::AddSharedConstants_Reblur(const ReblurSettings& settings
     }
 
     SharedConstants* consts                                     = (SharedConstants*)data;
-    consts->gWorldToClip                                        = m_WorldToClip;
-    consts->gViewToClip                                         = m_ViewToClip;
-    consts->gViewToWorld                                        = m_ViewToWorld;
-    consts->gWorldToViewPrev                                    = m_WorldToViewPrev;
-    consts->gWorldToClipPrev                                    = m_WorldToClipPrev;
-    consts->gWorldPrevToWorld                                   = m_WorldPrevToWorld;
-    consts->gRotatorPre                                         = m_RotatorPre;
-    consts->gRotator                                            = m_Rotator;
-    consts->gRotatorPost                                        = m_RotatorPost;
-    consts->gFrustum                                            = m_Frustum;
-    consts->gFrustumPrev                                        = m_FrustumPrev;
-    consts->gCameraDelta                                        = m_CameraDelta.xmm;
+    consts->gWorldToClip                                        = view.worldToClip;
+    consts->gViewToClip                                         = view.viewToClip;
+    consts->gViewToWorld                                        = view.viewToWorld;
+    consts->gWorldToViewPrev                                    = view.worldToViewPrev;
+    consts->gWorldToClipPrev                                    = view.worldToClipPrev;
+    consts->gWorldPrevToWorld                                   = view.worldPrevToWorld;
+    consts->gRotatorPre                                         = view.rotatorPre;
+    consts->gRotator                                            = view.rotator;
+    consts->gRotatorPost                                        = view.rotatorPost;
+    consts->gFrustum                                            = view.frustum;
+    consts->gFrustumPrev                                        = view.frustumPrev;
+    consts->gCameraDelta                                        = view.cameraDelta.xmm;
     consts->gHitDistParams                                      = float4(settings.hitDistanceParameters.A, settings.hitDistanceParameters.B, settings.hitDistanceParameters.C, settings.hitDistanceParameters.D);
-    consts->gViewVectorWorld                                    = m_ViewDirection.xmm;
-    consts->gViewVectorWorldPrev                                = m_ViewDirectionPrev.xmm;
-    consts->gMvScale                                            = float4(m_CommonSettings.motionVectorScale[0], m_CommonSettings.motionVectorScale[1], m_CommonSettings.motionVectorScale[2], m_CommonSettings.isMotionVectorInWorldSpace ? 1.0f : 0.0f);
+    consts->gViewVectorWorld                                    = view.viewDirection.xmm;
+    consts->gViewVectorWorldPrev                                = view.viewDirectionPrev.xmm;
+    consts->gMvScale                                            = float4(view.commonSettings.motionVectorScale[0], view.commonSettings.motionVectorScale[1], view.commonSettings.motionVectorScale[2], view.commonSettings.isMotionVectorInWorldSpace ? 1.0f : 0.0f);
     consts->gAntilagParams                                      = float2(settings.antilagSettings.luminanceSigmaScale, settings.antilagSettings.luminanceSensitivity);
     consts->gResourceSize                                       = float2(float(resourceW), float(resourceH));
     consts->gResourceSizeInv                                    = float2(1.0f / float(resourceW), 1.0f / float(resourceH));
@@ -355,25 +378,25 @@ void nrd::InstanceImpl::AddSharedConstants_Reblur(const ReblurSettings& settings
     consts->gRectSizePrev                                       = float2(float(rectWprev), float(rectHprev));
     consts->gResolutionScale                                    = float2(float(rectW) / float(resourceW), float(rectH) / float(resourceH));
     consts->gResolutionScalePrev                                = float2(float(rectWprev) / float(resourceWprev), float(rectHprev) / float(resourceHprev));
-    consts->gRectOffset                                         = float2(float(m_CommonSettings.rectOrigin[0]) / float(resourceW), float(m_CommonSettings.rectOrigin[1]) / float(resourceH));
-    consts->gSpecProbabilityThresholdsForMvModification         = float2(m_CommonSettings.isBaseColorMetalnessAvailable ? settings.specularProbabilityThresholdsForMvModification[0] : 2.0f, m_CommonSettings.isBaseColorMetalnessAvailable ? settings.specularProbabilityThresholdsForMvModification[1] : 3.0f);
-    consts->gJitter                                             = float2(m_CommonSettings.cameraJitter[0], m_CommonSettings.cameraJitter[1]);
-    consts->gPrintfAt                                           = uint2(m_CommonSettings.printfAt[0], m_CommonSettings.printfAt[1]);
-    consts->gRectOrigin                                         = uint2(m_CommonSettings.rectOrigin[0], m_CommonSettings.rectOrigin[1]);
+    consts->gRectOffset                                         = float2(float(view.commonSettings.rectOrigin[0]) / float(resourceW), float(view.commonSettings.rectOrigin[1]) / float(resourceH));
+    consts->gSpecProbabilityThresholdsForMvModification         = float2(view.commonSettings.isBaseColorMetalnessAvailable ? settings.specularProbabilityThresholdsForMvModification[0] : 2.0f, view.commonSettings.isBaseColorMetalnessAvailable ? settings.specularProbabilityThresholdsForMvModification[1] : 3.0f);
+    consts->gJitter                                             = float2(view.commonSettings.cameraJitter[0], view.commonSettings.cameraJitter[1]);
+    consts->gPrintfAt                                           = uint2(view.commonSettings.printfAt[0], view.commonSettings.printfAt[1]);
+    consts->gRectOrigin                                         = uint2(view.commonSettings.rectOrigin[0], view.commonSettings.rectOrigin[1]);
     consts->gRectSizeMinusOne                                   = int2(rectW - 1, rectH - 1);
-    consts->gDisocclusionThreshold                              = m_CommonSettings.disocclusionThreshold + disocclusionThresholdBonus;
-    consts->gDisocclusionThresholdAlternate                     = m_CommonSettings.disocclusionThresholdAlternate + disocclusionThresholdBonus;
-    consts->gCameraAttachedReflectionMaterialID                 = m_CommonSettings.cameraAttachedReflectionMaterialID;
-    consts->gStrandMaterialID                                   = m_CommonSettings.strandMaterialID;
-    consts->gStrandThickness                                    = m_CommonSettings.strandThickness;
+    consts->gDisocclusionThreshold                              = view.commonSettings.disocclusionThreshold + disocclusionThresholdBonus;
+    consts->gDisocclusionThresholdAlternate                     = view.commonSettings.disocclusionThresholdAlternate + disocclusionThresholdBonus;
+    consts->gCameraAttachedReflectionMaterialID                 = view.commonSettings.cameraAttachedReflectionMaterialID;
+    consts->gStrandMaterialID                                   = view.commonSettings.strandMaterialID;
+    consts->gStrandThickness                                    = view.commonSettings.strandThickness;
     consts->gStabilizationStrength                              = isHistoryReset ? 0.0f : stabilizationStrength;
     consts->gHitDistStabilizationStrength                       = isHistoryReset ? 0.0f : hitDistanceStabilizationStrength;
-    consts->gDebug                                              = m_CommonSettings.debug;
-    consts->gOrthoMode                                          = m_OrthoMode;
+    consts->gDebug                                              = view.commonSettings.debug;
+    consts->gOrthoMode                                          = view.orthoMode;
     consts->gUnproject                                          = unproject;
-    consts->gDenoisingRange                                     = m_CommonSettings.denoisingRange;
+    consts->gDenoisingRange                                     = view.commonSettings.denoisingRange;
     consts->gPlaneDistSensitivity                               = settings.planeDistanceSensitivity;
-    consts->gFramerateScale                                     = m_FrameRateScale;
+    consts->gFramerateScale                                     = view.frameRateScale;
     consts->gMaxBlurRadius                                      = max(maxBlurRadius, settings.minBlurRadius);
     consts->gMinBlurRadius                                      = settings.minBlurRadius;
     consts->gDiffPrepassBlurRadius                              = diffusePrepassBlurRadius;
@@ -388,24 +411,26 @@ void nrd::InstanceImpl::AddSharedConstants_Reblur(const ReblurSettings& settings
     consts->gHistoryFixBasePixelStride                          = (float)settings.historyFixBasePixelStride;
     consts->gMinRectDimMulUnproject                             = (float)min(rectW, rectH) * unproject;
     consts->gUsePrepassNotOnlyForSpecularMotionEstimation       = settings.usePrepassOnlyForSpecularMotionEstimation ? 0.0f : 1.0f;
-    consts->gSplitScreen                                        = m_CommonSettings.splitScreen;
-    consts->gSplitScreenPrev                                    = m_SplitScreenPrev;
-    consts->gCheckerboardResolveAccumSpeed                      = m_CheckerboardResolveAccumSpeed;
-    consts->gViewZScale                                         = m_CommonSettings.viewZScale;
+    consts->gSplitScreen                                        = view.commonSettings.splitScreen;
+    consts->gSplitScreenPrev                                    = view.splitScreenPrev;
+    consts->gCheckerboardResolveAccumSpeed                      = view.checkerboardResolveAccumSpeed;
+    consts->gViewZScale                                         = view.commonSettings.viewZScale;
     consts->gFireflySuppressorMinRelativeScale                  = settings.fireflySuppressorMinRelativeScale;
     consts->gMinHitDistanceWeight                               = settings.minHitDistanceWeight;
     consts->gDiffMinMaterial                                    = settings.minMaterialForDiffuse;
     consts->gSpecMinMaterial                                    = settings.minMaterialForSpecular;
-    consts->gHasHistoryConfidence                               = m_CommonSettings.isHistoryConfidenceAvailable;
-    consts->gHasDisocclusionThresholdMix                        = m_CommonSettings.isDisocclusionThresholdMixAvailable;
+    consts->gHasHistoryConfidence                               = view.commonSettings.isHistoryConfidenceAvailable;
+    consts->gHasDisocclusionThresholdMix                        = view.commonSettings.isDisocclusionThresholdMixAvailable;
     consts->gDiffCheckerboard                                   = diffCheckerboard;
     consts->gSpecCheckerboard                                   = specCheckerboard;
-    consts->gFrameIndex                                         = m_CommonSettings.frameIndex;
+    consts->gFrameIndex                                         = view.commonSettings.frameIndex;
     consts->gIsRectChanged                                      = isRectChanged ? 1 : 0;
     consts->gResetHistory                                       = isHistoryReset ? 1 : 0;
 }
 
 // REBLUR_SHARED
+#ifdef NRD_DENOISER_REBLUR_SHARED
+
 #ifdef NRD_EMBEDS_DXBC_SHADERS
     #include "REBLUR_ClassifyTiles.cs.dxbc.h"
     #include "REBLUR_Validation.cs.dxbc.h"
@@ -421,7 +446,11 @@ void nrd::InstanceImpl::AddSharedConstants_Reblur(const ReblurSettings& settings
     #include "REBLUR_Validation.cs.spirv.h"
 #endif
 
+#endif
+
 // REBLUR_DIFFUSE
+#ifdef NRD_DENOISER_REBLUR_DIFFUSE
+
 #ifdef NRD_EMBEDS_DXBC_SHADERS
     #include "REBLUR_Diffuse_HitDistReconstruction.cs.dxbc.h"
     #include "REBLUR_Diffuse_HitDistReconstruction_5x5.cs.dxbc.h"
@@ -492,8 +521,11 @@ void nrd::InstanceImpl::AddSharedConstants_Reblur(const ReblurSettings& settings
 #endif
 
 #include "Denoisers/Reblur_Diffuse.hpp"
+#endif
 
 // REBLUR_DIFFUSE_OCCLUSION
+#ifdef NRD_DENOISER_REBLUR_DIFFUSE_OCCLUSION
+
 #ifdef NRD_EMBEDS_DXBC_SHADERS
     #include "REBLUR_DiffuseOcclusion_HitDistReconstruction.cs.dxbc.h"
     #include "REBLUR_DiffuseOcclusion_HitDistReconstruction_5x5.cs.dxbc.h"
@@ -543,8 +575,11 @@ void nrd::InstanceImpl::AddSharedConstants_Reblur(const ReblurSettings& settings
 #endif
 
 #include "Denoisers/Reblur_DiffuseOcclusion.hpp"
+#endif
 
 // REBLUR_DIFFUSE_SH
+#ifdef NRD_DENOISER_REBLUR_DIFFUSE_SH
+
 #ifdef NRD_EMBEDS_DXBC_SHADERS
     #include "REBLUR_DiffuseSh_PrePass.cs.dxbc.h"
     #include "REBLUR_DiffuseSh_TemporalAccumulation.cs.dxbc.h"
@@ -603,8 +638,11 @@ void nrd::InstanceImpl::AddSharedConstants_Reblur(const ReblurSettings& settings
 #endif
 
 #include "Denoisers/Reblur_DiffuseSh.hpp"
+#endif
 
 // REBLUR_SPECULAR
+#ifdef NRD_DENOISER_REBLUR_SPECULAR
+
 #ifdef NRD_EMBEDS_DXBC_SHADERS
     #include "REBLUR_Specular_HitDistReconstruction.cs.dxbc.h"
     #include "REBLUR_Specular_HitDistReconstruction_5x5.cs.dxbc.h"
@@ -676,8 +714,11 @@ void nrd::InstanceImpl::AddSharedConstants_Reblur(const ReblurSettings& settings
 #endif
 
 #include "Denoisers/Reblur_Specular.hpp"
+#endif
 
 // REBLUR_SPECULAR_OCCLUSION
+#ifdef NRD_DENOISER_REBLUR_SPECULAR_OCCLUSION
+
 #ifdef NRD_EMBEDS_DXBC_SHADERS
     #include "REBLUR_SpecularOcclusion_HitDistReconstruction.cs.dxbc.h"
     #include "REBLUR_SpecularOcclusion_HitDistReconstruction_5x5.cs.dxbc.h"
@@ -727,8 +768,11 @@ void nrd::InstanceImpl::AddSharedConstants_Reblur(const ReblurSettings& settings
 #endif
 
 #include "Denoisers/Reblur_SpecularOcclusion.hpp"
+#endif
 
 // REBLUR_SPECULAR_SH
+#ifdef NRD_DENOISER_REBLUR_SPECULAR_SH
+
 #ifdef NRD_EMBEDS_DXBC_SHADERS
     #include "REBLUR_SpecularSh_PrePass.cs.dxbc.h"
     #include "REBLUR_SpecularSh_TemporalAccumulation.cs.dxbc.h"
@@ -787,8 +831,11 @@ void nrd::InstanceImpl::AddSharedConstants_Reblur(const ReblurSettings& settings
 #endif
 
 #include "Denoisers/Reblur_SpecularSh.hpp"
+#endif
 
 // REBLUR_DIFFUSE_SPECULAR
+#ifdef NRD_DENOISER_REBLUR_DIFFUSE_SPECULAR
+
 #ifdef NRD_EMBEDS_DXBC_SHADERS
     #include "REBLUR_DiffuseSpecular_HitDistReconstruction.cs.dxbc.h"
     #include "REBLUR_DiffuseSpecular_HitDistReconstruction_5x5.cs.dxbc.h"
@@ -859,8 +906,11 @@ void nrd::InstanceImpl::AddSharedConstants_Reblur(const ReblurSettings& settings
 #endif
 
 #include "Denoisers/Reblur_DiffuseSpecular.hpp"
+#endif
 
 // REBLUR_DIFFUSE_SPECULAR_OCCLUSION
+#ifdef NRD_DENOISER_REBLUR_DIFFUSE_SPECULAR_OCCLUSION
+
 #ifdef NRD_EMBEDS_DXBC_SHADERS
     #include "REBLUR_DiffuseSpecularOcclusion_HitDistReconstruction.cs.dxbc.h"
     #include "REBLUR_DiffuseSpecularOcclusion_HitDistReconstruction_5x5.cs.dxbc.h"
@@ -910,8 +960,11 @@ void nrd::InstanceImpl::AddSharedConstants_Reblur(const ReblurSettings& settings
 #endif
 
 #include "Denoisers/Reblur_DiffuseSpecularOcclusion.hpp"
+#endif
 
 // REBLUR_DIFFUSE_SPECULAR_SH
+#ifdef NRD_DENOISER_REBLUR_DIFFUSE_SPECULAR_SH
+
 #ifdef NRD_EMBEDS_DXBC_SHADERS
     #include "REBLUR_DiffuseSpecularSh_PrePass.cs.dxbc.h"
     #include "REBLUR_DiffuseSpecularSh_TemporalAccumulation.cs.dxbc.h"
@@ -970,8 +1023,11 @@ void nrd::InstanceImpl::AddSharedConstants_Reblur(const ReblurSettings& settings
 #endif
 
 #include "Denoisers/Reblur_DiffuseSpecularSh.hpp"
+#endif
 
 // REBLUR_DIFFUSE_DIRECTIONAL_OCCLUSION
+#ifdef NRD_DENOISER_REBLUR_DIFFUSE_DIRECTIONAL_OCCLUSION
+
 #ifdef NRD_EMBEDS_DXBC_SHADERS
     #include "REBLUR_DiffuseDirectionalOcclusion_PrePass.cs.dxbc.h"
     #include "REBLUR_DiffuseDirectionalOcclusion_TemporalAccumulation.cs.dxbc.h"
@@ -1027,3 +1083,4 @@ void nrd::InstanceImpl::AddSharedConstants_Reblur(const ReblurSettings& settings
 #endif
 
 #include "Denoisers/Reblur_DiffuseDirectionalOcclusion.hpp"
+#endif
@@ -11,6 +11,8 @@ license agreement from NVIDIA CORPORATION is strictly prohibited.
 #include "InstanceImpl.h"
 
 // REFERENCE
+#ifdef NRD_DENOISER_REFERENCE
+
 #ifdef NRD_EMBEDS_DXBC_SHADERS
     #include "REFERENCE_TemporalAccumulation.cs.dxbc.h"
     #include "REFERENCE_Copy.cs.dxbc.h"
@@ -27,3 +29,4 @@ license agreement from NVIDIA CORPORATION is strictly prohibited.
 #endif
 
 #include "Denoisers/Reference.hpp"
+#endif
@@ -57,31 +57,32 @@ inline float3 RELAX_GetFrustumForward(const float4x4& viewToWorld, const float4&
     return frustumForwardWorld;
 }
 
-void nrd::InstanceImpl::AddSharedConstants_Relax(const RelaxSettings& settings, void* data)
+void nrd::InstanceImpl::AddSharedConstants_Relax(const RelaxSettings& settings, const DispatchContext& context, void* data)
 {
     struct SharedConstants
     {
         RELAX_SHARED_CONSTANTS
     };
 
+    const ViewState& view = *context.view;
     NRD_DECLARE_DIMS;
 
-    float tanHalfFov = 1.0f / m_ViewToClip.a00;
-    float aspect = m_ViewToClip.a00 / m_ViewToClip.a11;
-    float3 frustumRight = float3(m_WorldToView.GetRow0().xyz) * tanHalfFov;
-    float3 frustumUp = float3(m_WorldToView.GetRow1().xyz) * tanHalfFov * aspect;
-    float3 frustumForward = RELAX_GetFrustumForward(m_ViewToWorld, m_Frustum);
+    float tanHalfFov = 1.0f / view.viewToClip.a00;
+    float aspect = view.viewToClip.a00 / view.viewToClip.a11;
+    float3 frustumRight = float3(view.worldToView.GetRow0().xyz) * tanHalfFov;
+    float3 frustumUp = float3(view.worldToView.GetRow1().xyz) * tanHalfFov * aspect;
+    float3 frustumForward = RELAX_GetFrustumForward(view.viewToWorld, view.frustum);
 
-    float prevTanHalfFov = 1.0f / m_ViewToClipPrev.a00;
-    float prevAspect = m_ViewToClipPrev.a00 / m_ViewToClipPrev.a11;
-    float3 prevFrustumRight = float3(m_WorldToViewPrev.GetRow0().xyz) * prevTanHalfFov;
-    float3 prevFrustumUp = float3(m_WorldToViewPrev.GetRow1().xyz) * prevTanHalfFov * prevAspect;
-    float3 prevFrustumForward = RELAX_GetFrustumForward(m_ViewToWorldPrev, m_FrustumPrev);
+    float prevTanHalfFov = 1.0f / view.viewToClipPrev.a00;
+    float prevAspect = view.viewToClipPrev.a00 / view.viewToClipPrev.a11;
+    float3 prevFrustumRight = float3(view.worldToViewPrev.GetRow0().xyz) * prevTanHalfFov;
+    float3 prevFrustumUp = float3(view.worldToViewPrev.GetRow1().xyz) * prevTanHalfFov * prevAspect;
+    float3 prevFrustumForward = RELAX_GetFrustumForward(view.viewToWorldPrev, view.frustumPrev);
 
     float maxDiffuseLuminanceRelativeDifference = -log( saturate(settings.diffuseMinLuminanceWeight) );
     float maxSpecularLuminanceRelativeDifference = -log( saturate(settings.specularMinLuminanceWeight) );
-    float disocclusionThresholdBonus = (1.0f + m_JitterDelta) / float(rectH);
-    bool isHistoryReset = m_CommonSettings.accumulationMode != AccumulationMode::CONTINUE;
+    float disocclusionThresholdBonus = (1.0f + view.jitterDelta) / float(rectH);
+    bool isHistoryReset = context.accumulationMode != AccumulationMode::CONTINUE;
 
     // Checkerboard logic
     uint32_t specCheckerboard = 2;
@@ -99,42 +100,42 @@ void nrd::InstanceImpl::AddSharedConstants_Relax(const RelaxSettings& settings,
     }
 
     SharedConstants* consts                                     = (SharedConstants*)data;
-    consts->gWorldToClip                                        = m_WorldToClip;
-    consts->gWorldToClipPrev                                    = m_WorldToClipPrev;
-    consts->gWorldToViewPrev                                    = m_WorldToViewPrev;
-    consts->gWorldPrevToWorld                                   = m_WorldPrevToWorld;
-    consts->gRotatorPre                                         = m_RotatorPre;
+    consts->gWorldToClip                                        = view.worldToClip;
+    consts->gWorldToClipPrev                                    = view.worldToClipPrev;
+    consts->gWorldToViewPrev                                    = view.worldToViewPrev;
+    consts->gWorldPrevToWorld                                   = view.worldPrevToWorld;
+    consts->gRotatorPre                                         = view.rotatorPre;
     consts->gFrustumRight                                       = float4(frustumRight.x, frustumRight.y, frustumRight.z, 0.0f);
     consts->gFrustumUp                                          = float4(frustumUp.x, frustumUp.y, frustumUp.z, 0.0f);
     consts->gFrustumForward                                     = float4(frustumForward.x, frustumForward.y, frustumForward.z, 0.0f);
     consts->gPrevFrustumRight                                   = float4(prevFrustumRight.x, prevFrustumRight.y, prevFrustumRight.z, 0.0f);
     consts->gPrevFrustumUp                                      = float4(prevFrustumUp.x, prevFrustumUp.y, prevFrustumUp.z, 0.0f);
     consts->gPrevFrustumForward                                 = float4(prevFrustumForward.x, prevFrustumForward.y, prevFrustumForward.z, 0.0f);
-    consts->gCameraDelta                                        = float4(m_CameraDelta.x, m_CameraDelta.y, m_CameraDelta.z, 0.0f);
-    consts->gMvScale                                            = float4(m_CommonSettings.motionVectorScale[0], m_CommonSettings.motionVectorScale[1], m_CommonSettings.motionVectorScale[2], m_CommonSettings.isMotionVectorInWorldSpace ? 1.0f : 0.0f);
-    consts->gJitter                                             = float2(m_CommonSettings.cameraJitter[0], m_CommonSettings.cameraJitter[1]);
+    consts->gCameraDelta                                        = float4(view.cameraDelta.x, view.cameraDelta.y, view.cameraDelta.z, 0.0f);
+    consts->gMvScale                                            = float4(view.commonSettings.motionVectorScale[0], view.commonSettings.motionVectorScale[1], view.commonSettings.motionVectorScale[2], view.commonSettings.isMotionVectorInWorldSpace ? 1.0f : 0.0f);
+    consts->gJitter                                             = float2(view.commonSettings.cameraJitter[0], view.commonSettings.cameraJitter[1]);
     consts->gResolutionScale                                    = float2(float(rectW) / float(resourceW), float(rectH) / float(resourceH));
-    consts->gRectOffset                                         = float2(float(m_CommonSettings.rectOrigin[0]) / float(resourceW), float(m_CommonSettings.rectOrigin[1]) / float(resourceH));
+    consts->gRectOffset                                         = float2(float(view.commonSettings.rectOrigin[0]) / float(resourceW), float(view.commonSettings.rectOrigin[1]) / float(resourceH));
     consts->gResourceSizeInv                                    = float2(1.0f / resourceW, 1.0f / resourceH);
     consts->gResourceSize                                       = float2(resourceW, resourceH);
     consts->gRectSizeInv                                        = float2(1.0f / rectW, 1.0f / rectH);
     consts->gRectSizePrev                                       = float2(float(rectWprev), float(rectHprev));
     consts->gResourceSizeInvPrev                                = float2(1.0f / resourceWprev, 1.0f / resourceHprev);
-    consts->gPrintfAt                                           = uint2(m_CommonSettings.printfAt[0], m_CommonSettings.printfAt[1]);
-    consts->gRectOrigin                                         = uint2(m_CommonSettings.rectOrigin[0], m_CommonSettings.rectOrigin[1]);
+    consts->gPrintfAt                                           = uint2(view.commonSettings.printfAt[0], view.commonSettings.printfAt[1]);
+    consts->gRectOrigin                                         = uint2(view.commonSettings.rectOrigin[0], view.commonSettings.rectOrigin[1]);
     consts->gRectSize                                           = int2(rectW, rectH);
     consts->gSpecMaxAccumulatedFrameNum                         = isHistoryReset ? 0.0f : (float)min(settings.specularMaxAccumulatedFrameNum, RELAX_MAX_HISTORY_FRAME_NUM);
     consts->gSpecMaxFastAccumulatedFrameNum                     = isHistoryReset ? 0.0f : (float)min(settings.specularMaxFastAccumulatedFrameNum, RELAX_MAX_HISTORY_FRAME_NUM);
     consts->gDiffMaxAccumulatedFrameNum                         = isHistoryReset ? 0.0f : (float)min(settings.diffuseMaxAccumulatedFrameNum, RELAX_MAX_HISTORY_FRAME_NUM);
     consts->gDiffMaxFastAccumulatedFrameNum                     = isHistoryReset ? 0.0f : (float)min(settings.diffuseMaxFastAccumulatedFrameNum, RELAX_MAX_HISTORY_FRAME_NUM);
-    consts->gDisocclusionThreshold                              = m_CommonSettings.disocclusionThreshold + disocclusionThresholdBonus;
-    consts->gDisocclusionThresholdAlternate                     = m_CommonSettings.disocclusionThresholdAlternate + disocclusionThresholdBonus;
-    consts->gCameraAttachedReflectionMaterialID                 = m_CommonSettings.cameraAttachedReflectionMaterialID;
-    consts->gStrandMaterialID                                   = m_CommonSettings.strandMaterialID;
-    consts->gStrandThickness                                    = m_CommonSettings.strandThickness;
+    consts->gDisocclusionThreshold                              = view.commonSettings.disocclusionThreshold + disocclusionThresholdBonus;
+    consts->gDisocclusionThresholdAlternate                     = view.commonSettings.disocclusionThresholdAlternate + disocclusionThresholdBonus;
+    consts->gCameraAttachedReflectionMaterialID                 = view.commonSettings.cameraAttachedReflectionMaterialID;
+    consts->gStrandMaterialID                                   = view.commonSettings.strandMaterialID;
+    consts->gStrandThickness                                    = view.commonSettings.strandThickness;
     consts->gRoughnessFraction                                  = settings.roughnessFraction;
     consts->gSpecVarianceBoost                                  = settings.specularVarianceBoost;
-    consts->gSplitScreen                                        = m_CommonSettings.splitScreen;
+    consts->gSplitScreen                                        = view.commonSettings.splitScreen;
     consts->gDiffBlurRadius                                     = settings.diffusePrepassBlurRadius;
     consts->gSpecBlurRadius                                     = settings.specularPrepassBlurRadius;
     consts->gDepthThreshold                                     = settings.depthThreshold;
@@ -148,7 +149,7 @@ void nrd::InstanceImpl::AddSharedConstants_Relax(const RelaxSettings& settings,
     consts->gHistoryResetTemporalSigmaScale                     = settings.antilagSettings.temporalSigmaScale;
     consts->gHistoryResetSpatialSigmaScale                      = settings.antilagSettings.spatialSigmaScale;
     consts->gHistoryResetAmount                                 = settings.antilagSettings.resetAmount;
-    consts->gDenoisingRange                                     = m_CommonSettings.denoisingRange;
+    consts->gDenoisingRange                                     = view.commonSettings.denoisingRange;
     consts->gSpecPhiLuminance                                   = settings.specularPhiLuminance;
     consts->gDiffPhiLuminance                                   = settings.diffusePhiLuminance;
     consts->gDiffMaxLuminanceRelativeDifference                 = maxDiffuseLuminanceRelativeDifference;
@@ -157,29 +158,29 @@ void nrd::InstanceImpl::AddSharedConstants_Relax(const RelaxSettings& settings,
     consts->gConfidenceDrivenRelaxationMultiplier               = settings.confidenceDrivenRelaxationMultiplier;
     consts->gConfidenceDrivenLuminanceEdgeStoppingRelaxation    = settings.confidenceDrivenLuminanceEdgeStoppingRelaxation;
     consts->gConfidenceDrivenNormalEdgeStoppingRelaxation       = settings.confidenceDrivenNormalEdgeStoppingRelaxation;
-    consts->gDebug                                              = m_CommonSettings.debug;
-    consts->gOrthoMode                                          = m_OrthoMode;
-    consts->gUnproject                                          = 1.0f / (0.5f * rectH * m_ProjectY);
-    consts->gFramerateScale                                     = clamp(16.66f / m_TimeDelta, 0.25f, 4.0f); // TODO: use m_FrameRateScale?
-    consts->gCheckerboardResolveAccumSpeed                      = m_CheckerboardResolveAccumSpeed;
-    consts->gJitterDelta                                        = m_JitterDelta;
+    consts->gDebug                                              = view.commonSettings.debug;
+    consts->gOrthoMode                                          = view.orthoMode;
+    consts->gUnproject                                          = 1.0f / (0.5f * rectH * view.projectY);
+    consts->gFramerateScale                                     = clamp(16.66f / view.timeDelta, 0.25f, 4.0f); // TODO: use view.frameRateScale?
+    consts->gCheckerboardResolveAccumSpeed                      = view.checkerboardResolveAccumSpeed;
+    consts->gJitterDelta                                        = view.jitterDelta;
     consts->gHistoryFixFrameNum                                 = settings.historyFixFrameNum + 1.0f;
     consts->gHistoryFixBasePixelStride                          = (float)settings.historyFixBasePixelStride;
     consts->gHistoryThreshold                                   = (float)settings.spatialVarianceEstimationHistoryThreshold;
-    consts->gViewZScale                                         = m_CommonSettings.viewZScale;
+    consts->gViewZScale                                         = view.commonSettings.viewZScale;
     consts->gMinHitDistanceWeight                               = settings.minHitDistanceWeight * 2.0f; // TODO: 2 to match REBLUR units and make Pre passes identical (matches old default)
     consts->gDiffMinMaterial                                    = settings.minMaterialForDiffuse;
     consts->gSpecMinMaterial                                    = settings.minMaterialForSpecular;
     consts->gRoughnessEdgeStoppingEnabled                       = settings.enableRoughnessEdgeStopping ? 1 : 0;
-    consts->gFrameIndex                                         = m_CommonSettings.frameIndex;
+    consts->gFrameIndex                                         = view.commonSettings.frameIndex;
     consts->gDiffCheckerboard                                   = diffCheckerboard;
     consts->gSpecCheckerboard                                   = specCheckerboard;
-    consts->gHasHistoryConfidence                               = m_CommonSettings.isHistoryConfidenceAvailable ? 1 : 0;
-    consts->gHasDisocclusionThresholdMix                        = m_CommonSettings.isDisocclusionThresholdMixAvailable ? 1 : 0;
+    consts->gHasHistoryConfidence                               = view.commonSettings.isHistoryConfidenceAvailable ? 1 : 0;
+    consts->gHasDisocclusionThresholdMix                        = view.commonSettings.isDisocclusionThresholdMixAvailable ? 1 : 0;
     consts->gResetHistory                                       = isHistoryReset ? 1 : 0;
 }
 
-void nrd::InstanceImpl::Update_Relax(const DenoiserData& denoiserData)
+void nrd::InstanceImpl::Update_Relax(const DenoiserData& denoiserData, DispatchContext& context)
 {
     enum class Dispatch
     {
@@ -194,26 +195,35 @@ void nrd::InstanceImpl::Update_Relax(const DenoiserData& denoiserData)
         ATROUS                  = ANTI_FIREFLY + RELAX_NO_PERMUTATIONS,
         SPLIT_SCREEN            = ATROUS + RELAX_ATROUS_PERMUTATION_NUM * RELAX_ATROUS_BINDING_VARIANT_NUM,
         VALIDATION              = SPLIT_SCREEN + RELAX_NO_PERMUTATIONS,
+        UPSCALE                 = VALIDATION + 1,
+        SAMPLING_HINT           = UPSCALE + 1,
     };
 
+    const ViewState& view = *context.view;
     NRD_DECLARE_DIMS;
 
     const RelaxSettings& settings = denoiserData.settings.relax;
     bool enableHitDistanceReconstruction = settings.hitDistanceReconstructionMode != HitDistanceReconstructionMode::OFF && settings.checkerboardMode == CheckerboardMode::OFF;
     uint32_t iterationNum = clamp(settings.atrousIterationNum, 2u, RELAX_MAX_ATROUS_PASS_NUM);
+    bool enableUpscale = view.commonSettings.outputSize[0] != 0 && IsUpscaleSupported(denoiserData.desc.denoiser);
+    bool enableSamplingHint = view.commonSettings.enableSamplingHint && IsUpscaleSupported(denoiserData.desc.denoiser);
 
     // SPLIT_SCREEN (passthrough)
-    if (m_CommonSettings.splitScreen >= 1.0f)
+    if (view.commonSettings.splitScreen >= 1.0f)
     {
-        void* consts = PushDispatch(denoiserData, AsUint(Dispatch::SPLIT_SCREEN));
-        AddSharedConstants_Relax(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, AsUint(Dispatch::SPLIT_SCREEN));
+        AddSharedConstants_Relax(settings, context, consts);
+
+        // UPSCALE
+        if (enableUpscale)
+            PushUpscaleDispatch(context, denoiserData, AsUint(Dispatch::UPSCALE));
 
         return;
     }
 
     { // CLASSIFY_TILES
-        void* consts = PushDispatch(denoiserData, AsUint(Dispatch::CLASSIFY_TILES));
-        AddSharedConstants_Relax(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, AsUint(Dispatch::CLASSIFY_TILES));
+        AddSharedConstants_Relax(settings, context, consts);
     }
 
     // HITDIST_RECONSTRUCTION
@@ -221,76 +231,89 @@ void nrd::InstanceImpl::Update_Relax(const DenoiserData& denoiserData)
     {
         bool is5x5 = settings.hitDistanceReconstructionMode == HitDistanceReconstructionMode::AREA_5X5;
         uint32_t passIndex = AsUint(Dispatch::HITDIST_RECONSTRUCTION) + (is5x5 ? 1 : 0);
-        void* consts = PushDispatch(denoiserData, passIndex);
-        AddSharedConstants_Relax(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, passIndex);
+        AddSharedConstants_Relax(settings, context, consts);
     }
 
     { // PREPASS
         uint32_t passIndex = AsUint(Dispatch::PREPASS) + (enableHitDistanceReconstruction ? 1 : 0);
-        void* consts = PushDispatch(denoiserData, passIndex);
-        AddSharedConstants_Relax(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, passIndex);
+        AddSharedConstants_Relax(settings, context, consts);
     }
 
     { // TEMPORAL_ACCUMULATION
-        uint32_t passIndex = AsUint(Dispatch::TEMPORAL_ACCUMULATION) + (m_CommonSettings.isDisocclusionThresholdMixAvailable ? 2 : 0) + (m_CommonSettings.isHistoryConfidenceAvailable ? 1 : 0);
-        void* consts = PushDispatch(denoiserData, passIndex);
-        AddSharedConstants_Relax(settings, consts);
+        uint32_t passIndex = AsUint(Dispatch::TEMPORAL_ACCUMULATION) + (view.commonSettings.isDisocclusionThresholdMixAvailable ? 2 : 0) + (view.commonSettings.isHistoryConfidenceAvailable ? 1 : 0);
+        void* consts = PushDispatch(context, denoiserData, passIndex);
+        AddSharedConstants_Relax(settings, context, consts);
     }
 
     { // HISTORY_FIX
-        void* consts = PushDispatch(denoiserData, AsUint(Dispatch::HISTORY_FIX));
-        AddSharedConstants_Relax(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, AsUint(Dispatch::HISTORY_FIX));
+        AddSharedConstants_Relax(settings, context, consts);
     }
 
     { // HISTORY_CLAMPING
-        void* consts = PushDispatch(denoiserData, AsUint(Dispatch::HISTORY_CLAMPING));
-        AddSharedConstants_Relax(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, AsUint(Dispatch::HISTORY_CLAMPING));
+        AddSharedConstants_Relax(settings, context, consts);
     }
 
     if (settings.enableAntiFirefly)
     {
         { // COPY
-            void* consts = PushDispatch(denoiserData, AsUint(Dispatch::COPY));
-            AddSharedConstants_Relax(settings, consts);
+            void* consts = PushDispatch(context, denoiserData, AsUint(Dispatch::COPY));
+            AddSharedConstants_Relax(settings, context, consts);
         }
 
         { // ANTI_FIREFLY
-            void* consts = PushDispatch(denoiserData, AsUint(Dispatch::ANTI_FIREFLY));
-            AddSharedConstants_Relax(settings, consts);
+            void* consts = PushDispatch(context, denoiserData, AsUint(Dispatch::ANTI_FIREFLY));
+            AddSharedConstants_Relax(settings, context, consts);
         }
     }
 
     // A-TROUS
     for (uint32_t i = 0; i < iterationNum; i++)
     {
-        uint32_t passIndex = AsUint(Dispatch::ATROUS) + (m_CommonSettings.isHistoryConfidenceAvailable ? RELAX_ATROUS_BINDING_VARIANT_NUM : 0);
+        uint32_t passIndex = AsUint(Dispatch::ATROUS) + (view.commonSettings.isHistoryConfidenceAvailable ? RELAX_ATROUS_BINDING_VARIANT_NUM : 0);
         if (i != 0)
             passIndex += 2 - (i & 0x1);
         if (i == iterationNum - 1)
             passIndex += 2;
 
-        RELAX_AtrousConstants* consts = (RELAX_AtrousConstants*)PushDispatch(denoiserData, AsUint(passIndex)); // TODO: same as "RELAX_AtrousSmemConstants"
-        AddSharedConstants_Relax(settings, consts);
-        consts->gStepSize = 1 << i; // TODO: push constant
-        consts->gIsLastPass = i == iterationNum - 1 ? 1 : 0; // TODO: push constant
+        // Per-iteration values go to root constants, i.e. the constant buffer stays the same across iterations
+        RELAX_AtrousRootConstants rootConstants = {};
+        rootConstants.gStepSize = 1 << i;
+        rootConstants.gIsLastPass = i == iterationNum - 1 ? 1 : 0;
+
+        RELAX_AtrousConstants* consts = (RELAX_AtrousConstants*)PushDispatch(context, denoiserData, AsUint(passIndex), &rootConstants); // same as "RELAX_AtrousSmemConstants"
+        AddSharedConstants_Relax(settings, context, consts);
     }
 
     // SPLIT_SCREEN
-    if (m_CommonSettings.splitScreen > 0.0f)
+    if (view.commonSettings.splitScreen > 0.0f)
     {
-        void* consts = PushDispatch(denoiserData, AsUint(Dispatch::SPLIT_SCREEN));
-        AddSharedConstants_Relax(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, AsUint(Dispatch::SPLIT_SCREEN));
+        AddSharedConstants_Relax(settings, context, consts);
     }
 
     // VALIDATION
-    if (m_CommonSettings.enableValidation)
+    if (view.commonSettings.enableValidation)
     {
-        void* consts = PushDispatch(denoiserData, AsUint(Dispatch::VALIDATION));
-        AddSharedConstants_Relax(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, AsUint(Dispatch::VALIDATION));
+        AddSharedConstants_Relax(settings, context, consts);
     }
+
+    // UPSCALE
+    if (enableUpscale)
+        PushUpscaleDispatch(context, denoiserData, AsUint(Dispatch::UPSCALE));
+
+    // SAMPLING_HINT
+    if (enableSamplingHint)
+        PushSamplingHintDispatch(context, denoiserData, AsUint(Dispatch::SAMPLING_HINT));
 }
 
 // RELAX_SHARED
+#ifdef NRD_DENOISER_RELAX_SHARED
+
 #ifdef NRD_EMBEDS_DXBC_SHADERS
     #include "RELAX_ClassifyTiles.cs.dxbc.h"
     #include "RELAX_Validation.cs.dxbc.h"
@@ -306,7 +329,11 @@ void nrd::InstanceImpl::Update_Relax(const DenoiserData& denoiserData)
     #include "RELAX_Validation.cs.spirv.h"
 #endif
 
+#endif
+
 // RELAX_DIFFUSE
+#ifdef NRD_DENOISER_RELAX_DIFFUSE
+
 #ifdef NRD_EMBEDS_DXBC_SHADERS
     #include "RELAX_Diffuse_HitDistReconstruction.cs.dxbc.h"
     #include "RELAX_Diffuse_HitDistReconstruction_5x5.cs.dxbc.h"
@@ -350,8 +377,11 @@ void nrd::InstanceImpl::Update_Relax(const DenoiserData& denoiserData)
 #endif
 
 #include "Denoisers/Relax_Diffuse.hpp"
+#endif
 
 // RELAX_DIFFUSE_SH
+#ifdef NRD_DENOISER_RELAX_DIFFUSE_SH
+
 #ifdef NRD_EMBEDS_DXBC_SHADERS
     #include "RELAX_DiffuseSh_PrePass.cs.dxbc.h"
     #include "RELAX_DiffuseSh_TemporalAccumulation.cs.dxbc.h"
@@ -389,8 +419,11 @@ void nrd::InstanceImpl::Update_Relax(const DenoiserData& denoiserData)
 #endif
 
 #include "Denoisers/Relax_DiffuseSh.hpp"
+#endif
 
 // RELAX_SPECULAR
+#ifdef NRD_DENOISER_RELAX_SPECULAR
+
 #ifdef NRD_EMBEDS_DXBC_SHADERS
     #include "RELAX_Specular_HitDistReconstruction.cs.dxbc.h"
     #include "RELAX_Specular_HitDistReconstruction_5x5.cs.dxbc.h"
@@ -434,8 +467,11 @@ void nrd::InstanceImpl::Update_Relax(const DenoiserData& denoiserData)
 #endif
 
 #include "Denoisers/Relax_Specular.hpp"
+#endif
 
 // RELAX_SPECULAR_SH
+#ifdef NRD_DENOISER_RELAX_SPECULAR_SH
+
 #ifdef NRD_EMBEDS_DXBC_SHADERS
     #include "RELAX_SpecularSh_PrePass.cs.dxbc.h"
     #include "RELAX_SpecularSh_TemporalAccumulation.cs.dxbc.h"
@@ -473,8 +509,11 @@ void nrd::InstanceImpl::Update_Relax(const DenoiserData& denoiserData)
 #endif
 
 #include "Denoisers/Relax_SpecularSh.hpp"
+#endif
 
 // RELAX_DIFFUSE_SPECULAR
+#ifdef NRD_DENOISER_RELAX_DIFFUSE_SPECULAR
+
 #ifdef NRD_EMBEDS_DXBC_SHADERS
     #include "RELAX_DiffuseSpecular_HitDistReconstruction.cs.dxbc.h"
     #include "RELAX_DiffuseSpecular_HitDistReconstruction_5x5.cs.dxbc.h"
@@ -518,8 +557,11 @@ void nrd::InstanceImpl::Update_Relax(const DenoiserData& denoiserData)
 #endif
 
 #include "Denoisers/Relax_DiffuseSpecular.hpp"
+#endif
 
 // RELAX_DIFFUSE_SPECULAR_SH
+#ifdef NRD_DENOISER_RELAX_DIFFUSE_SPECULAR_SH
+
 #ifdef NRD_EMBEDS_DXBC_SHADERS
     #include "RELAX_DiffuseSpecularSh_PrePass.cs.dxbc.h"
     #include "RELAX_DiffuseSpecularSh_TemporalAccumulation.cs.dxbc.h"
@@ -557,3 +599,4 @@ void nrd::InstanceImpl::Update_Relax(const DenoiserData& denoiserData)
 #endif
 
 #include "Denoisers/Relax_DiffuseSpecularSh.hpp"
+#endif
@@ -0,0 +1,150 @@
+/*
+Copyright (c) 2022, NVIDIA CORPORATION. All rights reserved.
+
+NVIDIA CORPORATION and its licensors retain all intellectual property
+and proprietary rights in and to this software, related documentation
+and any modifications thereto. Any use, reproduction, disclosure or
+distribution of this software and related documentation without an express
+license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "ShaderPack.h"
+
+#include <cstring>
+
+#if defined(_WIN32)
+    #include <windows.h>
+#elif defined(__linux__) || defined(__APPLE__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#else
+    #include <cstdio> // no memory mapping, the file is read into memory
+#endif
+
+nrd::ShaderPackImpl::~ShaderPackImpl()
+{
+    if (!m_Data)
+        return;
+
+#if defined(_WIN32)
+    UnmapViewOfFile(m_Data);
+    CloseHandle((HANDLE)m_FileMapping);
+#elif defined(__linux__) || defined(__APPLE__)
+    munmap((void*)m_Data, (size_t)m_Size);
+#else
+    m_StdAllocator.deallocate((uint8_t*)m_Data, 0);
+#endif
+}
+
+nrd::Result nrd::ShaderPackImpl::Create(const ShaderPackCreationDesc& shaderPackCreationDesc)
+{
+    if (!shaderPackCreationDesc.path)
+        return Result::INVALID_ARGUMENT;
+
+    // Map
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(shaderPackCreationDesc.path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return Result::FAILURE;
+
+    LARGE_INTEGER fileSize = {};
+    GetFileSizeEx(file, &fileSize);
+
+    HANDLE fileMapping = fileSize.QuadPart ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    CloseHandle(file);
+    if (!fileMapping)
+        return Result::FAILURE;
+
+    void* data = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data)
+    {
+        CloseHandle(fileMapping);
+        return Result::FAILURE;
+    }
+
+    m_FileMapping = fileMapping;
+    m_Size = (uint64_t)fileSize.QuadPart;
+#elif defined(__linux__) || defined(__APPLE__)
+    int file = open(shaderPackCreationDesc.path, O_RDONLY);
+    if (file < 0)
+        return Result::FAILURE;
+
+    struct stat fileStat = {};
+    void* data = MAP_FAILED;
+    if (fstat(file, &fileStat) == 0 && fileStat.st_size > 0)
+        data = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+    close(file); // the mapping stays valid
+    if (data == MAP_FAILED)
+        return Result::FAILURE;
+
+    m_Size = (uint64_t)fileStat.st_size;
+#else
+    FILE* file = fopen(shaderPackCreationDesc.path, "rb");
+    if (!file)
+        return Result::FAILURE;
+
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    uint8_t* data = fileSize > 0 ? m_StdAllocator.allocate((size_t)fileSize) : nullptr;
+    if (data && fread(data, 1, (size_t)fileSize, file) != (size_t)fileSize)
+    {
+        m_StdAllocator.deallocate(data, 0);
+        data = nullptr;
+    }
+
+    fclose(file);
+    if (!data)
+        return Result::FAILURE;
+
+    m_Size = (uint64_t)fileSize;
+#endif
+
+    m_Data = (const uint8_t*)data;
+
+    // Validate (only the header and the table, blobs are validated lazily in "Find")
+    m_Header = (const ShaderPackHeader*)m_Data;
+
+    if (m_Size < sizeof(ShaderPackHeader) || m_Header->magic != SHADER_PACK_MAGIC || m_Header->version != SHADER_PACK_VERSION)
+        return Result::UNSUPPORTED;
+
+    uint32_t bucketsNum = m_Header->bucketsNum;
+    bool isValid = m_Header->fileSize == m_Size
+        && m_Header->format < (uint32_t)ShaderFormat::MAX_NUM
+        && bucketsNum != 0 && (bucketsNum & (bucketsNum - 1)) == 0
+        && m_Header->entriesNum < bucketsNum
+        && sizeof(ShaderPackHeader) + uint64_t(bucketsNum) * sizeof(ShaderPackEntry) <= m_Size;
+
+    return isValid ? Result::SUCCESS : Result::UNSUPPORTED;
+}
+
+nrd::ComputeShaderDesc nrd::ShaderPackImpl::Find(const char* shaderFileName) const
+{
+    const ShaderPackEntry* entries = (const ShaderPackEntry*)(m_Data + sizeof(ShaderPackHeader));
+    uint32_t mask = m_Header->bucketsNum - 1;
+
+    size_t nameLength = strlen(shaderFileName);
+    uint64_t nameHash = HashString(shaderFileName);
+
+    // There is always at least one empty bucket, i.e. probing terminates
+    for (uint32_t i = uint32_t(nameHash) & mask; entries[i].nameLength != 0; i = (i + 1) & mask)
+    {
+        const ShaderPackEntry& entry = entries[i];
+        if (entry.nameHash != nameHash || entry.nameLength != nameLength)
+            continue;
+
+        if (uint64_t(entry.nameOffset) + entry.nameLength > m_Size || memcmp(m_Data + entry.nameOffset, shaderFileName, nameLength))
+            continue;
+
+        if (entry.dataOffset > m_Size || entry.dataSize > m_Size - entry.dataOffset)
+            break;
+
+        return {m_Data + entry.dataOffset, entry.dataSize};
+    }
+
+    return {};
+}
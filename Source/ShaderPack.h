@@ -0,0 +1,47 @@
+/*
+Copyright (c) 2022, NVIDIA CORPORATION. All rights reserved.
+
+NVIDIA CORPORATION and its licensors retain all intellectual property
+and proprietary rights in and to this software, related documentation
+and any modifications thereto. Any use, reproduction, disclosure or
+distribution of this software and related documentation without an express
+license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include "NRD.h"
+#include "ShaderPackFormat.h"
+
+typedef nrd::AllocationCallbacks AllocationCallbacks;
+#include "StdAllocator.h"
+
+namespace nrd
+{
+    // Read-only memory-mapped view of a shader pack file, bytecode is returned without copying
+    class ShaderPackImpl
+    {
+    public:
+        inline ShaderPackImpl(const StdAllocator<uint8_t>& stdAllocator) :
+            m_StdAllocator(stdAllocator)
+        {}
+
+        ~ShaderPackImpl();
+
+        inline StdAllocator<uint8_t>& GetStdAllocator()
+        { return m_StdAllocator; }
+
+        inline ShaderFormat GetFormat() const
+        { return (ShaderFormat)m_Header->format; }
+
+        Result Create(const ShaderPackCreationDesc& shaderPackCreationDesc);
+        ComputeShaderDesc Find(const char* shaderFileName) const;
+
+    private:
+        StdAllocator<uint8_t> m_StdAllocator;
+        const ShaderPackHeader* m_Header = nullptr;
+        const uint8_t* m_Data = nullptr;
+        uint64_t m_Size = 0;
+        void* m_FileMapping = nullptr; // Windows only
+    };
+}
@@ -0,0 +1,58 @@
+/*
+Copyright (c) 2022, NVIDIA CORPORATION. All rights reserved.
+
+NVIDIA CORPORATION and its licensors retain all intellectual property
+and proprietary rights in and to this software, related documentation
+and any modifications thereto. Any use, reproduction, disclosure or
+distribution of this software and related documentation without an express
+license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+// Shader pack file layout (shared with "Tools/ShaderPacker.cpp", no dependencies):
+//  - ShaderPackHeader
+//  - ShaderPackEntry[ bucketsNum ] - open addressing hash table (linear probing), keyed by "HashString(shaderFileName)"
+//  - names (not null-terminated)
+//  - bytecode blobs, each aligned to SHADER_PACK_ALIGNMENT
+// All offsets are relative to the beginning of the file
+namespace nrd
+{
+    constexpr uint32_t SHADER_PACK_MAGIC = 0x4B50524E; // "NRPK"
+    constexpr uint32_t SHADER_PACK_VERSION = 1;
+    constexpr uint32_t SHADER_PACK_ALIGNMENT = 16;
+
+    struct ShaderPackHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t format; // nrd::ShaderFormat
+        uint32_t entriesNum;
+        uint32_t bucketsNum; // power of 2
+        uint32_t reserved;
+        uint64_t fileSize;
+    };
+
+    struct ShaderPackEntry // empty bucket if "nameLength = 0"
+    {
+        uint64_t nameHash;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint64_t dataOffset;
+        uint64_t dataSize;
+    };
+
+    static_assert(sizeof(ShaderPackHeader) == 32, "Unexpected size");
+    static_assert(sizeof(ShaderPackEntry) == 32, "Unexpected size");
+
+    inline uint64_t HashString(const char* s, size_t length = size_t(-1)) // FNV-1a
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < length && s[i]; i++)
+            hash = (hash ^ (uint8_t)s[i]) * 1099511628211ull;
+
+        return hash;
+    }
+}
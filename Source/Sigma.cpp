@@ -22,7 +22,7 @@ license agreement from NVIDIA CORPORATION is strictly prohibited.
 #define SIGMA_POST_BLUR_PERMUTATION_NUM     2
 #define SIGMA_NO_PERMUTATIONS               1
 
-void nrd::InstanceImpl::Update_SigmaShadow(const DenoiserData& denoiserData)
+void nrd::InstanceImpl::Update_SigmaShadow(const DenoiserData& denoiserData, DispatchContext& context)
 {
     enum class Dispatch
     {
@@ -35,116 +35,120 @@ void nrd::InstanceImpl::Update_SigmaShadow(const DenoiserData& denoiserData)
         SPLIT_SCREEN            = TEMPORAL_STABILIZATION + SIGMA_NO_PERMUTATIONS,
     };
 
+    const ViewState& view = *context.view;
     const SigmaSettings& settings = denoiserData.settings.sigma;
 
     // SPLIT_SCREEN (passthrough)
-    if (m_CommonSettings.splitScreen >= 1.0f)
+    if (view.commonSettings.splitScreen >= 1.0f)
     {
-        void* consts = PushDispatch(denoiserData, AsUint(Dispatch::SPLIT_SCREEN));
-        AddSharedConstants_Sigma(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, AsUint(Dispatch::SPLIT_SCREEN));
+        AddSharedConstants_Sigma(settings, context, consts);
 
         return;
     }
 
     { // CLASSIFY_TILES
-        void* consts = PushDispatch(denoiserData, AsUint(Dispatch::CLASSIFY_TILES));
-        AddSharedConstants_Sigma(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, AsUint(Dispatch::CLASSIFY_TILES));
+        AddSharedConstants_Sigma(settings, context, consts);
     }
 
     { // SMOOTH_TILES
-        void* consts = PushDispatch(denoiserData, AsUint(Dispatch::SMOOTH_TILES));
-        AddSharedConstants_Sigma(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, AsUint(Dispatch::SMOOTH_TILES));
+        AddSharedConstants_Sigma(settings, context, consts);
     }
 
     // COPY
     if (settings.maxStabilizedFrameNum)
     {
-        void* consts = PushDispatch(denoiserData, AsUint(Dispatch::COPY));
-        AddSharedConstants_Sigma(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, AsUint(Dispatch::COPY));
+        AddSharedConstants_Sigma(settings, context, consts);
     }
 
     { // BLUR
-        void* consts = PushDispatch(denoiserData, AsUint(Dispatch::BLUR));
-        AddSharedConstants_Sigma(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, AsUint(Dispatch::BLUR));
+        AddSharedConstants_Sigma(settings, context, consts);
     }
 
     { // POST_BLUR
         uint32_t passIndex = AsUint(Dispatch::POST_BLUR) + (settings.maxStabilizedFrameNum ? 1 : 0);
-        void* consts = PushDispatch(denoiserData, passIndex);
-        AddSharedConstants_Sigma(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, passIndex);
+        AddSharedConstants_Sigma(settings, context, consts);
     }
 
     // TEMPORAL_STABILIZATION
     if (settings.maxStabilizedFrameNum)
     {
-        void* consts = PushDispatch(denoiserData, AsUint(Dispatch::TEMPORAL_STABILIZATION));
-        AddSharedConstants_Sigma(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, AsUint(Dispatch::TEMPORAL_STABILIZATION));
+        AddSharedConstants_Sigma(settings, context, consts);
     }
 
     // SPLIT_SCREEN
-    if (m_CommonSettings.splitScreen > 0.0f)
+    if (view.commonSettings.splitScreen > 0.0f)
     {
-        void* consts = PushDispatch(denoiserData, AsUint(Dispatch::SPLIT_SCREEN));
-        AddSharedConstants_Sigma(settings, consts);
+        void* consts = PushDispatch(context, denoiserData, AsUint(Dispatch::SPLIT_SCREEN));
+        AddSharedConstants_Sigma(settings, context, consts);
     }
 }
 
-void nrd::InstanceImpl::AddSharedConstants_Sigma(const SigmaSettings& settings, void* data)
+void nrd::InstanceImpl::AddSharedConstants_Sigma(const SigmaSettings& settings, const DispatchContext& context, void* data)
 {
     struct SharedConstants
     {
         SIGMA_SHARED_CONSTANTS
     };
 
+    const ViewState& view = *context.view;
     NRD_DECLARE_DIMS;
 
-    float unproject = 1.0f / (0.5f * rectH * m_ProjectY);
+    float unproject = 1.0f / (0.5f * rectH * view.projectY);
     uint16_t tilesW = DivideUp(rectW, 16);
     uint16_t tilesH = DivideUp(rectH, 16);
 
     bool isRectChanged = rectW != rectWprev || rectH != rectHprev;
     uint32_t frameNum = min(settings.maxStabilizedFrameNum, SIGMA_MAX_HISTORY_FRAME_NUM);
-    float3 lightDirectionView = Rotate(m_WorldToView, float3(settings.lightDirection[0], settings.lightDirection[1], settings.lightDirection[2]));
+    float3 lightDirectionView = Rotate(view.worldToView, float3(settings.lightDirection[0], settings.lightDirection[1], settings.lightDirection[2]));
     float stabilizationStrength = frameNum / (1.0f + frameNum);
 
     SharedConstants* consts         = (SharedConstants*)data;
-    consts->gWorldToView            = m_WorldToView;
-    consts->gViewToClip             = m_ViewToClip;
-    consts->gWorldToClipPrev        = m_WorldToClipPrev;
-    consts->gWorldToViewPrev        = m_WorldToViewPrev;
-    consts->gRotator                = m_Rotator;
-    consts->gRotatorPost            = m_RotatorPost;
-    consts->gViewVectorWorld        = m_ViewDirection.xmm;
+    consts->gWorldToView            = view.worldToView;
+    consts->gViewToClip             = view.viewToClip;
+    consts->gWorldToClipPrev        = view.worldToClipPrev;
+    consts->gWorldToViewPrev        = view.worldToViewPrev;
+    consts->gRotator                = view.rotator;
+    consts->gRotatorPost            = view.rotatorPost;
+    consts->gViewVectorWorld        = view.viewDirection.xmm;
     consts->gLightDirectionView     = float4(lightDirectionView.x, lightDirectionView.y, lightDirectionView.z, 0.0f);
-    consts->gFrustum                = m_Frustum;
-    consts->gFrustumPrev            = m_FrustumPrev;
-    consts->gCameraDelta            = m_CameraDelta.xmm;
-    consts->gMvScale                = float4(m_CommonSettings.motionVectorScale[0], m_CommonSettings.motionVectorScale[1], m_CommonSettings.motionVectorScale[2], m_CommonSettings.isMotionVectorInWorldSpace ? 1.0f : 0.0f);
+    consts->gFrustum                = view.frustum;
+    consts->gFrustumPrev            = view.frustumPrev;
+    consts->gCameraDelta            = view.cameraDelta.xmm;
+    consts->gMvScale                = float4(view.commonSettings.motionVectorScale[0], view.commonSettings.motionVectorScale[1], view.commonSettings.motionVectorScale[2], view.commonSettings.isMotionVectorInWorldSpace ? 1.0f : 0.0f);
     consts->gResourceSizeInv        = float2(1.0f / float(resourceW), 1.0f / float(resourceH));
     consts->gResourceSizeInvPrev    = float2(1.0f / float(resourceWprev), 1.0f / float(resourceHprev));
     consts->gRectSize               = float2(float(rectW), float(rectH));
     consts->gRectSizeInv            = float2(1.0f / float(rectW), 1.0f / float(rectH));
     consts->gRectSizePrev           = float2(float(rectWprev), float(rectHprev));
     consts->gResolutionScale        = float2(float(rectW) / float(resourceW), float(rectH) / float(resourceH));
-    consts->gRectOffset             = float2(float(m_CommonSettings.rectOrigin[0]) / float(resourceW), float(m_CommonSettings.rectOrigin[1]) / float(resourceH));
-    consts->gPrintfAt               = uint2(m_CommonSettings.printfAt[0], m_CommonSettings.printfAt[1]);
-    consts->gRectOrigin             = uint2(m_CommonSettings.rectOrigin[0], m_CommonSettings.rectOrigin[1]);
+    consts->gRectOffset             = float2(float(view.commonSettings.rectOrigin[0]) / float(resourceW), float(view.commonSettings.rectOrigin[1]) / float(resourceH));
+    consts->gPrintfAt               = uint2(view.commonSettings.printfAt[0], view.commonSettings.printfAt[1]);
+    consts->gRectOrigin             = uint2(view.commonSettings.rectOrigin[0], view.commonSettings.rectOrigin[1]);
     consts->gRectSizeMinusOne       = int2(rectW - 1, rectH - 1);
     consts->gTilesSizeMinusOne      = int2(tilesW - 1, tilesH - 1);
-    consts->gOrthoMode              = m_OrthoMode;
+    consts->gOrthoMode              = view.orthoMode;
     consts->gUnproject              = unproject;
-    consts->gDenoisingRange         = m_CommonSettings.denoisingRange;
+    consts->gDenoisingRange         = view.commonSettings.denoisingRange;
     consts->gPlaneDistSensitivity   = settings.planeDistanceSensitivity;
-    consts->gStabilizationStrength  = m_CommonSettings.accumulationMode == AccumulationMode::CONTINUE ? stabilizationStrength : 0.0f;
-    consts->gDebug                  = m_CommonSettings.debug;
-    consts->gSplitScreen            = m_CommonSettings.splitScreen;
-    consts->gViewZScale             = m_CommonSettings.viewZScale;
+    consts->gStabilizationStrength  = context.accumulationMode == AccumulationMode::CONTINUE ? stabilizationStrength : 0.0f;
+    consts->gDebug                  = view.commonSettings.debug;
+    consts->gSplitScreen            = view.commonSettings.splitScreen;
+    consts->gViewZScale             = view.commonSettings.viewZScale;
     consts->gMinRectDimMulUnproject = (float)min(rectW, rectH) * unproject;
-    consts->gFrameIndex             = m_CommonSettings.frameIndex;
+    consts->gFrameIndex             = view.commonSettings.frameIndex;
     consts->gIsRectChanged          = isRectChanged ? 1 : 0;
 }
 
 // SIGMA_SHARED
+#ifdef NRD_DENOISER_SIGMA_SHARED
+
 #ifdef NRD_EMBEDS_DXBC_SHADERS
     #include "SIGMA_Copy.cs.dxbc.h"
     #include "SIGMA_SmoothTiles.cs.dxbc.h"
@@ -160,7 +164,11 @@ void nrd::InstanceImpl::AddSharedConstants_Sigma(const SigmaSettings& settings,
     #include "SIGMA_SmoothTiles.cs.spirv.h"
 #endif
 
+#endif
+
 // SIGMA_SHADOW
+#ifdef NRD_DENOISER_SIGMA_SHADOW
+
 #ifdef NRD_EMBEDS_DXBC_SHADERS
     #include "SIGMA_Shadow_ClassifyTiles.cs.dxbc.h"
     #include "SIGMA_Shadow_Blur.cs.dxbc.h"
@@ -186,8 +194,11 @@ void nrd::InstanceImpl::AddSharedConstants_Sigma(const SigmaSettings& settings,
 #endif
 
 #include "Denoisers/Sigma_Shadow.hpp"
+#endif
 
 // SIGMA_SHADOW_TRANSLUCENCY
+#ifdef NRD_DENOISER_SIGMA_SHADOW_TRANSLUCENCY
+
 #ifdef NRD_EMBEDS_DXBC_SHADERS
     #include "SIGMA_ShadowTranslucency_ClassifyTiles.cs.dxbc.h"
     #include "SIGMA_ShadowTranslucency_Blur.cs.dxbc.h"
@@ -213,3 +224,4 @@ void nrd::InstanceImpl::AddSharedConstants_Sigma(const SigmaSettings& settings,
 #endif
 
 #include "Denoisers/Sigma_ShadowTranslucency.hpp"
+#endif
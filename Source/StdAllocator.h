@@ -156,7 +156,10 @@ private:
 template<typename T>
 bool operator== (const StdAllocator<T>& left, const StdAllocator<T>& right)
 {
-    return left.GetInterface() == right.GetInterface();
+    const AllocationCallbacks& a = left.GetInterface();
+    const AllocationCallbacks& b = right.GetInterface();
+
+    return a.Allocate == b.Allocate && a.Reallocate == b.Reallocate && a.Free == b.Free && a.userArg == b.userArg;
 }
 
 template<typename T>
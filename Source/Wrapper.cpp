@@ -10,6 +10,7 @@ license agreement from NVIDIA CORPORATION is strictly prohibited.
 
 #include "NRD.h"
 #include "InstanceImpl.h"
+#include "ShaderPack.h"
 #include "../Resources/Version.h"
 
 #include <array>
@@ -20,34 +21,73 @@ static_assert(VERSION_BUILD == NRD_VERSION_BUILD, "VERSION_BUILD & NRD_VERSION_B
 static_assert(NRD_NORMAL_ENCODING >= 0 && NRD_NORMAL_ENCODING < (uint32_t)nrd::NormalEncoding::MAX_NUM, "NRD_NORMAL_ENCODING out of bounds!");
 static_assert(NRD_ROUGHNESS_ENCODING >= 0 && NRD_ROUGHNESS_ENCODING < (uint32_t)nrd::RoughnessEncoding::MAX_NUM, "NRD_ROUGHNESS_ENCODING out of bounds!");
 
-constexpr std::array<nrd::Denoiser, (size_t)nrd::Denoiser::MAX_NUM> g_NrdSupportedDenoisers =
+// Only denoisers compiled in (see "NRD_DENOISER_SUBSET")
+constexpr nrd::Denoiser g_NrdSupportedDenoisers[] =
 {
+#ifdef NRD_DENOISER_REBLUR_DIFFUSE
     nrd::Denoiser::REBLUR_DIFFUSE,
+#endif
+#ifdef NRD_DENOISER_REBLUR_DIFFUSE_OCCLUSION
     nrd::Denoiser::REBLUR_DIFFUSE_OCCLUSION,
+#endif
+#ifdef NRD_DENOISER_REBLUR_DIFFUSE_SH
     nrd::Denoiser::REBLUR_DIFFUSE_SH,
+#endif
+#ifdef NRD_DENOISER_REBLUR_SPECULAR
     nrd::Denoiser::REBLUR_SPECULAR,
+#endif
+#ifdef NRD_DENOISER_REBLUR_SPECULAR_OCCLUSION
     nrd::Denoiser::REBLUR_SPECULAR_OCCLUSION,
+#endif
+#ifdef NRD_DENOISER_REBLUR_SPECULAR_SH
     nrd::Denoiser::REBLUR_SPECULAR_SH,
+#endif
+#ifdef NRD_DENOISER_REBLUR_DIFFUSE_SPECULAR
     nrd::Denoiser::REBLUR_DIFFUSE_SPECULAR,
+#endif
+#ifdef NRD_DENOISER_REBLUR_DIFFUSE_SPECULAR_OCCLUSION
     nrd::Denoiser::REBLUR_DIFFUSE_SPECULAR_OCCLUSION,
+#endif
+#ifdef NRD_DENOISER_REBLUR_DIFFUSE_SPECULAR_SH
     nrd::Denoiser::REBLUR_DIFFUSE_SPECULAR_SH,
+#endif
+#ifdef NRD_DENOISER_REBLUR_DIFFUSE_DIRECTIONAL_OCCLUSION
     nrd::Denoiser::REBLUR_DIFFUSE_DIRECTIONAL_OCCLUSION,
+#endif
+#ifdef NRD_DENOISER_RELAX_DIFFUSE
     nrd::Denoiser::RELAX_DIFFUSE,
+#endif
+#ifdef NRD_DENOISER_RELAX_DIFFUSE_SH
     nrd::Denoiser::RELAX_DIFFUSE_SH,
+#endif
+#ifdef NRD_DENOISER_RELAX_SPECULAR
     nrd::Denoiser::RELAX_SPECULAR,
+#endif
+#ifdef NRD_DENOISER_RELAX_SPECULAR_SH
     nrd::Denoiser::RELAX_SPECULAR_SH,
+#endif
+#ifdef NRD_DENOISER_RELAX_DIFFUSE_SPECULAR
     nrd::Denoiser::RELAX_DIFFUSE_SPECULAR,
+#endif
+#ifdef NRD_DENOISER_RELAX_DIFFUSE_SPECULAR_SH
     nrd::Denoiser::RELAX_DIFFUSE_SPECULAR_SH,
+#endif
+#ifdef NRD_DENOISER_SIGMA_SHADOW
     nrd::Denoiser::SIGMA_SHADOW,
+#endif
+#ifdef NRD_DENOISER_SIGMA_SHADOW_TRANSLUCENCY
     nrd::Denoiser::SIGMA_SHADOW_TRANSLUCENCY,
+#endif
+#ifdef NRD_DENOISER_REFERENCE
     nrd::Denoiser::REFERENCE,
+#endif
 };
 
 constexpr nrd::LibraryDesc g_NrdLibraryDesc =
 {
     { 100, 200, 300, 400 }, // IMPORTANT: must match values used in CMake
-    g_NrdSupportedDenoisers.data(),
-    (uint32_t)g_NrdSupportedDenoisers.size(),
+    g_NrdSupportedDenoisers,
+    GetCountOf(g_NrdSupportedDenoisers),
     VERSION_MAJOR,
     VERSION_MINOR,
     VERSION_BUILD,
@@ -92,6 +132,10 @@ const char* g_NrdResourceTypeNames[] =
 
     "TRANSIENT_POOL",
     "PERMANENT_POOL",
+
+    "OUT_DIFF_RADIANCE_HITDIST_UPSCALED",
+    "OUT_SPEC_RADIANCE_HITDIST_UPSCALED",
+    "OUT_SAMPLING_HINT",
 };
 static_assert( GetCountOf(g_NrdResourceTypeNames) == (uint32_t)nrd::ResourceType::MAX_NUM );
 
@@ -262,6 +306,33 @@ NRD_API nrd::Result NRD_CALL nrd::CreateInstance(const InstanceCreationDesc& ins
     return result;
 }
 
+NRD_API nrd::Result NRD_CALL nrd::PlanInstance(const InstanceCreationDesc& instanceCreationDesc, uint16_t resourceWidth, uint16_t resourceHeight,
+    InstancePlan& instancePlan, PassPlan* passPlans, uint32_t& passPlansNum)
+{
+    instancePlan = {};
+
+    // A temporary instance without shaders (only the resource graph is needed)
+    InstanceCreationDesc modifiedInstanceCreationDesc = instanceCreationDesc;
+    modifiedInstanceCreationDesc.shaderPacks = nullptr;
+    modifiedInstanceCreationDesc.shaderPacksNum = 0;
+    CheckAndSetDefaultAllocator(modifiedInstanceCreationDesc.allocationCallbacks);
+
+    StdAllocator<uint8_t> memoryAllocator(modifiedInstanceCreationDesc.allocationCallbacks);
+
+    InstanceImpl* implementation = Allocate<InstanceImpl>(memoryAllocator, memoryAllocator);
+    implementation->SkipShaders();
+
+    Result result = implementation->Create(modifiedInstanceCreationDesc);
+    if (result == Result::SUCCESS)
+        result = implementation->Plan(resourceWidth, resourceHeight, instancePlan, passPlans, passPlansNum);
+    else
+        passPlansNum = 0;
+
+    Deallocate(memoryAllocator, implementation);
+
+    return result;
+}
+
 NRD_API const nrd::InstanceDesc& NRD_CALL nrd::GetInstanceDesc(const Instance& denoiser)
 {
     return ((const InstanceImpl&)denoiser).GetDesc();
@@ -269,7 +340,17 @@ NRD_API const nrd::InstanceDesc& NRD_CALL nrd::GetInstanceDesc(const Instance& d
 
 NRD_API nrd::Result NRD_CALL nrd::SetCommonSettings(Instance& instance, const CommonSettings& commonSettings)
 {
-    return ((InstanceImpl&)instance).SetCommonSettings(commonSettings);
+    return ((InstanceImpl&)instance).SetViewportSettings(0, commonSettings);
+}
+
+NRD_API nrd::Result NRD_CALL nrd::SetViewportSettings(Instance& instance, uint32_t viewportIndex, const CommonSettings& commonSettings)
+{
+    return ((InstanceImpl&)instance).SetViewportSettings(viewportIndex, commonSettings);
+}
+
+NRD_API nrd::Result NRD_CALL nrd::SetStereoSettings(Instance& instance, const CommonSettings& leftEye, const CommonSettings& rightEye)
+{
+    return ((InstanceImpl&)instance).SetStereoSettings(leftEye, rightEye);
 }
 
 NRD_API nrd::Result NRD_CALL nrd::SetDenoiserSettings(Instance& instance, Identifier identifier, const void* denoiserSettings)
@@ -282,12 +363,70 @@ NRD_API nrd::Result NRD_CALL nrd::GetComputeDispatches(Instance& instance, const
     return ((InstanceImpl&)instance).GetComputeDispatches(identifiers, identifiersNum, dispatchDescs, dispatchDescsNum);
 }
 
+NRD_API nrd::Result NRD_CALL nrd::GetComputeDispatchesToMemory(Instance& instance, const Identifier* identifiers, uint32_t identifiersNum,
+    DispatchDesc* dispatchDescs, uint32_t& dispatchDescsNum, uint8_t* constantData, uint32_t& constantDataSize, uint32_t constantDataAlignment)
+{
+    return ((InstanceImpl&)instance).GetComputeDispatches(identifiers, identifiersNum, dispatchDescs, dispatchDescsNum, constantData, constantDataSize, constantDataAlignment);
+}
+
+NRD_API nrd::Result NRD_CALL nrd::GetResizeDispatches(Instance& instance, uint16_t resourceWidth, uint16_t resourceHeight, const DispatchDesc*& dispatchDescs, uint32_t& dispatchDescsNum)
+{
+    return ((InstanceImpl&)instance).GetResizeDispatches(resourceWidth, resourceHeight, dispatchDescs, dispatchDescsNum);
+}
+
+NRD_API nrd::Result NRD_CALL nrd::GetDispatchStats(const Instance& instance, const DispatchDesc* dispatchDescs, uint32_t dispatchDescsNum, DispatchStats& dispatchStats)
+{
+    return ((const InstanceImpl&)instance).GetDispatchStats(dispatchDescs, dispatchDescsNum, dispatchStats);
+}
+
+NRD_API nrd::Result NRD_CALL nrd::ExportHistory(const Instance& instance, void* data, uint32_t& dataSize)
+{
+    return ((const InstanceImpl&)instance).ExportHistory(data, dataSize);
+}
+
+NRD_API nrd::Result NRD_CALL nrd::ImportHistory(Instance& instance, const void* data, uint32_t dataSize, uint16_t* permanentPoolRemap)
+{
+    return ((InstanceImpl&)instance).ImportHistory(data, dataSize, permanentPoolRemap);
+}
+
+NRD_API nrd::Result NRD_CALL nrd::InheritHistory(Instance& instance, const Instance& source, uint16_t* permanentPoolRemap)
+{
+    return ((InstanceImpl&)instance).InheritHistory((const InstanceImpl&)source, permanentPoolRemap);
+}
+
 NRD_API void NRD_CALL nrd::DestroyInstance(Instance& instance)
 {
     StdAllocator<uint8_t> memoryAllocator = ((InstanceImpl&)instance).GetStdAllocator();
     Deallocate(memoryAllocator, (InstanceImpl*)&instance);
 }
 
+NRD_API nrd::Result NRD_CALL nrd::CreateShaderPack(const ShaderPackCreationDesc& shaderPackCreationDesc, ShaderPack*& shaderPack)
+{
+    AllocationCallbacks allocationCallbacks = shaderPackCreationDesc.allocationCallbacks;
+    CheckAndSetDefaultAllocator(allocationCallbacks);
+
+    StdAllocator<uint8_t> memoryAllocator(allocationCallbacks);
+
+    ShaderPackImpl* implementation = Allocate<ShaderPackImpl>(memoryAllocator, memoryAllocator);
+    const Result result = implementation->Create(shaderPackCreationDesc);
+
+    if (result == Result::SUCCESS)
+    {
+        shaderPack = (ShaderPack*)implementation;
+        return Result::SUCCESS;
+    }
+
+    Deallocate(memoryAllocator, implementation);
+
+    return result;
+}
+
+NRD_API void NRD_CALL nrd::DestroyShaderPack(ShaderPack& shaderPack)
+{
+    StdAllocator<uint8_t> memoryAllocator = ((ShaderPackImpl&)shaderPack).GetStdAllocator();
+    Deallocate(memoryAllocator, (ShaderPackImpl*)&shaderPack);
+}
+
 NRD_API const char* NRD_CALL nrd::GetResourceTypeString(ResourceType resourceType)
 {
     uint32_t i = (uint32_t)resourceType;
@@ -0,0 +1,51 @@
+/*
+Copyright (c) 2022, NVIDIA CORPORATION. All rights reserved.
+
+NVIDIA CORPORATION and its licensors retain all intellectual property
+and proprietary rights in and to this software, related documentation
+and any modifications thereto. Any use, reproduction, disclosure or
+distribution of this software and related documentation without an express
+license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+// Minimal test harness (no dependencies): a test is an executable, which returns non-0 if any check has failed
+//  - "NRD_TEST_SKIP" (77) is reported as "skipped" by CTest (see "SKIP_RETURN_CODE")
+
+#include <cstdint>
+#include <cstdio>
+
+#define NRD_TEST_SKIP 77
+
+static uint32_t g_TestFailedChecks = 0;
+
+#define NRD_TEST_CHECK(expr) \
+    do \
+    { \
+        if (!(expr)) \
+        { \
+            if (g_TestFailedChecks++ < 32) /* don't flood the log from loops */ \
+                printf("%s(%d): FAILED: %s\n", __FILE__, __LINE__, #expr); \
+        } \
+    } while (0)
+
+#define NRD_TEST_RESULT() \
+    (g_TestFailedChecks ? (printf("%u check(s) failed\n", g_TestFailedChecks), 1) : (printf("OK\n"), 0))
+
+struct Random // xorshift32, deterministic
+{
+    uint32_t state = 0x12345678;
+
+    uint32_t Uint()
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+
+        return state;
+    }
+
+    float Float(float a, float b)
+    { return a + (b - a) * float(Uint() >> 8) / float(1 << 24); }
+};
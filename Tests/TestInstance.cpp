@@ -0,0 +1,788 @@
+/*
+Copyright (c) 2022, NVIDIA CORPORATION. All rights reserved.
+
+NVIDIA CORPORATION and its licensors retain all intellectual property
+and proprietary rights in and to this software, related documentation
+and any modifications thereto. Any use, reproduction, disclosure or
+distribution of this software and related documentation without an express
+license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+// CPU side of the library (no device needed): denoiser subset, dispatch statistics, output to caller memory, live reconfiguration, sampling hint setup
+// "NRD_TEST_DENOISERS" - expected "NRD_DENOISERS" ("ALL" or a comma separated list), tests needing excluded denoisers are skipped
+
+#include "Test.h"
+
+#include "NRD.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+
+constexpr uint16_t WIDTH = 317; // not a multiple of a thread group size
+constexpr uint16_t HEIGHT = 123;
+
+constexpr nrd::Identifier REBLUR = 1;
+constexpr nrd::Identifier SIGMA = 2;
+constexpr nrd::Identifier RELAX = 3;
+
+static nrd::CommonSettings GetCommonSettings(uint32_t frameIndex, nrd::AccumulationMode accumulationMode)
+{
+    nrd::CommonSettings commonSettings = {};
+    commonSettings.resourceSize[0] = commonSettings.resourceSizePrev[0] = commonSettings.rectSize[0] = commonSettings.rectSizePrev[0] = WIDTH;
+    commonSettings.resourceSize[1] = commonSettings.resourceSizePrev[1] = commonSettings.rectSize[1] = commonSettings.rectSizePrev[1] = HEIGHT;
+    commonSettings.timeDeltaBetweenFrames = 16.6f; // not measured, i.e. deterministic constants
+    commonSettings.frameIndex = frameIndex;
+    commonSettings.accumulationMode = accumulationMode;
+
+    return commonSettings;
+}
+
+static bool IsSupported(nrd::Denoiser denoiser)
+{
+    const nrd::LibraryDesc& libraryDesc = nrd::GetLibraryDesc();
+    for (uint32_t i = 0; i < libraryDesc.supportedDenoisersNum; i++)
+    {
+        if (libraryDesc.supportedDenoisers[i] == denoiser)
+            return true;
+    }
+
+    return false;
+}
+
+static bool IsSupported(const nrd::DenoiserDesc* denoiserDescs, uint32_t denoiserDescsNum, const char* testName)
+{
+    for (uint32_t i = 0; i < denoiserDescsNum; i++)
+    {
+        if (!IsSupported(denoiserDescs[i].denoiser))
+        {
+            printf("%s: skipped, '%s' is excluded by 'NRD_DENOISERS'\n", testName, nrd::GetDenoiserString(denoiserDescs[i].denoiser));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// "NRD_DENOISERS": exactly the requested denoisers are compiled in, excluded ones can't be created
+static void TestDenoiserSubset()
+{
+    const std::string expected = "," + std::string(NRD_TEST_DENOISERS) + ",";
+    const bool isAll = expected == ",ALL,";
+
+    uint32_t expectedNum = 0;
+    for (uint32_t i = 0; i < (uint32_t)nrd::Denoiser::MAX_NUM; i++)
+    {
+        nrd::Denoiser denoiser = (nrd::Denoiser)i;
+        const char* name = nrd::GetDenoiserString(denoiser);
+
+        bool isExpected = isAll || expected.find("," + std::string(name) + ",") != std::string::npos;
+        NRD_TEST_CHECK(IsSupported(denoiser) == isExpected);
+        expectedNum += isExpected ? 1 : 0;
+
+        const nrd::DenoiserDesc denoiserDesc = {REBLUR, denoiser, 0};
+
+        nrd::InstanceCreationDesc instanceCreationDesc = {};
+        instanceCreationDesc.denoisers = &denoiserDesc;
+        instanceCreationDesc.denoisersNum = 1;
+
+        nrd::Instance* instance = nullptr;
+        nrd::Result result = nrd::CreateInstance(instanceCreationDesc, instance);
+        NRD_TEST_CHECK(result == (isExpected ? nrd::Result::SUCCESS : nrd::Result::UNSUPPORTED));
+        NRD_TEST_CHECK((instance != nullptr) == isExpected);
+
+        if (instance)
+            nrd::DestroyInstance(*instance);
+    }
+
+    NRD_TEST_CHECK(nrd::GetLibraryDesc().supportedDenoisersNum == expectedNum);
+}
+
+static nrd::DispatchStats GetExpectedStats(const nrd::DispatchDesc* dispatchDescs, uint32_t dispatchDescsNum)
+{
+    nrd::DispatchStats dispatchStats = {};
+    for (uint32_t i = 0; i < dispatchDescsNum; i++)
+    {
+        const nrd::DispatchDesc& dispatchDesc = dispatchDescs[i];
+
+        dispatchStats.dispatchNum++;
+        dispatchStats.threadGroupNum += uint64_t(dispatchDesc.gridWidth) * dispatchDesc.gridHeight;
+
+        if (dispatchDesc.constantBufferDataMatchesPreviousDispatch)
+            dispatchStats.constantBufferBytesSkipped += dispatchDesc.constantBufferDataSize;
+        else
+            dispatchStats.constantBufferBytesWritten += dispatchDesc.constantBufferDataSize;
+    }
+
+    return dispatchStats;
+}
+
+static bool IsEqual(const nrd::DispatchStats& a, const nrd::DispatchStats& b)
+{
+    return a.dispatchNum == b.dispatchNum && a.clearDispatchNum == b.clearDispatchNum && a.threadGroupNum == b.threadGroupNum
+        && a.constantBufferBytesWritten == b.constantBufferBytesWritten && a.constantBufferBytesSkipped == b.constantBufferBytesSkipped;
+}
+
+static void TestDispatchStats()
+{
+    const nrd::DenoiserDesc denoiserDescs[] =
+    {
+        {REBLUR, nrd::Denoiser::REBLUR_DIFFUSE_SPECULAR, 0},
+        {SIGMA, nrd::Denoiser::SIGMA_SHADOW, 0},
+    };
+
+    if (!IsSupported(denoiserDescs, 2, "TestDispatchStats"))
+        return;
+
+    nrd::InstanceCreationDesc instanceCreationDesc = {};
+    instanceCreationDesc.denoisers = denoiserDescs;
+    instanceCreationDesc.denoisersNum = 2;
+
+    nrd::Instance* instance = nullptr;
+    NRD_TEST_CHECK(nrd::CreateInstance(instanceCreationDesc, instance) == nrd::Result::SUCCESS);
+    if (!instance)
+        return;
+
+    // Synthetic dispatches: exact totals, "constantBufferDataMatchesPreviousDispatch" moves bytes from "written" to "skipped"
+    {
+        nrd::DispatchDesc dispatchDescs[3] = {};
+        dispatchDescs[0].gridWidth = 10;
+        dispatchDescs[0].gridHeight = 20;
+        dispatchDescs[0].constantBufferDataSize = 256;
+        dispatchDescs[0].pipelineIndex = 0xFFFF;
+
+        dispatchDescs[1] = dispatchDescs[0];
+        dispatchDescs[1].constantBufferDataMatchesPreviousDispatch = true;
+
+        dispatchDescs[2] = dispatchDescs[0];
+        dispatchDescs[2].gridWidth = 65535;
+        dispatchDescs[2].gridHeight = 65535; // 64-bit "threadGroupNum"
+        dispatchDescs[2].constantBufferDataSize = 64;
+
+        nrd::DispatchStats dispatchStats = {};
+        NRD_TEST_CHECK(nrd::GetDispatchStats(*instance, dispatchDescs, 3, dispatchStats) == nrd::Result::SUCCESS);
+        NRD_TEST_CHECK(dispatchStats.dispatchNum == 3);
+        NRD_TEST_CHECK(dispatchStats.clearDispatchNum == 0);
+        NRD_TEST_CHECK(dispatchStats.threadGroupNum == 2 * 200 + 65535ull * 65535ull);
+        NRD_TEST_CHECK(dispatchStats.constantBufferBytesWritten == 256 + 64);
+        NRD_TEST_CHECK(dispatchStats.constantBufferBytesSkipped == 256);
+
+        NRD_TEST_CHECK(nrd::GetDispatchStats(*instance, nullptr, 0, dispatchStats) == nrd::Result::SUCCESS);
+        NRD_TEST_CHECK(IsEqual(dispatchStats, nrd::DispatchStats{}));
+
+        NRD_TEST_CHECK(nrd::GetDispatchStats(*instance, nullptr, 1, dispatchStats) == nrd::Result::INVALID_ARGUMENT);
+    }
+
+    // Real dispatches: the first frame restarts accumulation (clears are injected), the next one continues
+    const nrd::Identifier identifiers[] = {REBLUR, SIGMA};
+
+    for (uint32_t frameIndex = 0; frameIndex < 3; frameIndex++)
+    {
+        nrd::AccumulationMode accumulationMode = frameIndex ? nrd::AccumulationMode::CONTINUE : nrd::AccumulationMode::CLEAR_AND_RESTART;
+        nrd::CommonSettings commonSettings = GetCommonSettings(frameIndex, accumulationMode);
+        NRD_TEST_CHECK(nrd::SetCommonSettings(*instance, commonSettings) == nrd::Result::SUCCESS);
+
+        const nrd::DispatchDesc* dispatchDescs = nullptr;
+        uint32_t dispatchDescsNum = 0;
+        NRD_TEST_CHECK(nrd::GetComputeDispatches(*instance, identifiers, 2, dispatchDescs, dispatchDescsNum) == nrd::Result::SUCCESS);
+        NRD_TEST_CHECK(dispatchDescsNum != 0);
+        if (!dispatchDescsNum)
+            break;
+
+        // "constantBufferDataMatchesPreviousDispatch" must be truthful
+        NRD_TEST_CHECK(!dispatchDescs[0].constantBufferDataMatchesPreviousDispatch);
+
+        for (uint32_t i = 1; i < dispatchDescsNum; i++)
+        {
+            const nrd::DispatchDesc& dispatchDescPrev = dispatchDescs[i - 1];
+            const nrd::DispatchDesc& dispatchDesc = dispatchDescs[i];
+            if (dispatchDesc.constantBufferDataMatchesPreviousDispatch)
+            {
+                NRD_TEST_CHECK(dispatchDesc.constantBufferDataSize == dispatchDescPrev.constantBufferDataSize);
+                NRD_TEST_CHECK(!memcmp(dispatchDesc.constantBufferData, dispatchDescPrev.constantBufferData, dispatchDesc.constantBufferDataSize));
+            }
+        }
+
+        // Totals
+        nrd::DispatchStats dispatchStats = {};
+        NRD_TEST_CHECK(nrd::GetDispatchStats(*instance, dispatchDescs, dispatchDescsNum, dispatchStats) == nrd::Result::SUCCESS);
+
+        nrd::DispatchStats expectedStats = GetExpectedStats(dispatchDescs, dispatchDescsNum);
+        NRD_TEST_CHECK(dispatchStats.dispatchNum == expectedStats.dispatchNum);
+        NRD_TEST_CHECK(dispatchStats.threadGroupNum == expectedStats.threadGroupNum);
+        NRD_TEST_CHECK(dispatchStats.constantBufferBytesWritten == expectedStats.constantBufferBytesWritten);
+        NRD_TEST_CHECK(dispatchStats.constantBufferBytesSkipped == expectedStats.constantBufferBytesSkipped);
+
+        if (frameIndex == 0)
+            NRD_TEST_CHECK(dispatchStats.clearDispatchNum != 0 && dispatchStats.clearDispatchNum < dispatchStats.dispatchNum);
+        else
+            NRD_TEST_CHECK(dispatchStats.clearDispatchNum == 0);
+
+        // Stateless: stats of a split list add up
+        uint32_t half = dispatchDescsNum / 2;
+
+        nrd::DispatchStats dispatchStats0 = {};
+        nrd::DispatchStats dispatchStats1 = {};
+        NRD_TEST_CHECK(nrd::GetDispatchStats(*instance, dispatchDescs, half, dispatchStats0) == nrd::Result::SUCCESS);
+        NRD_TEST_CHECK(nrd::GetDispatchStats(*instance, dispatchDescs + half, dispatchDescsNum - half, dispatchStats1) == nrd::Result::SUCCESS);
+
+        nrd::DispatchStats sum = dispatchStats0;
+        sum.dispatchNum += dispatchStats1.dispatchNum;
+        sum.clearDispatchNum += dispatchStats1.clearDispatchNum;
+        sum.threadGroupNum += dispatchStats1.threadGroupNum;
+        sum.constantBufferBytesWritten += dispatchStats1.constantBufferBytesWritten;
+        sum.constantBufferBytesSkipped += dispatchStats1.constantBufferBytesSkipped;
+        NRD_TEST_CHECK(IsEqual(sum, dispatchStats));
+    }
+
+    nrd::DestroyInstance(*instance);
+}
+
+static nrd::Instance* CreateInstance(const nrd::DenoiserDesc* denoiserDescs, uint32_t denoiserDescsNum)
+{
+    nrd::InstanceCreationDesc instanceCreationDesc = {};
+    instanceCreationDesc.denoisers = denoiserDescs;
+    instanceCreationDesc.denoisersNum = denoiserDescsNum;
+
+    nrd::Instance* instance = nullptr;
+    NRD_TEST_CHECK(nrd::CreateInstance(instanceCreationDesc, instance) == nrd::Result::SUCCESS);
+
+    return instance;
+}
+
+static bool GetDispatches(nrd::Instance& instance, nrd::Identifier identifier, const nrd::DispatchDesc*& dispatchDescs, uint32_t& dispatchDescsNum)
+{
+    return nrd::GetComputeDispatches(instance, &identifier, 1, dispatchDescs, dispatchDescsNum) == nrd::Result::SUCCESS && dispatchDescsNum != 0;
+}
+
+// "GetComputeDispatchesToMemory": the same dispatches and constants as the instance-owned output, the output is only written,
+// "constantBufferData = NULL" for dispatches, which constants don't fit
+static void TestDispatchesToMemory()
+{
+    constexpr uint32_t ALIGNMENT = 256;
+    constexpr uint8_t GARBAGE = 0xCD;
+
+    struct alignas(16) ConstantBlock
+    {
+        uint8_t data[16];
+    };
+
+    const nrd::DenoiserDesc denoiserDescs[] =
+    {
+        {REBLUR, nrd::Denoiser::REBLUR_DIFFUSE_SPECULAR, 0},
+        {SIGMA, nrd::Denoiser::SIGMA_SHADOW, 0},
+    };
+
+    if (!IsSupported(denoiserDescs, 2, "TestDispatchesToMemory"))
+        return;
+
+    nrd::Instance* instance = CreateInstance(denoiserDescs, 2);
+    if (!instance)
+        return;
+
+    const nrd::Identifier identifiers[] = {REBLUR, SIGMA};
+
+    uint32_t matchNum = 0;
+    for (uint32_t frameIndex = 0; frameIndex < 3; frameIndex++)
+    {
+        nrd::AccumulationMode accumulationMode = frameIndex ? nrd::AccumulationMode::CONTINUE : nrd::AccumulationMode::CLEAR_AND_RESTART;
+        nrd::CommonSettings commonSettings = GetCommonSettings(frameIndex, accumulationMode);
+        NRD_TEST_CHECK(nrd::SetCommonSettings(*instance, commonSettings) == nrd::Result::SUCCESS);
+
+        // Reference: the instance-owned output (repeated calls within a frame produce the same dispatches)
+        const nrd::DispatchDesc* referenceDescs = nullptr;
+        uint32_t referenceDescsNum = 0;
+        NRD_TEST_CHECK(nrd::GetComputeDispatches(*instance, identifiers, 2, referenceDescs, referenceDescsNum) == nrd::Result::SUCCESS);
+
+        std::vector<nrd::DispatchDesc> expectedDescs(referenceDescs, referenceDescs + referenceDescsNum);
+        std::vector<std::vector<uint8_t>> expectedConstants;
+        for (const nrd::DispatchDesc& dispatchDesc : expectedDescs)
+            expectedConstants.emplace_back(dispatchDesc.constantBufferData, dispatchDesc.constantBufferData + dispatchDesc.constantBufferDataSize);
+
+        // Size query
+        uint32_t dispatchDescsNum = 0;
+        uint32_t constantDataSize = 0;
+        NRD_TEST_CHECK(nrd::GetComputeDispatchesToMemory(*instance, identifiers, 2, nullptr, dispatchDescsNum, nullptr, constantDataSize, ALIGNMENT) == nrd::Result::SUCCESS);
+        NRD_TEST_CHECK(dispatchDescsNum == referenceDescsNum && constantDataSize != 0);
+        if (dispatchDescsNum != referenceDescsNum || !constantDataSize)
+            break;
+
+        // Garbage in the output doesn't matter
+        std::vector<ConstantBlock> constantStorage(constantDataSize / sizeof(ConstantBlock) + 1);
+        uint8_t* constantData = constantStorage.data()->data;
+        memset(constantData, GARBAGE, constantStorage.size() * sizeof(ConstantBlock));
+
+        std::vector<nrd::DispatchDesc> dispatchDescs(dispatchDescsNum);
+        NRD_TEST_CHECK(nrd::GetComputeDispatchesToMemory(*instance, identifiers, 2, dispatchDescs.data(), dispatchDescsNum, constantData, constantDataSize, ALIGNMENT) == nrd::Result::SUCCESS);
+
+        for (uint32_t i = 0; i < dispatchDescsNum; i++)
+        {
+            const nrd::DispatchDesc& dispatchDesc = dispatchDescs[i];
+            const nrd::DispatchDesc& expectedDesc = expectedDescs[i];
+
+            NRD_TEST_CHECK(dispatchDesc.pipelineIndex == expectedDesc.pipelineIndex);
+            NRD_TEST_CHECK(dispatchDesc.gridWidth == expectedDesc.gridWidth && dispatchDesc.gridHeight == expectedDesc.gridHeight);
+            NRD_TEST_CHECK(dispatchDesc.constantBufferDataSize == expectedDesc.constantBufferDataSize);
+            NRD_TEST_CHECK(dispatchDesc.constantBufferDataMatchesPreviousDispatch == expectedDesc.constantBufferDataMatchesPreviousDispatch);
+
+            uint32_t size = dispatchDesc.constantBufferDataSize;
+            if (!size)
+                continue;
+
+            NRD_TEST_CHECK(dispatchDesc.constantBufferData != nullptr);
+            if (!dispatchDesc.constantBufferData)
+                continue;
+
+            NRD_TEST_CHECK((dispatchDesc.constantBufferData - constantData) % ALIGNMENT == 0);
+            NRD_TEST_CHECK(dispatchDesc.constantBufferData + size <= constantData + constantDataSize);
+            NRD_TEST_CHECK(!memcmp(dispatchDesc.constantBufferData, expectedConstants[i].data(), size));
+
+            // "constantBufferDataMatchesPreviousDispatch" is set if and only if constants match
+            if (i)
+            {
+                const nrd::DispatchDesc& dispatchDescPrev = dispatchDescs[i - 1];
+                bool isSameAsPrev = dispatchDescPrev.constantBufferDataSize == size && !memcmp(dispatchDescPrev.constantBufferData, dispatchDesc.constantBufferData, size);
+                NRD_TEST_CHECK(dispatchDesc.constantBufferDataMatchesPreviousDispatch == isSameAsPrev);
+            }
+
+            matchNum += dispatchDesc.constantBufferDataMatchesPreviousDispatch ? 1 : 0;
+        }
+
+        // Constants don't fit: everything fitting is valid, the rest is NULL, nothing is written past the capacity
+        uint32_t capacity = constantDataSize / 2;
+        uint32_t requiredSize = capacity;
+        dispatchDescsNum = (uint32_t)dispatchDescs.size();
+        memset(constantData, GARBAGE, constantStorage.size() * sizeof(ConstantBlock));
+
+        NRD_TEST_CHECK(nrd::GetComputeDispatchesToMemory(*instance, identifiers, 2, dispatchDescs.data(), dispatchDescsNum, constantData, requiredSize, ALIGNMENT) == nrd::Result::INSUFFICIENT_MEMORY);
+        NRD_TEST_CHECK(requiredSize == constantDataSize && dispatchDescsNum == expectedDescs.size());
+
+        uint32_t nullNum = 0;
+        for (uint32_t i = 0; i < dispatchDescsNum; i++)
+        {
+            const nrd::DispatchDesc& dispatchDesc = dispatchDescs[i];
+            if (!dispatchDesc.constantBufferDataSize)
+                continue;
+
+            if (dispatchDesc.constantBufferData)
+            {
+                NRD_TEST_CHECK(dispatchDesc.constantBufferData + dispatchDesc.constantBufferDataSize <= constantData + capacity);
+                NRD_TEST_CHECK(!memcmp(dispatchDesc.constantBufferData, expectedConstants[i].data(), dispatchDesc.constantBufferDataSize));
+            }
+            else
+                nullNum++;
+        }
+
+        NRD_TEST_CHECK(nullNum != 0);
+
+        bool isUntouched = true;
+        for (uint32_t i = capacity; i < constantStorage.size() * sizeof(ConstantBlock); i++)
+            isUntouched &= constantData[i] == GARBAGE;
+
+        NRD_TEST_CHECK(isUntouched);
+    }
+
+    NRD_TEST_CHECK(matchNum != 0); // shared constants are expected to repeat across passes
+
+    nrd::DestroyInstance(*instance);
+}
+
+// "instance" must produce the same work as "source" would (same shaders, constants and textures, permanent textures are remapped)
+static void CheckSameDispatches(nrd::Instance& instance, nrd::Instance& source, nrd::Identifier identifier, const std::vector<uint16_t>& permanentPoolRemap)
+{
+    const nrd::InstanceDesc& instanceDesc = nrd::GetInstanceDesc(instance);
+    const nrd::InstanceDesc& sourceInstanceDesc = nrd::GetInstanceDesc(source);
+
+    const nrd::DispatchDesc* dispatchDescs = nullptr;
+    uint32_t dispatchDescsNum = 0;
+    NRD_TEST_CHECK(GetDispatches(instance, identifier, dispatchDescs, dispatchDescsNum));
+
+    const nrd::DispatchDesc* sourceDispatchDescs = nullptr;
+    uint32_t sourceDispatchDescsNum = 0;
+    NRD_TEST_CHECK(GetDispatches(source, identifier, sourceDispatchDescs, sourceDispatchDescsNum));
+
+    NRD_TEST_CHECK(dispatchDescsNum == sourceDispatchDescsNum);
+    if (dispatchDescsNum != sourceDispatchDescsNum)
+        return;
+
+    for (uint32_t i = 0; i < dispatchDescsNum; i++)
+    {
+        const nrd::DispatchDesc& dispatchDesc = dispatchDescs[i];
+        const nrd::DispatchDesc& sourceDispatchDesc = sourceDispatchDescs[i];
+
+        const char* shaderFileName = instanceDesc.pipelines[dispatchDesc.pipelineIndex].shaderFileName;
+        const char* sourceShaderFileName = sourceInstanceDesc.pipelines[sourceDispatchDesc.pipelineIndex].shaderFileName;
+        NRD_TEST_CHECK(!strcmp(shaderFileName, sourceShaderFileName));
+
+        NRD_TEST_CHECK(dispatchDesc.gridWidth == sourceDispatchDesc.gridWidth && dispatchDesc.gridHeight == sourceDispatchDesc.gridHeight);
+        NRD_TEST_CHECK(dispatchDesc.constantBufferDataSize == sourceDispatchDesc.constantBufferDataSize);
+        NRD_TEST_CHECK(dispatchDesc.constantBufferDataSize == sourceDispatchDesc.constantBufferDataSize
+            && !memcmp(dispatchDesc.constantBufferData, sourceDispatchDesc.constantBufferData, dispatchDesc.constantBufferDataSize));
+        NRD_TEST_CHECK(dispatchDesc.rootConstantDataSize == sourceDispatchDesc.rootConstantDataSize
+            && !memcmp(dispatchDesc.rootConstantData, sourceDispatchDesc.rootConstantData, sizeof(dispatchDesc.rootConstantData)));
+
+        NRD_TEST_CHECK(dispatchDesc.resourcesNum == sourceDispatchDesc.resourcesNum);
+        if (dispatchDesc.resourcesNum != sourceDispatchDesc.resourcesNum)
+            continue;
+
+        for (uint32_t j = 0; j < dispatchDesc.resourcesNum; j++)
+        {
+            const nrd::ResourceDesc& resource = dispatchDesc.resources[j];
+            const nrd::ResourceDesc& sourceResource = sourceDispatchDesc.resources[j];
+
+            NRD_TEST_CHECK(resource.descriptorType == sourceResource.descriptorType && resource.type == sourceResource.type);
+
+            if (resource.type == nrd::ResourceType::PERMANENT_POOL) // the history
+                NRD_TEST_CHECK(permanentPoolRemap[resource.indexInPool] == sourceResource.indexInPool);
+            else if (resource.type != nrd::ResourceType::TRANSIENT_POOL) // the transient pool is not preserved
+                NRD_TEST_CHECK(resource.indexInPool == sourceResource.indexInPool);
+        }
+    }
+}
+
+static uint32_t GetClearDispatchNum(nrd::Instance& instance, nrd::Identifier identifier)
+{
+    const nrd::DispatchDesc* dispatchDescs = nullptr;
+    uint32_t dispatchDescsNum = 0;
+    NRD_TEST_CHECK(GetDispatches(instance, identifier, dispatchDescs, dispatchDescsNum));
+
+    nrd::DispatchStats dispatchStats = {};
+    NRD_TEST_CHECK(nrd::GetDispatchStats(instance, dispatchDescs, dispatchDescsNum, dispatchStats) == nrd::Result::SUCCESS);
+
+    return dispatchStats.clearDispatchNum;
+}
+
+// "InheritHistory": kept denoisers reuse "source" history textures and continue exactly as "source" would, new denoisers restart alone
+static void TestInheritHistory()
+{
+    constexpr uint32_t FRAME_NUM = 5;
+
+    const nrd::DenoiserDesc sourceDenoiserDescs[] =
+    {
+        {REBLUR, nrd::Denoiser::REBLUR_DIFFUSE_SPECULAR, 0},
+        {SIGMA, nrd::Denoiser::SIGMA_SHADOW, 0},
+    };
+
+    // REBLUR is kept (placed after a new denoiser, i.e. at different offsets in the pool), SIGMA is removed, RELAX is added
+    const nrd::DenoiserDesc denoiserDescs[] =
+    {
+        {RELAX, nrd::Denoiser::RELAX_DIFFUSE, 0},
+        {REBLUR, nrd::Denoiser::REBLUR_DIFFUSE_SPECULAR, 0},
+    };
+
+    if (!IsSupported(sourceDenoiserDescs, 2, "TestInheritHistory") || !IsSupported(denoiserDescs, 2, "TestInheritHistory"))
+        return;
+
+    nrd::Instance* source = CreateInstance(sourceDenoiserDescs, 2);
+    nrd::Instance* instance = CreateInstance(denoiserDescs, 2);
+    if (!source || !instance)
+        return;
+
+    nrd::ReblurSettings reblurSettings = {};
+    reblurSettings.maxAccumulatedFrameNum = 17; // not default, must be inherited
+    NRD_TEST_CHECK(nrd::SetDenoiserSettings(*source, REBLUR, &reblurSettings) == nrd::Result::SUCCESS);
+
+    for (uint32_t frameIndex = 0; frameIndex < FRAME_NUM; frameIndex++)
+    {
+        nrd::AccumulationMode accumulationMode = frameIndex ? nrd::AccumulationMode::CONTINUE : nrd::AccumulationMode::CLEAR_AND_RESTART;
+        NRD_TEST_CHECK(nrd::SetCommonSettings(*source, GetCommonSettings(frameIndex, accumulationMode)) == nrd::Result::SUCCESS);
+
+        const nrd::Identifier identifiers[] = {REBLUR, SIGMA};
+        const nrd::DispatchDesc* dispatchDescs = nullptr;
+        uint32_t dispatchDescsNum = 0;
+        NRD_TEST_CHECK(nrd::GetComputeDispatches(*source, identifiers, 2, dispatchDescs, dispatchDescsNum) == nrd::Result::SUCCESS);
+    }
+
+    // Remap: REBLUR slots point to the same textures of "source", RELAX slots are new
+    const nrd::InstanceDesc& instanceDesc = nrd::GetInstanceDesc(*instance);
+    const nrd::InstanceDesc& sourceInstanceDesc = nrd::GetInstanceDesc(*source);
+
+    std::vector<uint16_t> permanentPoolRemap(instanceDesc.permanentPoolSize, 0x1234);
+    NRD_TEST_CHECK(nrd::InheritHistory(*instance, *source, permanentPoolRemap.data()) == nrd::Result::SUCCESS);
+
+    std::vector<bool> isSourceTextureUsed(sourceInstanceDesc.permanentPoolSize, false);
+    uint32_t newTextureNum = 0;
+    for (uint32_t i = 0; i < instanceDesc.permanentPoolSize; i++)
+    {
+        uint16_t j = permanentPoolRemap[i];
+        if (j == 0xFFFF)
+        {
+            NRD_TEST_CHECK(!strncmp(instanceDesc.permanentPool[i].name, "RELAX", 5));
+            newTextureNum++;
+            continue;
+        }
+
+        NRD_TEST_CHECK(j < sourceInstanceDesc.permanentPoolSize);
+        if (j >= sourceInstanceDesc.permanentPoolSize)
+            continue;
+
+        NRD_TEST_CHECK(!isSourceTextureUsed[j]);
+        isSourceTextureUsed[j] = true;
+
+        const nrd::TextureDesc& textureDesc = instanceDesc.permanentPool[i];
+        const nrd::TextureDesc& sourceTextureDesc = sourceInstanceDesc.permanentPool[j];
+        NRD_TEST_CHECK(textureDesc.format == sourceTextureDesc.format && textureDesc.downsampleFactor == sourceTextureDesc.downsampleFactor);
+        NRD_TEST_CHECK(!strcmp(textureDesc.name, sourceTextureDesc.name));
+        NRD_TEST_CHECK(!strncmp(textureDesc.name, "REBLUR", 6));
+    }
+
+    NRD_TEST_CHECK(newTextureNum != 0 && newTextureNum < instanceDesc.permanentPoolSize);
+
+    // The next frame: the viewport state is inherited too, i.e. "frameIndex" continues
+    nrd::CommonSettings commonSettings = GetCommonSettings(FRAME_NUM, nrd::AccumulationMode::CONTINUE);
+    NRD_TEST_CHECK(nrd::SetCommonSettings(*source, commonSettings) == nrd::Result::SUCCESS);
+    NRD_TEST_CHECK(nrd::SetCommonSettings(*instance, commonSettings) == nrd::Result::SUCCESS);
+
+    CheckSameDispatches(*instance, *source, REBLUR, permanentPoolRemap);
+    NRD_TEST_CHECK(GetClearDispatchNum(*instance, REBLUR) == 0);
+    NRD_TEST_CHECK(GetClearDispatchNum(*instance, RELAX) != 0);
+
+    // The frame after: RELAX doesn't restart again
+    commonSettings = GetCommonSettings(FRAME_NUM + 1, nrd::AccumulationMode::CONTINUE);
+    NRD_TEST_CHECK(nrd::SetCommonSettings(*source, commonSettings) == nrd::Result::SUCCESS);
+    NRD_TEST_CHECK(nrd::SetCommonSettings(*instance, commonSettings) == nrd::Result::SUCCESS);
+
+    CheckSameDispatches(*instance, *source, REBLUR, permanentPoolRemap);
+    NRD_TEST_CHECK(GetClearDispatchNum(*instance, RELAX) == 0);
+
+    NRD_TEST_CHECK(nrd::InheritHistory(*instance, *instance, nullptr) == nrd::Result::INVALID_ARGUMENT);
+
+    nrd::DestroyInstance(*instance);
+    nrd::DestroyInstance(*source);
+}
+
+// "SamplingHint.resources.hlsli"
+struct SamplingHintConstants
+{
+    uint32_t gRectOrigin[2];
+    uint32_t gRectSize[2];
+    float gMaxAccumulatedFrameNum[2];
+    float gHistoryLengthScale;
+    float gDenoisingRange;
+    float gViewZScale;
+    float gDebug;
+};
+
+struct SamplingHintRootConstants
+{
+    uint32_t gHasDiffuse;
+    uint32_t gHasSpecular;
+    uint32_t gIsReblur;
+};
+
+// A pixel of a synthetic history: "historyLength" is normalized (as stored by the denoiser), luminance of noisy and denoised radiance
+struct SamplingHintPixel
+{
+    float viewZ;
+    float historyLength[2]; // diffuse, specular
+    float noisy[2];
+    float denoised[2];
+};
+
+// Reference for "SamplingHint.cs.hlsl" (a tile of up to 16x16 pixels)
+static float GetReferenceBudget(float noisy, float denoised, float frames, float maxAccumulatedFrameNum)
+{
+    float noise = std::min(std::abs(noisy - denoised) / std::max(denoised, 1e-6f), 4.0f);
+    float lag = 1.0f - std::min(std::max(frames / std::max(maxAccumulatedFrameNum, 1.0f), 0.0f), 1.0f);
+
+    return std::min(std::max(lag, noise / std::sqrt(1.0f + frames)), 1.0f);
+}
+
+static float GetReferenceHint(const SamplingHintConstants& consts, const SamplingHintRootConstants& rootConstants, const std::vector<SamplingHintPixel>& tile)
+{
+    uint32_t sum = 0;
+    uint32_t num = 0;
+
+    for (const SamplingHintPixel& pixel : tile)
+    {
+        if (pixel.viewZ > consts.gDenoisingRange)
+            continue;
+
+        float diffFrames = pixel.historyLength[0] * consts.gHistoryLengthScale;
+        float specFrames = (rootConstants.gIsReblur && rootConstants.gHasDiffuse) ? pixel.historyLength[1] * consts.gHistoryLengthScale : diffFrames;
+
+        float budget = 0.0f;
+        if (rootConstants.gHasDiffuse)
+            budget = GetReferenceBudget(pixel.noisy[0], pixel.denoised[0], diffFrames, consts.gMaxAccumulatedFrameNum[0]);
+        if (rootConstants.gHasSpecular)
+            budget = std::max(budget, GetReferenceBudget(pixel.noisy[1], pixel.denoised[1], specFrames, consts.gMaxAccumulatedFrameNum[1]));
+
+        sum += uint32_t(budget * 255.0f + 0.5f);
+        num++;
+    }
+
+    return num ? float(sum) / (255.0f * float(num)) : 0.0f;
+}
+
+struct SamplingHintDispatch
+{
+    nrd::DispatchDesc dispatchDesc; // pointers are not valid after the next "GetComputeDispatches" call
+    std::vector<nrd::ResourceDesc> resources;
+    SamplingHintConstants consts;
+    SamplingHintRootConstants rootConstants;
+    bool isLast;
+};
+
+static bool FindSamplingHintDispatch(nrd::Instance& instance, nrd::Identifier identifier, SamplingHintDispatch& samplingHintDispatch)
+{
+    const nrd::InstanceDesc& instanceDesc = nrd::GetInstanceDesc(instance);
+
+    const nrd::DispatchDesc* dispatchDescs = nullptr;
+    uint32_t dispatchDescsNum = 0;
+    NRD_TEST_CHECK(GetDispatches(instance, identifier, dispatchDescs, dispatchDescsNum));
+
+    uint32_t samplingHintDispatchNum = 0;
+    for (uint32_t i = 0; i < dispatchDescsNum; i++)
+    {
+        const nrd::DispatchDesc& dispatchDesc = dispatchDescs[i];
+
+        // The hint is written only by its own pass
+        bool isSamplingHint = strstr(instanceDesc.pipelines[dispatchDesc.pipelineIndex].shaderFileName, "SamplingHint") != nullptr;
+        for (uint32_t j = 0; j < dispatchDesc.resourcesNum; j++)
+        {
+            const nrd::ResourceDesc& resource = dispatchDesc.resources[j];
+            if (resource.descriptorType == nrd::DescriptorType::STORAGE_TEXTURE)
+                NRD_TEST_CHECK(isSamplingHint == (resource.type == nrd::ResourceType::OUT_SAMPLING_HINT));
+        }
+
+        if (!isSamplingHint)
+            continue;
+
+        NRD_TEST_CHECK(dispatchDesc.constantBufferDataSize >= sizeof(SamplingHintConstants));
+        NRD_TEST_CHECK(dispatchDesc.rootConstantDataSize == sizeof(SamplingHintRootConstants));
+        if (dispatchDesc.constantBufferDataSize < sizeof(SamplingHintConstants) || dispatchDesc.rootConstantDataSize != sizeof(SamplingHintRootConstants))
+            return false;
+
+        samplingHintDispatch.dispatchDesc = dispatchDesc;
+        samplingHintDispatch.resources.assign(dispatchDesc.resources, dispatchDesc.resources + dispatchDesc.resourcesNum);
+        memcpy(&samplingHintDispatch.consts, dispatchDesc.constantBufferData, sizeof(SamplingHintConstants));
+        memcpy(&samplingHintDispatch.rootConstants, dispatchDesc.rootConstantData, sizeof(SamplingHintRootConstants));
+        samplingHintDispatch.isLast = i == dispatchDescsNum - 1;
+        samplingHintDispatchNum++;
+    }
+
+    NRD_TEST_CHECK(samplingHintDispatchNum <= 1);
+
+    return samplingHintDispatchNum != 0;
+}
+
+// "OUT_SAMPLING_HINT": the dispatch, its constants and the hint they produce for synthetic histories
+static void TestSamplingHint()
+{
+    const nrd::DenoiserDesc denoiserDescs[] =
+    {
+        {REBLUR, nrd::Denoiser::REBLUR_DIFFUSE_SPECULAR, 0},
+        {SIGMA, nrd::Denoiser::SIGMA_SHADOW, 0},
+        {RELAX, nrd::Denoiser::RELAX_DIFFUSE, 0},
+    };
+
+    if (!IsSupported(denoiserDescs, 3, "TestSamplingHint"))
+        return;
+
+    nrd::Instance* instance = CreateInstance(denoiserDescs, 3);
+    if (!instance)
+        return;
+
+    // More than the history can hold, i.e. clamped
+    nrd::ReblurSettings reblurSettings = {};
+    reblurSettings.maxAccumulatedFrameNum = nrd::REBLUR_MAX_HISTORY_FRAME_NUM + 10;
+    NRD_TEST_CHECK(nrd::SetDenoiserSettings(*instance, REBLUR, &reblurSettings) == nrd::Result::SUCCESS);
+
+    nrd::RelaxSettings relaxSettings = {};
+    relaxSettings.diffuseMaxAccumulatedFrameNum = 40;
+    NRD_TEST_CHECK(nrd::SetDenoiserSettings(*instance, RELAX, &relaxSettings) == nrd::Result::SUCCESS);
+
+    for (uint32_t frameIndex = 0; frameIndex < 2; frameIndex++)
+    {
+        nrd::AccumulationMode accumulationMode = frameIndex ? nrd::AccumulationMode::CONTINUE : nrd::AccumulationMode::CLEAR_AND_RESTART;
+        nrd::CommonSettings commonSettings = GetCommonSettings(frameIndex, accumulationMode);
+        commonSettings.enableSamplingHint = frameIndex != 0;
+        commonSettings.denoisingRange = 1000.0f;
+        NRD_TEST_CHECK(nrd::SetCommonSettings(*instance, commonSettings) == nrd::Result::SUCCESS);
+
+        SamplingHintDispatch reblur = {};
+        SamplingHintDispatch relax = {};
+        SamplingHintDispatch sigma = {};
+        NRD_TEST_CHECK(FindSamplingHintDispatch(*instance, REBLUR, reblur) == commonSettings.enableSamplingHint);
+        NRD_TEST_CHECK(FindSamplingHintDispatch(*instance, RELAX, relax) == commonSettings.enableSamplingHint);
+        NRD_TEST_CHECK(!FindSamplingHintDispatch(*instance, SIGMA, sigma));
+
+        if (!commonSettings.enableSamplingHint)
+            continue;
+
+        // The last pass (outputs are ready), one thread group per 16x16 tile
+        for (const SamplingHintDispatch* samplingHintDispatch : {&reblur, &relax})
+        {
+            NRD_TEST_CHECK(samplingHintDispatch->isLast);
+            NRD_TEST_CHECK(samplingHintDispatch->dispatchDesc.gridWidth == (WIDTH + 15) / 16 && samplingHintDispatch->dispatchDesc.gridHeight == (HEIGHT + 15) / 16);
+            NRD_TEST_CHECK(samplingHintDispatch->resources.size() == 7 && samplingHintDispatch->resources[0].type == nrd::ResourceType::IN_VIEWZ);
+            NRD_TEST_CHECK(samplingHintDispatch->consts.gRectSize[0] == WIDTH && samplingHintDispatch->consts.gRectSize[1] == HEIGHT);
+            NRD_TEST_CHECK(samplingHintDispatch->consts.gDenoisingRange == commonSettings.denoisingRange);
+        }
+
+        // Constants
+        const SamplingHintConstants& reblurConsts = reblur.consts;
+        const SamplingHintRootConstants& reblurRootConstants = reblur.rootConstants;
+        const SamplingHintConstants& relaxConsts = relax.consts;
+        const SamplingHintRootConstants& relaxRootConstants = relax.rootConstants;
+
+        NRD_TEST_CHECK(reblurRootConstants.gHasDiffuse == 1 && reblurRootConstants.gHasSpecular == 1 && reblurRootConstants.gIsReblur == 1);
+        NRD_TEST_CHECK(relaxRootConstants.gHasDiffuse == 1 && relaxRootConstants.gHasSpecular == 0 && relaxRootConstants.gIsReblur == 0);
+
+        // Synthetic histories (normalized as stored: REBLUR - "frames / REBLUR_MAX_HISTORY_FRAME_NUM", RELAX - "frames / 255")
+        auto Pixel = [](float diffFrames, float specFrames, float historyLengthNorm, float noise, float viewZ)
+        { return SamplingHintPixel{viewZ, {diffFrames / historyLengthNorm, specFrames / historyLengthNorm}, {1.0f + noise, 1.0f + noise}, {1.0f, 1.0f}}; };
+
+        auto Tile = [](const SamplingHintPixel& pixel, uint32_t num = 256)
+        { return std::vector<SamplingHintPixel>(num, pixel); };
+
+        auto IsNear = [](float a, float b)
+        { return std::abs(a - b) <= 1.0f / 255.0f; };
+
+        const float reblurNorm = float(nrd::REBLUR_MAX_HISTORY_FRAME_NUM);
+        const float reblurMax = float(nrd::REBLUR_MAX_HISTORY_FRAME_NUM); // clamped
+        const float relaxNorm = float(nrd::RELAX_MAX_HISTORY_FRAME_NUM);
+        const float relaxMax = float(relaxSettings.diffuseMaxAccumulatedFrameNum);
+
+        // Disocclusion => all rays, converged with no residual => no rays (the clamp makes it reachable), half converged => half
+        NRD_TEST_CHECK(GetReferenceHint(reblurConsts, reblurRootConstants, Tile(Pixel(0.0f, 0.0f, reblurNorm, 0.0f, 1.0f))) == 1.0f);
+        NRD_TEST_CHECK(GetReferenceHint(reblurConsts, reblurRootConstants, Tile(Pixel(reblurMax, reblurMax, reblurNorm, 0.0f, 1.0f))) == 0.0f);
+        NRD_TEST_CHECK(IsNear(GetReferenceHint(reblurConsts, reblurRootConstants, Tile(Pixel(reblurMax, reblurMax * 0.5f, reblurNorm, 0.0f, 1.0f))), 0.5f));
+        NRD_TEST_CHECK(IsNear(GetReferenceHint(reblurConsts, reblurRootConstants, Tile(Pixel(reblurMax * 0.5f, reblurMax, reblurNorm, 0.0f, 1.0f))), 0.5f));
+
+        NRD_TEST_CHECK(GetReferenceHint(relaxConsts, relaxRootConstants, Tile(Pixel(0.0f, 0.0f, relaxNorm, 0.0f, 1.0f))) == 1.0f);
+        NRD_TEST_CHECK(GetReferenceHint(relaxConsts, relaxRootConstants, Tile(Pixel(relaxMax, 0.0f, relaxNorm, 0.0f, 1.0f))) == 0.0f); // no specular
+        NRD_TEST_CHECK(IsNear(GetReferenceHint(relaxConsts, relaxRootConstants, Tile(Pixel(relaxMax * 0.25f, 0.0f, relaxNorm, 0.0f, 1.0f))), 0.75f));
+
+        // Converged with a residual => rays in proportion to the error of the accumulated estimate
+        NRD_TEST_CHECK(IsNear(GetReferenceHint(reblurConsts, reblurRootConstants, Tile(Pixel(reblurMax, reblurMax, reblurNorm, 1.6f, 1.0f))), 1.6f / std::sqrt(1.0f + reblurMax)));
+        NRD_TEST_CHECK(IsNear(GetReferenceHint(relaxConsts, relaxRootConstants, Tile(Pixel(relaxMax, 0.0f, relaxNorm, 1.6f, 1.0f))), 1.6f / std::sqrt(1.0f + relaxMax)));
+
+        // Tiles: average over pixels in the denoising range (partial tiles at the edges), 0 if there are none
+        std::vector<SamplingHintPixel> tile = Tile(Pixel(0.0f, 0.0f, reblurNorm, 0.0f, 1.0f), 64);
+        std::vector<SamplingHintPixel> converged = Tile(Pixel(reblurMax, reblurMax, reblurNorm, 0.0f, 1.0f), 192);
+        tile.insert(tile.end(), converged.begin(), converged.end());
+        NRD_TEST_CHECK(GetReferenceHint(reblurConsts, reblurRootConstants, tile) == 0.25f);
+
+        std::vector<SamplingHintPixel> sky = Tile(Pixel(0.0f, 0.0f, reblurNorm, 0.0f, commonSettings.denoisingRange * 2.0f), 100);
+        NRD_TEST_CHECK(GetReferenceHint(reblurConsts, reblurRootConstants, sky) == 0.0f);
+
+        tile.insert(tile.end(), sky.begin(), sky.end());
+        NRD_TEST_CHECK(GetReferenceHint(reblurConsts, reblurRootConstants, tile) == 0.25f);
+    }
+
+    nrd::DestroyInstance(*instance);
+}
+
+int main()
+{
+    TestDenoiserSubset();
+    TestDispatchStats();
+    TestDispatchesToMemory();
+    TestInheritHistory();
+    TestSamplingHint();
+
+    return NRD_TEST_RESULT();
+}
@@ -0,0 +1,473 @@
+/*
+Copyright (c) 2022, NVIDIA CORPORATION. All rights reserved.
+
+NVIDIA CORPORATION and its licensors retain all intellectual property
+and proprietary rights in and to this software, related documentation
+and any modifications thereto. Any use, reproduction, disclosure or
+distribution of this software and related documentation without an express
+license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+// Device independent parts of the NRD integration ("NRDIntegrationUtils.h"). NRI is not needed, descriptors are never dereferenced,
+// i.e. the NRI types used by the header are declared below
+
+#include "Test.h"
+
+#include "NRD.h"
+
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace nri
+{
+    struct Descriptor;
+    typedef uint8_t MemoryType;
+
+    struct MemoryDesc
+    {
+        uint64_t size;
+        uint32_t alignment;
+        MemoryType type;
+        bool mustBeDedicated;
+    };
+
+    enum class GraphicsAPI : uint8_t
+    {
+        NONE,
+        D3D11,
+        D3D12,
+        VK,
+    };
+
+    enum class Vendor : uint8_t
+    {
+        UNKNOWN,
+        NVIDIA,
+        AMD,
+        INTEL,
+    };
+
+    struct AdapterDesc
+    {
+        uint32_t deviceId;
+        Vendor vendor;
+    };
+
+    struct DeviceDesc
+    {
+        AdapterDesc adapterDesc;
+        GraphicsAPI graphicsAPI;
+        uint16_t nriVersionMajor;
+        uint16_t nriVersionMinor;
+    };
+}
+
+#include "NRDIntegrationUtils.h"
+
+static uint8_t g_DescriptorStorage[64];
+
+static nri::Descriptor* GetDescriptor(uint64_t key)
+{ return (nri::Descriptor*)&g_DescriptorStorage[key % sizeof(g_DescriptorStorage)]; }
+
+// The integration looks up a view, and inserts a new descriptor on a miss (see "Integration::Dispatch")
+static nri::Descriptor* Use(nrd::DescriptorCache& cache, uint64_t key, uint32_t frameIndex, uint32_t capacity, std::vector<nri::Descriptor*>& evicted)
+{
+    nri::Descriptor* descriptor = cache.Find(key, frameIndex);
+    if (!descriptor)
+    {
+        descriptor = GetDescriptor(key);
+        cache.Insert(key, descriptor, frameIndex, capacity, evicted);
+    }
+
+    return descriptor;
+}
+
+static void TestDescriptorCacheEviction()
+{
+    constexpr uint32_t CAPACITY = 4;
+
+    nrd::DescriptorCache cache;
+    std::vector<nri::Descriptor*> evicted;
+
+    // Frame 0: fill
+    for (uint64_t key = 0; key < CAPACITY; key++)
+        Use(cache, key, 0, CAPACITY, evicted);
+
+    NRD_TEST_CHECK(evicted.empty());
+    NRD_TEST_CHECK(cache.GetStats().descriptorNum == CAPACITY);
+    NRD_TEST_CHECK(cache.GetStats().missNum == CAPACITY && cache.GetStats().hitNum == 0);
+
+    // Frame 1: a hit makes "0" the most recently used, i.e. a new key evicts "1" (the least recently used)
+    NRD_TEST_CHECK(cache.Find(0, 1) == GetDescriptor(0));
+    Use(cache, 4, 1, CAPACITY, evicted);
+
+    NRD_TEST_CHECK(evicted.size() == 1 && evicted[0] == GetDescriptor(1));
+    NRD_TEST_CHECK(cache.GetStats().descriptorNum == CAPACITY);
+    NRD_TEST_CHECK(cache.Find(1, 1) == nullptr);
+    NRD_TEST_CHECK(cache.Find(0, 1) == GetDescriptor(0));
+
+    // Frame 2: all entries are used by the current frame, i.e. eviction stops and the capacity is overshot
+    evicted.clear();
+
+    const uint64_t frame2[] = {3, 0, 2, 4};
+    for (uint64_t key : frame2)
+        NRD_TEST_CHECK(cache.Find(key, 2) == GetDescriptor(key));
+
+    Use(cache, 5, 2, CAPACITY, evicted);
+    Use(cache, 6, 2, CAPACITY, evicted);
+
+    NRD_TEST_CHECK(evicted.empty());
+    NRD_TEST_CHECK(cache.GetStats().descriptorNum == CAPACITY + 2);
+
+    for (uint64_t key : frame2)
+        NRD_TEST_CHECK(cache.Find(key, 2) == GetDescriptor(key));
+
+    // Frame 3: the next insertion shrinks the cache back to the capacity, the least recently used entries go first
+    Use(cache, 7, 3, CAPACITY, evicted);
+
+    NRD_TEST_CHECK(evicted.size() == 3);
+    NRD_TEST_CHECK(evicted.size() == 3 && evicted[0] == GetDescriptor(5) && evicted[1] == GetDescriptor(6) && evicted[2] == GetDescriptor(3));
+    NRD_TEST_CHECK(cache.GetStats().descriptorNum == CAPACITY);
+    NRD_TEST_CHECK(cache.GetStats().evictionNum == 4);
+
+    // Frame 4: "capacity = 0" - unbounded
+    evicted.clear();
+
+    for (uint64_t key = 100; key < 200; key++)
+        Use(cache, key, 4, 0, evicted);
+
+    NRD_TEST_CHECK(evicted.empty());
+    NRD_TEST_CHECK(cache.GetStats().descriptorNum == CAPACITY + 100);
+
+    // Clear returns everything
+    cache.Clear(evicted);
+
+    NRD_TEST_CHECK(evicted.size() == CAPACITY + 100);
+    NRD_TEST_CHECK(cache.GetStats().descriptorNum == 0);
+    NRD_TEST_CHECK(cache.GetStats().evictionNum == 4 + CAPACITY + 100);
+    NRD_TEST_CHECK(cache.Find(0, 5) == nullptr);
+
+    cache.ResetStats();
+
+    nrd::DescriptorCacheStats stats = cache.GetStats();
+    NRD_TEST_CHECK(stats.hitNum == 0 && stats.missNum == 0 && stats.evictionNum == 0 && stats.descriptorNum == 0);
+}
+
+// Random lookups vs a straightforward model (a list ordered by recency)
+static void TestDescriptorCacheRandom()
+{
+    constexpr uint32_t CAPACITY = 8;
+
+    struct ModelEntry
+    {
+        uint64_t key;
+        uint32_t lastUsedFrame;
+    };
+
+    nrd::DescriptorCache cache;
+    std::vector<ModelEntry> model; // most recently used first
+    std::vector<nri::Descriptor*> evicted;
+    std::vector<nri::Descriptor*> evictedExpected;
+    nrd::DescriptorCacheStats statsExpected = {};
+    Random random;
+
+    for (uint32_t frameIndex = 0; frameIndex < 500; frameIndex++)
+    {
+        uint32_t lookupNum = random.Uint() % 13;
+        bool isInserted = false;
+        for (uint32_t i = 0; i < lookupNum; i++)
+        {
+            uint64_t key = random.Uint() % 24;
+
+            // Model
+            size_t j = 0;
+            while (j < model.size() && model[j].key != key)
+                j++;
+
+            if (j < model.size())
+            {
+                model.erase(model.begin() + j);
+                statsExpected.hitNum++;
+            }
+            else
+            {
+                while (model.size() >= CAPACITY && model.back().lastUsedFrame != frameIndex)
+                {
+                    evictedExpected.push_back(GetDescriptor(model.back().key));
+                    model.pop_back();
+                    statsExpected.evictionNum++;
+                }
+
+                statsExpected.missNum++;
+                isInserted = true;
+            }
+
+            model.insert(model.begin(), {key, frameIndex});
+
+            // Cache
+            NRD_TEST_CHECK(Use(cache, key, frameIndex, CAPACITY, evicted) == GetDescriptor(key));
+            NRD_TEST_CHECK(evicted == evictedExpected);
+        }
+
+        nrd::DescriptorCacheStats stats = cache.GetStats();
+        NRD_TEST_CHECK(stats.hitNum == statsExpected.hitNum);
+        NRD_TEST_CHECK(stats.missNum == statsExpected.missNum);
+        NRD_TEST_CHECK(stats.evictionNum == statsExpected.evictionNum);
+        NRD_TEST_CHECK(stats.descriptorNum == model.size());
+
+        if (isInserted) // overshoot is bounded by the views of a frame (it stays until the next insertion)
+            NRD_TEST_CHECK(stats.descriptorNum <= std::max(CAPACITY, lookupNum));
+    }
+}
+
+static void TestTransientPoolPlacement()
+{
+    uint64_t offsets[64] = {};
+    nrd::TransientPoolPlacement placement = {};
+
+    // Nothing to place
+    NRD_TEST_CHECK(nrd::CalculateTransientPoolPlacement(nullptr, 0, offsets, placement));
+    NRD_TEST_CHECK(placement.isExternal && placement.size == 0 && placement.alignment == 1);
+
+    // Offsets are aligned individually, the window alignment is the max
+    const nri::MemoryDesc memoryDescs[] =
+    {
+        {100, 64, 3, false},
+        {10, 256, 3, false},
+        {1, 0, 3, false}, // "0" - no alignment requirement
+        {300, 16, 3, false},
+        {64, 64, 3, false},
+    };
+
+    NRD_TEST_CHECK(nrd::CalculateTransientPoolPlacement(memoryDescs, 5, offsets, placement));
+    NRD_TEST_CHECK(offsets[0] == 0 && offsets[1] == 256 && offsets[2] == 266 && offsets[3] == 272 && offsets[4] == 576);
+    NRD_TEST_CHECK(placement.size == 640);
+    NRD_TEST_CHECK(placement.alignment == 256);
+    NRD_TEST_CHECK(placement.memoryType == 3);
+    NRD_TEST_CHECK(placement.isExternal);
+
+    // Mixed memory types and dedicated allocations are rejected (at any position), the placement is reset
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        nri::MemoryDesc rejected[5];
+        memcpy(rejected, memoryDescs, sizeof(rejected));
+        rejected[i].type = 4;
+
+        placement.isExternal = true;
+        bool isPlaced = nrd::CalculateTransientPoolPlacement(rejected, 5, offsets, placement);
+        NRD_TEST_CHECK(!isPlaced && !placement.isExternal && placement.size == 0 && placement.alignment == 0);
+
+        memcpy(rejected, memoryDescs, sizeof(rejected));
+        rejected[i].mustBeDedicated = true;
+
+        placement.isExternal = true;
+        isPlaced = nrd::CalculateTransientPoolPlacement(rejected, 5, offsets, placement);
+        NRD_TEST_CHECK(!isPlaced && !placement.isExternal && placement.size == 0 && placement.alignment == 0);
+    }
+
+    // Random: aligned, ordered, not overlapping, tight (no more padding than needed)
+    Random random;
+    for (uint32_t n = 0; n < 1000; n++)
+    {
+        nri::MemoryDesc randomDescs[64];
+        uint32_t num = 1 + random.Uint() % 64;
+        for (uint32_t i = 0; i < num; i++)
+            randomDescs[i] = {1 + random.Uint() % (1 << 20), 1u << (random.Uint() % 17), 1, false};
+
+        NRD_TEST_CHECK(nrd::CalculateTransientPoolPlacement(randomDescs, num, offsets, placement));
+        NRD_TEST_CHECK(placement.isExternal);
+
+        uint64_t end = 0;
+        uint64_t alignment = 1;
+        for (uint32_t i = 0; i < num; i++)
+        {
+            NRD_TEST_CHECK(offsets[i] % randomDescs[i].alignment == 0);
+            NRD_TEST_CHECK(offsets[i] >= end && offsets[i] - end < randomDescs[i].alignment);
+
+            end = offsets[i] + randomDescs[i].size;
+            alignment = std::max(alignment, (uint64_t)randomDescs[i].alignment);
+        }
+
+        NRD_TEST_CHECK(placement.size == end);
+        NRD_TEST_CHECK(placement.alignment == alignment);
+    }
+}
+
+// "PrewarmList": the key, shader hashes and the blob format (Load / Store via callbacks and files)
+static void TestPrewarmList()
+{
+    nrd::LibraryDesc libraryDesc = {};
+    libraryDesc.versionMajor = 4;
+    libraryDesc.versionMinor = 15;
+    libraryDesc.versionBuild = 0;
+    libraryDesc.normalEncoding = nrd::NormalEncoding::R10_G10_B10_A2_UNORM;
+    libraryDesc.roughnessEncoding = nrd::RoughnessEncoding::SQRT_LINEAR;
+
+    nri::DeviceDesc deviceDesc = {};
+    deviceDesc.graphicsAPI = nri::GraphicsAPI::VK;
+    deviceDesc.adapterDesc.vendor = nri::Vendor::NVIDIA;
+    deviceDesc.adapterDesc.deviceId = 0x2684;
+    deviceDesc.nriVersionMajor = 1;
+    deviceDesc.nriVersionMinor = 17;
+
+    // The key is stable across runs and builds (FNV-1a of the fields, little endian), other fields don't affect it
+    const uint64_t key = nrd::PrewarmList::GetKey(libraryDesc, deviceDesc);
+    NRD_TEST_CHECK(key == 0xFADC3A43D1FF428Aull);
+
+    {
+        nrd::LibraryDesc other = libraryDesc;
+        other.supportedDenoisersNum = 5;
+        other.spirvBindingOffsets.samplerOffset = 100;
+        NRD_TEST_CHECK(nrd::PrewarmList::GetKey(other, deviceDesc) == key);
+    }
+
+    // ... but every field used by the key changes it
+    std::vector<uint64_t> keys = {key};
+    auto AddKey = [&](const nrd::LibraryDesc& l, const nri::DeviceDesc& d)
+    { keys.push_back(nrd::PrewarmList::GetKey(l, d)); };
+
+    nrd::LibraryDesc l = libraryDesc;
+    l.versionMajor++;
+    AddKey(l, deviceDesc);
+    l = libraryDesc;
+    l.versionMinor++;
+    AddKey(l, deviceDesc);
+    l = libraryDesc;
+    l.versionBuild++;
+    AddKey(l, deviceDesc);
+    l = libraryDesc;
+    l.normalEncoding = nrd::NormalEncoding::RGBA16_SNORM;
+    AddKey(l, deviceDesc);
+    l = libraryDesc;
+    l.roughnessEncoding = nrd::RoughnessEncoding::LINEAR;
+    AddKey(l, deviceDesc);
+
+    nri::DeviceDesc d = deviceDesc;
+    d.graphicsAPI = nri::GraphicsAPI::D3D12;
+    AddKey(libraryDesc, d);
+    d = deviceDesc;
+    d.adapterDesc.vendor = nri::Vendor::AMD;
+    AddKey(libraryDesc, d);
+    d = deviceDesc;
+    d.adapterDesc.deviceId++;
+    AddKey(libraryDesc, d);
+    d = deviceDesc;
+    d.nriVersionMajor++;
+    AddKey(libraryDesc, d);
+    d = deviceDesc;
+    d.nriVersionMinor++;
+    AddKey(libraryDesc, d);
+
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        for (size_t j = i + 1; j < keys.size(); j++)
+            NRD_TEST_CHECK(keys[i] != keys[j]);
+    }
+
+    // Shader hashes depend only on the name
+    nrd::PipelineDesc pipelineDesc = {};
+    pipelineDesc.shaderFileName = "REBLUR_Diffuse_Blur.cs";
+    NRD_TEST_CHECK(nrd::PrewarmList::GetShaderHash(pipelineDesc) == 0x6C8CA1FEA1AF6548ull);
+
+    nrd::PipelineDesc otherPipelineDesc = {};
+    otherPipelineDesc.shaderFileName = "REBLUR_Diffuse_PostBlur.cs";
+    NRD_TEST_CHECK(nrd::PrewarmList::GetShaderHash(otherPipelineDesc) != nrd::PrewarmList::GetShaderHash(pipelineDesc));
+
+    // Round trip (empty and not)
+    std::vector<uint64_t> shaderHashes;
+    std::vector<uint8_t> data;
+
+    nrd::PrewarmList::Serialize(key, shaderHashes, data);
+    shaderHashes.push_back(1);
+    NRD_TEST_CHECK(nrd::PrewarmList::Deserialize(key, data.data(), data.size(), shaderHashes));
+    NRD_TEST_CHECK(shaderHashes.empty());
+
+    Random random;
+    std::vector<uint64_t> expectedHashes;
+    for (uint32_t i = 0; i < 37; i++)
+        expectedHashes.push_back((uint64_t(random.Uint()) << 32) | random.Uint());
+
+    nrd::PrewarmList::Serialize(key, expectedHashes, data);
+    NRD_TEST_CHECK(nrd::PrewarmList::Deserialize(key, data.data(), data.size(), shaderHashes));
+    NRD_TEST_CHECK(shaderHashes == expectedHashes);
+
+    // Rejected: a stale key, no data, a truncated or extended blob, any modified byte (header fields or the checksum)
+    NRD_TEST_CHECK(!nrd::PrewarmList::Deserialize(keys[1], data.data(), data.size(), shaderHashes) && shaderHashes.empty());
+    NRD_TEST_CHECK(!nrd::PrewarmList::Deserialize(key, nullptr, data.size(), shaderHashes));
+    NRD_TEST_CHECK(!nrd::PrewarmList::Deserialize(key, data.data(), 0, shaderHashes));
+
+    for (size_t size : {size_t(1), data.size() - 8 * expectedHashes.size() - 1, data.size() - 8, data.size() - 1})
+        NRD_TEST_CHECK(!nrd::PrewarmList::Deserialize(key, data.data(), size, shaderHashes) && shaderHashes.empty());
+
+    for (size_t extra : {1, 8})
+    {
+        std::vector<uint8_t> extended = data;
+        extended.resize(data.size() + extra);
+        NRD_TEST_CHECK(!nrd::PrewarmList::Deserialize(key, extended.data(), extended.size(), shaderHashes) && shaderHashes.empty());
+    }
+
+    bool isRejected = true;
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        std::vector<uint8_t> corrupted = data;
+        corrupted[i] ^= uint8_t(1 << (i % 8));
+        isRejected &= !nrd::PrewarmList::Deserialize(key, corrupted.data(), corrupted.size(), shaderHashes) && shaderHashes.empty();
+    }
+    NRD_TEST_CHECK(isRejected);
+
+    // Store / Load: callbacks have priority over the path
+    struct Storage
+    {
+        std::vector<uint8_t> data;
+        uint32_t loadNum;
+        uint32_t storeNum;
+    } storage = {};
+
+    nrd::PrewarmListCallbacks callbacks = {};
+    callbacks.userArg = &storage;
+    callbacks.Load = [](void* userArg, std::vector<uint8_t>& data) -> bool
+    {
+        Storage& storage = *(Storage*)userArg;
+        storage.loadNum++;
+        data = storage.data;
+
+        return !data.empty();
+    };
+    callbacks.Store = [](void* userArg, const uint8_t* data, size_t size)
+    {
+        Storage& storage = *(Storage*)userArg;
+        storage.storeNum++;
+        storage.data.assign(data, data + size);
+    };
+
+    const char* path = "NRDTestPrewarmList.bin";
+    remove(path);
+
+    std::vector<uint8_t> loaded = {1, 2, 3};
+    nrd::PrewarmList::Store(path, callbacks, data);
+    NRD_TEST_CHECK(storage.storeNum == 1 && storage.data == data);
+    NRD_TEST_CHECK(nrd::PrewarmList::Load(path, callbacks, loaded) && loaded == data && storage.loadNum == 1);
+    NRD_TEST_CHECK(!nrd::PrewarmList::Load(path, nrd::PrewarmListCallbacks{}, loaded) && loaded.empty()); // not written to the path
+
+    // Files
+    NRD_TEST_CHECK(!nrd::PrewarmList::Load(nullptr, nrd::PrewarmListCallbacks{}, loaded));
+    NRD_TEST_CHECK(!nrd::PrewarmList::Load("", nrd::PrewarmListCallbacks{}, loaded));
+
+    nrd::PrewarmList::Store(path, nrd::PrewarmListCallbacks{}, data);
+    NRD_TEST_CHECK(nrd::PrewarmList::Load(path, nrd::PrewarmListCallbacks{}, loaded) && loaded == data);
+    NRD_TEST_CHECK(nrd::PrewarmList::Deserialize(key, loaded.data(), loaded.size(), shaderHashes) && shaderHashes == expectedHashes);
+
+    remove(path);
+}
+
+int main()
+{
+    TestDescriptorCacheEviction();
+    TestDescriptorCacheRandom();
+    TestTransientPoolPlacement();
+    TestPrewarmList();
+
+    return NRD_TEST_RESULT();
+}
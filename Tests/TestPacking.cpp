@@ -0,0 +1,341 @@
+/*
+Copyright (c) 2022, NVIDIA CORPORATION. All rights reserved.
+
+NVIDIA CORPORATION and its licensors retain all intellectual property
+and proprietary rights in and to this software, related documentation
+and any modifications thereto. Any use, reproduction, disclosure or
+distribution of this software and related documentation without an express
+license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+// "NRDPacking.h" promises bit-exact results regardless of the SIMD path. Functions process "num" elements as SIMD batches followed
+// by a scalar tail, i.e. one call for many elements (SIMD) must match calls for single elements (scalar). The test is compiled
+// with the default SIMD options (SSE4.1) and with "NRD_TEST_AVX2" (AVX2 + F16C, skipped if the CPU doesn't support them)
+
+#include "Test.h"
+
+#include "NRDPacking.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+constexpr uint32_t NUM = 4099; // not a multiple of SIMD width, i.e. the scalar tail is used by the batch call too
+
+static bool IsCpuSupported()
+{
+#if defined(NRD_TEST_AVX2)
+    #if defined(_MSC_VER)
+        int32_t regs[4];
+        __cpuid(regs, 0);
+        if (regs[0] < 7)
+            return false;
+
+        __cpuid(regs, 1);
+        bool hasF16C = (regs[2] & (1 << 29)) != 0;
+        bool hasOSXSAVE = (regs[2] & (1 << 27)) != 0;
+        if (!hasF16C || !hasOSXSAVE || (_xgetbv(0) & 0x6) != 0x6)
+            return false;
+
+        __cpuidex(regs, 7, 0);
+        return (regs[1] & (1 << 5)) != 0;
+    #else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c");
+    #endif
+#else
+    return true;
+#endif
+}
+
+//=================================================================================================================================
+// Utilities
+//=================================================================================================================================
+
+static bool IsBitExact(float a, float b) // NAN payload is unspecified
+{
+    if (std::isnan(a) || std::isnan(b))
+        return std::isnan(a) && std::isnan(b);
+
+    return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+static bool IsBitExact(const std::vector<float>& a, const std::vector<float>& b)
+{
+    if (a.size() != b.size())
+        return false;
+
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        if (!IsBitExact(a[i], b[i]))
+        {
+            printf("  mismatch at %zu: %.9g vs %.9g\n", i, a[i], b[i]);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Values in "[a; b]" with ~1/8 of special values (signed zeros, denormals, huge values, INF, NAN...)
+static std::vector<float> Generate(Random& random, uint32_t num, float a, float b)
+{
+    static const float specials[] =
+    {
+        0.0f, -0.0f, 1.0f, -1.0f, 0.5f, 1e-8f, -1e-8f, 1e-40f, -1e-40f, FLT_MIN,
+        65504.0f, 65520.0f, -65504.0f, 1e10f, FLT_MAX, -FLT_MAX, INFINITY, -INFINITY, NAN, -NAN,
+    };
+
+    std::vector<float> v(num);
+    for (float& x : v)
+        x = (random.Uint() & 7) == 0 ? specials[random.Uint() % (sizeof(specials) / sizeof(specials[0]))] : random.Float(a, b);
+
+    return v;
+}
+
+// Calls "func(i, n)" for all "NUM" elements at once (SIMD + tail) and for each element separately (scalar), outputs must match
+template<class Func>
+static void Compare(const char* name, std::vector<float>& out, uint32_t outStride, Func func)
+{
+    out.assign(NUM * outStride, 0.0f);
+    func(0u, NUM);
+    std::vector<float> batch = out;
+
+    out.assign(NUM * outStride, 0.0f);
+    for (uint32_t i = 0; i < NUM; i++)
+        func(i, 1u);
+
+    bool isExact = IsBitExact(batch, out);
+    if (!isExact)
+        printf("  in '%s'\n", name);
+
+    NRD_TEST_CHECK(isExact);
+}
+
+template<class Func>
+static void Compare2(const char* name, std::vector<float>& out0, uint32_t outStride0, std::vector<float>& out1, uint32_t outStride1, Func func)
+{
+    out0.assign(NUM * outStride0, 0.0f);
+    out1.assign(NUM * outStride1, 0.0f);
+    func(0u, NUM);
+    std::vector<float> batch0 = out0;
+    std::vector<float> batch1 = out1;
+
+    out0.assign(NUM * outStride0, 0.0f);
+    out1.assign(NUM * outStride1, 0.0f);
+    for (uint32_t i = 0; i < NUM; i++)
+        func(i, 1u);
+
+    bool isExact = IsBitExact(batch0, out0) && IsBitExact(batch1, out1);
+    if (!isExact)
+        printf("  in '%s'\n", name);
+
+    NRD_TEST_CHECK(isExact);
+}
+
+//=================================================================================================================================
+// Tests
+//=================================================================================================================================
+
+static void TestPacking()
+{
+    Random random;
+
+    std::vector<float> normal = Generate(random, NUM * 3, -1.0f, 1.0f);
+    std::vector<float> direction = Generate(random, NUM * 3, -1.0f, 1.0f);
+    std::vector<float> radiance = Generate(random, NUM * 3, 0.0f, 100.0f);
+    std::vector<float> translucency = Generate(random, NUM * 3, -0.5f, 1.5f);
+    std::vector<float> roughness = Generate(random, NUM, 0.0f, 1.0f);
+    std::vector<float> materialID = Generate(random, NUM, 0.0f, 3.0f);
+    std::vector<float> hitDist = Generate(random, NUM, 0.0f, 1000.0f);
+    std::vector<float> normHitDist = Generate(random, NUM, 0.0f, 1.0f);
+    std::vector<float> viewZ = Generate(random, NUM, -1000.0f, 1000.0f);
+    std::vector<float> distanceToOccluder = Generate(random, NUM, 0.0f, 100.0f);
+    std::vector<float> distanceToLight = Generate(random, NUM, 0.0f, 200.0f);
+    std::vector<float> packed = Generate(random, NUM * 4, -2.0f, 2.0f);
+
+    nrd::HitDistanceParameters hitDistanceParameters = {};
+    std::vector<float> out, out1;
+
+    Compare("NRD_FrontEnd_PackNormalAndRoughness", out, 4, [&](uint32_t i, uint32_t n)
+        { nrd::NRD_FrontEnd_PackNormalAndRoughness(&normal[i * 3], &roughness[i], &materialID[i], n, &out[i * 4]); });
+
+    Compare("NRD_FrontEnd_PackNormalAndRoughness (no materialID)", out, 4, [&](uint32_t i, uint32_t n)
+        { nrd::NRD_FrontEnd_PackNormalAndRoughness(&normal[i * 3], &roughness[i], nullptr, n, &out[i * 4]); });
+
+    Compare2("NRD_FrontEnd_UnpackNormalAndRoughness", out, 4, out1, 1, [&](uint32_t i, uint32_t n)
+        { nrd::NRD_FrontEnd_UnpackNormalAndRoughness(&packed[i * 4], n, &out[i * 4], &out1[i]); });
+
+    Compare("REBLUR_FrontEnd_GetNormHitDist", out, 1, [&](uint32_t i, uint32_t n)
+        { nrd::REBLUR_FrontEnd_GetNormHitDist(&hitDist[i], &viewZ[i], &roughness[i], hitDistanceParameters, n, &out[i]); });
+
+    for (bool sanitize : {false, true})
+    {
+        Compare("REBLUR_FrontEnd_PackRadianceAndNormHitDist", out, 4, [&](uint32_t i, uint32_t n)
+            { nrd::REBLUR_FrontEnd_PackRadianceAndNormHitDist(&radiance[i * 3], &normHitDist[i], n, sanitize, &out[i * 4]); });
+
+        Compare2("REBLUR_FrontEnd_PackSh", out, 4, out1, 4, [&](uint32_t i, uint32_t n)
+            { nrd::REBLUR_FrontEnd_PackSh(&radiance[i * 3], &normHitDist[i], &direction[i * 3], n, sanitize, &out[i * 4], &out1[i * 4]); });
+
+        Compare("REBLUR_FrontEnd_PackDirectionalOcclusion", out, 4, [&](uint32_t i, uint32_t n)
+            { nrd::REBLUR_FrontEnd_PackDirectionalOcclusion(&direction[i * 3], &normHitDist[i], n, sanitize, &out[i * 4]); });
+
+        Compare("RELAX_FrontEnd_PackRadianceAndHitDist", out, 4, [&](uint32_t i, uint32_t n)
+            { nrd::RELAX_FrontEnd_PackRadianceAndHitDist(&radiance[i * 3], &hitDist[i], n, sanitize, &out[i * 4]); });
+
+        Compare2("RELAX_FrontEnd_PackSh", out, 4, out1, 4, [&](uint32_t i, uint32_t n)
+            { nrd::RELAX_FrontEnd_PackSh(&radiance[i * 3], &hitDist[i], &direction[i * 3], n, sanitize, &out[i * 4], &out1[i * 4]); });
+    }
+
+    Compare("SIGMA_FrontEnd_PackPenumbra", out, 1, [&](uint32_t i, uint32_t n)
+        { nrd::SIGMA_FrontEnd_PackPenumbra(&distanceToOccluder[i], 0.0047f, n, &out[i]); });
+
+    Compare("SIGMA_FrontEnd_PackPenumbraLocal", out, 1, [&](uint32_t i, uint32_t n)
+        { nrd::SIGMA_FrontEnd_PackPenumbraLocal(&distanceToOccluder[i], &distanceToLight[i], 0.5f, n, &out[i]); });
+
+    Compare("SIGMA_FrontEnd_PackTranslucency", out, 4, [&](uint32_t i, uint32_t n)
+        { nrd::SIGMA_FrontEnd_PackTranslucency(&distanceToOccluder[i], &translucency[i * 3], n, &out[i * 4]); });
+
+    Compare("REBLUR_BackEnd_UnpackRadianceAndNormHitDist", out, 4, [&](uint32_t i, uint32_t n)
+        { nrd::REBLUR_BackEnd_UnpackRadianceAndNormHitDist(&packed[i * 4], n, &out[i * 4]); });
+
+    Compare("SIGMA_BackEnd_UnpackShadow", out, 1, [&](uint32_t i, uint32_t n)
+        { nrd::SIGMA_BackEnd_UnpackShadow(&packed[i], n, &out[i]); });
+}
+
+static float AsFloat(uint32_t u)
+{
+    float f;
+    memcpy(&f, &u, sizeof(f));
+
+    return f;
+}
+
+static uint32_t AsUint(float f)
+{
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+
+    return u;
+}
+
+static uint16_t ToHalf(float x)
+{
+    uint16_t h;
+    nrd::ConvertFloatToHalf(&x, 1, &h);
+
+    return h;
+}
+
+static void TestHalfReference()
+{
+    // Known values (round to nearest even)
+    NRD_TEST_CHECK(ToHalf(0.0f) == 0x0000);
+    NRD_TEST_CHECK(ToHalf(-0.0f) == 0x8000);
+    NRD_TEST_CHECK(ToHalf(1.0f) == 0x3C00);
+    NRD_TEST_CHECK(ToHalf(-2.0f) == 0xC000);
+    NRD_TEST_CHECK(ToHalf(65504.0f) == 0x7BFF);
+    NRD_TEST_CHECK(ToHalf(65519.0f) == 0x7BFF);
+    NRD_TEST_CHECK(ToHalf(65520.0f) == 0x7C00); // tie, rounds to even, i.e. INF
+    NRD_TEST_CHECK(ToHalf(INFINITY) == 0x7C00);
+    NRD_TEST_CHECK(ToHalf(-INFINITY) == 0xFC00);
+    NRD_TEST_CHECK((ToHalf(NAN) & 0x7E00) == 0x7E00); // quiet NAN
+    NRD_TEST_CHECK(ToHalf(AsFloat(0x33800000)) == 0x0001); // 2^-24, the smallest denormal
+    NRD_TEST_CHECK(ToHalf(AsFloat(0x33000000)) == 0x0000); // 2^-25, tie, rounds to even
+    NRD_TEST_CHECK(ToHalf(AsFloat(0x33000001)) == 0x0001); // above the tie
+    NRD_TEST_CHECK(ToHalf(AsFloat(0x33C00000)) == 0x0002); // 1.5 * 2^-24, tie, rounds to even
+    NRD_TEST_CHECK(ToHalf(AsFloat(0x387FC000)) == 0x03FF); // the largest denormal
+    NRD_TEST_CHECK(ToHalf(AsFloat(0x387FE000)) == 0x0400); // the largest denormal + 1/2 ulp, tie, rounds to the smallest normal
+    NRD_TEST_CHECK(ToHalf(1.0f + 1.0f / 2048.0f) == 0x3C00); // tie, rounds to even
+    NRD_TEST_CHECK(ToHalf(1.0f + 3.0f / 2048.0f) == 0x3C02); // tie, rounds to even
+
+    // All halves: "half => float => half" is lossless (NANs are quieted)
+    std::vector<uint16_t> halves(65536);
+    for (uint32_t i = 0; i < 65536; i++)
+        halves[i] = (uint16_t)i;
+
+    std::vector<float> floats(65536);
+    nrd::ConvertHalfToFloat(halves.data(), 65536, floats.data());
+
+    std::vector<uint16_t> roundtrip(65536);
+    nrd::ConvertFloatToHalf(floats.data(), 65536, roundtrip.data());
+
+    for (uint32_t i = 0; i < 65536; i++)
+    {
+        uint32_t exponent = (i >> 10) & 0x1F;
+        uint32_t mantissa = i & 0x3FF;
+
+        double expected = exponent == 0 ? std::ldexp(double(mantissa), -24) : std::ldexp(double(mantissa | 0x400), int(exponent) - 25);
+        if (exponent == 0x1F)
+            expected = mantissa ? NAN : INFINITY;
+        if (i & 0x8000)
+            expected = -expected;
+
+        bool isNan = exponent == 0x1F && mantissa != 0;
+        NRD_TEST_CHECK(isNan ? std::isnan(floats[i]) : (double)floats[i] == expected);
+        NRD_TEST_CHECK(roundtrip[i] == (isNan ? (i | 0x200) : i));
+    }
+}
+
+static void TestHalfBatches()
+{
+    // All halves
+    std::vector<uint16_t> halves(65536);
+    for (uint32_t i = 0; i < 65536; i++)
+        halves[i] = (uint16_t)i;
+
+    std::vector<float> batch(65536);
+    nrd::ConvertHalfToFloat(halves.data(), 65536, batch.data());
+
+    std::vector<float> single(65536);
+    for (uint32_t i = 0; i < 65536; i++)
+        nrd::ConvertHalfToFloat(&halves[i], 1, &single[i]);
+
+    for (uint32_t i = 0; i < 65536; i++)
+        NRD_TEST_CHECK(AsUint(batch[i]) == AsUint(single[i])); // NANs must match too
+
+    // Floats: rounding boundaries of all halves (the value, the middle point and its neighbors) + a sweep through all floats
+    std::vector<float> floats;
+    floats.reserve(65536 * 5 + (1ull << 32) / 65521 + 1);
+    for (uint32_t i = 0; i < 65536; i++)
+    {
+        uint32_t f = AsUint(single[i]);
+        uint32_t middle = (i & 0x7C00) == 0x7C00 ? f : AsUint(0.5f * (single[i] + single[(i & 0x8000) | ((i + 1) & 0x7FFF)]));
+        floats.insert(floats.end(), {AsFloat(f), AsFloat(middle - 1), AsFloat(middle), AsFloat(middle + 1), AsFloat(f | 0x1FFF)});
+    }
+
+    for (uint64_t f = 0; f < (1ull << 32); f += 65521) // prime
+        floats.push_back(AsFloat((uint32_t)f));
+
+    uint32_t num = (uint32_t)floats.size();
+    std::vector<uint16_t> batchHalves(num);
+    nrd::ConvertFloatToHalf(floats.data(), num, batchHalves.data());
+
+    for (uint32_t i = 0; i < num; i++)
+    {
+        uint16_t h;
+        nrd::ConvertFloatToHalf(&floats[i], 1, &h);
+
+        NRD_TEST_CHECK(batchHalves[i] == h);
+    }
+}
+
+int main()
+{
+    if (!IsCpuSupported())
+    {
+        printf("Skipped: the CPU doesn't support the tested instruction set\n");
+        return NRD_TEST_SKIP;
+    }
+
+    TestPacking();
+    TestHalfReference();
+    TestHalfBatches();
+
+    return NRD_TEST_RESULT();
+}
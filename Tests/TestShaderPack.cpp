@@ -0,0 +1,236 @@
+/*
+Copyright (c) 2022, NVIDIA CORPORATION. All rights reserved.
+
+NVIDIA CORPORATION and its licensors retain all intellectual property
+and proprietary rights in and to this software, related documentation
+and any modifications thereto. Any use, reproduction, disclosure or
+distribution of this software and related documentation without an express
+license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+// Shader pack round trip: fake ShaderMake headers => "NRDShaderPacker" => "ShaderPackImpl" (map, find, miss, corrupted files)
+// Usage: NRDTestShaderPack <NRDShaderPacker path> <working folder>
+
+#include "Test.h"
+
+#include "ShaderPack.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+struct FakeShader
+{
+    std::string name; // "PipelineDesc::shaderFileName"
+    std::vector<uint8_t> bytecode;
+};
+
+static void WriteBinary(const fs::path& path, const std::string& content)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << content;
+}
+
+static std::string ReadBinary(const fs::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+static void WriteShaderMakeHeader(const fs::path& folder, const std::string& name, const char* format, const std::vector<uint8_t>& bytecode)
+{
+    std::string variable = "g_" + name + "_" + format;
+    for (char& c : variable)
+        c = c == '.' ? '_' : c;
+
+    std::string text = "// ShaderMake output\n\nconst uint8_t " + variable + "[] = {";
+    for (size_t i = 0; i < bytecode.size(); i++)
+        text += (i % 16 ? ", " : "\n    ") + std::to_string(bytecode[i]);
+    text += "\n};\n";
+
+    WriteBinary(folder / (name + "." + format + ".h"), text);
+}
+
+static nrd::Result Open(const fs::path& path, nrd::ShaderPackImpl*& shaderPack)
+{
+    StdAllocator<uint8_t> stdAllocator(nrd::AllocationCallbacks{});
+    shaderPack = new nrd::ShaderPackImpl(stdAllocator);
+
+    nrd::ShaderPackCreationDesc shaderPackCreationDesc = {};
+    std::string pathString = path.string();
+    shaderPackCreationDesc.path = pathString.c_str();
+
+    return shaderPack->Create(shaderPackCreationDesc);
+}
+
+static nrd::Result OpenAndClose(const fs::path& path)
+{
+    nrd::ShaderPackImpl* shaderPack = nullptr;
+    nrd::Result result = Open(path, shaderPack);
+    delete shaderPack;
+
+    return result;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        printf("Usage: NRDTestShaderPack <NRDShaderPacker path> <working folder>\n");
+        return 1;
+    }
+
+    fs::path packer = argv[1];
+    fs::path folder = argv[2];
+
+    std::error_code ec;
+    fs::remove_all(folder, ec);
+    fs::create_directories(folder);
+
+    // Fake shaders: enough to get probing collisions, plus identical bytecode under different names (deduplication)
+    std::vector<FakeShader> shaders;
+    for (uint32_t i = 0; i < 40; i++)
+    {
+        FakeShader shader;
+        shader.name = "FAKE_Shader" + std::to_string(i) + "_Pass.cs";
+        shader.bytecode.resize(1 + (i * 37) % 101);
+        for (size_t j = 0; j < shader.bytecode.size(); j++)
+            shader.bytecode[j] = uint8_t(i * 31 + j * 7);
+
+        shaders.push_back(shader);
+    }
+
+    shaders.push_back({"FAKE_Duplicate_Pass.cs", shaders[3].bytecode});
+
+    for (const FakeShader& shader : shaders)
+        WriteShaderMakeHeader(folder, shader.name, "spirv", shader.bytecode);
+
+    WriteShaderMakeHeader(folder, "FAKE_Other_Pass.cs", "dxil", {1, 2, 3}); // another format, must be ignored
+
+    // Pack
+    fs::path packPath = folder / "NRD.spirv.pack";
+    std::string command = "\"" + packer.string() + "\" \"" + folder.string() + "\" spirv \"" + packPath.string() + "\"";
+#if defined(_WIN32)
+    command = "\"" + command + "\""; // "cmd /c" strips the outer quotes
+#endif
+
+    int exitCode = std::system(command.c_str());
+    NRD_TEST_CHECK(exitCode == 0);
+    if (exitCode != 0)
+        return NRD_TEST_RESULT();
+
+    // Map and find
+    {
+        nrd::ShaderPackImpl* shaderPack = nullptr;
+        NRD_TEST_CHECK(Open(packPath, shaderPack) == nrd::Result::SUCCESS);
+        NRD_TEST_CHECK(shaderPack->GetFormat() == nrd::ShaderFormat::SPIRV);
+
+        for (const FakeShader& shader : shaders)
+        {
+            nrd::ComputeShaderDesc desc = shaderPack->Find(shader.name.c_str());
+            NRD_TEST_CHECK(desc.bytecode != nullptr);
+            NRD_TEST_CHECK(desc.size == shader.bytecode.size());
+            NRD_TEST_CHECK(desc.bytecode && desc.size == shader.bytecode.size() && memcmp(desc.bytecode, shader.bytecode.data(), shader.bytecode.size()) == 0);
+            NRD_TEST_CHECK(size_t(desc.bytecode) % nrd::SHADER_PACK_ALIGNMENT == 0); // the mapping is page aligned
+        }
+
+        nrd::ComputeShaderDesc original = shaderPack->Find(shaders[3].name.c_str());
+        nrd::ComputeShaderDesc duplicate = shaderPack->Find("FAKE_Duplicate_Pass.cs");
+        NRD_TEST_CHECK(original.bytecode == duplicate.bytecode);
+
+        // Misses
+        const char* misses[] = {"", "FAKE_Unknown_Pass.cs", "FAKE_Shader1_Pass", "FAKE_Shader1_Pass.cs ", "AKE_Shader1_Pass.cs", "FAKE_Other_Pass.cs"};
+        for (const char* miss : misses)
+        {
+            nrd::ComputeShaderDesc desc = shaderPack->Find(miss);
+            NRD_TEST_CHECK(desc.bytecode == nullptr && desc.size == 0);
+        }
+
+        delete shaderPack;
+    }
+
+    // Invalid and corrupted files
+    const std::string pack = ReadBinary(packPath);
+    NRD_TEST_CHECK(pack.size() > sizeof(nrd::ShaderPackHeader));
+
+    fs::path corruptedPath = folder / "Corrupted.pack";
+    auto Corrupt = [&](size_t offset, const void* data, size_t size)
+    {
+        std::string corrupted = pack;
+        memcpy(&corrupted[offset], data, size);
+        WriteBinary(corruptedPath, corrupted);
+
+        return OpenAndClose(corruptedPath);
+    };
+
+    {
+        nrd::ShaderPackImpl* shaderPack = new nrd::ShaderPackImpl(StdAllocator<uint8_t>(nrd::AllocationCallbacks{}));
+        nrd::ShaderPackCreationDesc shaderPackCreationDesc = {};
+        NRD_TEST_CHECK(shaderPack->Create(shaderPackCreationDesc) == nrd::Result::INVALID_ARGUMENT);
+        delete shaderPack;
+    }
+
+    NRD_TEST_CHECK(OpenAndClose(folder / "Missing.pack") == nrd::Result::FAILURE);
+
+    WriteBinary(corruptedPath, "");
+    NRD_TEST_CHECK(OpenAndClose(corruptedPath) == nrd::Result::FAILURE);
+
+    WriteBinary(corruptedPath, pack.substr(0, sizeof(nrd::ShaderPackHeader) - 1));
+    NRD_TEST_CHECK(OpenAndClose(corruptedPath) == nrd::Result::UNSUPPORTED);
+
+    WriteBinary(corruptedPath, pack.substr(0, pack.size() - 1)); // "fileSize" mismatch
+    NRD_TEST_CHECK(OpenAndClose(corruptedPath) == nrd::Result::UNSUPPORTED);
+
+    uint32_t value = 0x12345678;
+    NRD_TEST_CHECK(Corrupt(offsetof(nrd::ShaderPackHeader, magic), &value, sizeof(value)) == nrd::Result::UNSUPPORTED);
+
+    value = nrd::SHADER_PACK_VERSION + 1;
+    NRD_TEST_CHECK(Corrupt(offsetof(nrd::ShaderPackHeader, version), &value, sizeof(value)) == nrd::Result::UNSUPPORTED);
+
+    value = (uint32_t)nrd::ShaderFormat::MAX_NUM;
+    NRD_TEST_CHECK(Corrupt(offsetof(nrd::ShaderPackHeader, format), &value, sizeof(value)) == nrd::Result::UNSUPPORTED);
+
+    value = 3; // not a power of 2
+    NRD_TEST_CHECK(Corrupt(offsetof(nrd::ShaderPackHeader, bucketsNum), &value, sizeof(value)) == nrd::Result::UNSUPPORTED);
+
+    value = 1u << 30; // the table doesn't fit into the file
+    NRD_TEST_CHECK(Corrupt(offsetof(nrd::ShaderPackHeader, bucketsNum), &value, sizeof(value)) == nrd::Result::UNSUPPORTED);
+
+    value = 1u << 30; // no empty bucket, i.e. probing would not terminate
+    NRD_TEST_CHECK(Corrupt(offsetof(nrd::ShaderPackHeader, entriesNum), &value, sizeof(value)) == nrd::Result::UNSUPPORTED);
+
+    // Corrupted entry: the header is valid, but the blob is out of bounds, i.e. the shader is not found
+    {
+        const FakeShader& corruptedShader = shaders[1];
+        NRD_TEST_CHECK(corruptedShader.bytecode.size() > 1);
+
+        const nrd::ShaderPackHeader* header = (const nrd::ShaderPackHeader*)pack.data();
+        const nrd::ShaderPackEntry* entries = (const nrd::ShaderPackEntry*)(pack.data() + sizeof(nrd::ShaderPackHeader));
+
+        uint64_t hash = nrd::HashString(corruptedShader.name.c_str());
+        uint32_t i = uint32_t(hash) & (header->bucketsNum - 1);
+        while (entries[i].nameHash != hash)
+            i = (i + 1) & (header->bucketsNum - 1);
+
+        uint64_t dataOffset = pack.size() - 1; // "dataSize" doesn't fit
+        size_t offset = sizeof(nrd::ShaderPackHeader) + i * sizeof(nrd::ShaderPackEntry) + offsetof(nrd::ShaderPackEntry, dataOffset);
+        NRD_TEST_CHECK(Corrupt(offset, &dataOffset, sizeof(dataOffset)) == nrd::Result::SUCCESS);
+
+        nrd::ShaderPackImpl* shaderPack = nullptr;
+        NRD_TEST_CHECK(Open(corruptedPath, shaderPack) == nrd::Result::SUCCESS);
+        NRD_TEST_CHECK(shaderPack->Find(corruptedShader.name.c_str()).bytecode == nullptr);
+        NRD_TEST_CHECK(shaderPack->Find(shaders[2].name.c_str()).bytecode != nullptr);
+        delete shaderPack;
+    }
+
+    fs::remove_all(folder, ec);
+
+    return NRD_TEST_RESULT();
+}
@@ -0,0 +1,211 @@
+/*
+Copyright (c) 2022, NVIDIA CORPORATION. All rights reserved.
+
+NVIDIA CORPORATION and its licensors retain all intellectual property
+and proprietary rights in and to this software, related documentation
+and any modifications thereto. Any use, reproduction, disclosure or
+distribution of this software and related documentation without an express
+license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+// Build-time tool for "NRD_EMBEDS_COMPRESSED_SHADERS":
+//  - reads ShaderMake headers ("*.cs.dxbc.h", "*.cs.dxil.h", "*.cs.spirv.h") from the input folder
+//  - deduplicates and compresses bytecode (LZ4 block format) into a single "NRDShaderBlobs.h"
+//  - writes same-named headers to the output folder, which reference blobs instead of embedding bytecode
+// Usage: NRDShaderCompressor <ShaderMake output folder> <output folder>
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+
+#include "ShaderMakeHeader.h"
+
+struct ShaderBlob
+{
+    uint32_t offset;
+    uint32_t compressedSize;
+    uint32_t size;
+};
+
+// LZ4 block format (greedy, single hash table)
+static std::vector<uint8_t> Compress(const std::vector<uint8_t>& src)
+{
+    constexpr size_t MIN_MATCH = 4;
+    constexpr size_t LAST_LITERALS = 5;
+    constexpr size_t MF_LIMIT = 12;
+    constexpr uint32_t HASH_BITS = 16;
+
+    std::vector<uint8_t> dst;
+    dst.reserve(src.size() / 2);
+
+    std::vector<int64_t> table(size_t(1) << HASH_BITS, -1);
+
+    auto Read32 = [&](size_t p)
+    {
+        uint32_t v;
+        memcpy(&v, src.data() + p, sizeof(v));
+        return v;
+    };
+
+    auto WriteLength = [&](size_t length)
+    {
+        for (; length >= 255; length -= 255)
+            dst.push_back(255);
+        dst.push_back((uint8_t)length);
+    };
+
+    auto WriteSequence = [&](size_t literalBegin, size_t literalNum, size_t matchLength, size_t offset)
+    {
+        size_t extraMatchLength = matchLength ? matchLength - MIN_MATCH : 0;
+        dst.push_back(uint8_t((std::min<size_t>(literalNum, 15) << 4) | std::min<size_t>(extraMatchLength, 15)));
+
+        if (literalNum >= 15)
+            WriteLength(literalNum - 15);
+
+        dst.insert(dst.end(), src.begin() + literalBegin, src.begin() + literalBegin + literalNum);
+
+        if (matchLength)
+        {
+            dst.push_back(uint8_t(offset & 0xFF));
+            dst.push_back(uint8_t(offset >> 8));
+
+            if (extraMatchLength >= 15)
+                WriteLength(extraMatchLength - 15);
+        }
+    };
+
+    size_t n = src.size();
+    size_t anchor = 0;
+    size_t i = 0;
+
+    while (i + MF_LIMIT <= n)
+    {
+        uint32_t sequence = Read32(i);
+        uint32_t hash = (sequence * 2654435761u) >> (32 - HASH_BITS);
+
+        int64_t ref = table[hash];
+        table[hash] = (int64_t)i;
+
+        if (ref < 0 || i - (size_t)ref > 65535 || Read32((size_t)ref) != sequence)
+        {
+            i++;
+            continue;
+        }
+
+        size_t length = MIN_MATCH;
+        while (i + length < n - LAST_LITERALS && src[(size_t)ref + length] == src[i + length])
+            length++;
+
+        WriteSequence(anchor, i - anchor, length, i - (size_t)ref);
+
+        i += length;
+        anchor = i;
+    }
+
+    WriteSequence(anchor, n - anchor, 0, 0);
+
+    return dst;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        printf("Usage: NRDShaderCompressor <input folder> <output folder>\n");
+        return 1;
+    }
+
+    fs::path inputDir = argv[1];
+    fs::path outputDir = argv[2];
+
+    std::error_code ec;
+    fs::create_directories(outputDir, ec);
+
+    // Gather headers (sorted for deterministic output)
+    std::vector<fs::path> headers;
+    for (const fs::directory_entry& entry : fs::directory_iterator(inputDir, ec))
+    {
+        std::string filename = entry.path().filename().string();
+        if (EndsWith(filename, ".cs.dxbc.h") || EndsWith(filename, ".cs.dxil.h") || EndsWith(filename, ".cs.spirv.h"))
+            headers.push_back(entry.path());
+    }
+
+    if (ec)
+    {
+        printf("ERROR: can't read '%s'!\n", inputDir.string().c_str());
+        return 1;
+    }
+
+    std::sort(headers.begin(), headers.end());
+
+    // Compress and deduplicate
+    std::vector<uint8_t> blobs;
+    std::map<std::vector<uint8_t>, ShaderBlob> uniqueBlobs;
+    size_t totalSize = 0;
+
+    for (const fs::path& header : headers)
+    {
+        std::string text;
+        ShaderMakeArrays arrays;
+        if (!ReadFile(header, text) || !ParseHeader(text, arrays))
+        {
+            printf("ERROR: can't parse '%s'!\n", header.string().c_str());
+            return 1;
+        }
+
+        std::string output = "// This file is auto-generated by NRDShaderCompressor. Do not modify!\n";
+        for (const auto& array : arrays)
+        {
+            totalSize += array.second.size();
+
+            auto it = uniqueBlobs.find(array.second);
+            if (it == uniqueBlobs.end())
+            {
+                std::vector<uint8_t> compressed = Compress(array.second);
+
+                ShaderBlob blob = {(uint32_t)blobs.size(), (uint32_t)compressed.size(), (uint32_t)array.second.size()};
+                blobs.insert(blobs.end(), compressed.begin(), compressed.end());
+
+                it = uniqueBlobs.insert({array.second, blob}).first;
+            }
+
+            const ShaderBlob& blob = it->second;
+            output += "static const nrd::CompressedShaderBlob " + array.first + " = {" + std::to_string(blob.offset) + ", " +
+                std::to_string(blob.compressedSize) + ", " + std::to_string(blob.size) + "};\n";
+        }
+
+        if (!WriteFileIfChanged(outputDir / header.filename(), output))
+        {
+            printf("ERROR: can't write '%s'!\n", (outputDir / header.filename()).string().c_str());
+            return 1;
+        }
+    }
+
+    // Blobs
+    std::string output = "// This file is auto-generated by NRDShaderCompressor. Do not modify!\n";
+    output += "static const uint8_t g_NrdShaderBlobs[] = {";
+
+    for (size_t i = 0; i < blobs.size(); i++)
+    {
+        if (i % 32 == 0)
+            output += "\n    ";
+
+        output += std::to_string(blobs[i]) + ",";
+    }
+
+    if (blobs.empty())
+        output += "0";
+
+    output += "\n};\n";
+
+    if (!WriteFileIfChanged(outputDir / "NRDShaderBlobs.h", output))
+    {
+        printf("ERROR: can't write '%s'!\n", (outputDir / "NRDShaderBlobs.h").string().c_str());
+        return 1;
+    }
+
+    printf("NRDShaderCompressor: %zu shaders, %zu unique, %.2f Mb => %.2f Mb\n", headers.size(), uniqueBlobs.size(),
+        double(totalSize) / (1024.0 * 1024.0), double(blobs.size()) / (1024.0 * 1024.0));
+
+    return 0;
+}
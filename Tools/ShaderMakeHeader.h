@@ -0,0 +1,105 @@
+/*
+Copyright (c) 2022, NVIDIA CORPORATION. All rights reserved.
+
+NVIDIA CORPORATION and its licensors retain all intellectual property
+and proprietary rights in and to this software, related documentation
+and any modifications thereto. Any use, reproduction, disclosure or
+distribution of this software and related documentation without an express
+license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+// File helpers and ShaderMake header parsing, shared by build-time tools
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+typedef std::vector<std::pair<std::string, std::vector<uint8_t>>> ShaderMakeArrays;
+
+static bool EndsWith(const std::string& s, const char* suffix)
+{
+    size_t n = strlen(suffix);
+
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+static bool ReadFile(const fs::path& path, std::string& content)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+
+    std::stringstream ss;
+    ss << file.rdbuf();
+    content = ss.str();
+
+    return true;
+}
+
+// Keeps timestamps of unchanged files, i.e. doesn't trigger needless recompilation
+static bool WriteFileIfChanged(const fs::path& path, const std::string& content)
+{
+    std::string old;
+    if (ReadFile(path, old) && old == content)
+        return true;
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+
+    file << content;
+
+    return true;
+}
+
+// Parses "... uint8_t g_Name[] = { 1, 0x2, ... };" declarations
+static bool ParseHeader(const std::string& text, ShaderMakeArrays& arrays)
+{
+    size_t pos = 0;
+    while ((pos = text.find("uint8_t", pos)) != std::string::npos)
+    {
+        pos += 7;
+
+        size_t nameBegin = text.find_first_not_of(" \t", pos);
+        size_t nameEnd = text.find('[', nameBegin);
+        size_t dataBegin = text.find('{', nameEnd);
+        size_t dataEnd = text.find('}', dataBegin);
+        if (nameBegin == std::string::npos || nameEnd == std::string::npos || dataBegin == std::string::npos || dataEnd == std::string::npos)
+            return false;
+
+        std::string name = text.substr(nameBegin, nameEnd - nameBegin);
+        while (!name.empty() && (name.back() == ' ' || name.back() == '\t'))
+            name.pop_back();
+
+        std::vector<uint8_t> bytes;
+        const char* s = text.c_str() + dataBegin + 1;
+        const char* end = text.c_str() + dataEnd;
+        while (s < end)
+        {
+            char* next = nullptr;
+            unsigned long value = strtoul(s, &next, 0);
+            if (next == s)
+            {
+                s++; // skip separators
+                continue;
+            }
+
+            bytes.push_back((uint8_t)value);
+            s = next;
+        }
+
+        arrays.push_back({name, bytes});
+        pos = dataEnd;
+    }
+
+    return true;
+}
@@ -0,0 +1,169 @@
+/*
+Copyright (c) 2022, NVIDIA CORPORATION. All rights reserved.
+
+NVIDIA CORPORATION and its licensors retain all intellectual property
+and proprietary rights in and to this software, related documentation
+and any modifications thereto. Any use, reproduction, disclosure or
+distribution of this software and related documentation without an express
+license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+// Build-time tool for "NRD_SHADER_PACKS":
+//  - reads ShaderMake headers ("*.cs.<format>.h") of the requested format from the input folder
+//  - deduplicates bytecode and writes a shader pack (see "Source/ShaderPackFormat.h"), which can be memory-mapped by "nrd::CreateShaderPack"
+// Usage: NRDShaderPacker <ShaderMake output folder> <dxbc|dxil|spirv> <output file>
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+
+#include "ShaderMakeHeader.h"
+#include "../Source/ShaderPackFormat.h"
+
+static const char* g_FormatNames[] = {"dxbc", "dxil", "spirv"}; // order matches "nrd::ShaderFormat"
+
+struct PackedShader
+{
+    std::string name;
+    uint64_t dataOffset;
+    uint64_t dataSize;
+};
+
+static uint64_t Align(uint64_t x, uint64_t alignment)
+{ return (x + alignment - 1) & ~(alignment - 1); }
+
+int main(int argc, char** argv)
+{
+    if (argc != 4)
+    {
+        printf("Usage: NRDShaderPacker <input folder> <dxbc|dxil|spirv> <output file>\n");
+        return 1;
+    }
+
+    fs::path inputDir = argv[1];
+    std::string formatName = argv[2];
+    fs::path outputFile = argv[3];
+
+    uint32_t format = 0;
+    for (; format < sizeof(g_FormatNames) / sizeof(g_FormatNames[0]); format++)
+    {
+        if (formatName == g_FormatNames[format])
+            break;
+    }
+
+    if (format == sizeof(g_FormatNames) / sizeof(g_FormatNames[0]))
+    {
+        printf("ERROR: unknown format '%s'!\n", formatName.c_str());
+        return 1;
+    }
+
+    // Gather headers (sorted for deterministic output)
+    std::string suffix = ".cs." + formatName + ".h";
+
+    std::error_code ec;
+    std::vector<fs::path> headers;
+    for (const fs::directory_entry& entry : fs::directory_iterator(inputDir, ec))
+    {
+        if (EndsWith(entry.path().filename().string(), suffix.c_str()))
+            headers.push_back(entry.path());
+    }
+
+    if (ec)
+    {
+        printf("ERROR: can't read '%s'!\n", inputDir.string().c_str());
+        return 1;
+    }
+
+    std::sort(headers.begin(), headers.end());
+
+    // Deduplicate bytecode
+    std::vector<uint8_t> blobs;
+    std::map<std::vector<uint8_t>, uint64_t> uniqueBlobs;
+    std::vector<PackedShader> shaders;
+
+    for (const fs::path& header : headers)
+    {
+        std::string text;
+        ShaderMakeArrays arrays;
+        if (!ReadFile(header, text) || !ParseHeader(text, arrays) || arrays.size() != 1)
+        {
+            printf("ERROR: can't parse '%s'!\n", header.string().c_str());
+            return 1;
+        }
+
+        const std::vector<uint8_t>& bytecode = arrays[0].second;
+
+        auto it = uniqueBlobs.find(bytecode);
+        if (it == uniqueBlobs.end())
+        {
+            blobs.resize(Align(blobs.size(), nrd::SHADER_PACK_ALIGNMENT));
+            it = uniqueBlobs.insert({bytecode, blobs.size()}).first;
+            blobs.insert(blobs.end(), bytecode.begin(), bytecode.end());
+        }
+
+        // "REBLUR_Diffuse_Blur.cs.dxil.h" => "REBLUR_Diffuse_Blur.cs" (matches "PipelineDesc::shaderFileName")
+        std::string name = header.filename().string();
+        name.resize(name.size() - suffix.size() + 3);
+
+        shaders.push_back({name, it->second, bytecode.size()});
+    }
+
+    // Layout
+    uint32_t bucketsNum = 1;
+    while (bucketsNum < shaders.size() * 2) // load factor <= 0.5 (at least one empty bucket)
+        bucketsNum <<= 1;
+
+    std::string names;
+    std::vector<nrd::ShaderPackEntry> entries(bucketsNum, nrd::ShaderPackEntry{});
+
+    uint64_t namesOffset = sizeof(nrd::ShaderPackHeader) + bucketsNum * sizeof(nrd::ShaderPackEntry);
+    uint64_t namesSize = 0;
+    for (const PackedShader& shader : shaders)
+        namesSize += shader.name.size();
+
+    uint64_t dataOffset = Align(namesOffset + namesSize, nrd::SHADER_PACK_ALIGNMENT);
+
+    for (const PackedShader& shader : shaders)
+    {
+        uint64_t hash = nrd::HashString(shader.name.c_str());
+
+        uint32_t i = uint32_t(hash) & (bucketsNum - 1);
+        while (entries[i].nameLength)
+            i = (i + 1) & (bucketsNum - 1);
+
+        nrd::ShaderPackEntry& entry = entries[i];
+        entry.nameHash = hash;
+        entry.nameOffset = uint32_t(namesOffset + names.size());
+        entry.nameLength = (uint32_t)shader.name.size();
+        entry.dataOffset = dataOffset + shader.dataOffset;
+        entry.dataSize = shader.dataSize;
+
+        names += shader.name;
+    }
+
+    nrd::ShaderPackHeader header = {};
+    header.magic = nrd::SHADER_PACK_MAGIC;
+    header.version = nrd::SHADER_PACK_VERSION;
+    header.format = format;
+    header.entriesNum = (uint32_t)shaders.size();
+    header.bucketsNum = bucketsNum;
+    header.fileSize = dataOffset + blobs.size();
+
+    // Write
+    std::string output;
+    output.append((const char*)&header, sizeof(header));
+    output.append((const char*)entries.data(), entries.size() * sizeof(nrd::ShaderPackEntry));
+    output += names;
+    output.resize((size_t)dataOffset, '\0');
+    output.append((const char*)blobs.data(), blobs.size());
+
+    if (!WriteFileIfChanged(outputFile, output))
+    {
+        printf("ERROR: can't write '%s'!\n", outputFile.string().c_str());
+        return 1;
+    }
+
+    printf("NRDShaderPacker: %zu shaders, %zu unique, %.2f Mb\n", shaders.size(), uniqueBlobs.size(), double(output.size()) / (1024.0 * 1024.0));
+
+    return 0;
+}